@@ -43,6 +43,9 @@ Anim::Anim(const object& startCallback, const object& stopCallback)
 Anim::~Anim()
 {
     ObjectCounter::get()->decRef(&typeid(*this));
+    if (m_bRunning && m_bIsRoot) {
+        AnimStepper::get().removeAnim(this);
+    }
     if (Player::exists()) {
         Player::get()->unregisterPlaybackEndListener(this);
     }
@@ -70,7 +73,7 @@ void Anim::start(bool)
     }
     m_bRunning = true;
     if (m_bIsRoot) {
-        Player::get()->registerPreRenderListener(this);
+        AnimStepper::get().addAnim(this);
     }
     if (m_StartCallback != object()) {
         call<void>(m_StartCallback.ptr());
@@ -106,7 +109,7 @@ void Anim::onPlaybackEnd()
 void Anim::setStopped()
 {
     if (m_bIsRoot) {
-        Player::get()->unregisterPreRenderListener(this);
+        AnimStepper::get().removeAnim(this);
     }
     m_bRunning = false;
     if (m_StopCallback != object()) {
@@ -120,4 +123,88 @@ void Anim::setStopped()
     }
 }
 
+
+AnimStepper& AnimStepper::get()
+{
+    static AnimStepper s_Instance;
+    return s_Instance;
+}
+
+AnimStepper::AnimStepper()
+    : m_StepSignal(&Anim::onPreRender),
+      m_bRegistered(false),
+      m_bStepping(false)
+{
+}
+
+AnimStepper::~AnimStepper()
+{
+}
+
+void AnimStepper::addAnim(Anim* pAnim)
+{
+    dropStaleAnims();
+    m_StepSignal.connect(pAnim);
+    updateRegistration();
+}
+
+void AnimStepper::removeAnim(Anim* pAnim)
+{
+    // Animations dropped by dropStaleAnims() aren't connected anymore.
+    dropStaleAnims();
+    if (m_StepSignal.isConnected(pAnim)) {
+        m_StepSignal.disconnect(pAnim);
+        updateRegistration();
+    }
+}
+
+int AnimStepper::getNumAnims() const
+{
+    return m_StepSignal.getNumListeners();
+}
+
+void AnimStepper::onPreRender()
+{
+    m_bStepping = true;
+    try {
+        m_StepSignal.emit();
+    } catch (...) {
+        m_bStepping = false;
+        updateRegistration();
+        throw;
+    }
+    m_bStepping = false;
+    updateRegistration();
+}
+
+void AnimStepper::updateRegistration()
+{
+    if (m_bStepping) {
+        // Animations removed during emit() are still counted until it returns.
+        return;
+    }
+    bool bNeedsListener = (m_StepSignal.getNumListeners() > 0);
+    if (bNeedsListener && !m_bRegistered) {
+        Player::get()->registerPreRenderListener(this);
+        m_pCanvas = Player::get()->getMainCanvas();
+        m_bRegistered = true;
+    } else if (!bNeedsListener && m_bRegistered) {
+        Player::get()->unregisterPreRenderListener(this);
+        m_pCanvas = boost::weak_ptr<Canvas>();
+        m_bRegistered = false;
+    }
+}
+
+void AnimStepper::dropStaleAnims()
+{
+    if (m_bRegistered && m_pCanvas.expired()) {
+        // The canvas went away without a playback end notification, taking the 
+        // registration with it.
+        AVG_ASSERT(!m_bStepping);
+        m_StepSignal.disconnectAll();
+        m_pCanvas = boost::weak_ptr<Canvas>();
+        m_bRegistered = false;
+    }
+}
+
 }
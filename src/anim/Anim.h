@@ -28,6 +28,7 @@
 
 #include "../base/IPreRenderListener.h"
 #include "../base/IPlaybackEndListener.h"
+#include "../base/Signal.h"
 
 #include <boost/python.hpp>
 #include <boost/shared_ptr.hpp>
@@ -38,6 +39,8 @@
 
 namespace avg {
 
+class Canvas;
+
 class Anim;
 class GroupAnim;
 
@@ -75,6 +78,33 @@ private:
     bool m_bIsRoot;
 };
 
+// Steps all running root animations from one pre-render listener, so the player 
+// doesn't need to manage a listener per animation. The listener is registered with
+// the main canvas; animations that were still running when that canvas went away
+// (i.e. playback was aborted) are dropped and never stepped again.
+class AVG_API AnimStepper: public IPreRenderListener
+{
+public:
+    static AnimStepper& get();
+    virtual ~AnimStepper();
+
+    void addAnim(Anim* pAnim);
+    void removeAnim(Anim* pAnim);
+    int getNumAnims() const;
+
+    virtual void onPreRender();
+
+private:
+    AnimStepper();
+    void updateRegistration();
+    void dropStaleAnims();
+
+    Signal<Anim> m_StepSignal;
+    boost::weak_ptr<Canvas> m_pCanvas;
+    bool m_bRegistered;
+    bool m_bStepping;
+};
+
 template<class T>
 bool isPythonType(const boost::python::object& obj)
 {
@@ -66,6 +66,8 @@ AttrAnim::~AttrAnim()
 void AttrAnim::start(bool bKeepAttr)
 {
     stopActiveAttrAnim();
+    // Bound once here, so stepping doesn't need to go through python.
+    m_NativeAttr.bind(m_Node, m_sAttrName);
     Anim::start();
     addToMap();
 }
@@ -80,6 +82,11 @@ void AttrAnim::setValue(const object& val)
     m_Node.attr(m_sAttrName.c_str()) = val;
 }
 
+const NativeAttr& AttrAnim::getNativeAttr() const
+{
+    return m_NativeAttr;
+}
+
 void AttrAnim::addToMap()
 {
     s_ActiveAnimations[ObjAttrID(m_Node, m_sAttrName)] = 
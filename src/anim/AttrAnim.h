@@ -23,6 +23,7 @@
 #define _AttrAnim_H_
 
 #include "Anim.h"
+#include "NativeAttr.h"
 
 #include "../api.h"
 // Python docs say python.h should be included before any standard headers (!)
@@ -68,6 +69,7 @@ public:
 protected:
     boost::python::object getValue() const;
     void setValue(const boost::python::object& val);
+    const NativeAttr& getNativeAttr() const;
 
     void addToMap();
     void removeFromMap();
@@ -79,6 +81,7 @@ private:
 
     boost::python::object m_Node;
     std::string m_sAttrName;
+    NativeAttr m_NativeAttr;
 
     typedef std::map<ObjAttrID, AttrAnimPtr> AttrAnimationMap;
     static AttrAnimationMap s_ActiveAnimations;
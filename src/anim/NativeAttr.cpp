@@ -0,0 +1,232 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#include "NativeAttr.h"
+
+#include "../base/Exception.h"
+
+#include "../player/Node.h"
+#include "../player/AreaNode.h"
+#include "../player/VectorNode.h"
+#include "../player/FilledVectorNode.h"
+#include "../player/CircleNode.h"
+#include "../player/RectNode.h"
+#include "../player/LineNode.h"
+#include "../player/TypeDefinition.h"
+#include "../player/Arg.h"
+
+#include <boost/bind.hpp>
+
+using namespace boost;
+using namespace boost::python;
+using namespace std;
+
+namespace avg {
+
+NativeAttr::NativeAttr()
+    : m_Type(NONE)
+{
+}
+
+NativeAttr::~NativeAttr()
+{
+}
+
+void NativeAttr::bind(const object& node, const string& sAttrName)
+{
+    unbind();
+    extract<NodePtr> nodeExtractor(node);
+    if (!nodeExtractor.check()) {
+        return;
+    }
+    m_pNode = nodeExtractor();
+    if (m_pNode && isDeclared(sAttrName) && isCppProperty(node, sAttrName)) {
+        bindAccessors(sAttrName);
+    }
+    if (m_Type == NONE) {
+        m_pNode = NodePtr();
+    }
+}
+
+void NativeAttr::unbind()
+{
+    m_pNode = NodePtr();
+    m_Type = NONE;
+    m_FloatGetter.clear();
+    m_FloatSetter.clear();
+    m_Vec2Getter.clear();
+    m_Vec2Setter.clear();
+}
+
+NativeAttr::Type NativeAttr::getType() const
+{
+    return m_Type;
+}
+
+float NativeAttr::getFloat() const
+{
+    AVG_ASSERT(m_Type == FLOAT);
+    return m_FloatGetter();
+}
+
+void NativeAttr::setFloat(float val) const
+{
+    AVG_ASSERT(m_Type == FLOAT);
+    m_FloatSetter(val);
+}
+
+glm::vec2 NativeAttr::getVec2() const
+{
+    AVG_ASSERT(m_Type == VEC2);
+    return m_Vec2Getter();
+}
+
+void NativeAttr::setVec2(const glm::vec2& val) const
+{
+    AVG_ASSERT(m_Type == VEC2);
+    m_Vec2Setter(val);
+}
+
+bool NativeAttr::isDeclared(const string& sAttrName) const
+{
+    const TypeDefinition* pDef = m_pNode->getDefinition();
+    if (!pDef) {
+        return false;
+    }
+    const ArgList& args = pDef->getDefaultArgs();
+    if (!args.hasArg(sAttrName)) {
+        return false;
+    }
+    ArgBasePtr pArg = args.getArg(sAttrName);
+    return dynamic_cast<Arg<float>*>(pArg.get()) || 
+            dynamic_cast<Arg<glm::vec2>*>(pArg.get());
+}
+
+bool NativeAttr::isCppProperty(const object& node, const string& sAttrName) const
+{
+    // Python subclasses can override attributes. In that case, the python setter
+    // needs to be called.
+    try {
+        object descriptor = node.attr("__class__").attr(sAttrName.c_str());
+        object getter = descriptor.attr("fget");
+        string sModule = extract<string>(getter.attr("__class__").attr("__module__"));
+        return sModule == "Boost.Python";
+    } catch (error_already_set&) {
+        PyErr_Clear();
+        return false;
+    }
+}
+
+void NativeAttr::bindAccessors(const string& sAttrName)
+{
+    Node* pNode = m_pNode.get();
+    AreaNode* pAreaNode = dynamic_cast<AreaNode*>(pNode);
+    CircleNode* pCircleNode = dynamic_cast<CircleNode*>(pNode);
+    RectNode* pRectNode = dynamic_cast<RectNode*>(pNode);
+    LineNode* pLineNode = dynamic_cast<LineNode*>(pNode);
+    VectorNode* pVectorNode = dynamic_cast<VectorNode*>(pNode);
+    FilledVectorNode* pFilledVectorNode = dynamic_cast<FilledVectorNode*>(pNode);
+
+    if (sAttrName == "opacity") {
+        setFloatAccessors(boost::bind(&Node::getOpacity, pNode), 
+                boost::bind(&Node::setOpacity, pNode, _1));
+    } else if (pAreaNode) {
+        if (sAttrName == "x") {
+            setFloatAccessors(boost::bind(&AreaNode::getX, pAreaNode), 
+                    boost::bind(&AreaNode::setX, pAreaNode, _1));
+        } else if (sAttrName == "y") {
+            setFloatAccessors(boost::bind(&AreaNode::getY, pAreaNode), 
+                    boost::bind(&AreaNode::setY, pAreaNode, _1));
+        } else if (sAttrName == "pos") {
+            setVec2Accessors(boost::bind(&AreaNode::getPos, pAreaNode), 
+                    boost::bind(&AreaNode::setPos, pAreaNode, _1));
+        } else if (sAttrName == "width") {
+            setFloatAccessors(boost::bind(&AreaNode::getWidth, pAreaNode), 
+                    boost::bind(&AreaNode::setWidth, pAreaNode, _1));
+        } else if (sAttrName == "height") {
+            setFloatAccessors(boost::bind(&AreaNode::getHeight, pAreaNode), 
+                    boost::bind(&AreaNode::setHeight, pAreaNode, _1));
+        } else if (sAttrName == "size") {
+            setVec2Accessors(boost::bind(&AreaNode::getSize, pAreaNode), 
+                    boost::bind(&AreaNode::setSize, pAreaNode, _1));
+        } else if (sAttrName == "angle") {
+            setFloatAccessors(boost::bind(&AreaNode::getAngle, pAreaNode), 
+                    boost::bind(&AreaNode::setAngle, pAreaNode, _1));
+        } else if (sAttrName == "pivot") {
+            setVec2Accessors(boost::bind(&AreaNode::getPivot, pAreaNode), 
+                    boost::bind(&AreaNode::setPivot, pAreaNode, _1));
+        }
+    } else if (pCircleNode) {
+        if (sAttrName == "pos") {
+            setVec2Accessors(boost::bind(&CircleNode::getPos, pCircleNode), 
+                    boost::bind(&CircleNode::setPos, pCircleNode, _1));
+        } else if (sAttrName == "r") {
+            setFloatAccessors(boost::bind(&CircleNode::getR, pCircleNode), 
+                    boost::bind(&CircleNode::setR, pCircleNode, _1));
+        }
+    } else if (pRectNode) {
+        if (sAttrName == "pos") {
+            setVec2Accessors(boost::bind(&RectNode::getPos, pRectNode), 
+                    boost::bind(&RectNode::setPos, pRectNode, _1));
+        } else if (sAttrName == "size") {
+            setVec2Accessors(boost::bind(&RectNode::getSize, pRectNode), 
+                    boost::bind(&RectNode::setSize, pRectNode, _1));
+        } else if (sAttrName == "angle") {
+            setFloatAccessors(boost::bind(&RectNode::getAngle, pRectNode), 
+                    boost::bind(&RectNode::setAngle, pRectNode, _1));
+        }
+    } else if (pLineNode) {
+        if (sAttrName == "pos1") {
+            setVec2Accessors(boost::bind(&LineNode::getPos1, pLineNode), 
+                    boost::bind(&LineNode::setPos1, pLineNode, _1));
+        } else if (sAttrName == "pos2") {
+            setVec2Accessors(boost::bind(&LineNode::getPos2, pLineNode), 
+                    boost::bind(&LineNode::setPos2, pLineNode, _1));
+        }
+    }
+    if (m_Type == NONE && pVectorNode && sAttrName == "strokewidth") {
+        setFloatAccessors(boost::bind(&VectorNode::getStrokeWidth, pVectorNode), 
+                boost::bind(&VectorNode::setStrokeWidth, pVectorNode, _1));
+    }
+    if (m_Type == NONE && pFilledVectorNode && sAttrName == "fillopacity") {
+        setFloatAccessors(boost::bind(&FilledVectorNode::getFillOpacity, 
+                pFilledVectorNode), 
+                boost::bind(&FilledVectorNode::setFillOpacity, pFilledVectorNode, _1));
+    }
+}
+
+void NativeAttr::setFloatAccessors(const FloatGetter& getter, const FloatSetter& setter)
+{
+    m_Type = FLOAT;
+    m_FloatGetter = getter;
+    m_FloatSetter = setter;
+}
+
+void NativeAttr::setVec2Accessors(const Vec2Getter& getter, const Vec2Setter& setter)
+{
+    m_Type = VEC2;
+    m_Vec2Getter = getter;
+    m_Vec2Setter = setter;
+}
+
+}
@@ -0,0 +1,86 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#ifndef _NativeAttr_H_
+#define _NativeAttr_H_
+
+#include "../api.h"
+#include "../player/WrapPython.h" 
+
+#include "../base/GLMHelper.h"
+
+#include <boost/python.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+#include <string>
+
+namespace avg {
+
+class Node;
+typedef boost::shared_ptr<Node> NodePtr;
+
+// Typed access to an animatable node attribute that bypasses python. Binding only 
+// succeeds for float and vec2 attributes that are declared in the node's 
+// TypeDefinition, have a known C++ accessor and aren't overridden in python.
+class AVG_API NativeAttr
+{
+public:
+    enum Type {NONE, FLOAT, VEC2};
+
+    NativeAttr();
+    virtual ~NativeAttr();
+
+    void bind(const boost::python::object& node, const std::string& sAttrName);
+    void unbind();
+    Type getType() const;
+
+    float getFloat() const;
+    void setFloat(float val) const;
+    glm::vec2 getVec2() const;
+    void setVec2(const glm::vec2& val) const;
+
+private:
+    typedef boost::function<float ()> FloatGetter;
+    typedef boost::function<void (float)> FloatSetter;
+    typedef boost::function<glm::vec2 ()> Vec2Getter;
+    typedef boost::function<void (const glm::vec2&)> Vec2Setter;
+
+    bool isDeclared(const std::string& sAttrName) const;
+    bool isCppProperty(const boost::python::object& node, 
+            const std::string& sAttrName) const;
+    void bindAccessors(const std::string& sAttrName);
+    void setFloatAccessors(const FloatGetter& getter, const FloatSetter& setter);
+    void setVec2Accessors(const Vec2Getter& getter, const Vec2Setter& setter);
+
+    NodePtr m_pNode;
+    Type m_Type;
+    FloatGetter m_FloatGetter;
+    FloatSetter m_FloatSetter;
+    Vec2Getter m_Vec2Getter;
+    Vec2Setter m_Vec2Setter;
+};
+
+}
+
+#endif 
@@ -37,7 +37,8 @@ SimpleAnim::SimpleAnim(const object& node, const string& sAttrName, long long du
       m_Duration(duration),
       m_StartValue(startValue),
       m_EndValue(endValue),
-      m_bUseInt(bUseInt)
+      m_bUseInt(bUseInt),
+      m_ValueType(NativeAttr::NONE)
 {
 }
 
@@ -51,13 +52,14 @@ SimpleAnim::~SimpleAnim()
 void SimpleAnim::start(bool bKeepAttr)
 {
     AttrAnim::start();
+    initTypedValues();
     if (bKeepAttr) {
         m_StartTime = calcStartTime();
     } else {
         m_StartTime = Player::get()->getFrameTime();
     }
     if (m_Duration == 0) {
-        setValue(m_EndValue);
+        setEndValue();
         remove();
     } else {
         step();
@@ -71,44 +73,27 @@ void SimpleAnim::abort()
     }
 }
 
-template<class T>
-object typedLERP(const object& startValue, const object& endValue, float part)
-{
-    T start = extract<T>(startValue);
-    T end = extract<T>(endValue);
-    T cur = start+(end-start)*part;
-    return object(cur);
-}
-
 bool SimpleAnim::step()
 {
     assert(isRunning());
     float t = ((float(Player::get()->getFrameTime())-m_StartTime)
             /m_Duration);
     if (t >= 1.0) {
-        setValue(m_EndValue);
+        setEndValue();
         remove();
         return true;
     } else {
-        object curValue;
-        float part = interpolate(t);
-        if (isPythonType<float>(m_StartValue)) {
-            curValue = typedLERP<float>(m_StartValue, m_EndValue, part);
-            if (m_bUseInt) {
-                float d = extract<float>(curValue);
-                curValue = object(round(d));
-            }
-        } else if (isPythonType<glm::vec2>(m_StartValue)) {
-            curValue = typedLERP<glm::vec2>(m_StartValue, m_EndValue, part);
-            if (m_bUseInt) {
-                glm::vec2 pt = extract<glm::vec2>(curValue);
-                curValue = object(glm::vec2(round(pt.x), round(pt.y)));
-            }
-        } else {
+        if (m_ValueType == NativeAttr::NONE) {
             throw (Exception(AVG_ERR_TYPE, 
                     "Animated attributes must be either numbers or Point2D."));
         }
-        setValue(curValue);
+        float part = interpolate(t);
+        glm::vec2 curValue = m_TypedStartValue + 
+                (m_TypedEndValue-m_TypedStartValue)*part;
+        if (m_bUseInt) {
+            curValue = glm::vec2(round(curValue.x), round(curValue.y));
+        }
+        setTypedValue(curValue);
         return false;
     }
 }
@@ -172,6 +157,50 @@ float SimpleAnim::getStartPart(float start, float end, float cur)
     return (tend+tstart)/2;
 }
 
+void SimpleAnim::initTypedValues()
+{
+    if (isPythonType<float>(m_StartValue) && isPythonType<float>(m_EndValue)) {
+        m_ValueType = NativeAttr::FLOAT;
+        m_TypedStartValue = glm::vec2(extract<float>(m_StartValue), 0);
+        m_TypedEndValue = glm::vec2(extract<float>(m_EndValue), 0);
+    } else if (isPythonType<glm::vec2>(m_StartValue) && 
+            isPythonType<glm::vec2>(m_EndValue)) 
+    {
+        m_ValueType = NativeAttr::VEC2;
+        m_TypedStartValue = extract<glm::vec2>(m_StartValue);
+        m_TypedEndValue = extract<glm::vec2>(m_EndValue);
+    } else {
+        m_ValueType = NativeAttr::NONE;
+    }
+}
+
+void SimpleAnim::setTypedValue(const glm::vec2& val)
+{
+    const NativeAttr& nativeAttr = getNativeAttr();
+    if (m_ValueType == NativeAttr::FLOAT) {
+        if (nativeAttr.getType() == NativeAttr::FLOAT) {
+            nativeAttr.setFloat(val.x);
+        } else {
+            setValue(object(val.x));
+        }
+    } else {
+        if (nativeAttr.getType() == NativeAttr::VEC2) {
+            nativeAttr.setVec2(val);
+        } else {
+            setValue(object(val));
+        }
+    }
+}
+
+void SimpleAnim::setEndValue()
+{
+    if (m_ValueType != NativeAttr::NONE && m_ValueType == getNativeAttr().getType()) {
+        setTypedValue(m_TypedEndValue);
+    } else {
+        setValue(m_EndValue);
+    }
+}
+
 void SimpleAnim::remove() 
 {
     AnimPtr tempThis = shared_from_this();
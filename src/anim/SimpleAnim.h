@@ -63,12 +63,20 @@ private:
     long long getDuration() const;
     long long calcStartTime();
     virtual float getStartPart(float start, float end, float cur);
+    void initTypedValues();
+    void setTypedValue(const glm::vec2& val);
+    void setEndValue();
 
     long long m_Duration;
     boost::python::object m_StartValue;
     boost::python::object m_EndValue;
     bool m_bUseInt;
     long long m_StartTime;
+
+    // Floats are stored in the x component.
+    NativeAttr::Type m_ValueType;
+    glm::vec2 m_TypedStartValue;
+    glm::vec2 m_TypedEndValue;
 };
 
 }
@@ -24,9 +24,11 @@
 #include "AudioEngine.h"
 
 #include "Dynamics.h"
+#include "AudioMixer.h"
 
 #include "../base/Exception.h"
 #include "../base/Logger.h"
+#include "../base/StringHelper.h"
 
 #include <iostream>
 
@@ -85,18 +87,53 @@ const AudioParams * AudioEngine::getParams()
     }
 }
 
-void AudioEngine::init(const AudioParams& ap, float volume) 
+template<int CHANNELS>
+IProcessor<float>* createLimiter(float sampleRate)
 {
-    m_Volume = volume;
-    m_AP = ap;
-    Dynamics<float, 2>* pLimiter = new Dynamics<float, 2>(float(m_AP.m_SampleRate));
+    Dynamics<float, CHANNELS>* pLimiter = new Dynamics<float, CHANNELS>(sampleRate);
     pLimiter->setThreshold(0.f); // in dB
     pLimiter->setAttackTime(0.f); // in seconds
     pLimiter->setReleaseTime(0.05f); // in seconds
     pLimiter->setRmsTime(0.f); // in seconds
     pLimiter->setRatio(std::numeric_limits<float>::infinity());
     pLimiter->setMakeupGain(0.f); // in dB
-    m_pLimiter = pLimiter;
+    return pLimiter;
+}
+
+void AudioEngine::init(const AudioParams& ap, float volume) 
+{
+    m_Volume = volume;
+    m_AP = ap;
+    float sampleRate = float(m_AP.m_SampleRate);
+    switch (m_AP.m_Channels) {
+        case 1:
+            m_pLimiter = createLimiter<1>(sampleRate);
+            break;
+        case 2:
+            m_pLimiter = createLimiter<2>(sampleRate);
+            break;
+        case 3:
+            m_pLimiter = createLimiter<3>(sampleRate);
+            break;
+        case 4:
+            m_pLimiter = createLimiter<4>(sampleRate);
+            break;
+        case 5:
+            m_pLimiter = createLimiter<5>(sampleRate);
+            break;
+        case 6:
+            m_pLimiter = createLimiter<6>(sampleRate);
+            break;
+        case 7:
+            m_pLimiter = createLimiter<7>(sampleRate);
+            break;
+        case 8:
+            m_pLimiter = createLimiter<8>(sampleRate);
+            break;
+        default:
+            throw Exception(AVG_ERR_UNSUPPORTED, "Unsupported number of audio channels: "
+                    + toString(m_AP.m_Channels) + ". Between 1 and 8 are supported.");
+    }
     
     SDL_AudioSpec desired;
     desired.freq = m_AP.m_SampleRate;
@@ -235,38 +272,30 @@ bool AudioEngine::isEnabled() const
         
 void AudioEngine::mixAudio(Uint8 *pDestBuffer, int destBufferLen)
 {
-    int numFrames = destBufferLen/(2*getChannels()); // 16 bit samples.
+    int numChannels = getChannels();
+    int numFrames = destBufferLen/(2*numChannels); // 16 bit samples.
 
     if (m_AudioSources.size() == 0) {
         return;
     }
-    if (!m_pTempBuffer || m_pTempBuffer->getNumFrames() < numFrames) {
+    if (!m_pTempBuffer || m_pTempBuffer->getNumFrames() != numFrames) {
         if (m_pTempBuffer) {
             delete[] m_pMixBuffer;
         }
         m_pTempBuffer = AudioBufferPtr(new AudioBuffer(numFrames, m_AP));
-        m_pMixBuffer = new float[getChannels()*numFrames];
+        m_pMixBuffer = new float[numChannels*numFrames];
     }
 
-    for (int i = 0; i < getChannels()*numFrames; ++i) {
-        m_pMixBuffer[i]=0;
-    }
+    clearMixBuffer(m_pMixBuffer, numChannels*numFrames);
     {
         lock_guard lock(m_Mutex);
         AudioSourceMap::iterator it;
         for (it = m_AudioSources.begin(); it != m_AudioSources.end(); it++) {
-            m_pTempBuffer->clear();
-            it->second->fillAudioBuffer(m_pTempBuffer);
-            addBuffers(m_pMixBuffer, m_pTempBuffer);
-        }
-    }
-    calcVolume(m_pMixBuffer, numFrames*getChannels(), getVolume());
-    for (int i = 0; i < numFrames; ++i) {
-        m_pLimiter->process(m_pMixBuffer+i*getChannels());
-        for (int j = 0; j < getChannels(); ++j) {
-            ((short*)pDestBuffer)[i*2+j]=short(m_pMixBuffer[i*2+j]*32768);
+            it->second->mixAudio(m_pMixBuffer, m_pTempBuffer, m_Volume);
         }
     }
+    m_pLimiter->process(m_pMixBuffer, numFrames);
+    mixBufferToShort((short*)pDestBuffer, m_pMixBuffer, numChannels*numFrames);
 }
 
 void AudioEngine::audioCallback(void *userData, Uint8 *audioBuffer, int audioBufferLen)
@@ -275,21 +304,4 @@ void AudioEngine::audioCallback(void *userData, Uint8 *audioBuffer, int audioBuf
     pThis->mixAudio(audioBuffer, audioBufferLen);
 }
 
-void AudioEngine::addBuffers(float *pDest, AudioBufferPtr pSrc)
-{
-    int numFrames = pSrc->getNumFrames();
-    short * pData = pSrc->getData();
-    for(int i = 0; i < numFrames*getChannels(); ++i) {
-        pDest[i] += pData[i]/32768.0f;
-    }
-}
-
-void AudioEngine::calcVolume(float *pBuffer, int numSamples, float volume)
-{
-    // TODO: We need a VolumeFader class that keeps state.
-    for(int i = 0; i < numSamples; ++i) {
-        pBuffer[i] *= volume;
-    }
-}
-
 }
@@ -73,8 +73,6 @@ class AVG_API AudioEngine
     private:
         void mixAudio(Uint8 *pDestBuffer, int destBufferLen);
         static void audioCallback(void *userData, Uint8 *audioBuffer, int audioBufferLen);
-        void addBuffers(float *pDest, AudioBufferPtr pSrc);
-        void calcVolume(float *pBuffer, int numSamples, float volume);
         
         AudioParams m_AP;
         AudioBufferPtr m_pTempBuffer;
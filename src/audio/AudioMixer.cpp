@@ -0,0 +1,173 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "AudioMixer.h"
+
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_WIN32)
+#include <emmintrin.h>
+#define AVG_MIX_SSE2
+#endif
+
+// The AVX2 kernel is built whenever the compiler can generate it. Unless the whole
+// build targets AVX2, it is only used if the CPU supports it.
+#if defined(__AVX2__)
+#define AVG_MIX_AVX2
+#define AVG_AVX2_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AVG_MIX_AVX2
+#define AVG_MIX_AVX2_RUNTIME
+#define AVG_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#if defined(AVG_MIX_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace avg {
+
+void clearMixBuffer(float* pDest, int numSamples)
+{
+    memset(pDest, 0, numSamples*sizeof(float));
+}
+
+#if defined(AVG_MIX_AVX2)
+static bool useAVX2()
+{
+#if defined(AVG_MIX_AVX2_RUNTIME)
+    static bool bUseAVX2 = __builtin_cpu_supports("avx2");
+    return bUseAVX2;
+#else
+    return true;
+#endif
+}
+
+// Returns the number of samples processed.
+AVG_AVX2_TARGET static int addSamplesAVX2(float* pDest, const short* pSrc,
+        int numSamples, float gain)
+{
+    int i = 0;
+    __m256 gain8 = _mm256_set1_ps(gain);
+    for (; i+8 <= numSamples; i += 8) {
+        __m128i src = _mm_loadu_si128((const __m128i*)(pSrc+i));
+        __m256 srcF = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(src));
+        __m256 dest = _mm256_loadu_ps(pDest+i);
+        _mm256_storeu_ps(pDest+i, _mm256_add_ps(dest, _mm256_mul_ps(srcF, gain8)));
+    }
+    return i;
+}
+#endif
+
+#if defined(AVG_MIX_SSE2)
+static int addSamplesSSE2(float* pDest, const short* pSrc, int numSamples, float gain)
+{
+    int i = 0;
+    __m128 gain4 = _mm_set1_ps(gain);
+    for (; i+8 <= numSamples; i += 8) {
+        __m128i src = _mm_loadu_si128((const __m128i*)(pSrc+i));
+        // Sign-extend to 32 bit by moving each sample into the high word.
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(src, src), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(src, src), 16);
+        __m128 destLo = _mm_loadu_ps(pDest+i);
+        __m128 destHi = _mm_loadu_ps(pDest+i+4);
+        destLo = _mm_add_ps(destLo, _mm_mul_ps(_mm_cvtepi32_ps(lo), gain4));
+        destHi = _mm_add_ps(destHi, _mm_mul_ps(_mm_cvtepi32_ps(hi), gain4));
+        _mm_storeu_ps(pDest+i, destLo);
+        _mm_storeu_ps(pDest+i+4, destHi);
+    }
+    return i;
+}
+#endif
+
+static void addSamples(float* pDest, const short* pSrc, int numSamples, float gain)
+{
+    int i = 0;
+#if defined(AVG_MIX_AVX2)
+    if (useAVX2()) {
+        i = addSamplesAVX2(pDest, pSrc, numSamples, gain);
+    } else
+#endif
+    {
+#if defined(AVG_MIX_SSE2)
+        i = addSamplesSSE2(pDest, pSrc, numSamples, gain);
+#endif
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc[i]*gain;
+    }
+}
+
+void addToMixBuffer(float* pDest, const short* pSrc, int numFrames, int numChannels,
+        float startGain, float endGain, int rampFrames)
+{
+    if (startGain == endGain || rampFrames <= 0) {
+        rampFrames = 0;
+    } else if (rampFrames > numFrames) {
+        rampFrames = numFrames;
+    }
+    // The ramp is short compared to a callback buffer, so it stays scalar.
+    float gainStep = (endGain-startGain)/(rampFrames+1);
+    float gain = startGain;
+    for (int i = 0; i < rampFrames; ++i) {
+        gain += gainStep;
+        for (int j = 0; j < numChannels; ++j) {
+            *pDest++ += *pSrc++ * gain;
+        }
+    }
+    if (endGain != 0.f) {
+        addSamples(pDest, pSrc, (numFrames-rampFrames)*numChannels, endGain);
+    }
+}
+
+void mixBufferToShort(short* pDest, const float* pSrc, int numSamples)
+{
+    int i = 0;
+#if defined(AVG_MIX_SSE2)
+    // Clamp in float first: cvtps2dq maps values outside the int range to INT_MIN.
+    // cvtps2dq rounds using the current rounding mode (round half to even by
+    // default), and so does lrintf() in the scalar loop below.
+    __m128 scale4 = _mm_set1_ps(32768.f);
+    __m128 min4 = _mm_set1_ps(-32768.f);
+    __m128 max4 = _mm_set1_ps(32767.f);
+    for (; i+8 <= numSamples; i += 8) {
+        __m128 lo = _mm_mul_ps(_mm_loadu_ps(pSrc+i), scale4);
+        __m128 hi = _mm_mul_ps(_mm_loadu_ps(pSrc+i+4), scale4);
+        lo = _mm_max_ps(_mm_min_ps(lo, max4), min4);
+        hi = _mm_max_ps(_mm_min_ps(hi, max4), min4);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+        _mm_storeu_si128((__m128i*)(pDest+i), packed);
+    }
+#endif
+    for (; i < numSamples; ++i) {
+        float s = pSrc[i]*32768.f;
+        if (s >= 32767.f) {
+            pDest[i] = 32767;
+        } else if (s <= -32768.f) {
+            pDest[i] = -32768;
+        } else {
+            pDest[i] = short(lrintf(s));
+        }
+    }
+}
+
+}
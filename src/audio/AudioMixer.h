@@ -0,0 +1,49 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _AudioMixer_H_
+#define _AudioMixer_H_
+
+#include "../api.h"
+
+namespace avg {
+
+// Sample kernels for the AudioEngine mix bus. All buffers hold interleaved samples;
+// the float mix buffer uses 1.0 as full scale. The kernels use SSE2 when the compiler
+// targets it and AVX2 when the CPU supports it, falling back to plain C++ otherwise.
+// All code paths produce identical results.
+
+void AVG_API clearMixBuffer(float* pDest, int numSamples);
+
+// Converts pSrc to float and adds it to pDest. The gain is interpolated linearly
+// from startGain to endGain over the first rampFrames frames and is endGain after
+// that.
+void AVG_API addToMixBuffer(float* pDest, const short* pSrc, int numFrames,
+        int numChannels, float startGain, float endGain, int rampFrames);
+
+// Converts the mix buffer to 16 bit samples, clipping at full scale. Values are
+// rounded to nearest, with ties going to the even sample value.
+void AVG_API mixBufferToShort(short* pDest, const float* pSrc, int numSamples);
+
+}
+
+#endif
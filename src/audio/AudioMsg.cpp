@@ -60,6 +60,11 @@ void AudioMsg::setEOF()
     setType(END_OF_FILE);
 }
 
+void AudioMsg::setLoopEnd()
+{
+    setType(LOOP_END);
+}
+
 void AudioMsg::setError(const Exception& ex)
 {
     setType(ERROR);
@@ -129,6 +134,9 @@ void AudioMsg::dump()
         case END_OF_FILE:
             cerr << "END_OF_FILE" << endl;
             break;
+        case LOOP_END:
+            cerr << "LOOP_END" << endl;
+            break;
         case ERROR:
             cerr << "ERROR" << endl;
             break;
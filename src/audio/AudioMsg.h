@@ -33,12 +33,13 @@ namespace avg {
 
 class AVG_API AudioMsg {
 public:
-    enum MsgType {NONE, AUDIO, AUDIO_TIME, END_OF_FILE, ERROR, FRAME, VDPAU_FRAME, 
-            SEEK_DONE, PACKET, CLOSED};
+    enum MsgType {NONE, AUDIO, AUDIO_TIME, END_OF_FILE, LOOP_END, ERROR, FRAME, 
+            VDPAU_FRAME, SEEK_DONE, PACKET, CLOSED};
     AudioMsg();
     void setAudio(AudioBufferPtr pAudioBuffer, float audioTime);
     void setAudioTime(float audioTime);
     void setEOF();
+    void setLoopEnd();
     void setError(const Exception& ex);
     void setSeekDone(int seqNum, float seekTime);
     void setClosed();
@@ -21,10 +21,13 @@
 
 #include "AudioSource.h"
 #include "AudioEngine.h"
+#include "AudioMixer.h"
 
 #include <string>
 #include <algorithm>
 
+#define VOLUME_FADE_FRAMES 100
+
 using namespace std;
 
 namespace avg {
@@ -67,7 +70,7 @@ void AudioSource::setVolume(float volume)
     m_Volume = volume;
 }
 
-void AudioSource::fillAudioBuffer(AudioBufferPtr pBuffer)
+int AudioSource::fillAudioBuffer(AudioBufferPtr pBuffer)
 {
     bool bContinue = true;
     while (bContinue && m_bSeeking) {
@@ -105,12 +108,24 @@ void AudioSource::fillAudioBuffer(AudioBufferPtr pBuffer)
                 }
             }
         }
-        pBuffer->volumize(m_LastVolume, m_Volume);
-        m_LastVolume = m_Volume;
-
         AudioMsgPtr pStatusMsg(new AudioMsg);
         pStatusMsg->setAudioTime(m_LastTime);
         m_StatusQ.push(pStatusMsg);
+        return (pDest-(unsigned char *)(pBuffer->getData()))/pBuffer->getFrameSize();
+    } else {
+        return 0;
+    }
+}
+
+void AudioSource::mixAudio(float* pDest, AudioBufferPtr pTempBuffer, float masterVolume)
+{
+    int numFrames = fillAudioBuffer(pTempBuffer);
+    if (numFrames > 0) {
+        float gain = masterVolume/32768.f;
+        addToMixBuffer(pDest, pTempBuffer->getData(), numFrames,
+                pTempBuffer->getNumChannels(), m_LastVolume*gain, m_Volume*gain,
+                VOLUME_FADE_FRAMES);
+        m_LastVolume = m_Volume;
     }
 }
     
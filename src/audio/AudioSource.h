@@ -42,7 +42,8 @@ public:
     void notifySeek();
     void setVolume(float volume);
 
-    void fillAudioBuffer(AudioBufferPtr pBuffer);
+    int fillAudioBuffer(AudioBufferPtr pBuffer);
+    void mixAudio(float* pDest, AudioBufferPtr pTempBuffer, float masterVolume);
 
 private:
     bool processNextMsg(bool bWait);
@@ -47,6 +47,7 @@ class AVG_API Dynamics: public IProcessor<T>
         Dynamics(T fs);
         virtual ~Dynamics();
         virtual void process(T* pSamples);
+        virtual void process(T* pSamples, int numFrames);
 
         void setThreshold(T threshold);
         T getThreshold() const;
@@ -62,6 +63,7 @@ class AVG_API Dynamics: public IProcessor<T>
         T getMakeupGain() const;
 
     private:
+        inline void processFrame(T* pSamples);
         void maxFilter(T& rms);
 
         T m_fs;
@@ -181,7 +183,20 @@ void Dynamics<T, CHANNELS>::maxFilter(T& rms)
 template<typename T, int CHANNELS>
 void Dynamics<T, CHANNELS>::process(T* pSamples)
 {
+    processFrame(pSamples);
+}
+
+template<typename T, int CHANNELS>
+void Dynamics<T, CHANNELS>::process(T* pSamples, int numFrames)
+{
+    for (int i = 0; i < numFrames; ++i) {
+        processFrame(pSamples+i*CHANNELS);
+    }
+}
 
+template<typename T, int CHANNELS>
+void Dynamics<T, CHANNELS>::processFrame(T* pSamples)
+{
     //---------------- Preprocessing
     T x = 0.f;
     for (int i = 0; i < CHANNELS; i++) {
@@ -205,10 +220,17 @@ void Dynamics<T, CHANNELS>::process(T* pSamples)
     }
 
     //---------------- Ratio
-    T dbMax  = std::log10(lookaheadBuf_[lookaheadBufIdx_]);
-    T dbComp = dbMax * inverseRatio_;
-    T comp   = std::pow(static_cast<T>(10.), dbComp);
-    T c      = comp / lookaheadBuf_[lookaheadBufIdx_];
+    T peak = lookaheadBuf_[lookaheadBufIdx_];
+    T c;
+    if (peak == 1.) {
+        // Nothing to compress in the lookahead window: the gain is exactly 1.
+        c = 1.;
+    } else {
+        T dbMax  = std::log10(peak);
+        T dbComp = dbMax * inverseRatio_;
+        T comp   = std::pow(static_cast<T>(10.), dbComp);
+        c        = comp / peak;
+    }
 
     lookaheadBuf_[lookaheadBufIdx_] = 1.;
     lookaheadBufIdx_ = (lookaheadBufIdx_+1)%LOOKAHEAD;
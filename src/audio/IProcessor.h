@@ -30,6 +30,8 @@ class AVG_API IProcessor
 public:
     virtual ~IProcessor() {};
     virtual void process(T* pSamples) = 0;
+    // Processes numFrames interleaved frames in one call.
+    virtual void process(T* pSamples, int numFrames) = 0;
 
 };
 
@@ -0,0 +1,184 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "Dynamics.h"
+#include "AudioMixer.h"
+
+#include "../base/TimeSource.h"
+
+#include <iostream>
+#include <limits>
+#include <stdlib.h>
+
+using namespace avg;
+using namespace std;
+
+// One SDL callback buffer mixed from 16 stereo sources.
+const int NUM_SOURCES = 16;
+const int CHANNELS = 2;
+const int NUM_FRAMES = 1024;
+const int NUM_SAMPLES = NUM_FRAMES*CHANNELS;
+
+template<class TEST>
+void runPerformanceTest(int numRuns=2000)
+{
+    TEST PerfTest;
+    long long StartTime = TimeSource::get()->getCurrentMicrosecs();
+    for (int i = 0; i < numRuns; ++i) {
+        PerfTest.run();
+    }
+    float ActiveTime = (TimeSource::get()->getCurrentMicrosecs()-StartTime)/1000.f;
+    cerr << PerfTest.getName() << ": " << ActiveTime*1000/numRuns << " us" << endl;
+}
+
+class PerfTestBase {
+public:
+    PerfTestBase(string sName) 
+        : m_sName(sName)
+    {
+        for (int i = 0; i < NUM_SOURCES; ++i) {
+            for (int j = 0; j < NUM_SAMPLES; ++j) {
+                m_Sources[i][j] = short(rand()%65536-32768);
+            }
+        }
+    }
+
+    std::string getName()
+    {
+        return m_sName;
+    }
+
+protected:
+    short m_Sources[NUM_SOURCES][NUM_SAMPLES];
+    float m_MixBuffer[NUM_SAMPLES];
+    short m_DestBuffer[NUM_SAMPLES];
+
+private:
+    std::string m_sName;
+};
+
+// The per-sample loops the mix bus used before the kernels in AudioMixer.
+class ScalarMixPerfTest: public PerfTestBase {
+public:
+    ScalarMixPerfTest()
+        : PerfTestBase("ScalarMixPerfTest")
+    {
+    }
+
+    void run()
+    {
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            m_MixBuffer[i] = 0;
+        }
+        for (int i = 0; i < NUM_SOURCES; ++i) {
+            float vol = 0.5f;
+            for (int j = 0; j < NUM_SAMPLES; ++j) {
+                int s = int(m_Sources[i][j]*vol);
+                m_MixBuffer[j] += short(s)/32768.0f;
+            }
+        }
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            m_MixBuffer[i] *= 0.1f;
+        }
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            m_DestBuffer[i] = short(m_MixBuffer[i]*32768);
+        }
+    }
+};
+
+class MixPerfTest: public PerfTestBase {
+public:
+    MixPerfTest()
+        : PerfTestBase("MixPerfTest")
+    {
+    }
+
+    void run()
+    {
+        clearMixBuffer(m_MixBuffer, NUM_SAMPLES);
+        for (int i = 0; i < NUM_SOURCES; ++i) {
+            float gain = 0.5f*0.1f/32768.f;
+            addToMixBuffer(m_MixBuffer, m_Sources[i], NUM_FRAMES, CHANNELS, gain, gain,
+                    100);
+        }
+        mixBufferToShort(m_DestBuffer, m_MixBuffer, NUM_SAMPLES);
+    }
+};
+
+class LimiterPerfTestBase: public PerfTestBase {
+public:
+    LimiterPerfTestBase(string sName)
+        : PerfTestBase(sName)
+    {
+        Dynamics<float, CHANNELS>* pLimiter = new Dynamics<float, CHANNELS>(44100.f);
+        pLimiter->setRatio(std::numeric_limits<float>::infinity());
+        m_pLimiter = pLimiter;
+        // Some overshoot so the limiter actually has to compress.
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            m_MixBuffer[i] = m_Sources[0][i]/16384.f;
+        }
+    }
+
+    virtual ~LimiterPerfTestBase()
+    {
+        delete m_pLimiter;
+    }
+
+protected:
+    IProcessor<float>* m_pLimiter;
+};
+
+class LimiterFramePerfTest: public LimiterPerfTestBase {
+public:
+    LimiterFramePerfTest()
+        : LimiterPerfTestBase("LimiterFramePerfTest")
+    {
+    }
+
+    void run()
+    {
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            m_pLimiter->process(m_MixBuffer+i*CHANNELS);
+        }
+    }
+};
+
+class LimiterBlockPerfTest: public LimiterPerfTestBase {
+public:
+    LimiterBlockPerfTest()
+        : LimiterPerfTestBase("LimiterBlockPerfTest")
+    {
+    }
+
+    void run()
+    {
+        m_pLimiter->process(m_MixBuffer, NUM_FRAMES);
+    }
+};
+
+int main(int nargs, char** args)
+{
+    runPerformanceTest<ScalarMixPerfTest>();
+    runPerformanceTest<MixPerfTest>();
+    runPerformanceTest<LimiterFramePerfTest>(200);
+    runPerformanceTest<LimiterBlockPerfTest>(200);
+}
@@ -20,6 +20,7 @@
 //
 
 #include "Dynamics.h"
+#include "AudioMixer.h"
 
 #include "../base/TestSuite.h"
 #include "../base/MathHelper.h"
@@ -95,14 +96,150 @@ public:
         // Free memory
         delete d;
         delete[] pSamples;
+
+        testBlockProcessing();
+    }
+
+private:
+    void testBlockProcessing()
+    {
+        // Processing a block must give the same result as processing single frames.
+        const int CHANNELS = 6;
+        float fs = 44100.f;
+        int numFrames = 1000;
+        Dynamics<float, CHANNELS> frameLimiter(fs);
+        Dynamics<float, CHANNELS> blockLimiter(fs);
+        float* pFrameSamples = new float[CHANNELS*numFrames];
+        float* pBlockSamples = new float[CHANNELS*numFrames];
+        for (int j = 0; j < numFrames; j++) {
+            for (int i = 0; i < CHANNELS; i++) {
+                pFrameSamples[j*CHANNELS+i] = (i+1)*sin(j*(440.f/44100)*float(M_PI));
+                pBlockSamples[j*CHANNELS+i] = pFrameSamples[j*CHANNELS+i];
+            }
+        }
+        for (int j = 0; j < numFrames; j++) {
+            frameLimiter.process(pFrameSamples+j*CHANNELS);
+        }
+        blockLimiter.process(pBlockSamples, numFrames/2);
+        blockLimiter.process(pBlockSamples+CHANNELS*(numFrames/2), numFrames/2);
+        bool bEqual = true;
+        for (int i = 0; i < CHANNELS*numFrames; i++) {
+            if (pFrameSamples[i] != pBlockSamples[i]) {
+                bEqual = false;
+            }
+        }
+        TEST(bEqual);
+        delete[] pFrameSamples;
+        delete[] pBlockSamples;
+    }
+};
+
+class MixerTest: public Test {
+public:
+    MixerTest()
+        : Test("MixerTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        // Odd sizes so both the vectorized and the scalar parts of the kernels run.
+        const int CHANNELS = 3;
+        const int NUM_FRAMES = 37;
+        const int NUM_SAMPLES = CHANNELS*NUM_FRAMES;
+        short src[NUM_SAMPLES];
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            src[i] = short((i*2731)%65536-32768);
+        }
+
+        float mix[NUM_SAMPLES];
+        clearMixBuffer(mix, NUM_SAMPLES);
+        addToMixBuffer(mix, src, NUM_FRAMES, CHANNELS, 0.5f, 0.5f, 10);
+        addToMixBuffer(mix, src, NUM_FRAMES, CHANNELS, 0.f, 0.25f, 0);
+        bool bOK = true;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            if (!almostEqual(mix[i], src[i]*0.75f, 0.01f)) {
+                bOK = false;
+            }
+        }
+        TEST(bOK);
+
+        // Volume ramp: rises monotonically per frame, all channels of a frame get
+        // the same gain, and the target gain is reached after the ramp.
+        clearMixBuffer(mix, NUM_SAMPLES);
+        short ones[NUM_SAMPLES];
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            ones[i] = 1000;
+        }
+        addToMixBuffer(mix, ones, NUM_FRAMES, CHANNELS, 0.f, 1.f, 20);
+        bOK = true;
+        for (int j = 0; j < NUM_FRAMES; j++) {
+            for (int i = 1; i < CHANNELS; i++) {
+                if (mix[j*CHANNELS+i] != mix[j*CHANNELS]) {
+                    bOK = false;
+                }
+            }
+            if (j > 0 && mix[j*CHANNELS] < mix[(j-1)*CHANNELS]) {
+                bOK = false;
+            }
+        }
+        TEST(bOK);
+        TEST(mix[0] > 0.f && mix[0] < 100.f);
+        TEST(mix[20*CHANNELS] == 1000.f);
+
+        // Conversion to 16 bit clips at full scale.
+        float floats[NUM_SAMPLES];
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            floats[i] = (i-NUM_SAMPLES/2)/float(NUM_SAMPLES/8);
+        }
+        short dest[NUM_SAMPLES];
+        mixBufferToShort(dest, floats, NUM_SAMPLES);
+        bOK = true;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            float expected = floats[i]*32768.f;
+            if (expected > 32767.f) {
+                expected = 32767.f;
+            } else if (expected < -32768.f) {
+                expected = -32768.f;
+            }
+            if (fabs(dest[i]-expected) > 1.f) {
+                bOK = false;
+            }
+        }
+        TEST(bOK);
+
+        // Ties round to even in the vectorized and in the scalar part alike.
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            floats[i] = (i-NUM_SAMPLES/2+0.5f)/32768.f;
+        }
+        mixBufferToShort(dest, floats, NUM_SAMPLES);
+        bOK = true;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            int lower = i-NUM_SAMPLES/2;
+            int expected = (lower%2 == 0) ? lower : lower+1;
+            if (dest[i] != expected) {
+                bOK = false;
+            }
+        }
+        TEST(bOK);
+    }
+};
+
+class AudioTestSuite: public TestSuite {
+public:
+    AudioTestSuite()
+        : TestSuite("AudioTestSuite")
+    {
+        addTest(TestPtr(new LimiterTest));
+        addTest(TestPtr(new MixerTest));
     }
 };
 
 int main(int nargs, char** args)
 {
-    LimiterTest test;
-    test.runTests();
-    bool bOK = test.isOk();
+    AudioTestSuite suite;
+    suite.runTests();
+    bool bOK = suite.isOk();
 
     if (bOK) {
         return 0;
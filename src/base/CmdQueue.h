@@ -33,15 +33,15 @@ template<class RECEIVER>
 class AVG_TEMPLATE_API CmdQueue: public Queue<Command<RECEIVER> >
 {
 public:
-    CmdQueue(int maxSize=-1);
+    CmdQueue(int maxSize=-1, bool bLockFree=false);
     typedef typename Queue<Command<RECEIVER> >::QElementPtr CmdPtr;
     void pushCmd(typename Command<RECEIVER>::CmdFunc func);
     
 };
 
 template<class RECEIVER>
-CmdQueue<RECEIVER>::CmdQueue(int maxSize)
-    : Queue<Command<RECEIVER> >(maxSize)
+CmdQueue<RECEIVER>::CmdQueue(int maxSize, bool bLockFree)
+    : Queue<Command<RECEIVER> >(maxSize, bLockFree)
 {
 }
 
@@ -79,12 +79,17 @@ ConfigMgr::ConfigMgr()
     addOption("scr", "gamma", "-1,-1,-1");
     addOption("scr", "vsyncmode", "auto");
     addOption("scr", "videoaccel", "true");
+    addOption("scr", "batchrendering", "false");
     
     addSubsys("aud");
     addOption("aud", "channels", "2");
     addOption("aud", "samplerate", "44100");
     addOption("aud", "outputbuffersamples", "1024");
 
+    addSubsys("cpu");
+    addOption("cpu", "numthreads", "-1");
+    addOption("cpu", "numdecoderthreads", "-1");
+
     addSubsys("gesture");
     addOption("gesture", "maxtapdist", "15");
     addOption("gesture", "maxdoubletaptime", "300");
@@ -0,0 +1,91 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "EventCount.h"
+
+#ifdef linux
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+namespace avg {
+
+EventCount::EventCount()
+    : m_Epoch(0),
+      m_NumWaiters(0)
+{
+}
+
+EventCount::~EventCount()
+{
+}
+
+int EventCount::prepareWait()
+{
+    m_NumWaiters.fetch_add(1, boost::memory_order_seq_cst);
+    return m_Epoch.load(boost::memory_order_seq_cst);
+}
+
+void EventCount::cancelWait()
+{
+    m_NumWaiters.fetch_sub(1, boost::memory_order_seq_cst);
+}
+
+void EventCount::wait(int key)
+{
+#ifdef linux
+    while (m_Epoch.load(boost::memory_order_acquire) == key) {
+        // Returns immediately if the epoch has changed in the meantime.
+        syscall(SYS_futex, (int*)&m_Epoch, FUTEX_WAIT_PRIVATE, key, 0, 0, 0);
+    }
+#else
+    {
+        boost::unique_lock<boost::mutex> lock(m_Mutex);
+        while (m_Epoch.load(boost::memory_order_acquire) == key) {
+            m_Cond.wait(lock);
+        }
+    }
+#endif
+    m_NumWaiters.fetch_sub(1, boost::memory_order_seq_cst);
+}
+
+void EventCount::notify()
+{
+    // The fence orders the caller's state change before the check for waiters, so a
+    // thread that is between prepareWait() and wait() can't miss the notification.
+    boost::atomic_thread_fence(boost::memory_order_seq_cst);
+    if (m_NumWaiters.load(boost::memory_order_relaxed) == 0) {
+        return;
+    }
+#ifdef linux
+    m_Epoch.fetch_add(1, boost::memory_order_release);
+    syscall(SYS_futex, (int*)&m_Epoch, FUTEX_WAKE_PRIVATE, INT_MAX, 0, 0, 0);
+#else
+    boost::unique_lock<boost::mutex> lock(m_Mutex);
+    m_Epoch.fetch_add(1, boost::memory_order_release);
+    m_Cond.notify_all();
+#endif
+}
+
+}
@@ -0,0 +1,68 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _EventCount_H_
+#define _EventCount_H_
+
+#include "../api.h"
+
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+namespace avg {
+
+// Lets a thread sleep until another thread signals a change without both threads
+// sharing a lock in the common case. Waiting is a two-step process:
+//
+//     int key = event.prepareWait();
+//     if (conditionIsTrue()) {
+//         event.cancelWait();
+//     } else {
+//         event.wait(key);
+//     }
+//
+// notify() only enters the kernel if there is a thread waiting. On linux, waits are
+// implemented using futexes; on other platforms, a mutex and condition are used.
+class AVG_API EventCount
+{
+public:
+    EventCount();
+    virtual ~EventCount();
+
+    int prepareWait();
+    void cancelWait();
+    void wait(int key);
+    void notify();
+
+private:
+    boost::atomic<int> m_Epoch;
+    boost::atomic<int> m_NumWaiters;
+#ifndef linux
+    boost::mutex m_Mutex;
+    boost::condition m_Cond;
+#endif
+};
+
+}
+
+#endif
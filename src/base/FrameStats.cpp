@@ -0,0 +1,195 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "FrameStats.h"
+
+#include "Exception.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+
+using namespace std;
+
+namespace avg {
+
+FrameStageStats::FrameStageStats()
+    : m_P50(0),
+      m_P95(0),
+      m_P99(0),
+      m_Max(0)
+{
+}
+
+FrameStatsSummary::FrameStatsSummary()
+    : m_NumFrames(0),
+      m_NumLateFrames(0)
+{
+}
+
+FrameStats::Record::Record()
+    : m_FrameTime(0),
+      m_bLate(false)
+{
+    for (int i=0; i<NUM_STAGES; ++i) {
+        m_Durations[i] = 0;
+    }
+}
+
+FrameStats::FrameStats(unsigned maxFrames)
+    : m_Records(maxFrames),
+      m_FirstFrame(0),
+      m_NumFrames(0)
+{
+    AVG_ASSERT(maxFrames > 0);
+    m_SortBuffer.reserve(maxFrames);
+}
+
+FrameStats::~FrameStats()
+{
+}
+
+void FrameStats::addFrame(const Record& record)
+{
+    unsigned maxFrames = m_Records.size();
+    if (m_NumFrames < maxFrames) {
+        m_Records[(m_FirstFrame+m_NumFrames) % maxFrames] = record;
+        m_NumFrames++;
+    } else {
+        m_Records[m_FirstFrame] = record;
+        m_FirstFrame = (m_FirstFrame+1) % maxFrames;
+    }
+}
+
+void FrameStats::clear()
+{
+    m_FirstFrame = 0;
+    m_NumFrames = 0;
+}
+
+unsigned FrameStats::getNumFrames() const
+{
+    return m_NumFrames;
+}
+
+unsigned FrameStats::getMaxFrames() const
+{
+    return m_Records.size();
+}
+
+const FrameStats::Record& FrameStats::getFrame(unsigned i) const
+{
+    AVG_ASSERT(i < m_NumFrames);
+    return m_Records[(m_FirstFrame+i) % m_Records.size()];
+}
+
+FrameStatsSummary FrameStats::getSummary() const
+{
+    FrameStatsSummary summary;
+    summary.m_NumFrames = m_NumFrames;
+    for (unsigned i=0; i<m_NumFrames; ++i) {
+        if (getFrame(i).m_bLate) {
+            summary.m_NumLateFrames++;
+        }
+    }
+    calcStageStats(FRAME, summary.m_Frame);
+    calcStageStats(TIMERS, summary.m_Timers);
+    calcStageStats(EVENTS, summary.m_Events);
+    calcStageStats(OFFSCREEN, summary.m_Offscreen);
+    calcStageStats(RENDER, summary.m_Render);
+    calcStageStats(WAIT, summary.m_Wait);
+    calcStageStats(SWAP, summary.m_Swap);
+    return summary;
+}
+
+void FrameStats::dumpCSV(const string& sFilename) const
+{
+    ofstream file(sFilename.c_str());
+    if (!file) {
+        throw Exception(AVG_ERR_FILEIO, "Could not open '" + sFilename + 
+                "' for writing.");
+    }
+    file << "frametime";
+    for (int i=0; i<NUM_STAGES; ++i) {
+        file << "," << getStageName(Stage(i));
+    }
+    file << ",late" << endl;
+    file << fixed << setprecision(3);
+    for (unsigned i=0; i<m_NumFrames; ++i) {
+        const Record& record = getFrame(i);
+        file << record.m_FrameTime;
+        for (int j=0; j<NUM_STAGES; ++j) {
+            file << "," << record.m_Durations[j]/1000.0;
+        }
+        file << "," << int(record.m_bLate) << "\n";
+    }
+}
+
+const char* FrameStats::getStageName(Stage stage)
+{
+    switch (stage) {
+        case FRAME:
+            return "frame";
+        case TIMERS:
+            return "timers";
+        case EVENTS:
+            return "events";
+        case OFFSCREEN:
+            return "offscreen";
+        case RENDER:
+            return "render";
+        case WAIT:
+            return "wait";
+        case SWAP:
+            return "swap";
+        default:
+            AVG_ASSERT(false);
+            return 0;
+    }
+}
+
+void FrameStats::calcStageStats(Stage stage, FrameStageStats& stats) const
+{
+    if (m_NumFrames == 0) {
+        return;
+    }
+    m_SortBuffer.clear();
+    for (unsigned i=0; i<m_NumFrames; ++i) {
+        m_SortBuffer.push_back(getFrame(i).m_Durations[stage]);
+    }
+    // Nearest-rank percentiles. nth_element leaves everything above the rank in
+    // the upper part of the buffer, so the percentiles are found in ascending order.
+    float percentiles[] = {0.5f, 0.95f, 0.99f};
+    float* pResults[] = {&stats.m_P50, &stats.m_P95, &stats.m_P99};
+    vector<long long>::iterator begin = m_SortBuffer.begin();
+    for (int i=0; i<3; ++i) {
+        int rank = int(ceil(percentiles[i]*m_NumFrames))-1;
+        vector<long long>::iterator it = m_SortBuffer.begin()+max(rank, 0);
+        nth_element(begin, it, m_SortBuffer.end());
+        *(pResults[i]) = *it/1000.f;
+        begin = it;
+    }
+    stats.m_Max = *max_element(begin, m_SortBuffer.end())/1000.f;
+}
+
+}
@@ -0,0 +1,100 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _FrameStats_H_
+#define _FrameStats_H_
+
+#include "../api.h"
+
+#include <string>
+#include <vector>
+
+namespace avg {
+
+// Distribution of one frame stage over the frames in the window, in milliseconds.
+struct AVG_API FrameStageStats
+{
+    FrameStageStats();
+
+    float m_P50;
+    float m_P95;
+    float m_P99;
+    float m_Max;
+};
+
+struct AVG_API FrameStatsSummary
+{
+    FrameStatsSummary();
+
+    int m_NumFrames;
+    int m_NumLateFrames;
+    FrameStageStats m_Frame;
+    FrameStageStats m_Timers;
+    FrameStageStats m_Events;
+    FrameStageStats m_Offscreen;
+    FrameStageStats m_Render;
+    FrameStageStats m_Wait;
+    FrameStageStats m_Swap;
+};
+
+// Keeps timing records of the last maxFrames frames in a ring buffer. Adding a frame
+// never allocates, so this can stay enabled permanently.
+class AVG_API FrameStats
+{
+public:
+    enum Stage {FRAME, TIMERS, EVENTS, OFFSCREEN, RENDER, WAIT, SWAP, NUM_STAGES};
+
+    struct AVG_API Record
+    {
+        Record();
+
+        long long m_FrameTime;                // Player frame time in milliseconds.
+        long long m_Durations[NUM_STAGES];    // Microseconds.
+        bool m_bLate;
+    };
+
+    FrameStats(unsigned maxFrames);
+    virtual ~FrameStats();
+
+    void addFrame(const Record& record);
+    void clear();
+    unsigned getNumFrames() const;
+    unsigned getMaxFrames() const;
+    const Record& getFrame(unsigned i) const;
+
+    FrameStatsSummary getSummary() const;
+    void dumpCSV(const std::string& sFilename) const;
+
+    static const char* getStageName(Stage stage);
+
+private:
+    void calcStageStats(Stage stage, FrameStageStats& stats) const;
+
+    std::vector<Record> m_Records;
+    unsigned m_FirstFrame;
+    unsigned m_NumFrames;
+    mutable std::vector<long long> m_SortBuffer;
+};
+
+}
+
+#endif
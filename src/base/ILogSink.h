@@ -38,6 +38,8 @@ namespace avg{
 typedef unsigned severity_t;
 typedef UTF8String category_t;
 
+// logMessage() is called without holding a lock, possibly from several threads at 
+// the same time, so implementations need to be thread-safe.
 class AVG_API ILogSink
 {
 public:
@@ -23,8 +23,10 @@
 #include "Exception.h"
 #include "StandardLogSink.h"
 #include "OSHelper.h"
+#include "EventCount.h"
 
 #include <boost/algorithm/string.hpp>
+#include <boost/thread/thread.hpp>
 
 #ifdef _WIN32
 #include <Winsock2.h>
@@ -37,6 +39,7 @@
 #endif
 #include <iostream>
 #include <iomanip>
+#include <cstdlib>
 
 using namespace std;
 namespace ba = boost::algorithm;
@@ -62,26 +65,183 @@ namespace avg {
     const category_t Logger::category::DEPRECATION = UTF8String("DEPREC");
 
 namespace {
-    Logger* s_pLogger = 0;
+    boost::atomic<Logger*> s_pLogger(0);
     boost::mutex s_logMutex;
-    boost::mutex s_traceMutex;
     boost::mutex s_sinkMutex;
     boost::mutex s_removeStdSinkMutex;
+    boost::mutex s_asyncMutex;
+
+    struct LogTimeStamp {
+#ifdef _WIN32
+        __int64 m_Seconds;
+#else
+        time_t m_Seconds;
+#endif
+        unsigned m_Millis;
+    };
+
+    LogTimeStamp getTimeStamp()
+    {
+        LogTimeStamp stamp;
+#ifdef _WIN32
+        _time64(&stamp.m_Seconds);
+        stamp.m_Millis = unsigned(timeGetTime() % 1000);
+#else
+        struct timeval time;
+        gettimeofday(&time, NULL);
+        stamp.m_Seconds = time.tv_sec;
+        stamp.m_Millis = time.tv_usec/1000;
+#endif
+        return stamp;
+    }
+
+    void getLocalTime(const LogTimeStamp& stamp, tm* pTime)
+    {
+#ifdef _WIN32
+        _localtime64_s(pTime, &stamp.m_Seconds);
+#else
+        localtime_r(&stamp.m_Seconds, pTime);
+#endif
+    }
+
+    // Bounded multi-producer, single-consumer ring buffer of log records (after
+    // D. Vyukov's bounded MPMC queue). Each cell carries a sequence number that tells
+    // producers and the consumer whose turn it is, so neither side ever waits for the
+    // other. The strings in a cell keep their capacity, which means that once the
+    // buffer is warmed up, pushing a record normally doesn't allocate.
+    struct LogRecord {
+        boost::atomic<unsigned> m_Seq;
+        LogTimeStamp m_TimeStamp;
+        category_t m_Category;
+        severity_t m_Severity;
+        UTF8String m_sMsg;
+    };
+
+    class LogRecordBuffer {
+    public:
+        LogRecordBuffer(unsigned size)
+            : m_Mask(size-1),
+              m_PushPos(0),
+              m_PopPos(0)
+        {
+            AVG_ASSERT((size & m_Mask) == 0);
+            m_pRecords = new LogRecord[size];
+            for (unsigned i=0; i<size; ++i) {
+                m_pRecords[i].m_Seq.store(i, boost::memory_order_relaxed);
+            }
+        }
+
+        bool push(const LogTimeStamp& timeStamp, const category_t& category,
+                severity_t severity, const UTF8String& sMsg)
+        {
+            unsigned pos = m_PushPos.load(boost::memory_order_relaxed);
+            LogRecord* pRecord;
+            while (true) {
+                pRecord = &m_pRecords[pos & m_Mask];
+                unsigned seq = pRecord->m_Seq.load(boost::memory_order_acquire);
+                int diff = int(seq - pos);
+                if (diff == 0) {
+                    if (m_PushPos.compare_exchange_weak(pos, pos+1,
+                            boost::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_PushPos.load(boost::memory_order_relaxed);
+                }
+            }
+            pRecord->m_TimeStamp = timeStamp;
+            pRecord->m_Category = category;
+            pRecord->m_Severity = severity;
+            pRecord->m_sMsg = sMsg;
+            pRecord->m_Seq.store(pos+1, boost::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. The record returned stays valid until pop() is called.
+        LogRecord* front()
+        {
+            unsigned pos = m_PopPos.load(boost::memory_order_relaxed);
+            LogRecord* pRecord = &m_pRecords[pos & m_Mask];
+            if (pRecord->m_Seq.load(boost::memory_order_acquire) == pos+1) {
+                return pRecord;
+            } else {
+                return 0;
+            }
+        }
+
+        void pop()
+        {
+            unsigned pos = m_PopPos.load(boost::memory_order_relaxed);
+            m_pRecords[pos & m_Mask].m_Seq.store(pos+m_Mask+1,
+                    boost::memory_order_release);
+            m_PopPos.store(pos+1, boost::memory_order_release);
+        }
+
+        unsigned getPushPos() const
+        {
+            return m_PushPos.load(boost::memory_order_acquire);
+        }
+
+        unsigned getPopPos() const
+        {
+            return m_PopPos.load(boost::memory_order_acquire);
+        }
+
+    private:
+        LogRecord* m_pRecords;
+        unsigned m_Mask;
+        boost::atomic<unsigned> m_PushPos;
+        boost::atomic<unsigned> m_PopPos;
+    };
+
+    const unsigned LOG_BUFFER_SIZE = 4096;
+
+    // The buffer is created on first use and never deleted, so producers that race
+    // with setAsync(false) never touch freed memory.
+    LogRecordBuffer* s_pRecordBuffer = 0;
+    boost::atomic<bool> s_bAsync(false);
+    boost::atomic<bool> s_bStopSinkThread(false);
+    boost::atomic<unsigned> s_NumDroppedRecords(0);
+    // Number of threads currently between checking s_bAsync and pushing a record.
+    boost::atomic<int> s_NumPushingThreads(0);
+    boost::thread* s_pSinkThread = 0;
+    bool s_bAtExitRegistered = false;
+    EventCount s_RecordPushedEvent;
+    EventCount s_RecordsDrainedEvent;
+
+    void stopSinkThreadAtExit()
+    {
+        Logger::get()->setAsync(false);
+    }
 }
 
 boost::mutex Logger::m_CategoryMutex;
 
 Logger * Logger::get()
 {
-    lock_guard lock(s_logMutex);
-    if (!s_pLogger) {
-        s_pLogger = new Logger;
+    Logger* pLogger = s_pLogger.load(boost::memory_order_acquire);
+    if (!pLogger) {
+        lock_guard lock(s_logMutex);
+        pLogger = s_pLogger.load(boost::memory_order_relaxed);
+        if (!pLogger) {
+            pLogger = new Logger;
+            s_pLogger.store(pLogger, boost::memory_order_release);
+        }
     }
-    return s_pLogger;
+    return pLogger;
 }
 
 Logger::Logger()
+    : m_NumCategories(0),
+      m_pSinks(new vector<LogSinkPtr>())
 {
+    for (unsigned i=0; i<NUM_CATEGORY_SLOTS; ++i) {
+        m_CategorySlots[i].m_pCategory.store(0, boost::memory_order_relaxed);
+        m_CategorySlots[i].m_Severity.store(severity::NONE, boost::memory_order_relaxed);
+    }
     m_Severity = severity::WARNING;
     string sEnvSeverity;
     bool bEnvSeveritySet = getEnv("AVG_LOG_SEVERITY", sEnvSeverity);
@@ -119,26 +279,37 @@ Logger::Logger()
         m_pStdSink = LogSinkPtr(new StandardLogSink);
         addLogSink(m_pStdSink);
     }
+
+    if (getEnv("AVG_LOG_ASYNC", sDummy)) {
+        setAsync(true);
+    }
 }
 
 Logger::~Logger()
 {
+    for (unsigned i=0; i<NUM_CATEGORY_SLOTS; ++i) {
+        delete m_CategorySlots[i].m_pCategory.load(boost::memory_order_relaxed);
+    }
 }
 
 void Logger::addLogSink(const LogSinkPtr& logSink)
 {
     lock_guard lock(s_sinkMutex);
-    m_pSinks.push_back(logSink);
+    vector<LogSinkPtr>* pSinks = new vector<LogSinkPtr>(*m_pSinks);
+    pSinks->push_back(logSink);
+    m_pSinks = LogSinkListPtr(pSinks);
 }
 
 void Logger::removeLogSink(const LogSinkPtr& logSink)
 {
     lock_guard lock(s_sinkMutex);
+    vector<LogSinkPtr>* pSinks = new vector<LogSinkPtr>(*m_pSinks);
     std::vector<LogSinkPtr>::iterator it;
-    it = find(m_pSinks.begin(), m_pSinks.end(), logSink);
-    if ( it != m_pSinks.end() ) {
-        m_pSinks.erase(it);
+    it = find(pSinks->begin(), pSinks->end(), logSink);
+    if ( it != pSinks->end() ) {
+        pSinks->erase(it);
     }
+    m_pSinks = LogSinkListPtr(pSinks);
 }
 
 void Logger::removeStdLogSink()
@@ -162,38 +333,192 @@ category_t Logger::configureCategory(category_t category, severity_t severity)
     }
     pair<const category_t, const severity_t> element(sCategory, severity);
     m_CategorySeverities.insert(element);
+
+    unsigned mask = NUM_CATEGORY_SLOTS-1;
+    unsigned i = unsigned(boost::hash<string>()(sCategory)) & mask;
+    while (true) {
+        CategorySlot& slot = m_CategorySlots[i];
+        const category_t* pSlotCategory = slot.m_pCategory.load(
+                boost::memory_order_relaxed);
+        if (!pSlotCategory) {
+            // Keep at least half of the table empty so lookups stay short.
+            if (m_NumCategories >= NUM_CATEGORY_SLOTS/2) {
+                m_CategorySeverities.erase(sCategory);
+                throw Exception(AVG_ERR_OUT_OF_RANGE,
+                        "Too many log categories: " + sCategory);
+            }
+            slot.m_Severity.store(severity, boost::memory_order_relaxed);
+            slot.m_pCategory.store(new category_t(sCategory),
+                    boost::memory_order_release);
+            m_NumCategories++;
+            break;
+        } else if (*pSlotCategory == sCategory) {
+            slot.m_Severity.store(severity, boost::memory_order_relaxed);
+            break;
+        }
+        i = (i+1) & mask;
+    }
     return sCategory;
 }
 
 CatToSeverityMap Logger::getCategories()
 {
+    lock_guard lock(m_CategoryMutex);
     return m_CategorySeverities;
 }
 
+severity_t Logger::getCategorySeverity(const category_t& category) const
+{
+    unsigned mask = NUM_CATEGORY_SLOTS-1;
+    unsigned i = unsigned(boost::hash<string>()(category)) & mask;
+    while (true) {
+        const CategorySlot& slot = m_CategorySlots[i];
+        const category_t* pSlotCategory = slot.m_pCategory.load(
+                boost::memory_order_acquire);
+        if (!pSlotCategory) {
+            string msg("Unknown category: " + category);
+            throw Exception(AVG_ERR_INVALID_ARGS, msg);
+        }
+        if (*pSlotCategory == category) {
+            return slot.m_Severity.load(boost::memory_order_relaxed);
+        }
+        i = (i+1) & mask;
+    }
+}
+
 void Logger::trace(const UTF8String& sMsg, const category_t& category,
         severity_t severity) const
 {
-    lock_guard lock(s_traceMutex);
-    struct tm* pTime;
-    #ifdef _WIN32
-    __int64 now;
-    _time64(&now);
-    pTime = _localtime64(&now);
-    DWORD tms = timeGetTime();
-    unsigned millis = unsigned(tms % 1000);
-    #else
-    struct timeval time;
-    gettimeofday(&time, NULL);
-    pTime = localtime(&time.tv_sec);
-    unsigned millis = time.tv_usec/1000;
-    #endif
-    lock_guard lockHandler(s_sinkMutex);
+    LogTimeStamp timeStamp = getTimeStamp();
+    bool bQueued = false;
+    if (s_bAsync.load(boost::memory_order_acquire)) {
+        // Announce the push before checking the flag again, so setAsync(false) can
+        // wait for it to finish before it drains the buffer.
+        s_NumPushingThreads.fetch_add(1, boost::memory_order_seq_cst);
+        if (s_bAsync.load(boost::memory_order_seq_cst)) {
+            if (s_pRecordBuffer->push(timeStamp, category, severity, sMsg)) {
+                s_RecordPushedEvent.notify();
+            } else {
+                s_NumDroppedRecords.fetch_add(1, boost::memory_order_relaxed);
+            }
+            bQueued = true;
+        }
+        s_NumPushingThreads.fetch_sub(1, boost::memory_order_release);
+    }
+    if (!bQueued) {
+        struct tm time;
+        getLocalTime(timeStamp, &time);
+        dispatch(&time, timeStamp.m_Millis, category, severity, sMsg);
+    }
+}
+
+void Logger::setAsync(bool bAsync)
+{
+    lock_guard lock(s_asyncMutex);
+    if (bAsync == s_bAsync.load(boost::memory_order_relaxed)) {
+        return;
+    }
+    if (bAsync) {
+        if (!s_pRecordBuffer) {
+            s_pRecordBuffer = new LogRecordBuffer(LOG_BUFFER_SIZE);
+        }
+        if (!s_bAtExitRegistered) {
+            atexit(stopSinkThreadAtExit);
+            s_bAtExitRegistered = true;
+        }
+        s_bStopSinkThread.store(false, boost::memory_order_relaxed);
+        s_pSinkThread = new boost::thread(&Logger::sinkThreadFunc);
+        s_bAsync.store(true, boost::memory_order_release);
+    } else {
+        s_bAsync.store(false, boost::memory_order_seq_cst);
+        s_bStopSinkThread.store(true, boost::memory_order_release);
+        s_RecordPushedEvent.notify();
+        s_pSinkThread->join();
+        delete s_pSinkThread;
+        s_pSinkThread = 0;
+        // Threads that saw the async flag just before it was cleared may still be
+        // pushing. Once they are done, nothing else enters the buffer and it can be
+        // drained for the last time.
+        while (s_NumPushingThreads.load(boost::memory_order_seq_cst) != 0) {
+            boost::this_thread::yield();
+        }
+        drainRecords();
+    }
+}
+
+bool Logger::isAsync() const
+{
+    return s_bAsync.load(boost::memory_order_acquire);
+}
+
+void Logger::flush()
+{
+    if (!s_bAsync.load(boost::memory_order_acquire)) {
+        return;
+    }
+    unsigned pushPos = s_pRecordBuffer->getPushPos();
+    while (true) {
+        int key = s_RecordsDrainedEvent.prepareWait();
+        if (int(s_pRecordBuffer->getPopPos() - pushPos) >= 0 ||
+                !s_bAsync.load(boost::memory_order_acquire))
+        {
+            s_RecordsDrainedEvent.cancelWait();
+            break;
+        }
+        s_RecordsDrainedEvent.wait(key);
+    }
+}
+
+unsigned Logger::getNumDroppedRecords() const
+{
+    return s_NumDroppedRecords.load(boost::memory_order_relaxed);
+}
+
+void Logger::dispatch(const tm* pTime, unsigned millis, const category_t& category,
+        severity_t severity, const UTF8String& sMsg) const
+{
+    LogSinkListPtr pSinks;
+    {
+        lock_guard lockHandler(s_sinkMutex);
+        pSinks = m_pSinks;
+    }
     std::vector<LogSinkPtr>::const_iterator it;
-    for(it=m_pSinks.begin(); it!=m_pSinks.end(); ++it){
+    for(it=pSinks->begin(); it!=pSinks->end(); ++it){
         (*it)->logMessage(pTime, millis, category, severity, sMsg);
     }
 }
 
+void Logger::drainRecords()
+{
+    LogRecord* pRecord = s_pRecordBuffer->front();
+    while (pRecord) {
+        struct tm time;
+        getLocalTime(pRecord->m_TimeStamp, &time);
+        get()->dispatch(&time, pRecord->m_TimeStamp.m_Millis, pRecord->m_Category,
+                pRecord->m_Severity, pRecord->m_sMsg);
+        s_pRecordBuffer->pop();
+        pRecord = s_pRecordBuffer->front();
+    }
+    s_RecordsDrainedEvent.notify();
+}
+
+void Logger::sinkThreadFunc()
+{
+    setAffinityMask(false);
+    while (true) {
+        int key = s_RecordPushedEvent.prepareWait();
+        if (s_pRecordBuffer->front()) {
+            s_RecordPushedEvent.cancelWait();
+            drainRecords();
+        } else if (s_bStopSinkThread.load(boost::memory_order_acquire)) {
+            s_RecordPushedEvent.cancelWait();
+            break;
+        } else {
+            s_RecordPushedEvent.wait(key);
+        }
+    }
+}
+
 void Logger::logDebug(const UTF8String& msg, const category_t& category) const
 {
     log(msg, category, Logger::severity::DEBUG);
@@ -29,6 +29,7 @@
 #include "../api.h"
 
 #include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/unordered_map.hpp>
 
@@ -89,6 +90,14 @@ public:
             severity_t severity=severity::NONE);
     CatToSeverityMap getCategories();
 
+    // In asynchronous mode, trace() only copies the record into a bounded buffer and
+    // the sinks are called from a separate thread. Records that don't fit into the
+    // buffer are dropped and counted.
+    void setAsync(bool bAsync);
+    bool isAsync() const;
+    void flush();
+    unsigned getNumDroppedRecords() const;
+
     void trace(const UTF8String& sMsg, const category_t& category,
             severity_t severity) const;
     void logDebug(const UTF8String& msg,
@@ -105,21 +114,34 @@ public:
             severity_t severity=severity::INFO) const;
 
     inline bool shouldLog(const category_t& category, severity_t severity) const {
-        lock_guard lock(m_CategoryMutex);
-        try {
-            severity_t targetSeverity = m_CategorySeverities.at(category);
-            return (targetSeverity <= severity);
-        } catch (out_of_range e){
-            string msg("Unknown category: " + category);
-            throw Exception(AVG_ERR_INVALID_ARGS, msg);
-        }
+        return getCategorySeverity(category) <= severity;
     }
 
 private:
     Logger();
     void setupCategory();
-
-    std::vector<LogSinkPtr> m_pSinks;
+    severity_t getCategorySeverity(const category_t& category) const;
+    void dispatch(const tm* pTime, unsigned millis, const category_t& category,
+            severity_t severity, const UTF8String& sMsg) const;
+    static void drainRecords();
+    static void sinkThreadFunc();
+
+    // Open-addressing hash table that mirrors m_CategorySeverities so shouldLog()
+    // can run without taking a lock. Slots are only ever added, never removed.
+    struct CategorySlot {
+        boost::atomic<const category_t*> m_pCategory;
+        boost::atomic<severity_t> m_Severity;
+    };
+    static const unsigned NUM_CATEGORY_SLOTS = 512;
+    CategorySlot m_CategorySlots[NUM_CATEGORY_SLOTS];
+    unsigned m_NumCategories;
+
+    // Copy-on-write, so dispatch() can call the sinks without holding a lock. Sinks
+    // may take other locks (e.g. the Python GIL) that callers of addLogSink() and 
+    // trace() hold, so sink calls aren't serialized either. Sinks are thread-safe 
+    // instead.
+    typedef boost::shared_ptr<const std::vector<LogSinkPtr> > LogSinkListPtr;
+    LogSinkListPtr m_pSinks;
     LogSinkPtr m_pStdSink;
     CatToSeverityMap m_CategorySeverities;
     severity_t m_Severity;
@@ -45,9 +45,15 @@ public:
     {
         m_TimeSum += TimeSource::get()->getCurrentMicrosecs()-m_StartTime;
     };
+    void addCount(long long count)
+    {
+        m_CountSum += count;
+    };
     void reset();
     long long getUSecs() const;
     long long getAvgUSecs() const;
+    long long getCount() const;
+    long long getAvgCount() const;
     void setIndentLevel(int indent);
     int getIndentLevel() const;
     std::string getIndentString() const;
@@ -57,6 +63,8 @@ private:
     long long m_TimeSum;
     long long m_AvgTime;
     long long m_StartTime;
+    long long m_CountSum;
+    long long m_AvgCount;
     int m_NumFrames;
     int m_Indent;
     const ProfilingZoneID& m_ZoneID;
@@ -24,25 +24,36 @@
 
 #include "../api.h"
 #include "Exception.h"
+#include "EventCount.h"
 
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <deque>
+#include <vector>
 #include <iostream>
 
 namespace avg {
 
 typedef boost::unique_lock<boost::mutex> unique_lock;
 
+// Thread-safe queue of shared pointers.
+// By default, access is serialized using a mutex. Bounded queues with a single
+// producer thread can instead be constructed lock-free (bLockFree=true): Elements are
+// then kept in a ring buffer, and push() never takes a lock that a consumer holds.
+// Consumers (pop, peek, clear) still serialize among themselves using a spinlock, so
+// it's ok for the producer to clear() the queue as well. Blocking calls sleep on an
+// EventCount.
 template<class QElement>
 class AVG_TEMPLATE_API Queue 
 {
 public:
     typedef boost::shared_ptr<QElement> QElementPtr;
 
-    Queue(int maxSize=-1);
+    Queue(int maxSize=-1, bool bLockFree=false);
     virtual ~Queue();
 
     bool empty() const;
@@ -52,20 +63,49 @@ public:
     QElementPtr peek(bool bBlock = true) const;
     int size() const;
     int getMaxSize() const;
+    bool isLockFree() const;
 
 private:
     QElementPtr getFrontElement(bool bBlock, unique_lock& Lock) const;
 
+    QElementPtr lockFreeGetFront(bool bBlock, bool bRemove) const;
+    void lockFreePush(const QElementPtr& pElem);
+    void lockConsumers() const;
+    void unlockConsumers() const;
+
     std::deque<QElementPtr> m_pElements;
     mutable boost::mutex m_Mutex;
     mutable boost::condition m_Cond;
     int m_MaxSize;
+
+    bool m_bLockFree;
+    mutable std::vector<QElementPtr> m_Ring;
+    unsigned m_RingMask;
+    mutable boost::atomic<unsigned> m_Head;
+    boost::atomic<unsigned> m_Tail;
+    mutable boost::atomic<bool> m_bConsumerLock;
+    mutable EventCount m_NotEmptyEvent;
+    mutable EventCount m_NotFullEvent;
 };
 
 template<class QElement>
-Queue<QElement>::Queue(int maxSize)
-    : m_MaxSize(maxSize)
+Queue<QElement>::Queue(int maxSize, bool bLockFree)
+    : m_MaxSize(maxSize),
+      m_bLockFree(bLockFree),
+      m_RingMask(0),
+      m_Head(0),
+      m_Tail(0),
+      m_bConsumerLock(false)
 {
+    if (m_bLockFree) {
+        AVG_ASSERT(m_MaxSize > 0);
+        unsigned ringSize = 1;
+        while (ringSize < unsigned(m_MaxSize)) {
+            ringSize *= 2;
+        }
+        m_Ring.resize(ringSize);
+        m_RingMask = ringSize-1;
+    }
 }
 
 template<class QElement>
@@ -76,6 +116,9 @@ Queue<QElement>::~Queue()
 template<class QElement>
 bool Queue<QElement>::empty() const
 {
+    if (m_bLockFree) {
+        return size() == 0;
+    }
     unique_lock Lock(m_Mutex);
     return m_pElements.empty();
 }
@@ -83,6 +126,9 @@ bool Queue<QElement>::empty() const
 template<class QElement>
 typename Queue<QElement>::QElementPtr Queue<QElement>::pop(bool bBlock)
 {
+    if (m_bLockFree) {
+        return lockFreeGetFront(bBlock, true);
+    }
     unique_lock lock(m_Mutex);
     QElementPtr pElem = getFrontElement(bBlock, lock); 
     if (pElem) {
@@ -104,6 +150,9 @@ void Queue<QElement>::clear()
 template<class QElement>
 typename Queue<QElement>::QElementPtr Queue<QElement>::peek(bool bBlock) const
 {
+    if (m_bLockFree) {
+        return lockFreeGetFront(bBlock, false);
+    }
     unique_lock lock(m_Mutex);
     QElementPtr pElem = getFrontElement(bBlock, lock); 
     if (pElem) {
@@ -116,6 +165,10 @@ template<class QElement>
 void Queue<QElement>::push(const QElementPtr& pElem)
 {
     assert(pElem);
+    if (m_bLockFree) {
+        lockFreePush(pElem);
+        return;
+    }
     unique_lock lock(m_Mutex);
     if (m_pElements.size() == (unsigned)m_MaxSize) {
         while (m_pElements.size() == (unsigned)m_MaxSize) {
@@ -129,6 +182,11 @@ void Queue<QElement>::push(const QElementPtr& pElem)
 template<class QElement>
 int Queue<QElement>::size() const
 {
+    if (m_bLockFree) {
+        unsigned head = m_Head.load(boost::memory_order_acquire);
+        unsigned tail = m_Tail.load(boost::memory_order_acquire);
+        return int(tail-head);
+    }
     unique_lock lock(m_Mutex);
     return int(m_pElements.size());
 }
@@ -136,10 +194,15 @@ int Queue<QElement>::size() const
 template<class QElement>
 int Queue<QElement>::getMaxSize() const
 {
-    unique_lock lock(m_Mutex);
     return m_MaxSize;
 }
 
+template<class QElement>
+bool Queue<QElement>::isLockFree() const
+{
+    return m_bLockFree;
+}
+
 template<class QElement>
 typename Queue<QElement>::QElementPtr 
         Queue<QElement>::getFrontElement(bool bBlock, unique_lock& lock) const
@@ -156,5 +219,75 @@ typename Queue<QElement>::QElementPtr
     return m_pElements.front();
 }
 
+template<class QElement>
+typename Queue<QElement>::QElementPtr 
+        Queue<QElement>::lockFreeGetFront(bool bBlock, bool bRemove) const
+{
+    while (true) {
+        lockConsumers();
+        unsigned head = m_Head.load(boost::memory_order_relaxed);
+        if (m_Tail.load(boost::memory_order_acquire) != head) {
+            QElementPtr pElem;
+            QElementPtr& slot = m_Ring[head & m_RingMask];
+            if (bRemove) {
+                // Swapping leaves the slot empty, so the ring doesn't keep the element
+                // alive.
+                pElem.swap(slot);
+                m_Head.store(head+1, boost::memory_order_release);
+            } else {
+                pElem = slot;
+            }
+            unlockConsumers();
+            if (bRemove) {
+                m_NotFullEvent.notify();
+            }
+            return pElem;
+        }
+        unlockConsumers();
+        if (!bBlock) {
+            return QElementPtr();
+        }
+        int key = m_NotEmptyEvent.prepareWait();
+        if (m_Tail.load(boost::memory_order_seq_cst) != 
+                m_Head.load(boost::memory_order_seq_cst))
+        {
+            m_NotEmptyEvent.cancelWait();
+        } else {
+            m_NotEmptyEvent.wait(key);
+        }
+    }
+}
+
+template<class QElement>
+void Queue<QElement>::lockFreePush(const QElementPtr& pElem)
+{
+    unsigned tail = m_Tail.load(boost::memory_order_relaxed);
+    while (tail - m_Head.load(boost::memory_order_acquire) >= unsigned(m_MaxSize)) {
+        int key = m_NotFullEvent.prepareWait();
+        if (tail - m_Head.load(boost::memory_order_seq_cst) < unsigned(m_MaxSize)) {
+            m_NotFullEvent.cancelWait();
+        } else {
+            m_NotFullEvent.wait(key);
+        }
+    }
+    m_Ring[tail & m_RingMask] = pElem;
+    m_Tail.store(tail+1, boost::memory_order_release);
+    m_NotEmptyEvent.notify();
+}
+
+template<class QElement>
+void Queue<QElement>::lockConsumers() const
+{
+    while (m_bConsumerLock.exchange(true, boost::memory_order_acquire)) {
+        boost::this_thread::yield();
+    }
+}
+
+template<class QElement>
+void Queue<QElement>::unlockConsumers() const
+{
+    m_bConsumerLock.store(false, boost::memory_order_release);
+}
+
 }
 #endif
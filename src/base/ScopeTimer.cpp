@@ -26,10 +26,19 @@ using namespace std;
 namespace avg {
 
 bool ScopeTimer::s_bTimersEnabled = false;
+bool ScopeTimer::s_bProfilingEnabled = false;
+bool ScopeTimer::s_bTracingEnabled = false;
 
 void ScopeTimer::enableTimers(bool bEnable)
 {
-    s_bTimersEnabled = bEnable;
+    s_bProfilingEnabled = bEnable;
+    s_bTimersEnabled = s_bProfilingEnabled || s_bTracingEnabled;
+}
+
+void ScopeTimer::enableTracing(bool bEnable)
+{
+    s_bTracingEnabled = bEnable;
+    s_bTimersEnabled = s_bProfilingEnabled || s_bTracingEnabled;
 }
 
 }
@@ -48,11 +48,19 @@ public:
     };
 
     static void enableTimers(bool bEnable);
+    static void enableTracing(bool bEnable);
+    static bool isTracingEnabled()
+    {
+        return s_bTracingEnabled;
+    };
 
 private:
     ProfilingZoneID* m_pZoneID;
 
+    // Timers run if either profiling or tracing is enabled.
     static bool s_bTimersEnabled;
+    static bool s_bProfilingEnabled;
+    static bool s_bTracingEnabled;
 };
 
 }
@@ -42,6 +42,8 @@ public:
 
     void connect(LISTENEROBJ* pListener);
     void disconnect(LISTENEROBJ* pListener);
+    void disconnectAll();
+    bool isConnected(LISTENEROBJ* pListener) const;
     
     void emit();
     int getNumListeners() const;
@@ -92,13 +94,39 @@ void Signal<LISTENEROBJ>::disconnect(LISTENEROBJ* pListener)
     }
 }
 
+template<class LISTENEROBJ>
+void Signal<LISTENEROBJ>::disconnectAll()
+{
+    AVG_ASSERT(!m_pCurrentListener);
+    m_Listeners.clear();
+}
+
+template<class LISTENEROBJ>
+bool Signal<LISTENEROBJ>::isConnected(LISTENEROBJ* pListener) const
+{
+    if (pListener == m_pCurrentListener && m_bKillCurrentListener) {
+        return false;
+    }
+    return find(m_Listeners.begin(), m_Listeners.end(), pListener) != m_Listeners.end();
+}
+
 template<class LISTENEROBJ>
 void Signal<LISTENEROBJ>::emit()
 {
     ListenerIterator it;
     for (it=m_Listeners.begin(); it != m_Listeners.end();) {
         m_pCurrentListener = *it;
-        ((*it)->*m_pFunc)();   // This is the actual call to the listener.
+        try {
+            ((*it)->*m_pFunc)();   // This is the actual call to the listener.
+        } catch (...) {
+            // Leave the signal in a consistent state for the next emit().
+            if (m_bKillCurrentListener) {
+                m_Listeners.erase(it);
+                m_bKillCurrentListener = false;
+            }
+            m_pCurrentListener = 0;
+            throw;
+        }
         if (m_bKillCurrentListener) {
             it = m_Listeners.erase(it);
             m_bKillCurrentListener = false;
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 using namespace std;
 
@@ -44,10 +45,15 @@ void StandardLogSink::logMessage(const tm* pTime, unsigned millis,
 {
     char timeString[256];
     strftime(timeString, sizeof(timeString), "%y-%m-%d %H:%M:%S", pTime);
-    cerr << "[" << timeString << "." << 
+    // Sinks are called from several threads at once. Writing the line in one call 
+    // keeps lines from different threads from being interleaved, and the local 
+    // stream keeps the formatting state out of cerr.
+    stringstream ss;
+    ss << "[" << timeString << "." << 
         setw(3) << setfill('0') << millis << setw(0) << "][";
-    cerr << setw(4) << setfill('.') << Logger::severityToString(severity) << "][";
-    cerr << setw(9) << setfill('.') << category << "] : " << sMsg << endl;
+    ss << setw(4) << setfill('.') << Logger::severityToString(severity) << "][";
+    ss << setw(9) << setfill('.') << category << "] : " << sMsg << "\n";
+    cerr << ss.str();
     cerr.flush();
 }
 
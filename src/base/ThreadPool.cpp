@@ -0,0 +1,217 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "ThreadPool.h"
+
+#include "ConfigMgr.h"
+#include "Exception.h"
+#include "ThreadHelper.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/once.hpp>
+
+#include <algorithm>
+#include <exception>
+
+using namespace std;
+
+namespace avg {
+
+// Bands smaller than this cost more in synchronization than they save.
+static const int MIN_BAND_PIXELS = 32*1024;
+// More bands than threads keep the load balanced when some threads get preempted.
+static const int BANDS_PER_THREAD = 4;
+
+ThreadPool* ThreadPool::s_pThreadPool = 0;
+
+static boost::once_flag s_CreateOnce = BOOST_ONCE_INIT;
+
+ThreadPool* ThreadPool::get()
+{
+    boost::call_once(s_CreateOnce, &ThreadPool::createInstance);
+    return s_pThreadPool;
+}
+
+void ThreadPool::createInstance()
+{
+    s_pThreadPool = new ThreadPool;
+    atexit(&ThreadPool::deleteInstance);
+}
+
+void ThreadPool::deleteInstance()
+{
+    delete s_pThreadPool;
+    s_pThreadPool = 0;
+}
+
+ThreadPool::ThreadPool()
+    : m_pFunc(0),
+      m_NumRows(0),
+      m_RowsPerBand(0),
+      m_NextRow(0),
+      m_NumBandsLeft(0),
+      m_JobID(0),
+      m_pException(0),
+      m_bStop(false)
+{
+    int numThreads = ConfigMgr::get()->getIntOption("cpu", "numthreads", -1);
+    if (numThreads < 0) {
+        numThreads = max(int(boost::thread::hardware_concurrency())-1, 0);
+    }
+    startThreads(numThreads);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stopThreads();
+}
+
+void ThreadPool::setNumThreads(int numThreads)
+{
+    AVG_ASSERT(numThreads >= 0);
+    lock_guard jobLock(m_JobMutex);
+    stopThreads();
+    startThreads(numThreads);
+}
+
+int ThreadPool::getNumThreads() const
+{
+    return int(m_pThreads.size());
+}
+
+void ThreadPool::runRowBands(int numRows, int rowWidth, const RowBandFunc& func)
+{
+    int maxBands = int(min((long long)(numRows)*rowWidth/MIN_BAND_PIXELS,
+            (long long)(numRows)));
+    int numBands = min(maxBands, (getNumThreads()+1)*BANDS_PER_THREAD);
+    if (numBands <= 1) {
+        func(0, numRows);
+        return;
+    }
+    boost::unique_lock<boost::mutex> jobLock(m_JobMutex, boost::try_to_lock);
+    if (!jobLock.owns_lock()) {
+        func(0, numRows);
+        return;
+    }
+
+    boost::unique_lock<boost::mutex> lock(m_Mutex);
+    m_pFunc = &func;
+    m_NumRows = numRows;
+    m_RowsPerBand = (numRows+numBands-1)/numBands;
+    m_NextRow = 0;
+    m_NumBandsLeft = (numRows+m_RowsPerBand-1)/m_RowsPerBand;
+    m_JobID++;
+    m_WorkCond.notify_all();
+    runBands(lock);
+    while (m_NumBandsLeft > 0) {
+        m_DoneCond.wait(lock);
+    }
+    m_pFunc = 0;
+    if (m_pException) {
+        Exception ex(*m_pException);
+        delete m_pException;
+        m_pException = 0;
+        throw ex;
+    }
+}
+
+void ThreadPool::startThreads(int numThreads)
+{
+    for (int i = 0; i < numThreads; ++i) {
+        m_pThreads.push_back(new boost::thread(boost::bind(&ThreadPool::threadFunc, 
+                this)));
+    }
+}
+
+void ThreadPool::stopThreads()
+{
+    {
+        lock_guard lock(m_Mutex);
+        m_bStop = true;
+        m_WorkCond.notify_all();
+    }
+    for (unsigned i = 0; i < m_pThreads.size(); ++i) {
+        m_pThreads[i]->join();
+        delete m_pThreads[i];
+    }
+    m_pThreads.clear();
+    m_bStop = false;
+}
+
+void ThreadPool::threadFunc()
+{
+    setAffinityMask(false);
+    boost::unique_lock<boost::mutex> lock(m_Mutex);
+    unsigned lastJobID = m_JobID;
+    while (true) {
+        while (!m_bStop && m_JobID == lastJobID) {
+            m_WorkCond.wait(lock);
+        }
+        if (m_bStop) {
+            return;
+        }
+        lastJobID = m_JobID;
+        runBands(lock);
+    }
+}
+
+void ThreadPool::runBands(boost::unique_lock<boost::mutex>& lock)
+{
+    // Called with m_Mutex locked. Bands are handed out in order until none are left.
+    while (m_NextRow < m_NumRows) {
+        int startRow = m_NextRow;
+        int endRow = min(startRow+m_RowsPerBand, m_NumRows);
+        m_NextRow = endRow;
+        const RowBandFunc* pFunc = m_pFunc;
+        lock.unlock();
+        try {
+            (*pFunc)(startRow, endRow);
+        } catch (const Exception& ex) {
+            setException(lock, ex);
+        } catch (const std::exception& ex) {
+            setException(lock, Exception(AVG_ERR_UNKNOWN, ex.what()));
+        } catch (...) {
+            setException(lock, Exception(AVG_ERR_UNKNOWN,
+                    "Unknown exception in thread pool job."));
+        }
+        // The band counts as done even if it failed, so the caller doesn't return
+        // while other threads still use the job.
+        lock.lock();
+        m_NumBandsLeft--;
+        if (m_NumBandsLeft == 0) {
+            m_DoneCond.notify_all();
+        }
+    }
+}
+
+void ThreadPool::setException(boost::unique_lock<boost::mutex>& lock,
+        const Exception& ex)
+{
+    // Only the first error is reported.
+    lock.lock();
+    if (!m_pException) {
+        m_pException = new Exception(ex);
+    }
+    lock.unlock();
+}
+
+}
@@ -0,0 +1,97 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _ThreadPool_H_
+#define _ThreadPool_H_
+
+#include "../api.h"
+
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class Exception;
+
+typedef boost::function<void (int, int)> RowBandFunc;
+
+// Process-wide pool of helper threads for data-parallel pixel loops. runRowBands()
+// splits an image into horizontal bands and processes them on the pool threads and
+// the calling thread at the same time. Each row is computed exactly as in a
+// single-threaded loop, so results don't depend on the number of threads.
+//
+// The number of helper threads is taken from the cpu/numthreads avgrc option. The
+// default (-1) uses one thread less than there are processors, since the calling
+// thread works as well.
+class AVG_API ThreadPool
+{
+public:
+    static ThreadPool* get();
+    virtual ~ThreadPool();
+
+    void setNumThreads(int numThreads);
+    int getNumThreads() const;
+
+    // Calls func(startRow, endRow) for bands covering rows [0, numRows) and returns
+    // when all bands are done. rowWidth is the number of pixels in a row; images that
+    // are too small to profit are processed in one band on the calling thread. This
+    // also happens if the pool is busy with a job from another thread, so calls may
+    // be nested.
+    void runRowBands(int numRows, int rowWidth, const RowBandFunc& func);
+
+private:
+    ThreadPool();
+    static void createInstance();
+    static void deleteInstance();
+
+    void startThreads(int numThreads);
+    void stopThreads();
+    void threadFunc();
+    void runBands(boost::unique_lock<boost::mutex>& lock);
+    void setException(boost::unique_lock<boost::mutex>& lock, const Exception& ex);
+
+    std::vector<boost::thread*> m_pThreads;
+    boost::mutex m_JobMutex;
+
+    // Current job, protected by m_Mutex.
+    boost::mutex m_Mutex;
+    boost::condition m_WorkCond;
+    boost::condition m_DoneCond;
+    const RowBandFunc* m_pFunc;
+    int m_NumRows;
+    int m_RowsPerBand;
+    int m_NextRow;
+    int m_NumBandsLeft;
+    unsigned m_JobID;
+    Exception* m_pException;
+    bool m_bStop;
+
+    static ThreadPool* s_pThreadPool;
+};
+
+}
+
+#endif
@@ -63,6 +63,9 @@ ThreadProfiler::ThreadProfiler()
 
 ThreadProfiler::~ThreadProfiler() 
 {
+    if (m_pTraceBuffer) {
+        m_pTraceBuffer->setFinished();
+    }
 }
 
 void ThreadProfiler::setLogCategory(category_t category)
@@ -98,31 +101,51 @@ void ThreadProfiler::startZone(const ProfilingZoneID& zoneID)
         pZone->start();
         m_ActiveZones.push_back(pZone);
     }
+    if (ScopeTimer::isTracingEnabled()) {
+        addTraceEvent(zoneID, true);
+    }
 }
 
 void ThreadProfiler::stopZone(const ProfilingZoneID& zoneID)
 {
+    if (ScopeTimer::isTracingEnabled()) {
+        addTraceEvent(zoneID, false);
+    }
     ZoneMap::iterator it = m_ZoneMap.find(&zoneID);
     ProfilingZonePtr& pZone = it->second;
     pZone->stop();
     m_ActiveZones.pop_back();
 }
 
+void ThreadProfiler::addZoneCount(const ProfilingZoneID& zoneID, long long count)
+{
+    // Counts are only recorded for zones that are being timed.
+    ZoneMap::iterator it = m_ZoneMap.find(&zoneID);
+    if (it != m_ZoneMap.end()) {
+        it->second->addCount(count);
+    }
+}
+
 void ThreadProfiler::dumpStatistics()
 {
     if (!m_Zones.empty()) {
         AVG_TRACE(m_LogCategory, Logger::severity::INFO, "Thread " << m_sName);
         AVG_TRACE(m_LogCategory, Logger::severity::INFO,
-                "Zone name                          Avg. time");
+                "Zone name                          Avg. time Avg. count");
         AVG_TRACE(m_LogCategory, Logger::severity::INFO,
-                "---------                          ---------");
+                "---------                          --------- ----------");
 
         ZoneVector::iterator it;
         for (it = m_Zones.begin(); it != m_Zones.end(); ++it) {
+            stringstream ss;
+            if ((*it)->getAvgCount() != 0) {
+                ss << std::setw(11) << std::right << (*it)->getAvgCount();
+            }
             AVG_TRACE(m_LogCategory, Logger::severity::INFO,
                     std::setw(35) << std::left 
                     << ((*it)->getIndentString()+(*it)->getName())
-                    << std::setw(9) << std::right << (*it)->getAvgUSecs());
+                    << std::setw(9) << std::right << (*it)->getAvgUSecs()
+                    << ss.str());
         }
         AVG_TRACE(m_LogCategory, Logger::severity::INFO, "");
     }
@@ -149,9 +172,20 @@ const std::string& ThreadProfiler::getName() const
 void ThreadProfiler::setName(const std::string& sName)
 {
     m_sName = sName;
+    if (m_pTraceBuffer) {
+        m_pTraceBuffer->setThreadName(sName);
+    }
 }
 
 
+void ThreadProfiler::addTraceEvent(const ProfilingZoneID& zoneID, bool bBegin)
+{
+    if (!m_pTraceBuffer) {
+        m_pTraceBuffer = TraceRecorder::get()->createBuffer(m_sName);
+    }
+    m_pTraceBuffer->addEvent(zoneID, bBegin);
+}
+
 ProfilingZonePtr ThreadProfiler::addZone(const ProfilingZoneID& zoneID)
 {
     ProfilingZonePtr pZone(new ProfilingZone(zoneID));
@@ -24,6 +24,7 @@
 
 #include "../api.h"
 #include "ILogSink.h"
+#include "TraceRecorder.h"
 
 #include <boost/thread.hpp>
 #include <boost/shared_ptr.hpp>
@@ -57,6 +58,7 @@ public:
     void restart();
     void startZone(const ProfilingZoneID& zoneID);
     void stopZone(const ProfilingZoneID& zoneID);
+    void addZoneCount(const ProfilingZoneID& zoneID, long long count);
     void dumpStatistics();
     void reset();
     int getNumZones();
@@ -66,7 +68,9 @@ public:
 
 private:
     ProfilingZonePtr addZone(const ProfilingZoneID& zoneID);
+    void addTraceEvent(const ProfilingZoneID& zoneID, bool bBegin);
     std::string m_sName;
+    TraceBufferPtr m_pTraceBuffer;
 
 #if defined(_WIN32) || defined(_LIBCPP_VERSION)
     typedef std::unordered_map<const ProfilingZoneID*, ProfilingZonePtr> ZoneMap;
@@ -0,0 +1,273 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "TraceRecorder.h"
+
+#include "Exception.h"
+#include "ProfilingZoneID.h"
+#include "ScopeTimer.h"
+#include "TimeSource.h"
+
+#include <boost/thread/once.hpp>
+
+#include <fstream>
+
+using namespace std;
+
+namespace avg {
+
+TraceBuffer::TraceBuffer(int threadID, const string& sThreadName)
+    : m_ThreadID(threadID),
+      m_sThreadName(sThreadName),
+      m_NumEvents(0),
+      m_NumDroppedEvents(0),
+      m_Session(0),
+      m_bFinished(false)
+{
+}
+
+TraceBuffer::~TraceBuffer()
+{
+}
+
+void TraceBuffer::addEvent(const ProfilingZoneID& zoneID, bool bBegin)
+{
+    TraceRecorder* pRecorder = TraceRecorder::get();
+    unsigned session = pRecorder->getSession();
+    if (m_Session.load(boost::memory_order_relaxed) != session) {
+        // First event of a new session: Only this thread ever changes the buffer, so
+        // it's safe to reset it here.
+        m_Events.resize(pRecorder->getMaxEventsPerThread());
+        m_NumEvents.store(0, boost::memory_order_relaxed);
+        m_NumDroppedEvents.store(0, boost::memory_order_relaxed);
+        m_Session.store(session, boost::memory_order_release);
+    }
+    unsigned numEvents = m_NumEvents.load(boost::memory_order_relaxed);
+    if (numEvents < m_Events.size()) {
+        TraceEvent& event = m_Events[numEvents];
+        event.m_pZoneID = &zoneID;
+        event.m_Time = TimeSource::get()->getCurrentMicrosecs();
+        event.m_bBegin = bBegin;
+        m_NumEvents.store(numEvents+1, boost::memory_order_release);
+    } else {
+        m_NumDroppedEvents.fetch_add(1, boost::memory_order_relaxed);
+    }
+}
+
+int TraceBuffer::getThreadID() const
+{
+    return m_ThreadID;
+}
+
+string TraceBuffer::getThreadName() const
+{
+    boost::lock_guard<boost::mutex> lock(m_NameMutex);
+    return m_sThreadName;
+}
+
+void TraceBuffer::setThreadName(const string& sThreadName)
+{
+    boost::lock_guard<boost::mutex> lock(m_NameMutex);
+    m_sThreadName = sThreadName;
+}
+
+void TraceBuffer::setFinished()
+{
+    m_bFinished.store(true, boost::memory_order_release);
+}
+
+bool TraceBuffer::isFinished() const
+{
+    return m_bFinished.load(boost::memory_order_acquire);
+}
+
+unsigned TraceBuffer::getNumEvents(unsigned session) const
+{
+    if (m_Session.load(boost::memory_order_acquire) != session) {
+        return 0;
+    }
+    return m_NumEvents.load(boost::memory_order_acquire);
+}
+
+const TraceEvent& TraceBuffer::getEvent(unsigned i) const
+{
+    return m_Events[i];
+}
+
+unsigned TraceBuffer::getNumDroppedEvents(unsigned session) const
+{
+    if (m_Session.load(boost::memory_order_acquire) != session) {
+        return 0;
+    }
+    return m_NumDroppedEvents.load(boost::memory_order_relaxed);
+}
+
+
+TraceRecorder* TraceRecorder::s_pRecorder = 0;
+
+static boost::once_flag s_CreateOnce = BOOST_ONCE_INIT;
+
+TraceRecorder* TraceRecorder::get()
+{
+    boost::call_once(s_CreateOnce, &TraceRecorder::createInstance);
+    return s_pRecorder;
+}
+
+void TraceRecorder::createInstance()
+{
+    s_pRecorder = new TraceRecorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : m_NextThreadID(1),
+      m_Session(0),
+      m_MaxEventsPerThread(DEFAULT_MAX_EVENTS),
+      m_bRecording(false)
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+}
+
+void TraceRecorder::start(unsigned maxEventsPerThread)
+{
+    boost::lock_guard<boost::mutex> lock(m_Mutex);
+    if (m_bRecording) {
+        throw Exception(AVG_ERR_UNSUPPORTED, "Tracing has already been started.");
+    }
+    // Buffers of threads that have ended are only kept until the next session.
+    vector<TraceBufferPtr>::iterator it = m_pBuffers.begin();
+    while (it != m_pBuffers.end()) {
+        if ((*it)->isFinished()) {
+            it = m_pBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_MaxEventsPerThread.store(maxEventsPerThread, boost::memory_order_relaxed);
+    m_Session.fetch_add(1, boost::memory_order_release);
+    m_bRecording = true;
+    ScopeTimer::enableTracing(true);
+}
+
+void TraceRecorder::stop()
+{
+    boost::lock_guard<boost::mutex> lock(m_Mutex);
+    m_bRecording = false;
+    ScopeTimer::enableTracing(false);
+}
+
+bool TraceRecorder::isRecording() const
+{
+    boost::lock_guard<boost::mutex> lock(m_Mutex);
+    return m_bRecording;
+}
+
+namespace {
+    string escapeJSON(const string& s)
+    {
+        string sResult;
+        for (unsigned i=0; i<s.size(); ++i) {
+            char c = s[i];
+            if (c == '"' || c == '\\') {
+                sResult += '\\';
+                sResult += c;
+            } else if ((unsigned char)c < 0x20) {
+                sResult += ' ';
+            } else {
+                sResult += c;
+            }
+        }
+        return sResult;
+    }
+}
+
+void TraceRecorder::writeChromeTrace(const string& sFilename) const
+{
+    boost::lock_guard<boost::mutex> lock(m_Mutex);
+    ofstream file(sFilename.c_str());
+    if (!file) {
+        throw Exception(AVG_ERR_FILEIO, "Could not open '" + sFilename + 
+                "' for writing.");
+    }
+    unsigned session = m_Session.load(boost::memory_order_relaxed);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool bFirst = true;
+    vector<TraceBufferPtr>::const_iterator it;
+    for (it = m_pBuffers.begin(); it != m_pBuffers.end(); ++it) {
+        const TraceBuffer& buffer = **it;
+        unsigned numEvents = buffer.getNumEvents(session);
+        if (numEvents == 0) {
+            continue;
+        }
+        int tid = buffer.getThreadID();
+        if (!bFirst) {
+            file << ",";
+        }
+        bFirst = false;
+        file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                << ",\"args\":{\"name\":\"" << escapeJSON(buffer.getThreadName())
+                << "\"}}";
+        for (unsigned i=0; i<numEvents; ++i) {
+            const TraceEvent& event = buffer.getEvent(i);
+            file << ",\n{\"name\":\"" << escapeJSON(event.m_pZoneID->getName())
+                    << "\",\"ph\":\"" << (event.m_bBegin ? "B" : "E")
+                    << "\",\"ts\":" << event.m_Time << ",\"pid\":1,\"tid\":" << tid
+                    << "}";
+        }
+    }
+    file << "\n]}\n";
+}
+
+unsigned TraceRecorder::getNumDroppedEvents() const
+{
+    boost::lock_guard<boost::mutex> lock(m_Mutex);
+    unsigned session = m_Session.load(boost::memory_order_relaxed);
+    unsigned numDropped = 0;
+    vector<TraceBufferPtr>::const_iterator it;
+    for (it = m_pBuffers.begin(); it != m_pBuffers.end(); ++it) {
+        numDropped += (*it)->getNumDroppedEvents(session);
+    }
+    return numDropped;
+}
+
+TraceBufferPtr TraceRecorder::createBuffer(const string& sThreadName)
+{
+    boost::lock_guard<boost::mutex> lock(m_Mutex);
+    TraceBufferPtr pBuffer(new TraceBuffer(m_NextThreadID, sThreadName));
+    m_NextThreadID++;
+    m_pBuffers.push_back(pBuffer);
+    return pBuffer;
+}
+
+unsigned TraceRecorder::getSession() const
+{
+    return m_Session.load(boost::memory_order_acquire);
+}
+
+unsigned TraceRecorder::getMaxEventsPerThread() const
+{
+    return m_MaxEventsPerThread.load(boost::memory_order_relaxed);
+}
+
+}
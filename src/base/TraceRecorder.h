@@ -0,0 +1,119 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _TraceRecorder_H_
+#define _TraceRecorder_H_
+
+#include "../api.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class ProfilingZoneID;
+
+struct TraceEvent
+{
+    // ProfilingZoneIDs are static objects, so the pointer stays valid.
+    const ProfilingZoneID* m_pZoneID;
+    long long m_Time;
+    bool m_bBegin;
+};
+
+// Events recorded by a single thread. Only the owning thread adds events; other threads
+// may read the events that have been published by m_NumEvents at any time.
+class AVG_API TraceBuffer
+{
+public:
+    TraceBuffer(int threadID, const std::string& sThreadName);
+    virtual ~TraceBuffer();
+
+    void addEvent(const ProfilingZoneID& zoneID, bool bBegin);
+
+    int getThreadID() const;
+    std::string getThreadName() const;
+    void setThreadName(const std::string& sThreadName);
+    void setFinished();
+    bool isFinished() const;
+
+    // Events of the current session, 0 if the thread hasn't traced anything yet.
+    unsigned getNumEvents(unsigned session) const;
+    const TraceEvent& getEvent(unsigned i) const;
+    unsigned getNumDroppedEvents(unsigned session) const;
+
+private:
+    int m_ThreadID;
+    std::string m_sThreadName;
+    mutable boost::mutex m_NameMutex;
+    std::vector<TraceEvent> m_Events;
+    boost::atomic<unsigned> m_NumEvents;
+    boost::atomic<unsigned> m_NumDroppedEvents;
+    boost::atomic<unsigned> m_Session;
+    boost::atomic<bool> m_bFinished;
+};
+
+typedef boost::shared_ptr<TraceBuffer> TraceBufferPtr;
+
+// Records the begin and end of every ScopeTimer on every thread while tracing is
+// active. The result can be written in the chrome trace event format and viewed using
+// chrome://tracing or https://ui.perfetto.dev.
+class AVG_API TraceRecorder
+{
+public:
+    static TraceRecorder* get();
+    virtual ~TraceRecorder();
+
+    void start(unsigned maxEventsPerThread=DEFAULT_MAX_EVENTS);
+    void stop();
+    bool isRecording() const;
+    void writeChromeTrace(const std::string& sFilename) const;
+    unsigned getNumDroppedEvents() const;
+
+    // Used by TraceBuffer and ThreadProfiler.
+    TraceBufferPtr createBuffer(const std::string& sThreadName);
+    unsigned getSession() const;
+    unsigned getMaxEventsPerThread() const;
+
+    static const unsigned DEFAULT_MAX_EVENTS = 200000;
+
+private:
+    TraceRecorder();
+    static void createInstance();
+
+    mutable boost::mutex m_Mutex;
+    std::vector<TraceBufferPtr> m_pBuffers;
+    int m_NextThreadID;
+    boost::atomic<unsigned> m_Session;
+    boost::atomic<unsigned> m_MaxEventsPerThread;
+    bool m_bRecording;
+
+    static TraceRecorder* s_pRecorder;
+};
+
+}
+
+#endif
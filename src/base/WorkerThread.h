@@ -52,23 +52,35 @@ public:
     virtual ~WorkerThread();
     void operator()();
 
+    // Alternative to operator() for workers that share threads with other workers: 
+    // Runs one iteration of the thread loop and returns false if there was nothing to 
+    // do. work() may not block in this case and should call setIdle() instead.
+    bool step();
+    bool isDone() const;
+
     void waitForCommand();
     void stop();
 
 protected:
     int getNumCmdsInQueue() const;
+    void setIdle();
 
 private:
     virtual bool init();
     virtual bool work() = 0;
     virtual void deinit() {};
 
-    void processCommands();
+    bool processCommands();
 
     std::string m_sName;
     bool m_bShouldStop;
     CQueue& m_CmdQ;
     category_t m_LogCategory;
+
+    // Used by step()
+    bool m_bInitialized;
+    bool m_bDone;
+    bool m_bIdle;
 };
 
 template<class DERIVED_THREAD>
@@ -77,7 +89,10 @@ WorkerThread<DERIVED_THREAD>::WorkerThread(const std::string& sName, CQueue& Cmd
     : m_sName(sName),
       m_bShouldStop(false),
       m_CmdQ(CmdQ),
-      m_LogCategory(logCategory)
+      m_LogCategory(logCategory),
+      m_bInitialized(false),
+      m_bDone(false),
+      m_bIdle(false)
 {
 }
 
@@ -88,6 +103,9 @@ WorkerThread<DERIVED_THREAD>::WorkerThread(WorkerThread const& other)
     m_sName = other.m_sName;
     m_bShouldStop = other.m_bShouldStop;
     m_LogCategory = other.m_LogCategory;
+    m_bInitialized = other.m_bInitialized;
+    m_bDone = other.m_bDone;
+    m_bIdle = other.m_bIdle;
 }
 
 template<class DERIVED_THREAD>
@@ -127,6 +145,40 @@ void WorkerThread<DERIVED_THREAD>::operator()()
     }
 }
 
+template<class DERIVED_THREAD>
+bool WorkerThread<DERIVED_THREAD>::step()
+{
+    AVG_ASSERT(!m_bDone);
+    if (!m_bInitialized) {
+        m_bInitialized = true;
+        if (!init()) {
+            m_bDone = true;
+            return true;
+        }
+    }
+    m_bIdle = false;
+    bool bOK = work();
+    if (!bOK) {
+        m_bShouldStop = true;
+    }
+    bool bCmdsProcessed = false;
+    if (!m_bShouldStop) {
+        bCmdsProcessed = processCommands();
+    }
+    if (m_bShouldStop) {
+        deinit();
+        m_bDone = true;
+        return true;
+    }
+    return !m_bIdle || bCmdsProcessed;
+}
+
+template<class DERIVED_THREAD>
+bool WorkerThread<DERIVED_THREAD>::isDone() const
+{
+    return m_bDone;
+}
+
 template<class DERIVED_THREAD>
 void WorkerThread<DERIVED_THREAD>::waitForCommand() 
 {
@@ -146,6 +198,12 @@ int WorkerThread<DERIVED_THREAD>::getNumCmdsInQueue() const
     return m_CmdQ.size();
 }
 
+template<class DERIVED_THREAD>
+void WorkerThread<DERIVED_THREAD>::setIdle()
+{
+    m_bIdle = true;
+}
+
 template<class DERIVED_THREAD>
 bool WorkerThread<DERIVED_THREAD>::init()
 {
@@ -153,15 +211,18 @@ bool WorkerThread<DERIVED_THREAD>::init()
 }
 
 template<class DERIVED_THREAD>
-void WorkerThread<DERIVED_THREAD>::processCommands()
+bool WorkerThread<DERIVED_THREAD>::processCommands()
 {
+    bool bCmdsProcessed = false;
     CmdPtr pCmd = m_CmdQ.pop(false);
     while (pCmd && !m_bShouldStop) {
         pCmd->execute(dynamic_cast<DERIVED_THREAD*>(this));
+        bCmdsProcessed = true;
         if (!m_bShouldStop) {
             pCmd = m_CmdQ.pop(false);
         }
     }
+    return bCmdsProcessed;
 }
 
 }
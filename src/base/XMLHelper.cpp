@@ -77,12 +77,40 @@ void registerDTDEntityLoader(const string& sID, const string& sDTD)
     xmlSetExternalEntityLoader(DTDExternalEntityLoader);
 }
 
+static void dtdErrorOutputFunc(void * ctx, const char * msg, ...)
+{
+    char psz[1024];
+    va_list args;
+    va_start(args, msg);
+    vsnprintf(psz, 1024, msg, args);
+    va_end(args);
+    *((string*)ctx) += psz;
+}
+
+xmlDtdPtr parseDTD(const string& sDTD, const string& sDTDName)
+{
+    xmlGenericErrorFunc oldErrorFunc = xmlGenericError;
+    void* pOldErrorCtx = xmlGenericErrorContext;
+    string sError;
+    xmlSetGenericErrorFunc(&sError, dtdErrorOutputFunc);
+
+    registerDTDEntityLoader("memory.dtd", sDTD.c_str());
+    xmlDtdPtr pDTD = xmlParseDTD(NULL, (const xmlChar*)"memory.dtd");
+
+    xmlSetGenericErrorFunc(pOldErrorCtx, oldErrorFunc);
+    if (!pDTD) {
+        throw (Exception(AVG_ERR_XML_PARSE, "Error parsing "+sDTDName+".\n"+sError));
+    }
+    return pDTD;
+}
+
 
 XMLParser::XMLParser()
     : m_SchemaParserCtxt(0),
       m_Schema(0),
       m_SchemaValidCtxt(0),
       m_DTD(0),
+      m_bOwnsDTD(false),
       m_DTDValidCtxt(0),
       m_Doc(0)
 {
@@ -102,7 +130,7 @@ XMLParser::~XMLParser()
     if (m_SchemaValidCtxt) {
         xmlSchemaFreeValidCtxt(m_SchemaValidCtxt);
     }
-    if (m_DTD) {
+    if (m_DTD && m_bOwnsDTD) {
         xmlFreeDtd(m_DTD);
     }
     if (m_DTDValidCtxt) {
@@ -144,6 +172,25 @@ void XMLParser::setDTD(const std::string& sDTD, const std::string& sDTDName)
     string sDTDFName = "memory.dtd";
     m_DTD = xmlParseDTD(NULL, (const xmlChar*) sDTDFName.c_str());
     checkError(!m_DTD, sDTDName);
+    m_bOwnsDTD = true;
+
+    m_DTDValidCtxt = xmlNewValidCtxt();
+    checkError(!m_DTDValidCtxt, sDTDName);
+    m_DTDValidCtxt->error = xmlParserValidityError;
+    m_DTDValidCtxt->warning = xmlParserValidityWarning;
+}
+
+void XMLParser::setDTD(xmlDtdPtr pDTD, const std::string& sDTDName)
+{
+    AVG_ASSERT(!m_SchemaParserCtxt);
+    AVG_ASSERT(!m_Schema);
+    AVG_ASSERT(!m_SchemaValidCtxt);
+    AVG_ASSERT(!m_DTD);
+    AVG_ASSERT(!m_DTDValidCtxt);
+    AVG_ASSERT(pDTD);
+
+    m_DTD = pDTD;
+    m_bOwnsDTD = false;
 
     m_DTDValidCtxt = xmlNewValidCtxt();
     checkError(!m_DTDValidCtxt, sDTDName);
@@ -38,6 +38,9 @@ std::string getXmlChildrenAsString(const xmlDocPtr xmlDoc, const xmlNodePtr& xml
 
 void registerDTDEntityLoader(const std::string& sID, const std::string& sDTD);
 
+// Returns a DTD that can be shared by several parsers. Free it using xmlFreeDtd().
+xmlDtdPtr parseDTD(const std::string& sDTD, const std::string& sDTDName);
+
 class XMLParser
 {
 public:
@@ -46,6 +49,8 @@ public:
 
     void setSchema(const std::string& sSchema, const std::string& sSchemaName);
     void setDTD(const std::string& sDTD, const std::string& sDTDName);
+    // pDTD is owned by the caller and must outlive the parser.
+    void setDTD(xmlDtdPtr pDTD, const std::string& sDTDName);
     void parse(const std::string& sXML, const std::string& sXMLName);
 
     xmlDocPtr getDoc();
@@ -62,6 +67,7 @@ private:
     xmlSchemaValidCtxtPtr m_SchemaValidCtxt;
 
     xmlDtdPtr m_DTD;
+    bool m_bOwnsDTD;
     xmlValidCtxtPtr m_DTDValidCtxt;
     
     xmlDocPtr m_Doc;
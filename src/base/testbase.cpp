@@ -23,6 +23,7 @@
 #include "Queue.h"
 #include "Command.h"
 #include "WorkerThread.h"
+#include "ThreadPool.h"
 #include "ObjectCounter.h"
 #include "triangulate/Triangulate.h"
 #include "GLMHelper.h"
@@ -42,12 +43,16 @@
 #include "TimeSource.h"
 #include "XMLHelper.h"
 #include "Logger.h"
+#include "FrameStats.h"
+#include "TraceRecorder.h"
+#include "ScopeTimer.h"
 
 #include <boost/thread/thread.hpp>
 
 #include <boost/bind.hpp>
 
 #include <iostream>
+#include <new>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -162,16 +167,19 @@ public:
 
     void runTests() 
     {
-        runSingleThreadTests();
+        runSingleThreadTests(false);
+        runSingleThreadTests(true);
         runMultiThreadTests();
+        runLockFreeTests();
     }
 
 private:
     typedef Queue<int>::QElementPtr ElemPtr;
     
-    void runSingleThreadTests()
+    void runSingleThreadTests(bool bLockFree)
     {
-        Queue<string> q;
+        Queue<string> q(bLockFree ? 4 : -1, bLockFree);
+        TEST(q.isLockFree() == bLockFree);
         typedef Queue<string>::QElementPtr ElemPtr;
         TEST(q.empty());
         q.push(ElemPtr(new string("1")));
@@ -189,6 +197,12 @@ private:
         TEST(q.empty());
         ElemPtr pElem = q.pop(false);
         TEST(!pElem);
+        TEST(!q.peek(false));
+        for (int i=0; i<3; ++i) {
+            q.push(ElemPtr(new string("5")));
+        }
+        q.clear();
+        TEST(q.empty());
     }
 
     void runMultiThreadTests()
@@ -221,6 +235,42 @@ private:
         }
     }
 
+    void runLockFreeTests()
+    {
+        {
+            // Ring size is rounded up to 16 internally, but push() still blocks at 10.
+            Queue<int> q(10, true);
+            TEST(q.getMaxSize() == 10);
+            thread pusher(boost::bind(&pushThread, &q, 100));
+            thread popper(boost::bind(&popThread, &q, 100));
+            pusher.join();
+            popper.join();
+            TEST(q.empty());
+        }
+        {
+            Queue<int> q(3, true);
+            thread pusher(boost::bind(&pushSequenceThread, &q, 10000));
+            int i = 0;
+            bool bOrderOK = true;
+            do {
+                ElemPtr pElem = q.pop();
+                bOrderOK &= (*pElem == i);
+                i++;
+            } while (i < 10000);
+            pusher.join();
+            TEST(bOrderOK);
+            TEST(q.empty());
+        }
+        {
+            Queue<int> q(10, true);
+            thread pusher(boost::bind(&pushClearThread, &q, 100));
+            thread popper(boost::bind(&popClearThread, &q));
+            pusher.join();
+            popper.join();
+            TEST(q.empty());
+        }
+    }
+
     static void pushThread(Queue<int>* pq, int numPushes)
     {
         for (int i=0; i<numPushes; ++i) {
@@ -238,6 +288,13 @@ private:
         }
     }
 
+    static void pushSequenceThread(Queue<int>* pq, int numPushes)
+    {
+        for (int i=0; i<numPushes; ++i) {
+            pq->push(ElemPtr(new int(i)));
+        }
+    }
+
     static void pushClearThread(Queue<int>* pq, int numPushes)
     {
         typedef Queue<int>::QElementPtr ElemPtr;
@@ -332,6 +389,115 @@ public:
 };
 
 
+class ThreadPoolTest: public Test
+{
+public:
+    ThreadPoolTest()
+        : Test("ThreadPoolTest", 2)
+    {
+    }
+
+    void runTests() 
+    {
+        ThreadPool* pPool = ThreadPool::get();
+        int oldNumThreads = pPool->getNumThreads();
+
+        pPool->setNumThreads(3);
+        TEST(pPool->getNumThreads() == 3);
+        vector<int> rowCounts(1000, 0);
+        pPool->runRowBands(1000, 1000, 
+                boost::bind(&ThreadPoolTest::countRows, &rowCounts, _1, _2));
+        TEST(count(rowCounts.begin(), rowCounts.end(), 1) == 1000);
+
+        // Small images aren't split.
+        m_NumCalls = 0;
+        pPool->runRowBands(10, 10, boost::bind(&ThreadPoolTest::countCall, this, _1, _2));
+        TEST(m_NumCalls == 1);
+        
+        // Nested calls run on the calling thread.
+        rowCounts.assign(1000, 0);
+        pPool->runRowBands(10, 1000000, boost::bind(&ThreadPoolTest::runNested, this,
+                &rowCounts, _1, _2));
+        TEST(count(rowCounts.begin(), rowCounts.end(), 10) == 1000);
+
+        bool bExceptionThrown = false;
+        try {
+            pPool->runRowBands(1000, 1000, 
+                    boost::bind(&ThreadPoolTest::throwException, _1, _2));
+        } catch (const Exception&) {
+            bExceptionThrown = true;
+        }
+        TEST(bExceptionThrown);
+
+        // Other exceptions are reported as avg exceptions after all bands are done.
+        bExceptionThrown = false;
+        try {
+            pPool->runRowBands(1000, 1000, 
+                    boost::bind(&ThreadPoolTest::throwStdException, _1, _2));
+        } catch (const Exception&) {
+            bExceptionThrown = true;
+        }
+        TEST(bExceptionThrown);
+        rowCounts.assign(1000, 0);
+        pPool->runRowBands(1000, 1000, 
+                boost::bind(&ThreadPoolTest::countRows, &rowCounts, _1, _2));
+        TEST(count(rowCounts.begin(), rowCounts.end(), 1) == 1000);
+
+        pPool->setNumThreads(0);
+        rowCounts.assign(1000, 0);
+        pPool->runRowBands(1000, 1000, 
+                boost::bind(&ThreadPoolTest::countRows, &rowCounts, _1, _2));
+        TEST(count(rowCounts.begin(), rowCounts.end(), 1) == 1000);
+
+        pPool->setNumThreads(oldNumThreads);
+    }
+
+private:
+    static void countRows(vector<int>* pRowCounts, int startRow, int endRow)
+    {
+        for (int y = startRow; y < endRow; ++y) {
+            (*pRowCounts)[y]++;
+        }
+    }
+
+    void countCall(int startRow, int endRow)
+    {
+        m_NumCalls++;
+    }
+
+    void runNested(vector<int>* pRowCounts, int startRow, int endRow)
+    {
+        for (int i = startRow; i < endRow; ++i) {
+            vector<int> rowCounts(1000, 0);
+            ThreadPool::get()->runRowBands(1000, 1000, 
+                    boost::bind(&ThreadPoolTest::countRows, &rowCounts, _1, _2));
+            // Different bands add to the same rows.
+            avg::lock_guard lock(m_Mutex);
+            for (int y = 0; y < 1000; ++y) {
+                (*pRowCounts)[y] += rowCounts[y];
+            }
+        }
+    }
+
+    static void throwException(int startRow, int endRow)
+    {
+        if (startRow > 0) {
+            throw Exception(AVG_ERR_UNKNOWN, "ThreadPoolTest");
+        }
+    }
+
+    static void throwStdException(int startRow, int endRow)
+    {
+        if (startRow > 0) {
+            throw std::bad_alloc();
+        }
+    }
+
+    int m_NumCalls;
+    boost::mutex m_Mutex;
+};
+
+
 class DummyClass
 {
 public:
@@ -922,6 +1088,29 @@ public:
             parser.setDTD(sDTD, "shiporder.dtd");
             parser.parse(sXmlString, "shiporder.xml");
         }
+        {
+            string sDTD =
+                "<!ELEMENT shiporder (orderperson)* >"
+                "<!ATTLIST shiporder"
+                "    orderid CDATA #REQUIRED>"
+                "<!ELEMENT orderperson (#PCDATA) >";
+            xmlDtdPtr pDTD = parseDTD(sDTD, "shiporder.dtd");
+            for (int i = 0; i < 2; ++i) {
+                XMLParser parser;
+                parser.setDTD(pDTD, "shiporder.dtd");
+                parser.parse(sXmlString, "shiporder.xml");
+            }
+            bool bExceptionThrown = false;
+            try {
+                XMLParser parser;
+                parser.setDTD(pDTD, "shiporder.dtd");
+                parser.parse("<shiporder/>", "invalid.xml");
+            } catch (const Exception&) {
+                bExceptionThrown = true;
+            }
+            TEST(bExceptionThrown);
+            xmlFreeDtd(pDTD);
+        }
     }
 };
 
@@ -983,6 +1172,288 @@ public:
     }
 };
 
+class FrameStatsTest: public Test
+{
+public:
+    FrameStatsTest()
+      : Test("FrameStatsTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        FrameStats stats(100);
+        FrameStatsSummary summary = stats.getSummary();
+        TEST(summary.m_NumFrames == 0);
+        TEST(summary.m_Frame.m_Max == 0);
+
+        // 200 frames: Only the last 100 (frame times 100-199) are kept.
+        for (int i=0; i<200; ++i) {
+            FrameStats::Record record;
+            record.m_FrameTime = i;
+            record.m_Durations[FrameStats::FRAME] = (i%100+1)*1000;
+            record.m_Durations[FrameStats::RENDER] = 500;
+            record.m_bLate = (i%10 == 0);
+            stats.addFrame(record);
+        }
+        TEST(stats.getNumFrames() == 100);
+        TEST(stats.getFrame(0).m_FrameTime == 100);
+        TEST(stats.getFrame(99).m_FrameTime == 199);
+        summary = stats.getSummary();
+        TEST(summary.m_NumFrames == 100);
+        TEST(summary.m_NumLateFrames == 10);
+        TEST(almostEqual(summary.m_Frame.m_P50, 50.f));
+        TEST(almostEqual(summary.m_Frame.m_P95, 95.f));
+        TEST(almostEqual(summary.m_Frame.m_P99, 99.f));
+        TEST(almostEqual(summary.m_Frame.m_Max, 100.f));
+        TEST(almostEqual(summary.m_Render.m_P99, 0.5f));
+        TEST(summary.m_Swap.m_Max == 0);
+
+        stats.clear();
+        TEST(stats.getNumFrames() == 0);
+    }
+};
+
+static ProfilingZoneID TraceOuterProfilingZone("Trace outer");
+static ProfilingZoneID TraceInnerProfilingZone("Trace \"inner\"", true);
+
+class TraceRecorderTest: public Test
+{
+public:
+    TraceRecorderTest()
+      : Test("TraceRecorderTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        TraceRecorder* pRecorder = TraceRecorder::get();
+        TEST(!pRecorder->isRecording());
+        pRecorder->start();
+        TEST(pRecorder->isRecording());
+        {
+            ScopeTimer timer(TraceOuterProfilingZone);
+            {
+                ScopeTimer timer(TraceInnerProfilingZone);
+            }
+        }
+        boost::thread workerThread(&TraceRecorderTest::traceInThread);
+        workerThread.join();
+        pRecorder->stop();
+        TEST(!pRecorder->isRecording());
+        {
+            ScopeTimer timer(TraceOuterProfilingZone);
+        }
+        TEST(pRecorder->getNumDroppedEvents() == 0);
+
+        string sTrace = writeAndRead();
+        TEST(sTrace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+        TEST(countSubstr(sTrace, "\"name\":\"Trace outer\",\"ph\":\"B\"") == 1);
+        TEST(countSubstr(sTrace, "\"name\":\"Trace outer\",\"ph\":\"E\"") == 1);
+        TEST(countSubstr(sTrace, "\"name\":\"Trace \\\"inner\\\"\",\"ph\":\"B\"") 
+                == 2);
+        TEST(countSubstr(sTrace, "\"args\":{\"name\":\"tracetestworker\"}") == 1);
+
+        // A new session discards old events; full buffers drop events.
+        pRecorder->start(2);
+        for (int i=0; i<3; ++i) {
+            ScopeTimer timer(TraceOuterProfilingZone);
+        }
+        pRecorder->stop();
+        TEST(pRecorder->getNumDroppedEvents() == 4);
+        sTrace = writeAndRead();
+        TEST(countSubstr(sTrace, "\"ph\":\"B\"") == 1);
+        TEST(countSubstr(sTrace, "\"ph\":\"E\"") == 1);
+        TEST(countSubstr(sTrace, "tracetestworker") == 0);
+    }
+
+private:
+    static void traceInThread()
+    {
+        ThreadProfiler* pProfiler = ThreadProfiler::get();
+        pProfiler->setName("tracetestworker");
+        {
+            ScopeTimer timer(TraceInnerProfilingZone);
+        }
+        pProfiler->kill();
+    }
+
+    string writeAndRead()
+    {
+        TraceRecorder::get()->writeChromeTrace("trace.json");
+        string sTrace;
+        readWholeFile("trace.json", sTrace);
+        unlink("trace.json");
+        return sTrace;
+    }
+
+    int countSubstr(const string& s, const string& sSubstr)
+    {
+        int count = 0;
+        string::size_type pos = s.find(sSubstr);
+        while (pos != string::npos) {
+            count++;
+            pos = s.find(sSubstr, pos+1);
+        }
+        return count;
+    }
+};
+
+class RecordingLogSink: public ILogSink
+{
+public:
+    RecordingLogSink()
+        : m_bBlocked(false)
+    {
+    }
+
+    virtual void logMessage(const tm* pTime, unsigned millis,
+            const category_t& category, severity_t severity, const UTF8String& sMsg)
+    {
+        boost::unique_lock<boost::mutex> lock(m_Mutex);
+        while (m_bBlocked) {
+            m_Cond.wait(lock);
+        }
+        m_Messages.push_back(sMsg);
+    }
+
+    void setBlocked(bool bBlocked)
+    {
+        boost::unique_lock<boost::mutex> lock(m_Mutex);
+        m_bBlocked = bBlocked;
+        m_Cond.notify_all();
+    }
+
+    vector<string> getMessages()
+    {
+        boost::unique_lock<boost::mutex> lock(m_Mutex);
+        return m_Messages;
+    }
+
+private:
+    vector<string> m_Messages;
+    bool m_bBlocked;
+    boost::mutex m_Mutex;
+    boost::condition m_Cond;
+};
+
+typedef boost::shared_ptr<RecordingLogSink> RecordingLogSinkPtr;
+
+class AsyncLoggerTest: public Test
+{
+public:
+    AsyncLoggerTest()
+      : Test("AsyncLoggerTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        Logger *logger = Logger::get();
+        logger->removeStdLogSink();
+        category_t asyncCat = logger->configureCategory("ASYNC_TEST",
+                Logger::severity::INFO);
+        {
+            // Records arrive in order and are all delivered by flush().
+            RecordingLogSinkPtr pSink(new RecordingLogSink);
+            logger->addLogSink(pSink);
+            logger->setAsync(true);
+            TEST(logger->isAsync());
+            unsigned numDropped = logger->getNumDroppedRecords();
+            for (int i=0; i<100; ++i) {
+                AVG_TRACE(asyncCat, Logger::severity::INFO, i);
+            }
+            AVG_TRACE(asyncCat, Logger::severity::DEBUG, "filtered");
+            logger->flush();
+            vector<string> messages = pSink->getMessages();
+            TEST(messages.size() == 100);
+            bool bInOrder = true;
+            for (unsigned i=0; i<messages.size(); ++i) {
+                bInOrder &= (messages[i] == toString(i));
+            }
+            TEST(bInOrder);
+            TEST(logger->getNumDroppedRecords() == numDropped);
+            logger->setAsync(false);
+            TEST(!logger->isAsync());
+            logger->removeLogSink(pSink);
+        }
+        {
+            // A stuck sink doesn't block logging; surplus records are counted.
+            RecordingLogSinkPtr pSink(new RecordingLogSink);
+            logger->addLogSink(pSink);
+            logger->setAsync(true);
+            pSink->setBlocked(true);
+            unsigned numDropped = logger->getNumDroppedRecords();
+            unsigned numRecords = 10000;
+            for (unsigned i=0; i<numRecords; ++i) {
+                AVG_TRACE(asyncCat, Logger::severity::INFO, i);
+            }
+            pSink->setBlocked(false);
+            logger->flush();
+            numDropped = logger->getNumDroppedRecords() - numDropped;
+            TEST(numDropped > 0);
+            TEST(pSink->getMessages().size() + numDropped == numRecords);
+            logger->setAsync(false);
+            logger->removeLogSink(pSink);
+        }
+        {
+            // Sinks can be added and removed while the log thread is inside a sink.
+            RecordingLogSinkPtr pSink(new RecordingLogSink);
+            RecordingLogSinkPtr pOtherSink(new RecordingLogSink);
+            logger->addLogSink(pSink);
+            logger->setAsync(true);
+            pSink->setBlocked(true);
+            AVG_TRACE(asyncCat, Logger::severity::INFO, "blocked");
+            msleep(10);
+            logger->addLogSink(pOtherSink);
+            logger->removeLogSink(pOtherSink);
+            pSink->setBlocked(false);
+            logger->flush();
+            TEST(pSink->getMessages().size() == 1);
+            logger->setAsync(false);
+            logger->removeLogSink(pSink);
+        }
+        {
+            // Records logged while async mode is switched off are all delivered.
+            RecordingLogSinkPtr pSink(new RecordingLogSink);
+            logger->addLogSink(pSink);
+            logger->setAsync(true);
+            unsigned numDropped = logger->getNumDroppedRecords();
+            boost::thread logThread(boost::bind(&AsyncLoggerTest::logRecords, asyncCat,
+                    10000));
+            msleep(1);
+            logger->setAsync(false);
+            logThread.join();
+            numDropped = logger->getNumDroppedRecords() - numDropped;
+            TEST(pSink->getMessages().size() + numDropped == 10000);
+            logger->removeLogSink(pSink);
+        }
+        {
+            // Synchronous mode still works, including for unknown categories.
+            RecordingLogSinkPtr pSink(new RecordingLogSink);
+            logger->addLogSink(pSink);
+            AVG_TRACE(asyncCat, Logger::severity::WARNING, "sync");
+            TEST(pSink->getMessages().size() == 1);
+            bool bExceptionThrown = false;
+            try {
+                AVG_TRACE("NO_SUCH_CATEGORY", Logger::severity::WARNING, "foo");
+            } catch (Exception&) {
+                bExceptionThrown = true;
+            }
+            TEST(bExceptionThrown);
+            logger->removeLogSink(pSink);
+        }
+    }
+
+private:
+    static void logRecords(category_t category, int numRecords)
+    {
+        for (int i=0; i<numRecords; ++i) {
+            AVG_TRACE(category, Logger::severity::INFO, i);
+        }
+    }
+};
+
 class BaseTestSuite: public TestSuite
 {
 public:
@@ -992,6 +1463,7 @@ public:
         addTest(TestPtr(new DAGTest));
         addTest(TestPtr(new QueueTest));
         addTest(TestPtr(new WorkerThreadTest));
+        addTest(TestPtr(new ThreadPoolTest));
         addTest(TestPtr(new ObjectCounterTest));
         addTest(TestPtr(new GeomTest));
         addTest(TestPtr(new TriangleTest));
@@ -1005,6 +1477,9 @@ public:
         addTest(TestPtr(new PolygonTest));
         addTest(TestPtr(new XmlParserTest));
         addTest(TestPtr(new StandardLoggerTest));
+        addTest(TestPtr(new AsyncLoggerTest));
+        addTest(TestPtr(new FrameStatsTest));
+        addTest(TestPtr(new TraceRecorderTest));
     }
 };
 
@@ -32,6 +32,9 @@
 #include "../base/MathHelper.h"
 #include "../base/FileHelper.h"
 #include "../base/OSHelper.h"
+#include "../base/ThreadPool.h"
+
+#include <boost/bind.hpp>
 
 #include <gdk-pixbuf/gdk-pixbuf.h>
 
@@ -1261,28 +1264,34 @@ void YUV411toBGR32Line(const unsigned char* pSrcLine, Pixel32* pDestLine, int wi
 void Bitmap::YCbCrtoBGR(const Bitmap& origBmp)
 {
     AVG_ASSERT(m_PF==B8G8R8X8);
-    const unsigned char * pSrc = origBmp.getPixels();
-    Pixel32 * pDest = (Pixel32*)m_pBits;
     int height = min(origBmp.getSize().y, m_Size.y);
+    ThreadPool::get()->runRowBands(height, m_Size.x,
+            boost::bind(&Bitmap::YCbCrtoBGRRows, this, boost::cref(origBmp), _1, _2));
+}
+
+void Bitmap::YCbCrtoBGRRows(const Bitmap& origBmp, int startRow, int endRow)
+{
     int width = min(origBmp.getSize().x, m_Size.x);
     int StrideInPixels = m_Stride/getBytesPerPixel();
+    const unsigned char * pSrc = origBmp.getPixels()+size_t(startRow)*origBmp.getStride();
+    Pixel32 * pDest = (Pixel32*)m_pBits+size_t(startRow)*StrideInPixels;
     switch(origBmp.m_PF) {
         case YCbCr422:
-            for (int y = 0; y < height; ++y) {
+            for (int y = startRow; y < endRow; ++y) {
                 UYVY422toBGR32Line(pSrc, pDest, width);
                 pDest += StrideInPixels;
                 pSrc += origBmp.getStride();
             }
             break;
         case YUYV422:
-            for (int y = 0; y < height; ++y) {
+            for (int y = startRow; y < endRow; ++y) {
                 YUYV422toBGR32Line(pSrc, pDest, width);
                 pDest += StrideInPixels;
                 pSrc += origBmp.getStride();
             }
             break;
         case YCbCr411:
-            for (int y = 0; y < height; ++y) {
+            for (int y = startRow; y < endRow; ++y) {
                 YUV411toBGR32Line(pSrc, pDest, width);
                 pDest += StrideInPixels;
                 pSrc += origBmp.getStride();
@@ -1397,13 +1406,20 @@ void Bitmap::I8toRGB(const Bitmap& origBmp)
 {
     AVG_ASSERT(getBytesPerPixel() == 4 || getBytesPerPixel() == 3);
     AVG_ASSERT(origBmp.getBytesPerPixel() == 1);
-    const unsigned char * pSrc = origBmp.getPixels();
     int height = min(origBmp.getSize().y, m_Size.y);
+    ThreadPool::get()->runRowBands(height, m_Size.x,
+            boost::bind(&Bitmap::I8toRGBRows, this, boost::cref(origBmp), _1, _2));
+}
+
+void Bitmap::I8toRGBRows(const Bitmap& origBmp, int startRow, int endRow)
+{
+    const unsigned char * pSrc = origBmp.getPixels()+size_t(startRow)*origBmp.getStride();
     int width = min(origBmp.getSize().x, m_Size.x);
     if (getBytesPerPixel() == 4) {
-        unsigned int * pDest = (unsigned int *)m_pBits;
         int destStrideInPixels = m_Stride/getBytesPerPixel();
-        for (int y = 0; y < height; ++y) {
+        unsigned int * pDest = (unsigned int *)m_pBits+
+                size_t(startRow)*destStrideInPixels;
+        for (int y = startRow; y < endRow; ++y) {
             const unsigned char * pSrcPixel = pSrc;
             unsigned int * pDestPixel = pDest;
             for (int x = 0; x < width; ++x) {
@@ -1416,8 +1432,8 @@ void Bitmap::I8toRGB(const Bitmap& origBmp)
             pSrc += origBmp.getStride();
         }
     } else {
-        unsigned char * pDest = m_pBits;
-        for (int y = 0; y < height; ++y) {
+        unsigned char * pDest = m_pBits+size_t(startRow)*m_Stride;
+        for (int y = startRow; y < endRow; ++y) {
             const unsigned char * pSrcPixel = pSrc;
             unsigned char * pDestPixel = pDest;
             for (int x = 0; x < width; ++x) {
@@ -1457,11 +1473,19 @@ void Bitmap::FloatRGBAtoByteRGBA(const Bitmap& origBmp)
 {
     AVG_ASSERT(getBytesPerPixel() == 4);
     AVG_ASSERT(origBmp.getPixelFormat() == R32G32B32A32F);
-    const float * pSrc = (const float *)origBmp.getPixels();
     int height = min(origBmp.getSize().y, m_Size.y);
+    ThreadPool::get()->runRowBands(height, m_Size.x,
+            boost::bind(&Bitmap::FloatRGBAtoByteRGBARows, this, boost::cref(origBmp),
+                    _1, _2));
+}
+
+void Bitmap::FloatRGBAtoByteRGBARows(const Bitmap& origBmp, int startRow, int endRow)
+{
+    const float * pSrc = (const float *)(origBmp.getPixels()+
+            size_t(startRow)*origBmp.getStride());
     int width = min(origBmp.getSize().x, m_Size.x);
-    unsigned char * pDest = m_pBits;
-    for (int y = 0; y < height; ++y) {
+    unsigned char * pDest = m_pBits+size_t(startRow)*m_Stride;
+    for (int y = startRow; y < endRow; ++y) {
         const float * pSrcPixel = pSrc;
         unsigned char * pDestPixel = pDest;
         for (int x = 0; x < width*4; ++x) {
@@ -1579,7 +1603,15 @@ void Bitmap::BY8toRGBBilinear(const Bitmap& origBmp)
     AVG_ASSERT(getBytesPerPixel() == 4);
     AVG_ASSERT(pixelFormatIsBayer(origBmp.getPixelFormat()));
 
+    // The first and last lines aren't converted.
     int height = min(origBmp.getSize().y, m_Size.y);
+    ThreadPool::get()->runRowBands(max(height-2, 0), m_Size.x,
+            boost::bind(&Bitmap::BY8toRGBBilinearRows, this, boost::cref(origBmp),
+                    _1, _2));
+}
+
+void Bitmap::BY8toRGBBilinearRows(const Bitmap& origBmp, int startRow, int endRow)
+{
     int width = min(origBmp.getSize().x, m_Size.x);
 
     const int srcStride = width;
@@ -1601,12 +1633,18 @@ void Bitmap::BY8toRGBBilinear(const Bitmap& origBmp)
     } else {
         greenFirst = 0;
     }
+    // The pattern alternates between lines.
+    if (startRow%2 == 1) {
+        blue = -blue;
+        greenFirst = !greenFirst;
+    }
 
-    const unsigned char *pSrcPixel = origBmp.getPixels();
-    unsigned char *pDestPixel = (unsigned char *) getPixels();
+    const unsigned char *pSrcPixel = origBmp.getPixels() + size_t(startRow)*srcStride;
+    unsigned char *pDestPixel = (unsigned char *) getPixels() + 
+            size_t(startRow)*destStride;
 
     pDestPixel += destStride + 4 + 1;
-    height -= 2;
+    int height = endRow-startRow;
     width -= 2;
 
     while (height--) {
@@ -110,15 +110,19 @@ private:
     void initWithData(unsigned char* pBits, int stride, bool bCopyBits);
     void allocBits(int stride=0);
     void YCbCrtoBGR(const Bitmap& origBmp);
+    void YCbCrtoBGRRows(const Bitmap& origBmp, int startRow, int endRow);
     void YCbCrtoI8(const Bitmap& origBmp);
     void I8toI16(const Bitmap& origBmp);
     void I8toRGB(const Bitmap& origBmp);
+    void I8toRGBRows(const Bitmap& origBmp, int startRow, int endRow);
     void I16toI8(const Bitmap& origBmp);
     void BGRtoB5G6R5(const Bitmap& origBmp);
     void ByteRGBAtoFloatRGBA(const Bitmap& origBmp);
     void FloatRGBAtoByteRGBA(const Bitmap& origBmp);
+    void FloatRGBAtoByteRGBARows(const Bitmap& origBmp, int startRow, int endRow);
     void BY8toRGBNearest(const Bitmap& origBmp);
     void BY8toRGBBilinear(const Bitmap& origBmp);
+    void BY8toRGBBilinearRows(const Bitmap& origBmp, int startRow, int endRow);
 
     IntPoint m_Size;
     int m_Stride;
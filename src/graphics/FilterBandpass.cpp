@@ -23,6 +23,11 @@
 #include "Filterfill.h"
 #include "Pixel8.h"
 #include "Bitmap.h"
+#include "SIMDKernels.h"
+
+#include "../base/ThreadPool.h"
+
+#include <boost/bind.hpp>
 
 #include <iostream>
 #include <math.h>
@@ -49,18 +54,31 @@ BitmapPtr FilterBandpass::apply(BitmapPtr pBmpSrc)
 
     IntPoint Size = pHPBmp->getSize();
     BitmapPtr pDestBmp = BitmapPtr(new Bitmap(Size, I8, pBmpSrc->getName()));
+    ThreadPool::get()->runRowBands(Size.y, Size.x, 
+            boost::bind(&FilterBandpass::subtractRows, this, pLPBmp.get(), pHPBmp.get(),
+                    pDestBmp.get(), _1, _2));
+    return pDestBmp;
+}
 
+void FilterBandpass::subtractRows(Bitmap* pLPBmp, Bitmap* pHPBmp, Bitmap* pDestBmp,
+        int startRow, int endRow)
+{
+    IntPoint Size = pDestBmp->getSize();
     int lpStride = pLPBmp->getStride();
     int hpStride = pHPBmp->getStride();
     int destStride = pDestBmp->getStride();
-    unsigned char * pLPLine = pLPBmp->getPixels()+m_FilterWidthDiff*lpStride;
-    unsigned char * pHPLine = pHPBmp->getPixels();
-    unsigned char * pDestLine = pDestBmp->getPixels();
-    for (int y = 0; y < Size.y; ++y) {
+    unsigned char * pLPLine = pLPBmp->getPixels()+(startRow+m_FilterWidthDiff)*lpStride;
+    unsigned char * pHPLine = pHPBmp->getPixels()+startRow*hpStride;
+    unsigned char * pDestLine = pDestBmp->getPixels()+startRow*destStride;
+    for (int y = startRow; y < endRow; ++y) {
         unsigned char * pLPPixel = pLPLine+m_FilterWidthDiff;
         unsigned char * pHPPixel = pHPLine;
         unsigned char * pDestPixel = pDestLine;
-        for (int x = 0; x < Size.x; ++x) {
+        int x0 = bandpassSubtractRow(pLPPixel, pHPPixel, pDestPixel, Size.x);
+        pLPPixel += x0;
+        pHPPixel += x0;
+        pDestPixel += x0;
+        for (int x = x0; x < Size.x; ++x) {
             *pDestPixel = (int(*pLPPixel)-*pHPPixel)+128;
             ++pLPPixel;
             ++pHPPixel;
@@ -70,7 +88,6 @@ BitmapPtr FilterBandpass::apply(BitmapPtr pBmpSrc)
         pHPLine += hpStride;
         pDestLine += destStride;
     }
-    return pDestBmp;
 }
 
 
@@ -25,6 +25,9 @@
 #include "Bitmap.h"
 
 #include "../base/Exception.h"
+#include "../base/ThreadPool.h"
+
+#include <boost/bind.hpp>
 
 #include <iostream>
 #include <math.h>
@@ -47,11 +50,20 @@ BitmapPtr FilterBlur::apply(BitmapPtr pBmpSrc)
     
     IntPoint Size(pBmpSrc->getSize().x-2, pBmpSrc->getSize().y-2);
     BitmapPtr pDestBmp = BitmapPtr(new Bitmap(Size, I8, pBmpSrc->getName()));
-    int srcStride = pBmpSrc->getStride();
+    ThreadPool::get()->runRowBands(Size.y, Size.x, 
+            boost::bind(&FilterBlur::blurRows, this, pBmpSrc.get(), pDestBmp.get(),
+                    _1, _2));
+    return pDestBmp;
+}
+
+void FilterBlur::blurRows(Bitmap* pSrcBmp, Bitmap* pDestBmp, int startRow, int endRow)
+{
+    IntPoint Size = pDestBmp->getSize();
+    int srcStride = pSrcBmp->getStride();
     int destStride = pDestBmp->getStride();
-    unsigned char * pSrcLine = pBmpSrc->getPixels()+srcStride+1;
-    unsigned char * pDestLine = pDestBmp->getPixels();
-    for (int y = 0; y < Size.y; ++y) {
+    unsigned char * pSrcLine = pSrcBmp->getPixels()+(startRow+1)*srcStride+1;
+    unsigned char * pDestLine = pDestBmp->getPixels()+startRow*destStride;
+    for (int y = startRow; y < endRow; ++y) {
         unsigned char * pSrcPixel = pSrcLine;
         unsigned char * pDestPixel = pDestLine;
         for (int x = 0; x < Size.x; ++x) {
@@ -63,7 +75,6 @@ BitmapPtr FilterBlur::apply(BitmapPtr pBmpSrc)
         pSrcLine += srcStride;
         pDestLine += destStride;
     }
-    return pDestBmp;
 }
 
 }
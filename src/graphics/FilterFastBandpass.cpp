@@ -24,6 +24,7 @@
 #include "Filterfill.h"
 #include "Pixel8.h"
 #include "Bitmap.h"
+#include "SIMDKernels.h"
 
 #include "../base/Exception.h"
 
@@ -59,7 +60,10 @@ BitmapPtr FilterFastBandpass::apply(BitmapPtr pBmpSrc)
         *pDstPixel++ = 128;
         *pDstPixel++ = 128;
         *pDstPixel++ = 128;
-        for (int x = 3; x < size.x-3; ++x) {
+        int x0 = fastBandpassRow(pSrcPixel, srcStride, pDstPixel, size.x-6);
+        pSrcPixel += x0;
+        pDstPixel += x0;
+        for (int x = 3+x0; x < size.x-3; ++x) {
             // Convolution Matrix is
             //  0  0  0  0  0  0  0 
             //  0 -2  0  0  0 -2  0
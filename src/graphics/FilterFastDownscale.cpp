@@ -21,6 +21,7 @@
 
 #include "FilterFastDownscale.h"
 #include "Pixeldefs.h"
+#include "SIMDKernels.h"
 
 #include "../base/Exception.h"
 
@@ -53,9 +54,13 @@ BitmapPtr FilterFastDownscale::apply(BitmapPtr pBmpSrc)
     for (int y = 0; y < size.y; ++y) {
         unsigned char * pSrcPixel = pSrcLine;
         unsigned char * pDstPixel = pDestLine;
+        int x0;
         switch (m_Factor) {
             case 2:
-                for (int x = 0; x < size.x; ++x) {
+                x0 = downscaleRow2x2(pSrcPixel, srcStride, pDstPixel, size.x);
+                pSrcPixel += 2*x0;
+                pDstPixel += x0;
+                for (int x = x0; x < size.x; ++x) {
                     int dstPixel= int(*pSrcPixel)+int(*(pSrcPixel+1))
                             +int(*(pSrcPixel+srcStride))+int(*(pSrcPixel+srcStride+1));
                     *pDstPixel = (dstPixel+2)/4;
@@ -23,9 +23,13 @@
 #include "Filterfill.h"
 #include "Pixel8.h"
 #include "Bitmap.h"
+#include "SIMDKernels.h"
 
 #include "../base/MathHelper.h"
 #include "../base/Exception.h"
+#include "../base/ThreadPool.h"
+
+#include <boost/bind.hpp>
 
 #include <iostream>
 #include <math.h>
@@ -52,16 +56,37 @@ BitmapPtr FilterGauss::apply(BitmapPtr pBmpSrc)
     // Convolve in x-direction
     IntPoint tempSize(pBmpSrc->getSize().x-2*intRadius, pBmpSrc->getSize().y);
     BitmapPtr pTempBmp = BitmapPtr(new Bitmap(tempSize, I8, pBmpSrc->getName()));
-    int srcStride = pBmpSrc->getStride();
+    ThreadPool::get()->runRowBands(tempSize.y, tempSize.x, 
+            boost::bind(&FilterGauss::convolveX, this, pBmpSrc.get(), pTempBmp.get(),
+                    _1, _2));
+
+    // Convolve in y-direction
+    IntPoint destSize(tempSize.x, tempSize.y-2*intRadius);
+    BitmapPtr pDestBmp = BitmapPtr(new Bitmap(destSize, I8, pBmpSrc->getName()));
+    ThreadPool::get()->runRowBands(destSize.y, destSize.x, 
+            boost::bind(&FilterGauss::convolveY, this, pTempBmp.get(), pDestBmp.get(),
+                    _1, _2));
+    return pDestBmp;
+}
+
+void FilterGauss::convolveX(Bitmap* pSrcBmp, Bitmap* pTempBmp, int startRow, 
+        int endRow)
+{
+    int intRadius = int(ceil(m_Radius));
+    IntPoint tempSize = pTempBmp->getSize();
+    int srcStride = pSrcBmp->getStride();
     int tempStride = pTempBmp->getStride();
-    unsigned char * pSrcLine = pBmpSrc->getPixels();
-    unsigned char * pTempLine = pTempBmp->getPixels();
-    for (int y = 0; y < tempSize.y; ++y) {
+    unsigned char * pSrcLine = pSrcBmp->getPixels()+startRow*srcStride;
+    unsigned char * pTempLine = pTempBmp->getPixels()+startRow*tempStride;
+    for (int y = startRow; y < endRow; ++y) {
         unsigned char * pSrcPixel = pSrcLine+intRadius;
         unsigned char * pTempPixel = pTempLine;
+        int x0 = convolveRow(pSrcPixel, 1, pTempPixel, tempSize.x, m_Kernel, intRadius);
+        pSrcPixel += x0;
+        pTempPixel += x0;
         switch (intRadius) {
             case 3:
-                for (int x = 0; x < tempSize.x; ++x) {
+                for (int x = x0; x < tempSize.x; ++x) {
                     *pTempPixel = (*(pSrcPixel-3)*m_Kernel[0] + 
                             *(pSrcPixel-2)*m_Kernel[1] +
                             *(pSrcPixel-1)*m_Kernel[2] + 
@@ -74,7 +99,7 @@ BitmapPtr FilterGauss::apply(BitmapPtr pBmpSrc)
                 }
                 break;
             case 2:
-                for (int x = 0; x < tempSize.x; ++x) {
+                for (int x = x0; x < tempSize.x; ++x) {
                     *pTempPixel = (*(pSrcPixel-2)*m_Kernel[0] +
                             *(pSrcPixel-1)*m_Kernel[1] + 
                             *(pSrcPixel)*m_Kernel[2] +
@@ -85,7 +110,7 @@ BitmapPtr FilterGauss::apply(BitmapPtr pBmpSrc)
                 }
                 break;
             case 1:
-                for (int x = 0; x < tempSize.x; ++x) {
+                for (int x = x0; x < tempSize.x; ++x) {
                     *pTempPixel = (*(pSrcPixel-1)*m_Kernel[0] + 
                             *(pSrcPixel)*m_Kernel[1] +
                             *(pSrcPixel+1)*m_Kernel[2])/256;
@@ -109,19 +134,28 @@ BitmapPtr FilterGauss::apply(BitmapPtr pBmpSrc)
         pSrcLine += srcStride;
         pTempLine += tempStride;
     }
+}
 
-    // Convolve in y-direction
-    IntPoint destSize(tempSize.x, tempSize.y-2*intRadius);
-    BitmapPtr pDestBmp = BitmapPtr(new Bitmap(destSize, I8, pBmpSrc->getName()));
+void FilterGauss::convolveY(Bitmap* pTempBmp, Bitmap* pDestBmp, int startRow, 
+        int endRow)
+{
+    int intRadius = int(ceil(m_Radius));
+    IntPoint tempSize = pTempBmp->getSize();
+    IntPoint destSize = pDestBmp->getSize();
+    int tempStride = pTempBmp->getStride();
     int destStride = pDestBmp->getStride();
-    pTempLine = pTempBmp->getPixels()+intRadius*tempStride;
-    unsigned char * pDestLine = pDestBmp->getPixels();
-    for (int y = 0; y < destSize.y; ++y) {
+    unsigned char * pTempLine = pTempBmp->getPixels()+(startRow+intRadius)*tempStride;
+    unsigned char * pDestLine = pDestBmp->getPixels()+startRow*destStride;
+    for (int y = startRow; y < endRow; ++y) {
         unsigned char * pTempPixel = pTempLine;
         unsigned char * pDestPixel = pDestLine;
+        int x0 = convolveRow(pTempPixel, tempStride, pDestPixel, destSize.x, m_Kernel,
+                intRadius);
+        pTempPixel += x0;
+        pDestPixel += x0;
         switch (intRadius) {
             case 3:
-                for (int x = 0; x < destSize.x; ++x) {
+                for (int x = x0; x < destSize.x; ++x) {
                     *pDestPixel = (*(pTempPixel-3*tempStride)*m_Kernel[0] +
                             *(pTempPixel-2*tempStride)*m_Kernel[1] +
                             *(pTempPixel-1*tempStride)*m_Kernel[2] + 
@@ -134,7 +168,7 @@ BitmapPtr FilterGauss::apply(BitmapPtr pBmpSrc)
                 }
                 break;
             case 2:
-                for (int x = 0; x < destSize.x; ++x) {
+                for (int x = x0; x < destSize.x; ++x) {
                     *pDestPixel = (*(pTempPixel-2*tempStride)*m_Kernel[0] +
                             *(pTempPixel-1*tempStride)*m_Kernel[1] + 
                             *(pTempPixel)*m_Kernel[2] +
@@ -145,7 +179,7 @@ BitmapPtr FilterGauss::apply(BitmapPtr pBmpSrc)
                 }
                 break;
             case 1:
-                for (int x = 0; x < destSize.x; ++x) {
+                for (int x = x0; x < destSize.x; ++x) {
                     *pDestPixel = (*(pTempPixel-1*tempStride)*m_Kernel[0] + 
                             *(pTempPixel)*m_Kernel[1] +
                             *(pTempPixel+1*tempStride)*m_Kernel[2])/256;
@@ -169,7 +203,6 @@ BitmapPtr FilterGauss::apply(BitmapPtr pBmpSrc)
         pTempLine += tempStride;
         pDestLine += destStride;
     }
-    return pDestBmp;
 }
 
 void FilterGauss::dumpKernel()
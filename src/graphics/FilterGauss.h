@@ -40,6 +40,8 @@ class AVG_API FilterGauss: public Filter{
         void dumpKernel();
 
     private:
+        void convolveX(Bitmap* pSrcBmp, Bitmap* pTempBmp, int startRow, int endRow);
+        void convolveY(Bitmap* pTempBmp, Bitmap* pDestBmp, int startRow, int endRow);
         void calcKernel();
 
         float m_Radius;
@@ -21,6 +21,7 @@
 
 #include "FilterMask.h"
 #include "Pixeldefs.h"
+#include "SIMDKernels.h"
 
 #include "../base/Exception.h"
 
@@ -69,7 +70,7 @@ void FilterMask::applyInPlace(BitmapPtr pBmp)
                 }
                 break;
             case 1:
-                for (int x = 0; x < size.x; x++) { 
+                for (int x = maskRowI8(pLine, pMaskLine, size.x); x < size.x; x++) { 
                     unsigned char src = *(pMaskLine+x);
                     unsigned char * pPixel = pLine + x;
                     *pPixel = (*pPixel*src)/255;
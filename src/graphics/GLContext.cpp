@@ -86,6 +86,7 @@ GLContext::GLContext(const IntPoint& windowSize, const SDL_SysWMinfo* pSDLWMInfo
       m_bCheckedMemoryMode(false),
       m_BlendColor(0.f, 0.f, 0.f, 0.f),
       m_BlendMode(BLEND_ADD),
+      m_DrawCallCount(0),
       m_MajorGLVersion(-1)
 {
     if (s_pCurrentContext.get() == 0) {
@@ -164,6 +165,7 @@ void GLContext::init(const GLConfig& glConfig, bool bOwnsContext)
 void GLContext::deleteObjects()
 {
     m_pStandardShader = StandardShaderPtr();
+    m_TextureUploadQueue.reset();
     for (unsigned i=0; i<m_FBOIDs.size(); ++i) {
         glproc::DeleteFramebuffers(1, &(m_FBOIDs[i]));
     }
@@ -227,6 +229,11 @@ GLBufferCache& GLContext::getPBOCache()
     return m_PBOCache;
 }
 
+TextureUploadQueue& GLContext::getTextureUploadQueue()
+{
+    return m_TextureUploadQueue;
+}
+
 unsigned GLContext::genFBO()
 {
     unsigned fboID;
@@ -320,6 +327,16 @@ void GLContext::bindTexture(unsigned unit, unsigned texID)
     }
 }
 
+int GLContext::getDrawCallCount() const
+{
+    return m_DrawCallCount;
+}
+
+void GLContext::resetDrawCallCount()
+{
+    m_DrawCallCount = 0;
+}
+
 const GLConfig& GLContext::getConfig()
 {
     return m_GLConfig;
@@ -25,6 +25,7 @@
 
 #include "OGLHelper.h"
 #include "GLBufferCache.h"
+#include "TextureUploadQueue.h"
 #include "GLConfig.h"
 
 #include "../base/GLMHelper.h"
@@ -62,6 +63,7 @@ public:
     GLBufferCache& getVertexBufferCache();
     GLBufferCache& getIndexBufferCache();
     GLBufferCache& getPBOCache();
+    TextureUploadQueue& getTextureUploadQueue();
     unsigned genFBO();
     void returnFBOToCache(unsigned fboID);
 
@@ -72,6 +74,12 @@ public:
     bool isBlendModeSupported(BlendMode mode) const;
     void bindTexture(unsigned unit, unsigned texID);
 
+    // Statistics.
+    void incDrawCallCount()
+        { m_DrawCallCount++; };
+    int getDrawCallCount() const;
+    void resetDrawCallCount();
+
     const GLConfig& getConfig();
     void logConfig();
     size_t getVideoMemInstalled();
@@ -125,6 +133,7 @@ private:
     GLBufferCache m_VertexBufferCache;
     GLBufferCache m_IndexBufferCache;
     GLBufferCache m_PBOCache;
+    TextureUploadQueue m_TextureUploadQueue;
     std::vector<unsigned int> m_FBOIDs;
 
     int m_MaxTexSize;
@@ -140,6 +149,8 @@ private:
     bool m_bPremultipliedAlpha;
     unsigned m_BoundTextures[16];
 
+    int m_DrawCallCount;
+
     int m_MajorGLVersion;
     int m_MinorGLVersion;
 
@@ -47,13 +47,18 @@ using namespace std;
 // don't overlap.
 unsigned GLTexture::s_LastTexID = 10000000;
 
+// Content versions are drawn from a single counter so that a newer texture always has
+// a higher version than anything that was uploaded before it.
+unsigned GLTexture::s_LastContentVersion = 0;
+
 GLTexture::GLTexture(const IntPoint& size, PixelFormat pf, bool bMipmap,
         int potBorderColor, unsigned wrapSMode, unsigned wrapTMode, bool bForcePOT)
     : m_Size(size),
       m_pf(pf),
       m_bMipmap(bMipmap),
       m_bDeleteTex(true),
-      m_bIsDirty(true)
+      m_bIsDirty(true),
+      m_ContentVersion(++s_LastContentVersion)
 {
     m_pGLContext = GLContext::getCurrent();
     ObjectCounter::get()->incRef(&typeid(*this));
@@ -122,7 +127,8 @@ GLTexture::GLTexture(unsigned glTexID, const IntPoint& size, PixelFormat pf, boo
       m_bDeleteTex(bDeleteTex),
       m_bUsePOT(false),
       m_TexID(glTexID),
-      m_bIsDirty(true)
+      m_bIsDirty(true),
+      m_ContentVersion(++s_LastContentVersion)
 {
     m_pGLContext = GLContext::getCurrent();
     ObjectCounter::get()->incRef(&typeid(*this));
@@ -175,7 +181,7 @@ void GLTexture::unlockStreamingBmp(bool bUpdated)
     m_pMover->unlock();
     if (bUpdated) {
         m_pMover->moveToTexture(*this);
-        m_bIsDirty = true;
+        setDirty();
     }
 }
 
@@ -183,7 +189,7 @@ void GLTexture::moveBmpToTexture(BitmapPtr pBmp)
 {
     TextureMoverPtr pMover = TextureMover::create(m_Size, m_pf, GL_DYNAMIC_DRAW);
     pMover->moveBmpToTexture(pBmp, *this);
-    m_bIsDirty = true;
+    setDirty();
 }
 
 BitmapPtr GLTexture::moveTextureToBmp(int mipmapLevel)
@@ -315,6 +321,7 @@ int GLTexture::getGLInternalFormat() const
 void GLTexture::setDirty()
 {
     m_bIsDirty = true;
+    m_ContentVersion = ++s_LastContentVersion;
 }
 
 bool GLTexture::isDirty() const
@@ -327,6 +334,11 @@ void GLTexture::resetDirty()
     m_bIsDirty = false;
 }
 
+unsigned GLTexture::getContentVersion() const
+{
+    return m_ContentVersion;
+}
+
 const string wrapModeToStr(unsigned wrapMode)
 {
     string sWrapMode;
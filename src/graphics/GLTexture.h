@@ -69,6 +69,9 @@ public:
     void setDirty();
     bool isDirty() const;
     void resetDirty();
+    // Changes every time the texture contents change. Unlike the dirty flag, this
+    // isn't reset by consumers.
+    unsigned getContentVersion() const;
 
     void dump(unsigned wrapSMode=-1, unsigned wrapTMode=-1) const;
 
@@ -83,6 +86,8 @@ private:
     static unsigned s_LastTexID;
     unsigned m_TexID;
     bool m_bIsDirty;
+    static unsigned s_LastContentVersion;
+    unsigned m_ContentVersion;
     TextureMoverPtr m_pMover;
 
     GLContext* m_pGLContext;
@@ -25,6 +25,7 @@
 
 #include "Bitmap.h"
 #include "Filterfill.h"
+#include "SIMDKernels.h"
 
 #include "../base/Exception.h"
 
@@ -103,10 +104,11 @@ void HistoryPreProcessor::applyInPlace(BitmapPtr pBmp)
     unsigned char * pDest = pBmp->getPixels();
     IntPoint size = pBmp->getSize();
     for (int y = 0; y < size.y; y++) {
-        const unsigned short * pSrcPixel = pSrc;
-        unsigned char * pDestPixel = pDest;
+        int x0 = subtractHistoryRow(pDest, pSrc, size.x, m_bBrighter);
+        const unsigned short * pSrcPixel = pSrc+x0;
+        unsigned char * pDestPixel = pDest+x0;
         if (m_bBrighter) {
-            for (int x = 0; x < size.x; x++) {
+            for (int x = x0; x < size.x; x++) {
                 unsigned char Src = *pSrcPixel/256;
                 if ((*pDestPixel) > Src) {
                     *pDestPixel = *pDestPixel-Src;
@@ -117,7 +119,7 @@ void HistoryPreProcessor::applyInPlace(BitmapPtr pBmp)
                 pSrcPixel++;
             }
         } else {
-            for (int x = 0; x < size.x; x++) {
+            for (int x = x0; x < size.x; x++) {
                 unsigned char Src = *pSrcPixel/256;
                 if ((*pDestPixel) < Src) {
                     *pDestPixel = Src-*pDestPixel;
@@ -0,0 +1,352 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#include "SIMDKernels.h"
+
+#if defined(__SSE2__) || defined(_WIN32)
+#include <emmintrin.h>
+#define AVG_SIMD_SSE2
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AVG_SIMD_NEON
+#if defined(__linux__) && defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+namespace avg {
+
+static bool detectSIMD()
+{
+#if defined(AVG_SIMD_SSE2)
+#ifdef _MSC_VER
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 1);
+    return (cpuInfo[3] & (1 << 26)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (edx & bit_SSE2) != 0;
+#endif
+#elif defined(AVG_SIMD_NEON)
+#if defined(__linux__) && defined(__arm__)
+    // 32-bit arm builds can run on cores without NEON.
+    return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+    return true;
+#endif
+#else
+    return false;
+#endif
+}
+
+static bool s_bSIMDSupported = detectSIMD();
+static bool s_bSIMDEnabled = s_bSIMDSupported;
+
+bool isSIMDSupported()
+{
+    return s_bSIMDSupported;
+}
+
+bool isSIMDEnabled()
+{
+    return s_bSIMDEnabled;
+}
+
+void setSIMDEnabled(bool bEnabled)
+{
+    s_bSIMDEnabled = bEnabled && s_bSIMDSupported;
+}
+
+int subtractHistoryRow(unsigned char* pLine, const unsigned short* pHistory,
+        int width, bool bBrighter)
+{
+    int x = 0;
+    if (!s_bSIMDEnabled) {
+        return x;
+    }
+#if defined(AVG_SIMD_SSE2)
+    for (; x+16 <= width; x += 16) {
+        __m128i hist0 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(pHistory+x)), 8);
+        __m128i hist1 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(pHistory+x+8)),
+                8);
+        __m128i hist = _mm_packus_epi16(hist0, hist1);
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(pLine+x));
+        if (bBrighter) {
+            pixels = _mm_subs_epu8(pixels, hist);
+        } else {
+            pixels = _mm_subs_epu8(hist, pixels);
+        }
+        _mm_storeu_si128((__m128i*)(pLine+x), pixels);
+    }
+#elif defined(AVG_SIMD_NEON)
+    for (; x+16 <= width; x += 16) {
+        uint8x16_t hist = vcombine_u8(vshrn_n_u16(vld1q_u16(pHistory+x), 8),
+                vshrn_n_u16(vld1q_u16(pHistory+x+8), 8));
+        uint8x16_t pixels = vld1q_u8(pLine+x);
+        if (bBrighter) {
+            pixels = vqsubq_u8(pixels, hist);
+        } else {
+            pixels = vqsubq_u8(hist, pixels);
+        }
+        vst1q_u8(pLine+x, pixels);
+    }
+#endif
+    return x;
+}
+
+// Exact t/255 for t = a*b with a, b <= 255: (t + 1 + (t >> 8)) >> 8.
+int maskRowI8(unsigned char* pLine, const unsigned char* pMask, int width)
+{
+    int x = 0;
+    if (!s_bSIMDEnabled) {
+        return x;
+    }
+#if defined(AVG_SIMD_SSE2)
+    __m128i zero = _mm_setzero_si128();
+    __m128i one = _mm_set1_epi16(1);
+    for (; x+16 <= width; x += 16) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(pLine+x));
+        __m128i mask = _mm_loadu_si128((const __m128i*)(pMask+x));
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero),
+                _mm_unpacklo_epi8(mask, zero));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero),
+                _mm_unpackhi_epi8(mask, zero));
+        lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)),
+                8);
+        hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)),
+                8);
+        _mm_storeu_si128((__m128i*)(pLine+x), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(AVG_SIMD_NEON)
+    uint16x8_t one = vdupq_n_u16(1);
+    for (; x+16 <= width; x += 16) {
+        uint8x16_t pixels = vld1q_u8(pLine+x);
+        uint8x16_t mask = vld1q_u8(pMask+x);
+        uint16x8_t lo = vmull_u8(vget_low_u8(pixels), vget_low_u8(mask));
+        uint16x8_t hi = vmull_u8(vget_high_u8(pixels), vget_high_u8(mask));
+        lo = vshrq_n_u16(vaddq_u16(vaddq_u16(lo, one), vshrq_n_u16(lo, 8)), 8);
+        hi = vshrq_n_u16(vaddq_u16(vaddq_u16(hi, one), vshrq_n_u16(hi, 8)), 8);
+        vst1q_u8(pLine+x, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+#endif
+    return x;
+}
+
+int downscaleRow2x2(const unsigned char* pSrc, int srcStride, unsigned char* pDest,
+        int destWidth)
+{
+    int x = 0;
+    if (!s_bSIMDEnabled) {
+        return x;
+    }
+    const unsigned char* pSrc2 = pSrc+srcStride;
+#if defined(AVG_SIMD_SSE2)
+    __m128i lowBytes = _mm_set1_epi16(0xFF);
+    __m128i two = _mm_set1_epi16(2);
+    for (; x+16 <= destWidth; x += 16) {
+        __m128i sums[2];
+        for (int i = 0; i < 2; ++i) {
+            __m128i row0 = _mm_loadu_si128((const __m128i*)(pSrc+2*x+16*i));
+            __m128i row1 = _mm_loadu_si128((const __m128i*)(pSrc2+2*x+16*i));
+            __m128i sum = _mm_add_epi16(_mm_and_si128(row0, lowBytes),
+                    _mm_srli_epi16(row0, 8));
+            sum = _mm_add_epi16(sum, _mm_and_si128(row1, lowBytes));
+            sum = _mm_add_epi16(sum, _mm_srli_epi16(row1, 8));
+            sums[i] = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+        }
+        _mm_storeu_si128((__m128i*)(pDest+x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#elif defined(AVG_SIMD_NEON)
+    for (; x+16 <= destWidth; x += 16) {
+        uint16x8_t sum0 = vaddq_u16(vpaddlq_u8(vld1q_u8(pSrc+2*x)),
+                vpaddlq_u8(vld1q_u8(pSrc2+2*x)));
+        uint16x8_t sum1 = vaddq_u16(vpaddlq_u8(vld1q_u8(pSrc+2*x+16)),
+                vpaddlq_u8(vld1q_u8(pSrc2+2*x+16)));
+        // vrshrn rounds, giving (sum+2)/4.
+        vst1q_u8(pDest+x, vcombine_u8(vrshrn_n_u16(sum0, 2), vrshrn_n_u16(sum1, 2)));
+    }
+#endif
+    return x;
+}
+
+// The scalar code computes 128 - int(2*(a+b+c+d) - (e+f+g+h) + 2)/4 + center in int
+// and truncates the result to 8 bits. The intermediate values fit into 16 bits; the
+// signed division rounds towards zero, so negative sums are biased by 3 before the
+// arithmetic shift.
+int fastBandpassRow(const unsigned char* pSrc, int srcStride, unsigned char* pDest,
+        int width)
+{
+    int x = 0;
+    if (!s_bSIMDEnabled) {
+        return x;
+    }
+    const unsigned char* pOuterTop = pSrc-2*srcStride;
+    const unsigned char* pOuterBottom = pSrc+2*srcStride;
+    const unsigned char* pInnerTop = pSrc-srcStride;
+    const unsigned char* pInnerBottom = pSrc+srcStride;
+#if defined(AVG_SIMD_SSE2)
+    __m128i zero = _mm_setzero_si128();
+    __m128i two = _mm_set1_epi16(2);
+    __m128i three = _mm_set1_epi16(3);
+    __m128i offset = _mm_set1_epi16(128);
+    __m128i lowBytes = _mm_set1_epi16(0xFF);
+#define AVG_LOAD8(p) _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(p)), zero)
+    for (; x+8 <= width; x += 8) {
+        __m128i outer = _mm_add_epi16(
+                _mm_add_epi16(AVG_LOAD8(pOuterTop+x-2), AVG_LOAD8(pOuterTop+x+2)),
+                _mm_add_epi16(AVG_LOAD8(pOuterBottom+x-2), AVG_LOAD8(pOuterBottom+x+2)));
+        __m128i inner = _mm_add_epi16(
+                _mm_add_epi16(AVG_LOAD8(pInnerTop+x-1), AVG_LOAD8(pInnerTop+x+1)),
+                _mm_add_epi16(AVG_LOAD8(pInnerBottom+x-1), AVG_LOAD8(pInnerBottom+x+1)));
+        __m128i sum = _mm_add_epi16(_mm_sub_epi16(_mm_slli_epi16(outer, 1), inner), two);
+        sum = _mm_add_epi16(sum, _mm_and_si128(_mm_srai_epi16(sum, 15), three));
+        __m128i result = _mm_sub_epi16(_mm_add_epi16(AVG_LOAD8(pSrc+x), offset),
+                _mm_srai_epi16(sum, 2));
+        result = _mm_and_si128(result, lowBytes);
+        _mm_storel_epi64((__m128i*)(pDest+x), _mm_packus_epi16(result, result));
+    }
+#undef AVG_LOAD8
+#elif defined(AVG_SIMD_NEON)
+    int16x8_t two = vdupq_n_s16(2);
+    int16x8_t three = vdupq_n_s16(3);
+    int16x8_t offset = vdupq_n_s16(128);
+#define AVG_LOAD8(p) vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p)))
+    for (; x+8 <= width; x += 8) {
+        int16x8_t outer = vaddq_s16(
+                vaddq_s16(AVG_LOAD8(pOuterTop+x-2), AVG_LOAD8(pOuterTop+x+2)),
+                vaddq_s16(AVG_LOAD8(pOuterBottom+x-2), AVG_LOAD8(pOuterBottom+x+2)));
+        int16x8_t inner = vaddq_s16(
+                vaddq_s16(AVG_LOAD8(pInnerTop+x-1), AVG_LOAD8(pInnerTop+x+1)),
+                vaddq_s16(AVG_LOAD8(pInnerBottom+x-1), AVG_LOAD8(pInnerBottom+x+1)));
+        int16x8_t sum = vaddq_s16(vsubq_s16(vshlq_n_s16(outer, 1), inner), two);
+        sum = vaddq_s16(sum, vandq_s16(vshrq_n_s16(sum, 15), three));
+        int16x8_t result = vsubq_s16(vaddq_s16(AVG_LOAD8(pSrc+x), offset),
+                vshrq_n_s16(sum, 2));
+        vst1_u8(pDest+x, vmovn_u16(vreinterpretq_u16_s16(result)));
+    }
+#undef AVG_LOAD8
+#endif
+    return x;
+}
+
+int convolveRow(const unsigned char* pSrc, int step, unsigned char* pDest, int width,
+        const int* pKernel, int radius)
+{
+    int x = 0;
+    if (!s_bSIMDEnabled || radius < 1 || radius > 3) {
+        return x;
+    }
+    // 255*257 is the largest weighted sum that fits into an unsigned 16 bit lane.
+    int kernelSum = 0;
+    for (int i = 0; i <= 2*radius; ++i) {
+        if (pKernel[i] < 0) {
+            return x;
+        }
+        kernelSum += pKernel[i];
+    }
+    if (kernelSum > 257) {
+        return x;
+    }
+    const unsigned char* pFirstTap = pSrc-radius*step;
+    int numTaps = 2*radius+1;
+#if defined(AVG_SIMD_SSE2)
+    __m128i zero = _mm_setzero_si128();
+    __m128i weights[7];
+    for (int i = 0; i < numTaps; ++i) {
+        weights[i] = _mm_set1_epi16(short(pKernel[i]));
+    }
+    for (; x+16 <= width; x += 16) {
+        __m128i sumLo = zero;
+        __m128i sumHi = zero;
+        const unsigned char* pTap = pFirstTap+x;
+        for (int i = 0; i < numTaps; ++i) {
+            __m128i pixels = _mm_loadu_si128((const __m128i*)pTap);
+            sumLo = _mm_add_epi16(sumLo,
+                    _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), weights[i]));
+            sumHi = _mm_add_epi16(sumHi,
+                    _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), weights[i]));
+            pTap += step;
+        }
+        _mm_storeu_si128((__m128i*)(pDest+x),
+                _mm_packus_epi16(_mm_srli_epi16(sumLo, 8), _mm_srli_epi16(sumHi, 8)));
+    }
+#elif defined(AVG_SIMD_NEON)
+    uint8x8_t weights[7];
+    for (int i = 0; i < numTaps; ++i) {
+        // A single tap can weigh 256 if the kernel degenerates; vmlal_u8 can't
+        // handle that.
+        if (pKernel[i] > 255) {
+            return x;
+        }
+        weights[i] = vdup_n_u8((unsigned char)pKernel[i]);
+    }
+    for (; x+16 <= width; x += 16) {
+        uint16x8_t sumLo = vdupq_n_u16(0);
+        uint16x8_t sumHi = vdupq_n_u16(0);
+        const unsigned char* pTap = pFirstTap+x;
+        for (int i = 0; i < numTaps; ++i) {
+            uint8x16_t pixels = vld1q_u8(pTap);
+            sumLo = vmlal_u8(sumLo, vget_low_u8(pixels), weights[i]);
+            sumHi = vmlal_u8(sumHi, vget_high_u8(pixels), weights[i]);
+            pTap += step;
+        }
+        vst1q_u8(pDest+x, vcombine_u8(vshrn_n_u16(sumLo, 8), vshrn_n_u16(sumHi, 8)));
+    }
+#endif
+    return x;
+}
+
+int bandpassSubtractRow(const unsigned char* pLP, const unsigned char* pHP,
+        unsigned char* pDest, int width)
+{
+    int x = 0;
+    if (!s_bSIMDEnabled) {
+        return x;
+    }
+#if defined(AVG_SIMD_SSE2)
+    __m128i offset = _mm_set1_epi8(char(0x80));
+    for (; x+16 <= width; x += 16) {
+        __m128i lp = _mm_loadu_si128((const __m128i*)(pLP+x));
+        __m128i hp = _mm_loadu_si128((const __m128i*)(pHP+x));
+        _mm_storeu_si128((__m128i*)(pDest+x),
+                _mm_add_epi8(_mm_sub_epi8(lp, hp), offset));
+    }
+#elif defined(AVG_SIMD_NEON)
+    uint8x16_t offset = vdupq_n_u8(128);
+    for (; x+16 <= width; x += 16) {
+        vst1q_u8(pDest+x, vaddq_u8(vsubq_u8(vld1q_u8(pLP+x), vld1q_u8(pHP+x)), offset));
+    }
+#endif
+    return x;
+}
+
+}
@@ -0,0 +1,73 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#ifndef _SIMDKernels_H_
+#define _SIMDKernels_H_
+
+#include "../api.h"
+
+namespace avg {
+
+// Row kernels for the I8 filters used by the tracker. Each kernel processes as many
+// pixels of the row as fit into whole SSE2 or NEON vectors and returns that count;
+// the caller finishes the row with its own scalar loop. The results are bit-exact
+// with the scalar code. If the cpu has no usable vector unit (or SIMD has been
+// disabled), the kernels return 0.
+
+bool AVG_API isSIMDSupported();
+bool AVG_API isSIMDEnabled();
+// Turns the kernels on and off at runtime, e.g. to compare against the scalar code.
+// Has no effect if isSIMDSupported() is false.
+void AVG_API setSIMDEnabled(bool bEnabled);
+
+// pLine = saturate(pLine - pHistory/256) if bBrighter, saturate(pHistory/256 - pLine)
+// otherwise.
+int AVG_API subtractHistoryRow(unsigned char* pLine, const unsigned short* pHistory,
+        int width, bool bBrighter);
+
+// pLine = pLine*pMask/255.
+int AVG_API maskRowI8(unsigned char* pLine, const unsigned char* pMask, int width);
+
+// Averages 2x2 blocks of the source rows starting at pSrc into pDest, rounding to
+// nearest.
+int AVG_API downscaleRow2x2(const unsigned char* pSrc, int srcStride,
+        unsigned char* pDest, int destWidth);
+
+// Applies the 7x7 FilterFastBandpass kernel. pSrc points to the center pixel of the
+// first destination pixel.
+int AVG_API fastBandpassRow(const unsigned char* pSrc, int srcStride,
+        unsigned char* pDest, int width);
+
+// One-dimensional convolution with a kernel of 2*radius+1 taps spaced step bytes
+// apart, divided by 256. pSrc points to the center tap of the first pixel. Only
+// radius 1 to 3 and kernels summing to at most 257 are vectorized.
+int AVG_API convolveRow(const unsigned char* pSrc, int step, unsigned char* pDest,
+        int width, const int* pKernel, int radius);
+
+// pDest = pLP - pHP + 128, wrapping around at 256.
+int AVG_API bandpassSubtractRow(const unsigned char* pLP, const unsigned char* pHP,
+        unsigned char* pDest, int width);
+
+}
+
+#endif
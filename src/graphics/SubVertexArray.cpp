@@ -87,6 +87,21 @@ int SubVertexArray::getNumVerts() const
     return m_NumVerts;
 }
 
+int SubVertexArray::getNumIndexes() const
+{
+    return m_NumIndexes;
+}
+
+unsigned SubVertexArray::getStartIndex() const
+{
+    return m_StartIndex;
+}
+
+VertexArray* SubVertexArray::getVertexArray() const
+{
+    return m_pVA;
+}
+
 void SubVertexArray::draw()
 {
     m_pVA->draw(m_StartIndex, m_NumIndexes, m_StartVertex, m_StartIndex);
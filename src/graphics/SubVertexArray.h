@@ -48,6 +48,9 @@ public:
             float width, float tc1=0, float tc2=1);
     void appendVertexData(VertexDataPtr pVertexes);
     int getNumVerts() const;
+    int getNumIndexes() const;
+    unsigned getStartIndex() const;
+    VertexArray* getVertexArray() const;
 
     void draw();
     void dump() const;
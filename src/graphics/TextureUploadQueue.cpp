@@ -0,0 +1,232 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "TextureUploadQueue.h"
+
+#include "../base/Exception.h"
+#include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
+
+using namespace std;
+
+namespace avg {
+
+static const unsigned MAX_MOVERS = 4;
+
+TextureUploadStats::TextureUploadStats()
+    : m_NumPending(0),
+      m_PendingBytes(0),
+      m_NumUploaded(0),
+      m_UploadedBytes(0),
+      m_LastFrameBytes(0),
+      m_LastFrameTime(0)
+{
+}
+
+TextureUploadQueue::TextureUploadQueue()
+    : m_MaxBytes(0),
+      m_MaxTime(0)
+{
+}
+
+TextureUploadQueue::~TextureUploadQueue()
+{
+}
+
+void TextureUploadQueue::setBudget(long long maxBytes, float maxTime)
+{
+    if (maxBytes < 0 || maxTime < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Texture upload budget must not be negative.");
+    }
+    m_MaxBytes = maxBytes;
+    m_MaxTime = maxTime;
+}
+
+long long TextureUploadQueue::getMaxBytes() const
+{
+    return m_MaxBytes;
+}
+
+float TextureUploadQueue::getMaxTime() const
+{
+    return m_MaxTime;
+}
+
+void TextureUploadQueue::pushUpload(BitmapPtr pBmp, GLTexturePtr pTex, 
+        ITextureUploadListener* pListener)
+{
+    AVG_ASSERT(pBmp->getSize() == pTex->getSize());
+    AVG_ASSERT(pBmp->getPixelFormat() == pTex->getPF());
+    cancelUpload(pTex);
+    Job job;
+    job.m_pBmp = pBmp;
+    job.m_pTex = pTex;
+    job.m_pListener = pListener;
+    m_Jobs.push_back(job);
+    m_Stats.m_NumPending++;
+    m_Stats.m_PendingBytes += pBmp->getMemNeeded();
+}
+
+void TextureUploadQueue::cancelUpload(const GLTexturePtr& pTex)
+{
+    JobList::iterator it = findJob(pTex);
+    if (it != m_Jobs.end()) {
+        m_Stats.m_NumPending--;
+        m_Stats.m_PendingBytes -= it->m_pBmp->getMemNeeded();
+        m_Jobs.erase(it);
+    }
+}
+
+void TextureUploadQueue::flushUpload(const GLTexturePtr& pTex)
+{
+    JobList::iterator it = findJob(pTex);
+    if (it != m_Jobs.end()) {
+        Job job = *it;
+        m_Jobs.erase(it);
+        upload(job);
+    }
+}
+
+BitmapPtr TextureUploadQueue::takeUpload(const GLTexturePtr& pTex)
+{
+    JobList::iterator it = findJob(pTex);
+    if (it == m_Jobs.end()) {
+        return BitmapPtr();
+    }
+    BitmapPtr pBmp = it->m_pBmp;
+    m_Stats.m_NumPending--;
+    m_Stats.m_PendingBytes -= pBmp->getMemNeeded();
+    m_Jobs.erase(it);
+    return pBmp;
+}
+
+bool TextureUploadQueue::isUploadPending(const GLTexturePtr& pTex) const
+{
+    for (JobList::const_iterator it = m_Jobs.begin(); it != m_Jobs.end(); ++it) {
+        if (it->m_pTex == pTex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TextureUploadQueue::startFrame()
+{
+    m_Stats.m_LastFrameBytes = 0;
+    m_Stats.m_LastFrameTime = 0;
+}
+
+static ProfilingZoneID UploadProfilingZone("Texture uploads");
+
+void TextureUploadQueue::processUploads()
+{
+    if (m_Jobs.empty()) {
+        return;
+    }
+    ScopeTimer timer(UploadProfilingZone);
+    long long frameBytes = m_Stats.m_LastFrameBytes;
+    while (!m_Jobs.empty()) {
+        // The first upload in a frame is always done, even if it exceeds the budget.
+        if (m_Stats.m_LastFrameBytes > 0) {
+            int jobBytes = m_Jobs.front().m_pBmp->getMemNeeded();
+            if ((m_MaxBytes > 0 && m_Stats.m_LastFrameBytes+jobBytes > m_MaxBytes) ||
+                    (m_MaxTime > 0 && m_Stats.m_LastFrameTime >= m_MaxTime))
+            {
+                break;
+            }
+        }
+        Job job = m_Jobs.front();
+        m_Jobs.pop_front();
+        long long startTime = TimeSource::get()->getCurrentMicrosecs();
+        upload(job);
+        m_Stats.m_LastFrameTime += 
+                (TimeSource::get()->getCurrentMicrosecs()-startTime)/1000.f;
+    }
+    UploadProfilingZone.getProfiler()->addZoneCount(UploadProfilingZone,
+            m_Stats.m_LastFrameBytes-frameBytes);
+}
+
+void TextureUploadQueue::reset()
+{
+    m_Jobs.clear();
+    m_pMovers.clear();
+    m_Stats = TextureUploadStats();
+}
+
+const TextureUploadStats& TextureUploadQueue::getStats() const
+{
+    return m_Stats;
+}
+
+void TextureUploadQueue::upload(const Job& job)
+{
+    int numBytes = job.m_pBmp->getMemNeeded();
+    m_Stats.m_NumPending--;
+    m_Stats.m_PendingBytes -= numBytes;
+
+    TextureMoverPtr pMover = getMover(job.m_pTex->getSize(), job.m_pTex->getPF());
+    BitmapPtr pMoverBmp = pMover->lock();
+    pMoverBmp->copyPixels(*job.m_pBmp);
+    pMover->unlock();
+    pMover->moveToTexture(*job.m_pTex);
+
+    m_Stats.m_NumUploaded++;
+    m_Stats.m_UploadedBytes += numBytes;
+    m_Stats.m_LastFrameBytes += numBytes;
+    if (job.m_pListener) {
+        job.m_pListener->onTextureUploaded(job.m_pTex);
+    }
+}
+
+TextureMoverPtr TextureUploadQueue::getMover(const IntPoint& size, PixelFormat pf)
+{
+    // Movers are kept in least-recently-used order. Reusing one doesn't stall: 
+    // lock() orphans the previous buffer contents.
+    for (unsigned i=0; i<m_pMovers.size(); ++i) {
+        TextureMoverPtr pMover = m_pMovers[i];
+        if (pMover->getSize() == size && pMover->getPF() == pf) {
+            m_pMovers.erase(m_pMovers.begin()+i);
+            m_pMovers.push_back(pMover);
+            return pMover;
+        }
+    }
+    TextureMoverPtr pMover = TextureMover::create(size, pf, GL_STREAM_DRAW);
+    if (m_pMovers.size() >= MAX_MOVERS) {
+        m_pMovers.erase(m_pMovers.begin());
+    }
+    m_pMovers.push_back(pMover);
+    return pMover;
+}
+
+TextureUploadQueue::JobList::iterator TextureUploadQueue::findJob(
+        const GLTexturePtr& pTex)
+{
+    for (JobList::iterator it = m_Jobs.begin(); it != m_Jobs.end(); ++it) {
+        if (it->m_pTex == pTex) {
+            return it;
+        }
+    }
+    return m_Jobs.end();
+}
+
+}
@@ -0,0 +1,111 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _TextureUploadQueue_H_
+#define _TextureUploadQueue_H_
+
+#include "../api.h"
+
+#include "Bitmap.h"
+#include "GLTexture.h"
+#include "TextureMover.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <list>
+#include <vector>
+
+namespace avg {
+
+class AVG_API ITextureUploadListener {
+public:
+    virtual ~ITextureUploadListener() {};
+    virtual void onTextureUploaded(GLTexturePtr pTex) = 0;
+};
+
+struct AVG_API TextureUploadStats {
+    TextureUploadStats();
+
+    int m_NumPending;
+    long long m_PendingBytes;
+    long long m_NumUploaded;
+    long long m_UploadedBytes;
+    long long m_LastFrameBytes;
+    float m_LastFrameTime;
+};
+
+// Moves bitmaps to textures spread over several frames. Uploads are processed in 
+// the order they were pushed until the per-frame budget is used up. At least one 
+// upload is done per frame so the queue always drains.
+class AVG_API TextureUploadQueue {
+public:
+    TextureUploadQueue();
+    virtual ~TextureUploadQueue();
+
+    // A budget of 0 means unlimited.
+    void setBudget(long long maxBytes, float maxTime);
+    long long getMaxBytes() const;
+    float getMaxTime() const;
+
+    // Replaces a pending upload to the same texture.
+    void pushUpload(BitmapPtr pBmp, GLTexturePtr pTex, 
+            ITextureUploadListener* pListener=0);
+    void cancelUpload(const GLTexturePtr& pTex);
+    // Uploads immediately if an upload to the texture is pending.
+    void flushUpload(const GLTexturePtr& pTex);
+    // Removes a pending upload and returns its bitmap. Returns an empty pointer if 
+    // there is no upload to the texture.
+    BitmapPtr takeUpload(const GLTexturePtr& pTex);
+    bool isUploadPending(const GLTexturePtr& pTex) const;
+
+    // startFrame() resets the budget and needs to be called once per frame.
+    void startFrame();
+    void processUploads();
+    void reset();
+
+    const TextureUploadStats& getStats() const;
+
+private:
+    struct Job {
+        BitmapPtr m_pBmp;
+        GLTexturePtr m_pTex;
+        ITextureUploadListener* m_pListener;
+    };
+    typedef std::list<Job> JobList;
+
+    void upload(const Job& job);
+    TextureMoverPtr getMover(const IntPoint& size, PixelFormat pf);
+    JobList::iterator findJob(const GLTexturePtr& pTex);
+
+    JobList m_Jobs;
+    // Recently used movers. For PBOs, this is a small ring of buffers taken from 
+    // the context's PBO cache.
+    std::vector<TextureMoverPtr> m_pMovers;
+
+    long long m_MaxBytes;
+    float m_MaxTime;
+    TextureUploadStats m_Stats;
+};
+
+}
+
+#endif
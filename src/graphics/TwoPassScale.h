@@ -7,6 +7,9 @@
 #include "ContribDefs.h"
 
 #include "../base/Exception.h"
+#include "../base/ThreadPool.h"
+
+#include <boost/bind.hpp>
 
 #include <math.h>
 #include <algorithm>
@@ -129,14 +132,20 @@ private:
     LineContribType *CalcContributions (unsigned    uLineSize,
                                         unsigned    uSrcSize);
 
-    void ScaleRow(PixelClass *pSrc, int uSrcWidth, PixelClass *pDest, int uResWidth, 
+    void ScaleRow(PixelClass *pSrc, PixelClass *pDest, int uResWidth, 
             LineContribType *pContrib);
 
     void HorizScale(PixelClass * pSrcData, const IntPoint& srcSize, int srcStride, 
             PixelClass *pDestData, const IntPoint& destSize, int destStride);
+    void HorizScaleRows(PixelClass * pSrcData, int srcStride, PixelClass *pDestData,
+            int destWidth, int destStride, LineContribType * pContrib, int startRow,
+            int endRow);
 
     void VertScale(PixelClass *pSrcData, const IntPoint& srcSize, int srcStride,
             PixelClass *pDestData, const IntPoint& destSize, int destStride);
+    void VertScaleRows(PixelClass * pSrcData, int srcStride, PixelClass *pDestData,
+            int destWidth, int destStride, LineContribType * pContrib, int startRow,
+            int endRow);
 
     const ContribDef& m_ContribDef;
 };
@@ -242,8 +251,8 @@ TwoPassScale<DataClass>::CalcContributions(unsigned uLineSize, unsigned uSrcSize
 
 template <class DataClass>
 void
-TwoPassScale<DataClass>::ScaleRow(PixelClass *pSrc, int uSrcWidth,
-        PixelClass *pDest, int uResWidth, LineContribType *pContrib)
+TwoPassScale<DataClass>::ScaleRow(PixelClass *pSrc, PixelClass *pDest, int uResWidth,
+        LineContribType *pContrib)
 {
     PixelClass * pDestPixel = pDest;
     for (int x = 0; x < uResWidth; x++) {
@@ -276,15 +285,27 @@ void TwoPassScale<DataClass>::HorizScale(PixelClass * pSrcData, const IntPoint&
         }
     } else {
         LineContribType * pContrib = CalcContributions(destSize.x, srcSize.x);
-        for (int y = 0; y < destSize.y; y++) {
-            ScaleRow(pSrc, srcSize.x, pDest, destSize.x, pContrib);
-            pSrc = (PixelClass*)((char*)(pSrc)+srcStride);
-            pDest = (PixelClass*)((char*)(pDest)+destStride);
-        }
+        ThreadPool::get()->runRowBands(destSize.y, destSize.x,
+                boost::bind(&TwoPassScale::HorizScaleRows, this, pSrcData, srcStride,
+                        pDestData, destSize.x, destStride, pContrib, _1, _2));
         FreeContributions(pContrib);  // Free contributions structure
     }
 }
 
+template <class DataClass>
+void TwoPassScale<DataClass>::HorizScaleRows(PixelClass * pSrcData, int srcStride, 
+        PixelClass *pDestData, int destWidth, int destStride, 
+        LineContribType * pContrib, int startRow, int endRow)
+{
+    PixelClass * pSrc = (PixelClass*)((char*)(pSrcData)+size_t(startRow)*srcStride);
+    PixelClass * pDest = (PixelClass*)((char*)(pDestData)+size_t(startRow)*destStride);
+    for (int y = startRow; y < endRow; y++) {
+        ScaleRow(pSrc, pDest, destWidth, pContrib);
+        pSrc = (PixelClass*)((char*)(pSrc)+srcStride);
+        pDest = (PixelClass*)((char*)(pDest)+destStride);
+    }
+}
+
 
 template <class DataClass>
 void TwoPassScale<DataClass>::VertScale(PixelClass *pSrcData, const IntPoint& srcSize,
@@ -301,31 +322,42 @@ void TwoPassScale<DataClass>::VertScale(PixelClass *pSrcData, const IntPoint& sr
         }
     } else {
         LineContribType * pContrib = CalcContributions(destSize.y, srcSize.y);
-        for (int y = 0; y < destSize.y; y++) {
-            PixelClass * pDestPixel = pDest;
-            int * pWeights = pContrib->ContribRow[y].Weights;
-            int iLeft = pContrib->ContribRow[y].Left;
-            int iRight = pContrib->ContribRow[y].Right;
-            PixelClass* pSrcPixelBase = (PixelClass*)((char*)(pSrc)
-                    + size_t(iLeft)*srcStride);
-            for (int x = 0; x < destSize.x; x++) {
-                typename DataClass::_Accumulator a;
-                int * pWeight = pWeights;
-                PixelClass * pSrcPixel = pSrcPixelBase;
-                pSrcPixelBase++;
-                for (int i = iLeft; i <= iRight; i++) {
-                    // Scan between boundries
-                    // Accumulate weighted effect of each neighboring pixel
-                    a.Accumulate(*pWeight, *pSrcPixel);
-                    pWeight++;
-                    pSrcPixel = (PixelClass*)((char*)(pSrcPixel)+srcStride);
-                }
-                a.Store(pDestPixel);
-                pDestPixel++;
+        ThreadPool::get()->runRowBands(destSize.y, destSize.x,
+                boost::bind(&TwoPassScale::VertScaleRows, this, pSrcData, srcStride,
+                        pDestData, destSize.x, destStride, pContrib, _1, _2));
+        FreeContributions(pContrib);     // Free contributions structure
+    }
+}
+
+template <class DataClass>
+void TwoPassScale<DataClass>::VertScaleRows(PixelClass * pSrcData, int srcStride, 
+        PixelClass *pDestData, int destWidth, int destStride, 
+        LineContribType * pContrib, int startRow, int endRow)
+{
+    PixelClass * pDest = (PixelClass*)((char*)(pDestData)+size_t(startRow)*destStride);
+    for (int y = startRow; y < endRow; y++) {
+        PixelClass * pDestPixel = pDest;
+        int * pWeights = pContrib->ContribRow[y].Weights;
+        int iLeft = pContrib->ContribRow[y].Left;
+        int iRight = pContrib->ContribRow[y].Right;
+        PixelClass* pSrcPixelBase = (PixelClass*)((char*)(pSrcData)
+                + size_t(iLeft)*srcStride);
+        for (int x = 0; x < destWidth; x++) {
+            typename DataClass::_Accumulator a;
+            int * pWeight = pWeights;
+            PixelClass * pSrcPixel = pSrcPixelBase;
+            pSrcPixelBase++;
+            for (int i = iLeft; i <= iRight; i++) {
+                // Scan between boundries
+                // Accumulate weighted effect of each neighboring pixel
+                a.Accumulate(*pWeight, *pSrcPixel);
+                pWeight++;
+                pSrcPixel = (PixelClass*)((char*)(pSrcPixel)+srcStride);
             }
-            pDest = (PixelClass*)((char*)(pDest)+destStride);
+            a.Store(pDestPixel);
+            pDestPixel++;
         }
-        FreeContributions(pContrib);     // Free contributions structure
+        pDest = (PixelClass*)((char*)(pDest)+destStride);
     }
 }
 
@@ -42,7 +42,10 @@ const unsigned VertexArray::POS_INDEX = 1;
 const unsigned VertexArray::COLOR_INDEX = 2;
 
 VertexArray::VertexArray(int reserveVerts, int reserveIndexes)
-    : VertexData(reserveVerts, reserveIndexes)
+    : VertexData(reserveVerts, reserveIndexes),
+      m_BufferVerts(0),
+      m_BufferIndexes(0),
+      m_NumUploadedBytes(0)
 {
     GLContext* pContext = GLContext::getCurrent();
     if (getReserveVerts() != MIN_VERTEXES || getReserveIndexes() != MIN_INDEXES) {
@@ -52,7 +55,6 @@ VertexArray::VertexArray(int reserveVerts, int reserveIndexes)
         m_GLVertexBufferID = pContext->getVertexBufferCache().getBuffer();
         m_GLIndexBufferID = pContext->getIndexBufferCache().getBuffer();
     }
-    m_bUseMapBuffer = (!pContext->isGLES());
 }
 
 VertexArray::~VertexArray()
@@ -74,24 +76,26 @@ VertexArray::~VertexArray()
 
 void VertexArray::update()
 {
-    if (hasDataChanged()) {
-        transferBuffer(GL_ARRAY_BUFFER, m_GLVertexBufferID, 
-                getReserveVerts()*sizeof(Vertex), 
-                getNumVerts()*sizeof(Vertex), getVertexPointer());
-#ifdef AVG_ENABLE_EGL        
-        transferBuffer(GL_ELEMENT_ARRAY_BUFFER, m_GLIndexBufferID, 
-                getReserveIndexes()*sizeof(unsigned short),
-                getNumIndexes()*sizeof(unsigned short), getIndexPointer());
-#else
-        transferBuffer(GL_ELEMENT_ARRAY_BUFFER, m_GLIndexBufferID, 
-                getReserveIndexes()*sizeof(unsigned int),
-                getNumIndexes()*sizeof(unsigned int), getIndexPointer());
-#endif
+    m_NumUploadedBytes = 0;
+    if (hasDataChanged() || m_BufferVerts != getReserveVerts() || 
+            m_BufferIndexes != getReserveIndexes())
+    {
+        m_NumUploadedBytes += transferBuffer(GL_ARRAY_BUFFER, m_GLVertexBufferID, 
+                sizeof(Vertex), getReserveVerts(), m_BufferVerts,
+                getDirtyVertRanges(), getVertexPointer());
+        m_NumUploadedBytes += transferBuffer(GL_ELEMENT_ARRAY_BUFFER, 
+                m_GLIndexBufferID, sizeof(GL_INDEX_TYPE), getReserveIndexes(), 
+                m_BufferIndexes, getDirtyIndexRanges(), getIndexPointer());
         GLContext::checkError("VertexArray::update()");
     }
     resetDataChanged();
 }
 
+unsigned VertexArray::getNumUploadedBytes() const
+{
+    return m_NumUploadedBytes;
+}
+
 void VertexArray::activate()
 {
     glproc::BindBuffer(GL_ARRAY_BUFFER, m_GLVertexBufferID);
@@ -117,6 +121,7 @@ void VertexArray::draw()
 #else
     glDrawElements(GL_TRIANGLES, getNumIndexes(), GL_UNSIGNED_INT, 0);
 #endif
+    GLContext::getCurrent()->incDrawCallCount();
     GLContext::checkError("VertexArray::draw()");
 }
 
@@ -133,6 +138,7 @@ void VertexArray::draw(unsigned startIndex, unsigned numIndexes, unsigned startV
 //    XXX: Theoretically faster, but broken on Linux/Intel N10 graphics, Ubuntu 12/04
 //    glproc::DrawRangeElements(GL_TRIANGLES, startVertex, startVertex+numVertexes, 
 //            numIndexes, GL_UNSIGNED_SHORT, (void *)(startIndex*sizeof(unsigned short)));
+    GLContext::getCurrent()->incDrawCallCount();
     GLContext::checkError("VertexArray::draw()");
 }
 
@@ -141,17 +147,28 @@ void VertexArray::startSubVA(SubVertexArray& subVA)
     subVA.init(this, getNumVerts(), getNumIndexes());
 }
 
-void VertexArray::transferBuffer(GLenum target, unsigned bufferID, unsigned reservedSize, 
-        unsigned usedSize, const void* pData)
+unsigned VertexArray::transferBuffer(GLenum target, unsigned bufferID, 
+        unsigned elemSize, int reservedElems, int& bufferElems, 
+        const DirtyRanges& dirtyRanges, const void* pData)
 {
     glproc::BindBuffer(target, bufferID);
-    if (m_bUseMapBuffer) {
-        glproc::BufferData(target, reservedSize, 0, GL_STREAM_DRAW);
-        void * pBuffer = glproc::MapBuffer(target, GL_WRITE_ONLY);
-        memcpy(pBuffer, pData, usedSize);
-        glproc::UnmapBuffer(target);
+    if (bufferElems != reservedElems) {
+        // The buffer is new or the data grew: upload everything, including the unused 
+        // tail, so the buffer stays an exact copy of the local data.
+        unsigned size = reservedElems*elemSize;
+        glproc::BufferData(target, size, pData, GL_DYNAMIC_DRAW);
+        bufferElems = reservedElems;
+        return size;
     } else {
-        glproc::BufferData(target, usedSize, pData, GL_STREAM_DRAW);
+        unsigned numBytes = 0;
+        const char* pBytes = (const char*)pData;
+        for (unsigned i=0; i<dirtyRanges.size(); ++i) {
+            unsigned offset = dirtyRanges[i].first*elemSize;
+            unsigned size = (dirtyRanges[i].second-dirtyRanges[i].first)*elemSize;
+            glproc::BufferSubData(target, offset, size, pBytes+offset);
+            numBytes += size;
+        }
+        return numBytes;
     }
 }
 
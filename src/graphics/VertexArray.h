@@ -44,7 +44,10 @@ public:
     VertexArray(int reserveVerts = 0, int reserveIndexes = 0);
     virtual ~VertexArray();
 
+    // Uploads the parts of the vertex and index data that changed since the last
+    // call. The GL buffers keep their storage until the reserved size changes.
     void update();
+    unsigned getNumUploadedBytes() const;
     void activate();
     void draw();
     void draw(unsigned startIndex, unsigned numIndexes, unsigned startVertex,
@@ -53,13 +56,17 @@ public:
     void startSubVA(SubVertexArray& subVA);
 
 private:
-    void transferBuffer(GLenum target, unsigned bufferID, unsigned reservedSize, 
-            unsigned usedSize, const void* pData);
+    unsigned transferBuffer(GLenum target, unsigned bufferID, unsigned elemSize,
+            int reservedElems, int& bufferElems, const DirtyRanges& dirtyRanges,
+            const void* pData);
 
     unsigned m_GLVertexBufferID;
     unsigned m_GLIndexBufferID;
 
-    bool m_bUseMapBuffer;
+    // Number of elements the GL buffers were allocated with.
+    int m_BufferVerts;
+    int m_BufferIndexes;
+    unsigned m_NumUploadedBytes;
 };
 
 typedef boost::shared_ptr<VertexArray> VertexArrayPtr;
@@ -28,6 +28,7 @@
 #include "../base/ObjectCounter.h"
 
 #include <iostream>
+#include <algorithm>
 #include <stddef.h>
 #include <string.h>
 
@@ -39,6 +40,11 @@ namespace avg {
 const int VertexData::MIN_VERTEXES = 100;
 const int VertexData::MIN_INDEXES = 100;
 
+// Dirty ranges closer than this are merged so small changes don't turn into lots of
+// tiny uploads.
+static const int DIRTY_RANGE_GAP = 32;
+static const unsigned MAX_DIRTY_RANGES = 16;
+
 VertexData::VertexData(int reserveVerts, int reserveIndexes)
     : m_NumVerts(0),
       m_NumIndexes(0),
@@ -54,8 +60,13 @@ VertexData::VertexData(int reserveVerts, int reserveIndexes)
         m_ReserveIndexes = MIN_INDEXES;
     }
     
+    // appendPos() and friends compare new data to the old contents to find dirty 
+    // ranges, so the buffers can't contain uninitialized memory. Vertex isn't zeroed
+    // by value-initialization because Pixel32 has an empty constructor.
     m_pVertexData = new Vertex[m_ReserveVerts];
+    memset(m_pVertexData, 0, sizeof(Vertex)*m_ReserveVerts);
     m_pIndexData = new GL_INDEX_TYPE[m_ReserveIndexes];
+    memset(m_pIndexData, 0, sizeof(GL_INDEX_TYPE)*m_ReserveIndexes);
 
 }
 
@@ -72,13 +83,18 @@ void VertexData::appendPos(const glm::vec2& pos, const glm::vec2& texPos,
     if (m_NumVerts >= m_ReserveVerts-1) {
         grow();
     }
+    Vertex vertex;
+    vertex.m_Pos[0] = (GLfloat)(pos.x);
+    vertex.m_Pos[1] = (GLfloat)(pos.y);
+    vertex.m_Tex[0] = (GLshort)(texPos.x*4096.f);
+    vertex.m_Tex[1] = (GLshort)(texPos.y*4096.f);
+    vertex.m_Color = color;
     Vertex* pVertex = &(m_pVertexData[m_NumVerts]);
-    pVertex->m_Pos[0] = (GLfloat)(pos.x);
-    pVertex->m_Pos[1] = (GLfloat)(pos.y);
-    pVertex->m_Tex[0] = (GLshort)(texPos.x*4096.f);
-    pVertex->m_Tex[1] = (GLshort)(texPos.y*4096.f);
-    pVertex->m_Color = color;
-    m_bDataChanged = true;
+    if (memcmp(pVertex, &vertex, sizeof(Vertex)) != 0) {
+        *pVertex = vertex;
+        addDirtyRange(m_DirtyVertRanges, m_NumVerts, m_NumVerts+1);
+        m_bDataChanged = true;
+    }
     m_NumVerts++;
 }
 
@@ -87,9 +103,9 @@ void VertexData::appendTriIndexes(int v0, int v1, int v2)
     if (m_NumIndexes >= m_ReserveIndexes-3) {
         grow();
     }
-    m_pIndexData[m_NumIndexes] = v0;
-    m_pIndexData[m_NumIndexes+1] = v1;
-    m_pIndexData[m_NumIndexes+2] = v2;
+    setIndex(m_NumIndexes, v0);
+    setIndex(m_NumIndexes+1, v1);
+    setIndex(m_NumIndexes+2, v2);
     m_NumIndexes += 3;
 }
 
@@ -98,12 +114,12 @@ void VertexData::appendQuadIndexes(int v0, int v1, int v2, int v3)
     if (m_NumIndexes >= m_ReserveIndexes-6) {
         grow();
     }
-    m_pIndexData[m_NumIndexes] = v0;
-    m_pIndexData[m_NumIndexes+1] = v1;
-    m_pIndexData[m_NumIndexes+2] = v2;
-    m_pIndexData[m_NumIndexes+3] = v1;
-    m_pIndexData[m_NumIndexes+4] = v2;
-    m_pIndexData[m_NumIndexes+5] = v3;
+    setIndex(m_NumIndexes, v0);
+    setIndex(m_NumIndexes+1, v1);
+    setIndex(m_NumIndexes+2, v2);
+    setIndex(m_NumIndexes+3, v1);
+    setIndex(m_NumIndexes+4, v2);
+    setIndex(m_NumIndexes+5, v3);
     m_NumIndexes += 6;
 }
 
@@ -129,13 +145,19 @@ void VertexData::appendVertexData(const VertexDataPtr& pVertexes)
         grow();
     }
 
-    memcpy(&(m_pVertexData[oldNumVerts]), pVertexes->m_pVertexData, 
-            pVertexes->getNumVerts()*sizeof(Vertex));
+    int numVerts = pVertexes->getNumVerts();
+    if (memcmp(&(m_pVertexData[oldNumVerts]), pVertexes->m_pVertexData, 
+            numVerts*sizeof(Vertex)) != 0)
+    {
+        memcpy(&(m_pVertexData[oldNumVerts]), pVertexes->m_pVertexData, 
+                numVerts*sizeof(Vertex));
+        addDirtyRange(m_DirtyVertRanges, oldNumVerts, m_NumVerts);
+        m_bDataChanged = true;
+    }
     int numIndexes = pVertexes->getNumIndexes();
     for (int i=0; i<numIndexes; ++i) {
-        m_pIndexData[oldNumIndexes+i] = pVertexes->m_pIndexData[i] + oldNumVerts;
+        setIndex(oldNumIndexes+i, pVertexes->m_pIndexData[i] + oldNumVerts);
     }
-    m_bDataChanged = true;
 }
 
 bool VertexData::hasDataChanged() const
@@ -146,6 +168,8 @@ bool VertexData::hasDataChanged() const
 void VertexData::resetDataChanged()
 {
     m_bDataChanged = false;
+    m_DirtyVertRanges.clear();
+    m_DirtyIndexRanges.clear();
 }
 
 void VertexData::reset()
@@ -203,6 +227,8 @@ void VertexData::grow()
         Vertex* pVertexData = m_pVertexData;
         m_pVertexData = new Vertex[m_ReserveVerts];
         memcpy(m_pVertexData, pVertexData, sizeof(Vertex)*oldReserveVerts);
+        memset(&(m_pVertexData[oldReserveVerts]), 0, 
+                sizeof(Vertex)*(m_ReserveVerts-oldReserveVerts));
         delete[] pVertexData;
     }
     if (m_NumIndexes >= m_ReserveIndexes-6) {
@@ -215,6 +241,8 @@ void VertexData::grow()
         GL_INDEX_TYPE * pIndexData = m_pIndexData;
         m_pIndexData = new GL_INDEX_TYPE[m_ReserveIndexes];
         memcpy(m_pIndexData, pIndexData, sizeof(GL_INDEX_TYPE)*oldReserveIndexes);
+        memset(&(m_pIndexData[oldReserveIndexes]), 0, 
+                sizeof(GL_INDEX_TYPE)*(m_ReserveIndexes-oldReserveIndexes));
         delete[] pIndexData;
     }
     if (bChanged) {
@@ -222,6 +250,39 @@ void VertexData::grow()
     }
 }
 
+void VertexData::setIndex(int i, GL_INDEX_TYPE index)
+{
+    if (m_pIndexData[i] != index) {
+        m_pIndexData[i] = index;
+        addDirtyRange(m_DirtyIndexRanges, i, i+1);
+        m_bDataChanged = true;
+    }
+}
+
+void VertexData::addDirtyRange(DirtyRanges& ranges, int start, int end)
+{
+    // Data is appended front to back, so new ranges almost always come after the
+    // last one.
+    if (ranges.empty()) {
+        ranges.push_back(make_pair(start, end));
+    } else {
+        pair<int, int>& lastRange = ranges.back();
+        if (start < lastRange.first) {
+            // Out of order: collapse everything into one range.
+            int rangeStart = min(start, ranges.front().first);
+            int rangeEnd = max(end, lastRange.second);
+            ranges.clear();
+            ranges.push_back(make_pair(rangeStart, rangeEnd));
+        } else if (start <= lastRange.second+DIRTY_RANGE_GAP ||
+                ranges.size() >= MAX_DIRTY_RANGES)
+        {
+            lastRange.second = max(end, lastRange.second);
+        } else {
+            ranges.push_back(make_pair(start, end));
+        }
+    }
+}
+
 int VertexData::getReserveVerts() const
 {
     return m_ReserveVerts;
@@ -232,6 +293,16 @@ int VertexData::getReserveIndexes() const
     return m_ReserveIndexes;
 }
 
+const VertexData::DirtyRanges& VertexData::getDirtyVertRanges() const
+{
+    return m_DirtyVertRanges;
+}
+
+const VertexData::DirtyRanges& VertexData::getDirtyIndexRanges() const
+{
+    return m_DirtyIndexRanges;
+}
+
 const Vertex * VertexData::getVertexPointer() const
 {
     return m_pVertexData;
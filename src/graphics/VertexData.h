@@ -31,6 +31,8 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <vector>
+
 namespace avg {
 
 struct Vertex {
@@ -77,11 +79,19 @@ protected:
     const Vertex * getVertexPointer() const;
     const GL_INDEX_TYPE * getIndexPointer() const;
 
+    // Element ranges [first, second) that differ from the data present before the 
+    // last resetDataChanged().
+    typedef std::vector<std::pair<int, int> > DirtyRanges;
+    const DirtyRanges& getDirtyVertRanges() const;
+    const DirtyRanges& getDirtyIndexRanges() const;
+
     static const int MIN_VERTEXES;
     static const int MIN_INDEXES;
 
 private:
     void grow();
+    void setIndex(int i, GL_INDEX_TYPE index);
+    static void addDirtyRange(DirtyRanges& ranges, int start, int end);
 
     int m_NumVerts;
     int m_NumIndexes;
@@ -91,6 +101,8 @@ private:
     GL_INDEX_TYPE * m_pIndexData;
 
     bool m_bDataChanged;
+    DirtyRanges m_DirtyVertRanges;
+    DirtyRanges m_DirtyIndexRanges;
 };
 
 std::ostream& operator<<(std::ostream& os, const Vertex& v);
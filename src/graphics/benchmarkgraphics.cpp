@@ -37,10 +37,15 @@
 #include "FilterGauss.h"
 #include "FilterBlur.h"
 #include "FilterBandpass.h"
+#include "FilterFastBandpass.h"
+#include "FilterFastDownscale.h"
+#include "FilterMask.h"
+#include "SIMDKernels.h"
 
 #include "../base/TimeSource.h"
 
 #include <iostream>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -48,9 +53,8 @@ using namespace avg;
 using namespace std;
 
 template<class TEST>
-void runPerformanceTest(int numRuns=500)
+void runPerformanceTest(TEST& PerfTest, int numRuns)
 {
-    TEST PerfTest;
     long long StartTime = TimeSource::get()->getCurrentMicrosecs();
     for (int i = 0; i < numRuns; ++i) {
         PerfTest.run();
@@ -60,6 +64,13 @@ void runPerformanceTest(int numRuns=500)
     
 }
 
+template<class TEST>
+void runPerformanceTest(int numRuns=500)
+{
+    TEST PerfTest;
+    runPerformanceTest(PerfTest, numRuns);
+}
+
 class PerfTestBase {
 public:
     PerfTestBase(string sName) 
@@ -234,6 +245,75 @@ private:
         
 };
 
+class FilterPerfTest: public PerfTestBase {
+public:
+    FilterPerfTest(const string& sName, FilterPtr pFilter, BitmapPtr pBmp)
+        : PerfTestBase(sName),
+          m_pFilter(pFilter),
+          m_pBmp(pBmp)
+    {
+    }
+
+    void run()
+    {
+        m_pFilter->apply(m_pBmp);
+    }
+
+private:
+    FilterPtr m_pFilter;
+    BitmapPtr m_pBmp;
+};
+
+// Times the stages the tracker runs on every camera frame, with and without the
+// SIMD kernels.
+void runTrackerStagePerfTests(const IntPoint& size)
+{
+    BitmapPtr pBmp(new Bitmap(size, I8));
+    BitmapPtr pMaskBmp(new Bitmap(size, I8));
+    for (int y = 0; y < size.y; ++y) {
+        unsigned char * pLine = pBmp->getPixels()+y*pBmp->getStride();
+        unsigned char * pMaskLine = pMaskBmp->getPixels()+y*pMaskBmp->getStride();
+        for (int x = 0; x < size.x; ++x) {
+            pLine[x] = (unsigned char)(rand() & 0xFF);
+            pMaskLine[x] = (unsigned char)(rand() & 0xFF);
+        }
+    }
+    const char * stageNames[] = {"HistoryPreProcessor", "FilterMask",
+            "FilterFastDownscale", "FilterFastBandpass", "FilterBandpass"};
+    for (int i = 0; i < 5; ++i) {
+        for (int simd = 1; simd >= 0; --simd) {
+            if (simd && !isSIMDSupported()) {
+                continue;
+            }
+            setSIMDEnabled(simd != 0);
+            FilterPtr pFilter;
+            switch (i) {
+                case 0:
+                    pFilter = FilterPtr(new HistoryPreProcessor(size, 1, true));
+                    break;
+                case 1:
+                    pFilter = FilterPtr(new FilterMask(pMaskBmp));
+                    break;
+                case 2:
+                    pFilter = FilterPtr(new FilterFastDownscale(2));
+                    break;
+                case 3:
+                    pFilter = FilterPtr(new FilterFastBandpass());
+                    break;
+                case 4:
+                    pFilter = FilterPtr(new FilterBandpass(1.9f, 3));
+                    break;
+            }
+            stringstream ss;
+            ss << stageNames[i] << " " << size.x << "x" << size.y << " I8"
+                    << (simd ? " (SIMD)" : " (scalar)");
+            FilterPerfTest perfTest(ss.str(), pFilter, pBmp);
+            runPerformanceTest(perfTest, 200);
+        }
+    }
+    setSIMDEnabled(true);
+}
+
 void runPerformanceTests()
 {
     runPerformanceTest<LoadPNGPerfTest>();
@@ -245,6 +325,8 @@ void runPerformanceTests()
     runPerformanceTest<CopyRGBPerfTest>();
     runPerformanceTest<CopyRGBAPerfTest>();
     runPerformanceTest<YUV2RGBPerfTest>(200);
+    runTrackerStagePerfTests(IntPoint(640, 480));
+    runTrackerStagePerfTests(IntPoint(1280, 1024));
 }
 
 int main(int nargs, char** args)
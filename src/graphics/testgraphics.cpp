@@ -25,6 +25,7 @@
 #include "Pixel32.h"
 #include "Pixel24.h"
 #include "Pixel16.h"
+#include "VertexData.h"
 #include "Filtercolorize.h"
 #include "Filtergrayscale.h"
 #include "Filterfill.h"
@@ -48,6 +49,7 @@
 #include "FilterGetAlpha.h"
 #include "FilterResizeBilinear.h"
 #include "FilterUnmultiplyAlpha.h"
+#include "SIMDKernels.h"
 
 #include "../base/TestSuite.h"
 #include "../base/Exception.h"
@@ -134,6 +136,82 @@ public:
     }
 };
 
+class VertexDataTest: public GraphicsTest {
+public:
+    VertexDataTest()
+      : GraphicsTest("VertexDataTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        TestVertexData data;
+        appendVertexes(data, 300, -1, -1);
+        TEST(data.hasDataChanged());
+        data.resetDataChanged();
+
+        // Rebuilding the same data doesn't produce any dirty ranges.
+        data.reset();
+        appendVertexes(data, 300, -1, -1);
+        TEST(!data.hasDataChanged());
+        TEST(data.getDirtyVertRanges().empty());
+        TEST(data.getDirtyIndexRanges().empty());
+
+        data.reset();
+        appendVertexes(data, 300, 150, -1);
+        TEST(data.hasDataChanged());
+        TEST(data.getDirtyVertRanges().size() == 1);
+        TEST(data.getDirtyVertRanges()[0] == std::make_pair(150, 151));
+        TEST(data.getDirtyIndexRanges().empty());
+        data.resetDataChanged();
+        data.reset();
+        appendVertexes(data, 300, -1, -1);
+        data.resetDataChanged();
+
+        // Far-apart changes are kept separate, close ones are merged.
+        data.reset();
+        appendVertexes(data, 300, 10, 250);
+        TEST(data.getDirtyVertRanges().size() == 2);
+        data.resetDataChanged();
+        data.reset();
+        appendVertexes(data, 300, -1, -1);
+        data.resetDataChanged();
+        data.reset();
+        appendVertexes(data, 300, 20, 30);
+        TEST(data.getDirtyVertRanges().size() == 1);
+        TEST(data.getDirtyVertRanges()[0] == std::make_pair(20, 31));
+        data.resetDataChanged();
+        data.reset();
+        appendVertexes(data, 300, -1, -1);
+        data.resetDataChanged();
+
+
+        // Fewer vertexes: Nothing to upload.
+        data.reset();
+        appendVertexes(data, 150, -1, -1);
+        TEST(!data.hasDataChanged());
+    }
+
+private:
+    class TestVertexData: public VertexData {
+    public:
+        using VertexData::getDirtyVertRanges;
+        using VertexData::getDirtyIndexRanges;
+    };
+
+    void appendVertexes(VertexData& data, int numVerts, int changedVert1, 
+            int changedVert2)
+    {
+        for (int i=0; i<numVerts; ++i) {
+            float x = (i == changedVert1 || i == changedVert2) ? -1.f : float(i);
+            data.appendPos(glm::vec2(x, 0), glm::vec2(0, 0));
+            if (i%3 == 2) {
+                data.appendTriIndexes(i-2, i-1, i);
+            }
+        }
+    }
+};
+
 class BitmapTest: public GraphicsTest {
 public:
     BitmapTest()
@@ -857,6 +935,79 @@ private:
     }
 };
 
+class SIMDFilterTest: public GraphicsTest {
+public:
+    SIMDFilterTest()
+        : GraphicsTest("SIMDFilterTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        if (!isSIMDSupported()) {
+            cerr << "    SIMD not supported, skipping." << endl;
+            return;
+        }
+        // Odd sizes so every kernel also leaves a scalar remainder.
+        runTestsWithSize(IntPoint(163, 61));
+        runTestsWithSize(IntPoint(640, 48));
+        setSIMDEnabled(true);
+    }
+
+private:
+    void runTestsWithSize(const IntPoint& size)
+    {
+        BitmapPtr pBmp = createNoiseBmp(size, 1);
+        BitmapPtr pMaskBmp = createNoiseBmp(size, 2);
+
+        for (int i = 0; i < 2; ++i) {
+            bool bBrighter = (i == 0);
+            HistoryPreProcessor simdFilt(size, 1, bBrighter);
+            HistoryPreProcessor scalarFilt(size, 1, bBrighter);
+            for (int frame = 0; frame < 3; ++frame) {
+                BitmapPtr pFrameBmp = createNoiseBmp(size, frame+3);
+                setSIMDEnabled(true);
+                BitmapPtr pSIMDBmp = simdFilt.apply(pFrameBmp);
+                setSIMDEnabled(false);
+                BitmapPtr pScalarBmp = scalarFilt.apply(pFrameBmp);
+                TEST(*pSIMDBmp == *pScalarBmp);
+            }
+        }
+        compare(FilterPtr(new FilterMask(pMaskBmp)), pBmp);
+        compare(FilterPtr(new FilterFastDownscale(2)), pBmp);
+        compare(FilterPtr(new FilterFastBandpass()), pBmp);
+        compare(FilterPtr(new FilterGauss(1)), pBmp);
+        compare(FilterPtr(new FilterGauss(1.5)), pBmp);
+        compare(FilterPtr(new FilterGauss(3)), pBmp);
+        compare(FilterPtr(new FilterBandpass(1.9f, 3)), pBmp);
+    }
+
+    void compare(FilterPtr pFilter, BitmapPtr pSrcBmp)
+    {
+        setSIMDEnabled(true);
+        BitmapPtr pSIMDBmp = pFilter->apply(pSrcBmp);
+        setSIMDEnabled(false);
+        BitmapPtr pScalarBmp = pFilter->apply(pSrcBmp);
+        TEST(*pSIMDBmp == *pScalarBmp);
+    }
+
+    BitmapPtr createNoiseBmp(const IntPoint& size, int seed)
+    {
+        BitmapPtr pBmp(new Bitmap(size, I8));
+        srand(seed);
+        for (int y = 0; y < size.y; ++y) {
+            unsigned char * pLine = pBmp->getPixels()+y*pBmp->getStride();
+            for (int x = 0; x < size.x; ++x) {
+                pLine[x] = (unsigned char)(rand() & 0xFF);
+            }
+        }
+        // Include the extreme values.
+        pBmp->getPixels()[0] = 0;
+        pBmp->getPixels()[1] = 255;
+        return pBmp;
+    }
+};
+
 class FilterThresholdTest: public GraphicsTest {
 public:
     FilterThresholdTest()
@@ -1011,6 +1162,7 @@ public:
         : TestSuite("GraphicsTestSuite")
     {
         addTest(TestPtr(new PixelTest));
+        addTest(TestPtr(new VertexDataTest));
         addTest(TestPtr(new BitmapTest));
         addTest(TestPtr(new Filter3x3Test));
         addTest(TestPtr(new FilterConvolTest));
@@ -1029,6 +1181,7 @@ public:
         addTest(TestPtr(new FilterFastBandpassTest));
         addTest(TestPtr(new FilterFastDownscaleTest));
         addTest(TestPtr(new FilterMaskTest));
+        addTest(TestPtr(new SIMDFilterTest));
         addTest(TestPtr(new FilterThresholdTest));
         addTest(TestPtr(new FilterFloodfillTest));
         addTest(TestPtr(new FilterDilationTest));
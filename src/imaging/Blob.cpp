@@ -40,12 +40,60 @@ using namespace std;
 
 namespace avg {
 
-Blob::Blob(const Run& run)
+BlobMoments::BlobMoments()
+    : m_NumRuns(0),
+      m_Area(0),
+      m_SumX(0),
+      m_SumY(0),
+      m_SumXX(0),
+      m_SumYY(0),
+      m_SumXY(0),
+      m_BoundingBox(INT_MAX, INT_MAX, 0, 0)
+{
+}
+
+void BlobMoments::addRun(const Run& run)
+{
+    double start = run.m_StartCol;
+    double end = run.m_EndCol;
+    double row = run.m_Row;
+    double length = end-start;
+    // Sums of x and x^2 over the columns start..end-1.
+    double sumX = ((end-1)*end - (start-1)*start)/2;
+    double sumXX = ((end-1)*end*(2*end-1) - (start-1)*start*(2*start-1))/6;
+    m_NumRuns++;
+    m_Area += length;
+    m_SumX += sumX;
+    m_SumY += length*row;
+    m_SumXX += sumXX;
+    m_SumYY += length*row*row;
+    m_SumXY += sumX*row;
+    m_BoundingBox.tl.x = std::min(m_BoundingBox.tl.x, run.m_StartCol);
+    m_BoundingBox.tl.y = std::min(m_BoundingBox.tl.y, run.m_Row);
+    m_BoundingBox.br.x = std::max(m_BoundingBox.br.x, run.m_EndCol);
+    m_BoundingBox.br.y = std::max(m_BoundingBox.br.y, run.m_Row);
+}
+
+void BlobMoments::add(const BlobMoments& other)
+{
+    m_NumRuns += other.m_NumRuns;
+    m_Area += other.m_Area;
+    m_SumX += other.m_SumX;
+    m_SumY += other.m_SumY;
+    m_SumXX += other.m_SumXX;
+    m_SumYY += other.m_SumYY;
+    m_SumXY += other.m_SumXY;
+    m_BoundingBox.tl.x = std::min(m_BoundingBox.tl.x, other.m_BoundingBox.tl.x);
+    m_BoundingBox.tl.y = std::min(m_BoundingBox.tl.y, other.m_BoundingBox.tl.y);
+    m_BoundingBox.br.x = std::max(m_BoundingBox.br.x, other.m_BoundingBox.br.x);
+    m_BoundingBox.br.y = std::max(m_BoundingBox.br.y, other.m_BoundingBox.br.y);
+}
+
+Blob::Blob(const BlobMoments& moments)
+    : m_Moments(moments)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
-    m_Runs.reserve(50);
-    m_Runs.push_back(run);
-    m_pParent = BlobPtr();
+    m_Runs.reserve(moments.m_NumRuns);
 
     m_bStatsAvailable = false;
 }
@@ -60,21 +108,6 @@ RunArray *Blob::getRuns()
     return &m_Runs;
 }
 
-void Blob::addRun(const Run& run)
-{
-    AVG_ASSERT((m_Runs.end()-1)->m_Row <= run.m_Row);
-    m_Runs.push_back(run);
-}
-
-
-void Blob::merge(const BlobPtr& pOtherBlob)
-{
-    AVG_ASSERT(pOtherBlob);
-    RunArray * pOtherRuns = pOtherBlob->getRuns();
-    m_Runs.insert(m_Runs.end(), pOtherRuns->begin(), pOtherRuns->end());
-    pOtherRuns->clear();
-}
-
 void Blob::render(BitmapPtr pSrcBmp, BitmapPtr pDestBmp, Pixel32 color, 
         int min, int max, bool bFinger, bool bMarkCenter, Pixel32 centerColor)
 {
@@ -154,10 +187,13 @@ bool Blob::contains(IntPoint pt)
 
 void Blob::calcStats()
 {
-    m_Center = calcCenter();
+    double area = m_Moments.m_Area;
+    double centerX = m_Moments.m_SumX/area;
+    double centerY = m_Moments.m_SumY/area;
+    m_Center = glm::vec2(centerX, centerY);
     m_EstimatedNextCenter = m_Center;
-    m_Area = float(calcArea());
-    m_BoundingBox = calcBBox();
+    m_Area = float(area);
+    m_BoundingBox = m_Moments.m_BoundingBox;
     /*
        more useful numbers that can be calculated from c
        see e.g. 
@@ -167,32 +203,15 @@ void Blob::calcStats()
        Inertia = c_xx + c_yy
        Eccentricity = ...
        */
-    float c_xx = 0;  // Variance in x direction
-    float c_yy =0;   // Variance in y direction
-    float c_xy = 0;  // Covariance
-    float ll=0;
+    // Central moments from the raw moments accumulated during labelling.
+    float c_xx = float(m_Moments.m_SumXX/area - centerX*centerX); // Variance in x
+    float c_yy = float(m_Moments.m_SumYY/area - centerY*centerY); // Variance in y
+    float c_xy = float(m_Moments.m_SumXY/area - centerX*centerY); // Covariance
     float l1;
     float l2;
     float tmp_x;
     float tmp_y;
     float mag;
-    for (RunArray::iterator r = m_Runs.begin(); r != m_Runs.end();++r) {
-        //This is the evaluated expression for the variance when using runs...
-        ll = float(r->length());
-        c_yy += ll* (r->m_Row- m_Center.y)*(r->m_Row- m_Center.y);
-        c_xx += ( (r->m_EndCol-1) * r->m_EndCol * (2*r->m_EndCol-1) 
-                - (r->m_StartCol-1) * r->m_StartCol * (2*r->m_StartCol -1))/6.f 
-            - m_Center.x * ((r->m_EndCol-1)*r->m_EndCol-(r->m_StartCol-1)*r->m_StartCol)
-            + ll* m_Center.x*m_Center.x;
-        c_xy += (r->m_Row-m_Center.y)*0.5f*( (r->m_EndCol-1)*r->m_EndCol
-                - (r->m_StartCol-1)*r->m_StartCol) 
-                + ll *(m_Center.x*m_Center.y - m_Center.x*r->m_Row);
-    }
-
-    c_xx /= m_Area;
-    c_yy /= m_Area;
-    c_xy /= m_Area;
-
     m_Inertia = c_xx + c_yy;
 
     float T = sqrt( (c_xx - c_yy) * (c_xx - c_yy) + 4*c_xy*c_xy);
@@ -324,42 +343,6 @@ const BlobPtr Blob::getFirstRelated()
     }
 }
 
-glm::vec2 Blob::calcCenter()
-{
-    glm::vec2 center(0,0);
-    float c = 0;
-    for (RunArray::iterator r = m_Runs.begin(); r != m_Runs.end(); ++r) {
-        center += r->m_Center * float(r->length());
-        c += r->length();
-    }
-    center = center/c;
-    return center;
-}
-
-IntRect Blob::calcBBox()
-{
-    int x1 = INT_MAX;
-    int y1 = INT_MAX;
-    int x2 = 0;
-    int y2 = 0;
-    for (RunArray::iterator r = m_Runs.begin(); r!=m_Runs.end(); ++r) {
-        x1 = std::min(x1, r->m_StartCol);
-        y1 = std::min(y1, r->m_Row);
-        x2 = std::max(x2, r->m_EndCol);
-        y2 = std::max(y2, r->m_Row);
-    }
-    return IntRect(x1, y1, x2, y2);
-}
-
-int Blob::calcArea()
-{
-    int res = 0;
-    for (RunArray::iterator r = m_Runs.begin(); r != m_Runs.end(); ++r) {
-        res+= r->length();
-    }
-    return res;
-}
-
 void Blob::initRowPositions()
 {
     int offset = m_BoundingBox.tl.y;
@@ -480,67 +463,53 @@ bool Blob::ptIsInBlob(const IntPoint& pt)
     return false;
 }
 
-bool areConnected(const Run & run1, const Run & run2)
+BlobLabeller::BlobLabeller()
 {
-    if (run1.m_StartCol > run2.m_StartCol) {
-        return run2.m_EndCol > run1.m_StartCol;
-    } else {
-        return run1.m_EndCol > run2.m_StartCol;
-    }
 }
 
-void storeRuns(BlobVectorPtr pBlobs, RunArray* pUpperRuns, RunArray* pLowerRuns)
+BlobVectorPtr BlobLabeller::findConnectedComponents(BitmapPtr pBmp,
+        unsigned char threshold)
 {
-    for (RunArray::iterator run1_it = pUpperRuns->begin(); run1_it != pUpperRuns->end();
-            ++run1_it)
-    {
-        for (RunArray::iterator run2_it = pLowerRuns->begin(); 
-                run2_it != pLowerRuns->end(); ++run2_it)
-        {
-            if (run2_it->m_StartCol > run1_it->m_EndCol) {
-                break;
-            }
-            if (areConnected(*run1_it, *run2_it)) {
-                BlobPtr pBlob = run1_it->m_pBlob.lock();
-                while (pBlob->m_pParent) {
-                    pBlob = pBlob->m_pParent;
-                }
-                if (!(run2_it->m_pBlob.expired())) {
-                    BlobPtr c_blob = run2_it->m_pBlob.lock();
-                    while (c_blob->m_pParent) {
-                        c_blob = c_blob->m_pParent;
-                    }
-                    if (c_blob != pBlob) {
-                        // When we merge, make sure the smaller blob is merged
-                        // into the bigger one to avoid a speed hit.
-                        if (pBlob->getRuns()->size() > c_blob->getRuns()->size()) {
-                            pBlob->merge(c_blob); //destroys c_blobs runs_list
-                            c_blob->m_pParent = pBlob;
-                        } else {
-                            c_blob->merge(pBlob); 
-                            pBlob->m_pParent = c_blob;
-                        }
-                    }
-                } else {
-                    run2_it->m_pBlob = pBlob;
-                    pBlob->addRun(*run2_it);
-                }
-            }
+    AVG_ASSERT(pBmp->getPixelFormat() == I8);
+    m_Runs.clear();
+    m_Parents.clear();
+    m_Moments.clear();
+    IntPoint size = pBmp->getSize();
+    int upperStart = 0;
+    for (int y = 0; y < size.y; y++) {
+        int lowerStart = int(m_Runs.size());
+        findRunsInLine(pBmp, y, threshold);
+        int lowerEnd = int(m_Runs.size());
+        for (int i = lowerStart; i < lowerEnd; ++i) {
+            m_Parents.push_back(i);
+            m_Moments.push_back(BlobMoments());
+            m_Moments.back().addRun(m_Runs[i]);
         }
+        connectRuns(upperStart, lowerStart, lowerEnd);
+        upperStart = lowerStart;
     }
-    for (RunArray::iterator run2_it = pLowerRuns->begin(); run2_it != pLowerRuns->end();
-            ++run2_it)
-    {
-        if (run2_it->m_pBlob.expired()) {
-            BlobPtr pBlob = BlobPtr(new Blob(*run2_it));
-            pBlobs->push_back(pBlob);
-            run2_it->m_pBlob = pBlob;
+
+    // Hand out the runs to one blob per component, in scan order.
+    BlobVectorPtr pBlobs = BlobVectorPtr(new BlobVector);
+    int numRuns = int(m_Runs.size());
+    m_BlobIndexes.assign(numRuns, -1);
+    for (int i = 0; i < numRuns; ++i) {
+        int root = findRoot(i);
+        if (m_BlobIndexes[root] == -1) {
+            m_BlobIndexes[root] = int(pBlobs->size());
+            pBlobs->push_back(BlobPtr(new Blob(m_Moments[root])));
         }
+        (*pBlobs)[m_BlobIndexes[root]]->getRuns()->push_back(m_Runs[i]);
+    }
+    for (BlobVector::iterator it = pBlobs->begin(); it != pBlobs->end(); ++it) {
+        (*it)->calcStats();
     }
+    return pBlobs;
 }
 
-void findRunsInLine(BitmapPtr pBmp, int y, RunArray* pRuns, unsigned char threshold)
+void BlobLabeller::findRunsInLine(BitmapPtr pBmp, int y, unsigned char threshold)
 {
+    int firstRun = int(m_Runs.size());
     int runStart=0;
     int runStop=0;
     const unsigned char * pPixel = pBmp->getPixels()+y*pBmp->getStride();
@@ -554,15 +523,15 @@ void findRunsInLine(BitmapPtr pBmp, int y, RunArray* pRuns, unsigned char thresh
                 // Only if the run is longer than one pixel.
                 if (x-runStart > 1) {
                     runStop = x;
-                    pRuns->push_back(Run(y, runStart, runStop));
+                    m_Runs.push_back(Run(y, runStart, runStop));
                     runStart = x;
                 }
             } else {
                 runStop = x - 1;
-                if (runStop-runStart == 0 && !pRuns->empty()) {
+                if (runStop-runStart == 0 && int(m_Runs.size()) > firstRun) {
                     // Single dark pixel: ignore the pixel, revive the last run.
-                    runStart = pRuns->back().m_StartCol;
-                    pRuns->pop_back();
+                    runStart = m_Runs.back().m_StartCol;
+                    m_Runs.pop_back();
                 } else {
                     runStart = x;
                 }
@@ -572,45 +541,61 @@ void findRunsInLine(BitmapPtr pBmp, int y, RunArray* pRuns, unsigned char thresh
         pPixel++;
     }
     if (bIsInRun) {
-        pRuns->push_back(Run(y, runStart, width));
+        m_Runs.push_back(Run(y, runStart, width));
     }
 }
 
-BlobVectorPtr findConnectedComponents(BitmapPtr pBmp, unsigned char threshold)
+void BlobLabeller::connectRuns(int upperStart, int lowerStart, int lowerEnd)
 {
-    AVG_ASSERT(pBmp->getPixelFormat() == I8);
-    BlobVectorPtr pBlobs = BlobVectorPtr(new BlobVector);
-    IntPoint size = pBmp->getSize();
-    RunArray* pUpperRuns = new RunArray();
-    RunArray* pLowerRuns = new RunArray();
-
-    int y = 0;
-    findRunsInLine(pBmp, 0, pUpperRuns, threshold);
-    for (RunArray::iterator it = pUpperRuns->begin(); it!=pUpperRuns->end(); ++it) {
-        BlobPtr pBlob = BlobPtr(new Blob(*it));
-        pBlobs->push_back(pBlob);
-        it->m_pBlob = pBlob;
+    // Both rows are sorted by column, so overlapping runs can be found by walking
+    // them in parallel.
+    int upper = upperStart;
+    int lower = lowerStart;
+    while (upper < lowerStart && lower < lowerEnd) {
+        const Run& upperRun = m_Runs[upper];
+        const Run& lowerRun = m_Runs[lower];
+        if (upperRun.m_StartCol < lowerRun.m_EndCol && 
+                lowerRun.m_StartCol < upperRun.m_EndCol)
+        {
+            unite(upper, lower);
+        }
+        if (upperRun.m_EndCol < lowerRun.m_EndCol) {
+            upper++;
+        } else {
+            lower++;
+        }
     }
-    
-    for (y = 1; y < size.y; y++) {
-        findRunsInLine(pBmp, y, pLowerRuns, threshold);
-        storeRuns(pBlobs, pUpperRuns, pLowerRuns);
-        RunArray* pTmpRuns = pUpperRuns;
-        pUpperRuns = pLowerRuns;
-        pLowerRuns = pTmpRuns;
-        pLowerRuns->clear();
+}
+
+int BlobLabeller::findRoot(int run)
+{
+    while (m_Parents[run] != run) {
+        // Path halving.
+        m_Parents[run] = m_Parents[m_Parents[run]];
+        run = m_Parents[run];
     }
-    BlobVectorPtr pResultBlobs = BlobVectorPtr(new BlobVector);
-    for (BlobVector::iterator it = pBlobs->begin(); it != pBlobs->end(); ++it) {
-        if (!(*it)->m_pParent) {
-            pResultBlobs->push_back(*it);
-            (*it)->calcStats();
-        }
+    return run;
+}
+
+void BlobLabeller::unite(int run1, int run2)
+{
+    int root1 = findRoot(run1);
+    int root2 = findRoot(run2);
+    if (root1 == root2) {
+        return;
+    }
+    // The earlier run stays root so components keep their scan order.
+    if (root2 < root1) {
+        std::swap(root1, root2);
     }
-    delete pUpperRuns;
-    delete pLowerRuns;
-    return pResultBlobs;
+    m_Parents[root2] = root1;
+    m_Moments[root1].add(m_Moments[root2]);
 }
 
+BlobVectorPtr findConnectedComponents(BitmapPtr pBmp, unsigned char threshold)
+{
+    BlobLabeller labeller;
+    return labeller.findConnectedComponents(pBmp, threshold);
+}
 
 }
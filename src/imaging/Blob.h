@@ -47,14 +47,30 @@ typedef std::vector<BlobWeakPtr> BlobWeakPtrVector;
 typedef boost::shared_ptr<BlobVector> BlobVectorPtr;
 typedef std::vector<IntPoint> ContourSeq;
 
+// Raw pixel moments of a set of runs. Moments of disjoint run sets can simply be
+// added, so they can be accumulated while the runs are being labelled.
+struct AVG_API BlobMoments
+{
+    BlobMoments();
+    void addRun(const Run& run);
+    void add(const BlobMoments& other);
+
+    int m_NumRuns;
+    double m_Area;
+    double m_SumX;
+    double m_SumY;
+    double m_SumXX;
+    double m_SumYY;
+    double m_SumXY;
+    IntRect m_BoundingBox;
+};
+
 class AVG_API Blob
 {
     public:
-        Blob(const Run& run);
+        Blob(const BlobMoments& moments);
         ~Blob();
 
-        void addRun(const Run& run);
-        void merge(const BlobPtr& other);
         RunArray* getRuns();
         void render(BitmapPtr pSrcBmp, BitmapPtr pDestBmp, Pixel32 Color, 
                 int Min, int Max, bool bFinger, bool bMarkCenter, 
@@ -81,22 +97,18 @@ class AVG_API Blob
         void addRelated(BlobPtr pBlob);
         const BlobPtr getFirstRelated(); 
 
-        BlobPtr m_pParent;
-
     private:
         Blob(const Blob &);
-        glm::vec2 calcCenter();
-        IntRect calcBBox();
-        int calcArea();
         void initRowPositions();
         IntPoint findNeighborInside(const IntPoint& Pt, int& Dir);
         bool ptIsInBlob(const IntPoint& Pt);
 
-        RunArray m_Runs; // This array is unsorted until contours are calculated.
+        RunArray m_Runs; // Sorted by row, then by column.
         std::vector<RunArray::iterator> m_RowPositions;
         BlobWeakPtrVector m_RelatedBlobs; // For fingers, this contains the hand.
                                           // For hands, this contains the fingers.
 
+        BlobMoments m_Moments;
         bool m_bStatsAvailable;
         glm::vec2 m_EstimatedNextCenter;
         glm::vec2 m_Center;
@@ -112,6 +124,29 @@ class AVG_API Blob
         ContourSeq m_Contour;
 };
 
+// Finds the connected components of the pixels brighter than threshold. The runs
+// of a frame are kept in one array and joined using union-find; the moments of each
+// component are accumulated in the same pass. Keep the labeller around between
+// frames to reuse its buffers.
+class AVG_API BlobLabeller
+{
+    public:
+        BlobLabeller();
+
+        BlobVectorPtr findConnectedComponents(BitmapPtr pBmp, unsigned char threshold);
+
+    private:
+        void findRunsInLine(BitmapPtr pBmp, int y, unsigned char threshold);
+        void connectRuns(int upperStart, int lowerStart, int lowerEnd);
+        int findRoot(int run);
+        void unite(int run1, int run2);
+
+        RunArray m_Runs;
+        std::vector<int> m_Parents;
+        std::vector<BlobMoments> m_Moments;
+        std::vector<int> m_BlobIndexes;
+};
+
 BlobVectorPtr AVG_API findConnectedComponents(BitmapPtr pBmp, 
         unsigned char threshold);
 
@@ -0,0 +1,292 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "BlobMatcher.h"
+
+#include "../glm/gtx/norm.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+namespace avg {
+
+// Cost of a pair that isn't allowed to match.
+static const float FORBIDDEN = 1e30f;
+// Upper bound for the number of grid cells per side.
+static const int MAX_GRID_CELLS = 64;
+
+BlobMatcher::BlobMatcher()
+{
+}
+
+void BlobMatcher::match(const vector<glm::vec2>& oldPositions, 
+        const vector<glm::vec2>& newPositions, float maxDist)
+{
+    int numOld = int(oldPositions.size());
+    int numNew = int(newPositions.size());
+    m_Matches.assign(numNew, -1);
+    if (numOld == 0 || numNew == 0) {
+        return;
+    }
+    findCandidates(oldPositions, newPositions, maxDist);
+
+    // Old and new blobs that share candidate pairs form a cluster. Each cluster can
+    // be assigned independently.
+    m_Parents.resize(numOld+numNew);
+    for (int i = 0; i < numOld+numNew; ++i) {
+        m_Parents[i] = i;
+    }
+    for (vector<Candidate>::iterator it = m_Candidates.begin(); 
+            it != m_Candidates.end(); ++it)
+    {
+        int oldRoot = findRoot(it->m_OldIndex);
+        int newRoot = findRoot(numOld+it->m_NewIndex);
+        if (oldRoot != newRoot) {
+            m_Parents[newRoot] = oldRoot;
+        }
+    }
+    for (vector<Candidate>::iterator it = m_Candidates.begin(); 
+            it != m_Candidates.end(); ++it)
+    {
+        it->m_Cluster = findRoot(it->m_OldIndex);
+    }
+    sort(m_Candidates.begin(), m_Candidates.end(), clusterIsLess);
+
+    m_LocalIndexes.assign(numOld+numNew, -1);
+    float unmatchedCost = maxDist*maxDist/2;
+    int numCandidates = int(m_Candidates.size());
+    int first = 0;
+    while (first < numCandidates) {
+        int last = first+1;
+        while (last < numCandidates && 
+                m_Candidates[last].m_Cluster == m_Candidates[first].m_Cluster)
+        {
+            last++;
+        }
+        if (last-first == 1) {
+            // A pair with no competitors: Matching always beats the penalty.
+            m_Matches[m_Candidates[first].m_NewIndex] = m_Candidates[first].m_OldIndex;
+        } else {
+            assignCluster(first, last-first, unmatchedCost);
+        }
+        first = last;
+    }
+}
+
+int BlobMatcher::getMatch(int newIndex) const
+{
+    return m_Matches[newIndex];
+}
+
+bool BlobMatcher::clusterIsLess(const Candidate& c1, const Candidate& c2)
+{
+    return c1.m_Cluster < c2.m_Cluster;
+}
+
+void BlobMatcher::findCandidates(const vector<glm::vec2>& oldPositions, 
+        const vector<glm::vec2>& newPositions, float maxDist)
+{
+    m_Candidates.clear();
+    int numOld = int(oldPositions.size());
+    int numNew = int(newPositions.size());
+
+    // Sort the old positions into a grid with cells at least maxDist wide, so
+    // candidates for a new position are always in the 3x3 cells around it.
+    glm::vec2 minPos = oldPositions[0];
+    glm::vec2 maxPos = oldPositions[0];
+    for (int i = 1; i < numOld; ++i) {
+        minPos = glm::min(minPos, oldPositions[i]);
+        maxPos = glm::max(maxPos, oldPositions[i]);
+    }
+    glm::vec2 extent = maxPos-minPos;
+    float cellSize = max(maxDist, max(extent.x, extent.y)/MAX_GRID_CELLS);
+    cellSize = max(cellSize, 0.001f);
+    int gridWidth = int(extent.x/cellSize)+1;
+    int gridHeight = int(extent.y/cellSize)+1;
+    int numCells = gridWidth*gridHeight;
+
+    m_CellIndexes.resize(numOld);
+    m_CellStarts.assign(numCells+1, 0);
+    for (int i = 0; i < numOld; ++i) {
+        int x = min(int((oldPositions[i].x-minPos.x)/cellSize), gridWidth-1);
+        int y = min(int((oldPositions[i].y-minPos.y)/cellSize), gridHeight-1);
+        m_CellIndexes[i] = y*gridWidth+x;
+        m_CellStarts[m_CellIndexes[i]+1]++;
+    }
+    for (int i = 0; i < numCells; ++i) {
+        m_CellStarts[i+1] += m_CellStarts[i];
+    }
+    m_CellEntries.resize(numOld);
+    for (int i = 0; i < numOld; ++i) {
+        m_CellEntries[m_CellStarts[m_CellIndexes[i]]++] = i;
+    }
+    // The fill loop advanced every start to the start of the next cell.
+    for (int i = numCells; i > 0; --i) {
+        m_CellStarts[i] = m_CellStarts[i-1];
+    }
+    m_CellStarts[0] = 0;
+
+    float maxDistSquared = maxDist*maxDist;
+    for (int j = 0; j < numNew; ++j) {
+        const glm::vec2& newPos = newPositions[j];
+        float gridX = (newPos.x-minPos.x)/cellSize;
+        float gridY = (newPos.y-minPos.y)/cellSize;
+        if (gridX < -1 || gridX >= gridWidth+1 || gridY < -1 || gridY >= gridHeight+1) {
+            continue;
+        }
+        int cellX = int(floor(gridX));
+        int cellY = int(floor(gridY));
+        for (int y = max(cellY-1, 0); y <= min(cellY+1, gridHeight-1); ++y) {
+            for (int x = max(cellX-1, 0); x <= min(cellX+1, gridWidth-1); ++x) {
+                int cell = y*gridWidth+x;
+                for (int k = m_CellStarts[cell]; k < m_CellStarts[cell+1]; ++k) {
+                    int i = m_CellEntries[k];
+                    float distSquared = glm::distance2(newPos, oldPositions[i]);
+                    if (distSquared <= maxDistSquared) {
+                        Candidate candidate;
+                        candidate.m_OldIndex = i;
+                        candidate.m_NewIndex = j;
+                        candidate.m_DistSquared = distSquared;
+                        candidate.m_Cluster = -1;
+                        m_Candidates.push_back(candidate);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void BlobMatcher::assignCluster(int firstCandidate, int numCandidates, 
+        float unmatchedCost)
+{
+    // Collect the blobs of the cluster.
+    int numOld = int(m_LocalIndexes.size()-m_Matches.size());
+    m_ClusterOld.clear();
+    m_ClusterNew.clear();
+    for (int c = firstCandidate; c < firstCandidate+numCandidates; ++c) {
+        const Candidate& candidate = m_Candidates[c];
+        if (m_LocalIndexes[candidate.m_OldIndex] == -1) {
+            m_LocalIndexes[candidate.m_OldIndex] = int(m_ClusterOld.size());
+            m_ClusterOld.push_back(candidate.m_OldIndex);
+        }
+        if (m_LocalIndexes[numOld+candidate.m_NewIndex] == -1) {
+            m_LocalIndexes[numOld+candidate.m_NewIndex] = int(m_ClusterNew.size());
+            m_ClusterNew.push_back(candidate.m_NewIndex);
+        }
+    }
+
+    // Square cost matrix: rows are the old blobs followed by one 'unmatched' slot
+    // per new blob, columns are the new blobs followed by one 'unmatched' slot per
+    // old blob.
+    int k = int(m_ClusterOld.size());
+    int m = int(m_ClusterNew.size());
+    int n = k+m;
+    m_Costs.assign(n*n, FORBIDDEN);
+    for (int c = firstCandidate; c < firstCandidate+numCandidates; ++c) {
+        const Candidate& candidate = m_Candidates[c];
+        int row = m_LocalIndexes[candidate.m_OldIndex];
+        int col = m_LocalIndexes[numOld+candidate.m_NewIndex];
+        m_Costs[row*n+col] = candidate.m_DistSquared;
+    }
+    for (int i = 0; i < k; ++i) {
+        m_Costs[i*n+m+i] = unmatchedCost;
+    }
+    for (int j = 0; j < m; ++j) {
+        m_Costs[(k+j)*n+j] = unmatchedCost;
+    }
+    for (int i = k; i < n; ++i) {
+        for (int j = m; j < n; ++j) {
+            m_Costs[i*n+j] = 0;
+        }
+    }
+
+    // Hungarian method with potentials, O(n^3). Arrays are 1-based; column 0 is
+    // a sentinel.
+    m_U.assign(n+1, 0);
+    m_V.assign(n+1, 0);
+    m_Assignment.assign(n+1, 0);
+    m_Way.assign(n+1, 0);
+    for (int i = 1; i <= n; ++i) {
+        m_Assignment[0] = i;
+        int j0 = 0;
+        m_MinV.assign(n+1, FORBIDDEN*2.);
+        m_Used.assign(n+1, 0);
+        do {
+            m_Used[j0] = 1;
+            int i0 = m_Assignment[j0];
+            double delta = FORBIDDEN*2.;
+            int j1 = 0;
+            for (int j = 1; j <= n; ++j) {
+                if (!m_Used[j]) {
+                    double cur = m_Costs[(i0-1)*n+j-1]-m_U[i0]-m_V[j];
+                    if (cur < m_MinV[j]) {
+                        m_MinV[j] = cur;
+                        m_Way[j] = j0;
+                    }
+                    if (m_MinV[j] < delta) {
+                        delta = m_MinV[j];
+                        j1 = j;
+                    }
+                }
+            }
+            for (int j = 0; j <= n; ++j) {
+                if (m_Used[j]) {
+                    m_U[m_Assignment[j]] += delta;
+                    m_V[j] -= delta;
+                } else {
+                    m_MinV[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (m_Assignment[j0] != 0);
+        do {
+            int j1 = m_Way[j0];
+            m_Assignment[j0] = m_Assignment[j1];
+            j0 = j1;
+        } while (j0);
+    }
+
+    for (int j = 1; j <= m; ++j) {
+        int row = m_Assignment[j]-1;
+        if (row < k && m_Costs[row*n+j-1] != FORBIDDEN) {
+            m_Matches[m_ClusterNew[j-1]] = m_ClusterOld[row];
+        }
+    }
+    for (int i = 0; i < k; ++i) {
+        m_LocalIndexes[m_ClusterOld[i]] = -1;
+    }
+    for (int j = 0; j < m; ++j) {
+        m_LocalIndexes[numOld+m_ClusterNew[j]] = -1;
+    }
+}
+
+int BlobMatcher::findRoot(int node)
+{
+    while (m_Parents[node] != node) {
+        m_Parents[node] = m_Parents[m_Parents[node]];
+        node = m_Parents[node];
+    }
+    return node;
+}
+
+}
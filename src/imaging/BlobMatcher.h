@@ -0,0 +1,88 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#ifndef _BlobMatcher_H_
+#define _BlobMatcher_H_
+
+#include "../api.h"
+
+#include "../base/GLMHelper.h"
+
+#include <vector>
+
+namespace avg {
+
+// Matches the blobs of a frame to the blobs of the previous frame. Candidate pairs
+// closer than maxDist are found using a uniform grid. Pairs are then assigned so
+// that the sum of the squared distances plus a penalty of maxDist^2/2 for every
+// unmatched blob is minimal. The Hungarian method runs separately on each cluster
+// of blobs that share candidates, so the cost stays low as long as the clusters are
+// small. All buffers are kept between calls.
+class AVG_API BlobMatcher
+{
+public:
+    BlobMatcher();
+
+    void match(const std::vector<glm::vec2>& oldPositions, 
+            const std::vector<glm::vec2>& newPositions, float maxDist);
+    // Returns the index of the old position matched to newIndex, or -1.
+    int getMatch(int newIndex) const;
+
+private:
+    struct Candidate {
+        int m_OldIndex;
+        int m_NewIndex;
+        float m_DistSquared;
+        int m_Cluster;
+    };
+    static bool clusterIsLess(const Candidate& c1, const Candidate& c2);
+
+    void findCandidates(const std::vector<glm::vec2>& oldPositions, 
+            const std::vector<glm::vec2>& newPositions, float maxDist);
+    void assignCluster(int firstCandidate, int numCandidates, float unmatchedCost);
+    int findRoot(int node);
+
+    std::vector<int> m_Matches;
+
+    std::vector<int> m_CellStarts;
+    std::vector<int> m_CellEntries;
+    std::vector<int> m_CellIndexes;
+    std::vector<Candidate> m_Candidates;
+    std::vector<int> m_Parents;
+
+    // Per-cluster buffers
+    std::vector<int> m_ClusterOld;
+    std::vector<int> m_ClusterNew;
+    std::vector<int> m_LocalIndexes;
+    std::vector<float> m_Costs;
+    std::vector<double> m_U;
+    std::vector<double> m_V;
+    std::vector<int> m_Assignment;
+    std::vector<int> m_Way;
+    std::vector<double> m_MinV;
+    std::vector<char> m_Used;
+};
+
+}
+
+#endif
@@ -524,13 +524,15 @@ void TrackerThread::calcBlobs(BitmapPtr pTrackBmp, BitmapPtr pTouchBmp, long lon
         }
         {
             if (m_TrackThreshold != 0) {
-                pTrackComps = findConnectedComponents(pTrackBmp, m_TrackThreshold);
+                pTrackComps = m_TrackLabeller.findConnectedComponents(pTrackBmp,
+                        m_TrackThreshold);
                 calcContours(pTrackComps);
                 drawBlobs(pTrackComps, pTrackBmp, pDestBmp, m_TrackThreshold, false);
                 pTrackComps = findRelevantBlobs(pTrackComps, false);
             }
             if (m_TouchThreshold != 0) {
-                pTouchComps = findConnectedComponents(pTouchBmp, m_TouchThreshold);
+                pTouchComps = m_TouchLabeller.findConnectedComponents(pTouchBmp,
+                        m_TouchThreshold);
                 pTouchComps = findRelevantBlobs(pTouchComps, true);
                 correlateHands(pTrackComps, pTouchComps);
                 drawBlobs(pTouchComps, pTouchBmp, pDestBmp, m_TouchThreshold, true);
@@ -127,6 +127,8 @@ class AVG_API TrackerThread: public WorkerThread<TrackerThread>
         
         GLContext* m_pImagingContext;
         FilterPtr m_pBandpassFilter;
+        BlobLabeller m_TrackLabeller;
+        BlobLabeller m_TouchLabeller;
 };
 
 }
@@ -0,0 +1,120 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "BlobMatcher.h"
+
+#include "../base/TimeSource.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace avg;
+using namespace std;
+
+template<class TEST>
+void runPerformanceTest(TEST& PerfTest, int numRuns)
+{
+    long long StartTime = TimeSource::get()->getCurrentMicrosecs();
+    for (int i = 0; i < numRuns; ++i) {
+        PerfTest.run();
+    }
+    float ActiveTime = (TimeSource::get()->getCurrentMicrosecs()-StartTime)/1000.; 
+    cerr << PerfTest.getName() << ": " << ActiveTime/numRuns << " ms" << endl;
+}
+
+class PerfTestBase {
+public:
+    PerfTestBase(string sName) 
+        : m_sName(sName)
+    {
+    }
+
+    std::string getName()
+    {
+        return m_sName;
+    }
+
+private:
+    std::string m_sName;
+};
+
+// Replays numBlobs blobs moving across a 1280x800 camera image through the
+// BlobMatcher. Every frame, a few blobs disappear and new ones appear.
+class BlobMatcherPerfTest: public PerfTestBase {
+public:
+    BlobMatcherPerfTest(const string& sName, int numBlobs)
+        : PerfTestBase(sName),
+          m_NumBlobs(numBlobs)
+    {
+        srand(42);
+        for (int i = 0; i < numBlobs; ++i) {
+            m_NewPositions.push_back(randomPos());
+            m_Velocities.push_back(glm::vec2(rand()%11-5, rand()%11-5));
+        }
+    }
+
+    void run()
+    {
+        m_OldPositions.swap(m_NewPositions);
+        m_NewPositions.clear();
+        for (int i = 0; i < m_NumBlobs; ++i) {
+            if (rand()%50 == 0) {
+                m_NewPositions.push_back(randomPos());
+            } else {
+                glm::vec2 jitter(rand()%3-1, rand()%3-1);
+                m_NewPositions.push_back(m_OldPositions[i]+m_Velocities[i]+jitter);
+            }
+        }
+        m_Matcher.match(m_OldPositions, m_NewPositions, 20);
+    }
+
+private:
+    glm::vec2 randomPos()
+    {
+        return glm::vec2(rand()%1280, rand()%800);
+    }
+
+    int m_NumBlobs;
+    BlobMatcher m_Matcher;
+    vector<glm::vec2> m_OldPositions;
+    vector<glm::vec2> m_NewPositions;
+    vector<glm::vec2> m_Velocities;
+};
+
+void runPerformanceTests()
+{
+    int numBlobs[] = {10, 40, 100, 400};
+    for (int i = 0; i < 4; ++i) {
+        stringstream ss;
+        ss << "BlobMatcherPerfTest (" << numBlobs[i] << " blobs)";
+        BlobMatcherPerfTest perfTest(ss.str(), numBlobs[i]);
+        runPerformanceTest(perfTest, 1000);
+    }
+}
+
+int main(int nargs, char** args)
+{
+    runPerformanceTests();
+}
@@ -25,9 +25,11 @@
 #include "DeDistort.h"
 #include "FilterWipeBorder.h"
 #include "FilterClearBorder.h"
+#include "BlobMatcher.h"
 
 #include "../graphics/GraphicsTest.h"
 #include "../graphics/Filtergrayscale.h"
+#include "../graphics/Filterfill.h"
 #include "../graphics/BitmapLoader.h"
 
 #include "../base/TestSuite.h"
@@ -170,6 +172,92 @@ public:
     }
 };
 
+class BlobTest: public Test
+{
+public:
+    BlobTest()
+      : Test("BlobTest", 2)
+    {}
+
+    void runTests()
+    {
+        BitmapPtr pBmp(new Bitmap(IntPoint(16, 12), I8));
+        FilterFill<Pixel8>(Pixel8(0)).applyInPlace(pBmp);
+        // U shape: Two bars that are only connected by their bottom row.
+        fillRect(pBmp, IntRect(1, 1, 3, 6));
+        fillRect(pBmp, IntRect(5, 1, 7, 6));
+        fillRect(pBmp, IntRect(1, 6, 7, 7));
+        // Square
+        fillRect(pBmp, IntRect(10, 2, 13, 5));
+
+        BlobLabeller labeller;
+        for (int i = 0; i < 2; ++i) {
+            BlobVectorPtr pBlobs = labeller.findConnectedComponents(pBmp, 128);
+            TEST(pBlobs->size() == 2);
+            BlobPtr pUBlob = (*pBlobs)[0];
+            TEST(pUBlob->getArea() == 26);
+            TEST(almostEqual(pUBlob->getCenter(), glm::vec2(3.5f, 96.f/26)));
+            TEST(pUBlob->getRuns()->size() == 11);
+            TEST(pUBlob->contains(IntPoint(6, 3)));
+            TEST(!pUBlob->contains(IntPoint(4, 3)));
+            BlobPtr pSquareBlob = (*pBlobs)[1];
+            TEST(pSquareBlob->getArea() == 9);
+            TEST(almostEqual(pSquareBlob->getCenter(), glm::vec2(11, 3)));
+            TEST(pSquareBlob->getBoundingBox() == IntRect(10, 2, 13, 4));
+            TEST(almostEqual(pSquareBlob->getInertia(), 4.f/3));
+        }
+    }
+
+private:
+    void fillRect(BitmapPtr pBmp, const IntRect& rect)
+    {
+        for (int y = rect.tl.y; y < rect.br.y; ++y) {
+            for (int x = rect.tl.x; x < rect.br.x; ++x) {
+                pBmp->setPixel(IntPoint(x, y), Pixel8(255));
+            }
+        }
+    }
+};
+
+class BlobMatcherTest: public Test
+{
+public:
+    BlobMatcherTest()
+      : Test("BlobMatcherTest", 2)
+    {}
+
+    void runTests()
+    {
+        BlobMatcher matcher;
+        vector<glm::vec2> oldPositions;
+        vector<glm::vec2> newPositions;
+        matcher.match(oldPositions, newPositions, 5);
+        newPositions.push_back(glm::vec2(9, 0));
+        matcher.match(oldPositions, newPositions, 5);
+        TEST(matcher.getMatch(0) == -1);
+
+        oldPositions.push_back(glm::vec2(0, 0));
+        oldPositions.push_back(glm::vec2(10, 0));
+        newPositions.push_back(glm::vec2(1, 0));
+        newPositions.push_back(glm::vec2(100, 100));
+        matcher.match(oldPositions, newPositions, 5);
+        TEST(matcher.getMatch(0) == 1);
+        TEST(matcher.getMatch(1) == 0);
+        TEST(matcher.getMatch(2) == -1);
+
+        // Matching the closest pair first would leave both other blobs unmatched.
+        oldPositions.clear();
+        oldPositions.push_back(glm::vec2(0, 0));
+        oldPositions.push_back(glm::vec2(3, 0));
+        newPositions.clear();
+        newPositions.push_back(glm::vec2(2, 0));
+        newPositions.push_back(glm::vec2(5, 0));
+        matcher.match(oldPositions, newPositions, 2.9f);
+        TEST(matcher.getMatch(0) == 0);
+        TEST(matcher.getMatch(1) == 1);
+    }
+};
+
 #ifdef _WIN32
 #pragma warning(disable: 4996)
 #endif
@@ -218,6 +306,8 @@ public:
         addTest(TestPtr(new FilterWipeBorderTest));
         addTest(TestPtr(new FilterClearBorderTest));
         addTest(TestPtr(new DeDistortTest));
+        addTest(TestPtr(new BlobTest));
+        addTest(TestPtr(new BlobMatcherTest));
         addTest(TestPtr(new SerializeTest));
     }
 };
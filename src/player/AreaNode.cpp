@@ -107,6 +107,8 @@ void AreaNode::connectDisplay()
         notifySubscribers("SIZE_CHANGED", m_RelViewport.size());
     }
     m_bTransformChanged = true;
+    setCanvasDirty();
+    invalidateHitBounds();
     Node::connectDisplay();
 }
 
@@ -182,6 +184,8 @@ void AreaNode::setAngle(float angle)
 {
     m_Angle = fmod(angle, 2*PI);
     m_bTransformChanged = true;
+    setCanvasDirty();
+    invalidateHitBounds();
 }
 
 glm::vec2 AreaNode::getPivot() const
@@ -199,6 +203,8 @@ void AreaNode::setPivot(const glm::vec2& pt)
     m_Pivot.y = pt.y;
     m_bHasCustomPivot = true;
     m_bTransformChanged = true;
+    setCanvasDirty();
+    invalidateHitBounds();
 }
 
 const std::string& AreaNode::getElementOutlineColor() const
@@ -214,6 +220,7 @@ void AreaNode::setElementOutlineColor(const std::string& sColor)
     } else {
         m_ElementOutlineColor = colorStringToColor(m_sElementOutlineColor);
     }
+    setCanvasDirty();
 }
 
 glm::vec2 AreaNode::toLocal(const glm::vec2& globalPos) const
@@ -237,11 +244,39 @@ void AreaNode::getElementsByPos(const glm::vec2& pos, vector<NodePtr>& pElements
     }
 }
 
+FRect AreaNode::calcHitBounds()
+{
+    if (reactsToMouseEvents()) {
+        return getTransformedBounds(FRect(glm::vec2(0,0), getSize()));
+    } else {
+        return getEmptyHitBounds();
+    }
+}
+
+FRect AreaNode::getTransformedBounds(const FRect& localRect) const
+{
+    // Inverse of AreaNode::toLocal(), applied to the corners of the rectangle.
+    glm::vec2 corners[4] = {localRect.tl, glm::vec2(localRect.br.x, localRect.tl.y),
+            localRect.br, glm::vec2(localRect.tl.x, localRect.br.y)};
+    glm::vec2 pivot = getPivot();
+    FRect bounds;
+    for (int i = 0; i < 4; ++i) {
+        glm::vec2 pt = getRotatedPivot(corners[i], m_Angle, pivot) + m_RelViewport.tl;
+        if (i == 0) {
+            bounds = FRect(pt, pt);
+        } else {
+            bounds.expand(FRect(pt, pt));
+        }
+    }
+    return bounds;
+}
+
 void AreaNode::maybeRender(const glm::mat4& parentTransform)
 {
     AVG_ASSERT(getState() == NS_CANRENDER);
     if (isVisible()) {
         calcTransform();
+        m_ParentTransform = parentTransform;
         m_Transform = parentTransform*m_LocalTransform;
         render();
     }
@@ -295,6 +330,8 @@ void AreaNode::setViewport(float x, float y, float width, float height)
         notifySubscribers("SIZE_CHANGED", m_RelViewport.size());
     }
     m_bTransformChanged = true;
+    setCanvasDirty();
+    invalidateHitBounds();
 }
 
 const FRect& AreaNode::getRelViewport() const
@@ -320,6 +357,17 @@ const glm::mat4& AreaNode::getTransform() const
     return m_Transform;
 }
 
+const glm::mat4& AreaNode::getLocalTransform()
+{
+    calcTransform();
+    return m_LocalTransform;
+}
+
+const glm::mat4& AreaNode::getParentTransform() const
+{
+    return m_ParentTransform;
+}
+
 glm::vec2 AreaNode::getUserSize() const
 {
     return m_UserSize;
@@ -109,6 +109,10 @@ class AVG_API AreaNode: public Node
         AreaNode();
         glm::vec2 getUserSize() const;
         Pixel32 getEffectiveOutlineColor(Pixel32 parentColor) const;
+        const glm::mat4& getLocalTransform();
+        const glm::mat4& getParentTransform() const;
+        virtual FRect calcHitBounds();
+        FRect getTransformedBounds(const FRect& localRect) const;
 
     private:
         void calcTransform();
@@ -123,6 +127,7 @@ class AVG_API AreaNode: public Node
         glm::vec2 m_UserSize;
         glm::mat4 m_Transform;
         glm::mat4 m_LocalTransform;
+        glm::mat4 m_ParentTransform;
         bool m_bTransformChanged;
 };
 
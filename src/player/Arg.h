@@ -47,6 +47,7 @@ public:
     void setValue(const T& Value);
     const T& getValue() const;
     virtual void setMember(ExportedObject * pObj) const;
+    virtual void getMember(const ExportedObject * pObj);
     virtual ArgBase* createCopy() const;
 
 private:
@@ -88,6 +89,15 @@ void Arg<T>::setMember(ExportedObject * pObj) const
     }
 }
 
+template<class T>
+void Arg<T>::getMember(const ExportedObject * pObj)
+{
+    if (getMemberOffset() != -1) {
+        const T* pMember = (const T*)((const char*)pObj+getMemberOffset());
+        m_Value = *pMember;
+    }
+}
+
 template<class T>
 ArgBase* Arg<T>::createCopy() const
 {
@@ -58,6 +58,11 @@ bool ArgBase::isRequired() const
     return m_bRequired;
 }
 
+bool ArgBase::hasMember() const
+{
+    return m_MemberOffset != -1;
+}
+
 ptrdiff_t ArgBase::getMemberOffset() const
 {
     return m_MemberOffset;
@@ -43,8 +43,11 @@ public:
     std::string getName() const;
     bool isDefault() const;
     bool isRequired() const;
+    bool hasMember() const;
     
     virtual void setMember(ExportedObject * pObj) const = 0;
+    // Inverse of setMember(): Reads the current value from the object's member.
+    virtual void getMember(const ExportedObject * pObj) = 0;
    
     virtual ArgBase* createCopy() const = 0;
 
@@ -39,26 +39,141 @@ namespace avg {
 
 typedef std::vector<std::vector<glm::vec2> > CollVec2Vector;
 
+void stringToArgValue(const string& sValue, string& result)
+{
+    result = sValue;
+}
+
+void stringToArgValue(const string& sValue, UTF8String& result)
+{
+    result = sValue;
+}
+
+void stringToArgValue(const string& sValue, int& result)
+{
+    result = stringToInt(sValue);
+}
+
+void stringToArgValue(const string& sValue, float& result)
+{
+    result = stringToFloat(sValue);
+}
+
+void stringToArgValue(const string& sValue, bool& result)
+{
+    result = stringToBool(sValue);
+}
+
+void stringToArgValue(const string& sValue, glm::vec2& result)
+{
+    result = stringToVec2(sValue);
+}
+
+void stringToArgValue(const string& sValue, glm::vec3& result)
+{
+    result = stringToVec3(sValue);
+}
+
+void stringToArgValue(const string& sValue, glm::ivec3& result)
+{
+    result = stringToIVec3(sValue);
+}
+
+template<class T>
+void stringToArgValue(const string& sValue, vector<T>& result)
+{
+    fromString(sValue, result);
+}
+
+template<class T>
+void setArgFromString(ArgBase* pArg, const string& sValue)
+{
+    T value;
+    stringToArgValue(sValue, value);
+    static_cast<Arg<T>*>(pArg)->setValue(value);
+}
+
+template<class T>
+void setArgFromPy(ArgBase* pArg, const string& sName, const py::object& value)
+{
+    Arg<T>* pTypedArg = static_cast<Arg<T>*>(pArg);
+    py::extract<T> valProxy(value);
+    if (!valProxy.check()) {
+        string sTypeName = getFriendlyTypeName(pTypedArg->getValue());
+        throw Exception(AVG_ERR_INVALID_ARGS, "Type error in argument "+sName+": "
+                +sTypeName+" expected.");
+    }
+    pTypedArg->setValue(valProxy());
+}
+
+template<class T>
+bool initPySetter(const ArgBasePtr& pArg, ArgDispatch& dispatch)
+{
+    if (dynamic_cast<Arg<T>*>(pArg.get())) {
+        dispatch.m_pPySetter = &setArgFromPy<T>;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+template<class T>
+bool initSetters(const ArgBasePtr& pArg, ArgDispatch& dispatch)
+{
+    if (initPySetter<T>(pArg, dispatch)) {
+        dispatch.m_pStringSetter = &setArgFromString<T>;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+ArgDispatch createArgDispatch(const ArgBasePtr& pArg)
+{
+    ArgDispatch dispatch;
+    dispatch.m_pDefault = pArg;
+    dispatch.m_pStringSetter = 0;
+    dispatch.m_pPySetter = 0;
+    // FontStyle arguments can't be set from xml.
+    initSetters<string>(pArg, dispatch) ||
+            initSetters<UTF8String>(pArg, dispatch) ||
+            initSetters<int>(pArg, dispatch) ||
+            initSetters<float>(pArg, dispatch) ||
+            initSetters<bool>(pArg, dispatch) ||
+            initSetters<glm::vec2>(pArg, dispatch) ||
+            initSetters<glm::vec3>(pArg, dispatch) ||
+            initSetters<glm::ivec3>(pArg, dispatch) ||
+            initSetters<vector<float> >(pArg, dispatch) ||
+            initSetters<vector<int> >(pArg, dispatch) ||
+            initSetters<vector<glm::vec2> >(pArg, dispatch) ||
+            initSetters<vector<glm::ivec3> >(pArg, dispatch) ||
+            initSetters<CollVec2Vector>(pArg, dispatch) ||
+            initPySetter<FontStyle>(pArg, dispatch) ||
+            initPySetter<FontStylePtr>(pArg, dispatch);
+    return dispatch;
+}
+
 ArgList::ArgList()
 {
 }
 
 ArgList::ArgList(const ArgList& argTemplates, const xmlNodePtr xmlNode)
+    : m_Args(argTemplates.m_Args)
 {
-    copyArgsFrom(argTemplates);
-
+    // Arguments start out sharing the templates. Only the ones that are actually set
+    // are copied.
     for (xmlAttrPtr prop = xmlNode->properties; prop; prop = prop->next)
     {
         string name = (char*)prop->name;
         string value = (char*)prop->children->content;
-        setArgValue(name, value);
+        setArgValue(argTemplates.getDispatch(name), name, value);
     }
 }
 
 ArgList::ArgList(const ArgList& argTemplates, const py::dict& PyDict)
+    : m_Args(argTemplates.m_Args)
 {
     // TODO: Check if all required args are being set.
-    copyArgsFrom(argTemplates);
     py::list keys = PyDict.keys();
     int nKeys = py::len(keys);
     for (int i = 0; i < nKeys; i++)
@@ -72,7 +187,7 @@ ArgList::ArgList(const ArgList& argTemplates, const py::dict& PyDict)
         }
         string keyStr = keyStrProxy();
 
-        setArgValue(keyStr, valObj);
+        setArgValue(argTemplates.getDispatch(keyStr), keyStr, valObj);
     }
 }
 
@@ -116,7 +231,9 @@ const ArgMap& ArgList::getArgMap() const
 
 void ArgList::setArg(const ArgBase& newArg)
 {
-    m_Args[newArg.getName()] =  ArgBasePtr(newArg.createCopy());
+    ArgBasePtr pArg(newArg.createCopy());
+    m_Args[newArg.getName()] = pArg;
+    m_Dispatch[newArg.getName()] = createArgDispatch(pArg);
 }
 
 void ArgList::setArgs(const ArgList& args)
@@ -135,132 +252,43 @@ void ArgList::setMembers(ExportedObject * pObj) const
     pObj->setArgs(*this);
 }
 
-template<class T>
-void setArgValue(Arg<T>* pArg, const std::string & sName, const py::object& value)
+void ArgList::getMembers(const ExportedObject * pObj)
 {
-    py::extract<T> valProxy(value);
-    if (!valProxy.check()) {
-        string sTypeName = getFriendlyTypeName(pArg->getValue());
-        throw Exception(AVG_ERR_INVALID_ARGS, "Type error in argument "+sName+": "
-                +sTypeName+" expected.");
+    for (ArgMap::iterator it = m_Args.begin(); it != m_Args.end(); it++) {
+        if (it->second->hasMember()) {
+            ArgBasePtr pArg(it->second->createCopy());
+            pArg->getMember(pObj);
+            it->second = pArg;
+        }
     }
-    pArg->setValue(valProxy());
+    pObj->getArgs(*this);
 }
 
-void ArgList::setArgValue(const std::string & sName, const py::object& value)
+const ArgDispatch& ArgList::getDispatch(const string& sName) const
 {
-    ArgBasePtr pArg = getArg(sName);
-    Arg<string>* pStringArg = dynamic_cast<Arg<string>* >(&*pArg);
-    Arg<UTF8String>* pUTF8StringArg = dynamic_cast<Arg<UTF8String>* >(&*pArg);
-    Arg<int>* pIntArg = dynamic_cast<Arg<int>* >(&*pArg);
-    Arg<float>* pFloatArg = dynamic_cast<Arg<float>* >(&*pArg);
-    Arg<bool>* pBoolArg = dynamic_cast<Arg<bool>* >(&*pArg);
-    Arg<glm::vec2>* pVec2Arg = dynamic_cast<Arg<glm::vec2>* >(&*pArg);
-    Arg<glm::vec3>* pVec3Arg = dynamic_cast<Arg<glm::vec3>* >(&*pArg);
-    Arg<glm::ivec3>* pIVec3Arg = dynamic_cast<Arg<glm::ivec3>* >(&*pArg);
-    Arg<vector<float> >* pFVectorArg = dynamic_cast<Arg<vector<float> >* >(&*pArg);
-    Arg<vector<int> >* pIVectorArg = dynamic_cast<Arg<vector<int> >* >(&*pArg);
-    Arg<vector<glm::vec2> >* pVec2VectorArg = 
-            dynamic_cast<Arg<vector<glm::vec2> >* >(&*pArg);
-    Arg<vector<glm::ivec3> >* pIVec3VectorArg = 
-            dynamic_cast<Arg<vector<glm::ivec3> >* >(&*pArg);
-    Arg<CollVec2Vector>* pCollVec2VectorArg =
-            dynamic_cast<Arg<CollVec2Vector>* >(&*pArg);
-    Arg<FontStyle>* pFontStyleArg = dynamic_cast<Arg<FontStyle>* >(&*pArg);
-    Arg<FontStylePtr>* pFontStylePtrArg = dynamic_cast<Arg<FontStylePtr>* >(&*pArg);
-    if(pStringArg) {
-        avg::setArgValue(pStringArg, sName, value);
-    } else if (pUTF8StringArg) {
-        avg::setArgValue(pUTF8StringArg, sName, value);
-    } else if (pIntArg) {
-        avg::setArgValue(pIntArg, sName, value);
-    } else if (pFloatArg) {
-        avg::setArgValue(pFloatArg, sName, value);
-    } else if (pBoolArg) {
-        avg::setArgValue(pBoolArg, sName, value);
-    } else if (pVec2Arg) {
-        avg::setArgValue(pVec2Arg, sName, value);
-    } else if (pVec3Arg) {
-        avg::setArgValue(pVec3Arg, sName, value);
-    } else if (pIVec3Arg) {
-        avg::setArgValue(pIVec3Arg, sName, value);
-    } else if (pFVectorArg) {
-        avg::setArgValue(pFVectorArg, sName, value);
-    } else if (pIVectorArg) {
-        avg::setArgValue(pIVectorArg, sName, value);
-    } else if (pVec2VectorArg) {
-        avg::setArgValue(pVec2VectorArg, sName, value);
-    } else if (pIVec3VectorArg) {
-        avg::setArgValue(pIVec3VectorArg, sName, value);
-    } else if (pCollVec2VectorArg) {
-        avg::setArgValue(pCollVec2VectorArg, sName, value);
-    } else if (pFontStyleArg) {
-        avg::setArgValue(pFontStyleArg, sName, value);
-    } else if (pFontStylePtrArg) {
-        avg::setArgValue(pFontStylePtrArg, sName, value);
-    } else {
-        AVG_ASSERT(false);
+    ArgDispatchMap::const_iterator it = m_Dispatch.find(sName);
+    if (it == m_Dispatch.end()) {
+        throw Exception(AVG_ERR_INVALID_ARGS, string("Argument ")+sName+" is not valid.");
     }
+    return it->second;
 }
 
-void ArgList::setArgValue(const std::string & sName, const std::string & sValue)
+void ArgList::setArgValue(const ArgDispatch& dispatch, const std::string & sName,
+        const py::object& value)
 {
-    ArgBasePtr pArg = getArg(sName);
-    Arg<string>* pStringArg = dynamic_cast<Arg<string>* >(&*pArg);
-    Arg<UTF8String>* pUTF8StringArg = dynamic_cast<Arg<UTF8String>* >(&*pArg);
-    Arg<int>* pIntArg = dynamic_cast<Arg<int>* >(&*pArg);
-    Arg<float>* pFloatArg = dynamic_cast<Arg<float>* >(&*pArg);
-    Arg<bool>* pBoolArg = dynamic_cast<Arg<bool>* >(&*pArg);
-    Arg<glm::vec2>* pVec2Arg = dynamic_cast<Arg<glm::vec2>* >(&*pArg);
-    Arg<glm::vec3>* pVec3Arg = dynamic_cast<Arg<glm::vec3>* >(&*pArg);
-    Arg<glm::ivec3>* pIVec3Arg = dynamic_cast<Arg<glm::ivec3>* >(&*pArg);
-    Arg<vector<float> >* pFVectorArg = dynamic_cast<Arg<vector<float> >* >(&*pArg);
-    Arg<vector<int> >* pIVectorArg = dynamic_cast<Arg<vector<int> >* >(&*pArg);
-    Arg<vector<glm::vec2> >* pVec2VectorArg = 
-            dynamic_cast<Arg<vector<glm::vec2> >* >(&*pArg);
-    Arg<vector<glm::ivec3> >* pIVec3VectorArg = 
-            dynamic_cast<Arg<vector<glm::ivec3> >* >(&*pArg);
-    Arg<CollVec2Vector>* pCollVec2VectorArg =
-            dynamic_cast<Arg<CollVec2Vector>* >(&*pArg);
-    if (pStringArg) {
-        pStringArg->setValue(sValue);
-    } else if (pUTF8StringArg) {
-        pUTF8StringArg->setValue(sValue);
-    } else if (pIntArg) {
-        pIntArg->setValue(stringToInt(sValue));
-    } else if (pFloatArg) {
-        pFloatArg->setValue(stringToFloat(sValue));
-    } else if (pBoolArg) {
-        pBoolArg->setValue(stringToBool(sValue));
-    } else if (pVec2Arg) {
-        pVec2Arg->setValue(stringToVec2(sValue));
-    } else if (pVec3Arg) {
-        pVec3Arg->setValue(stringToVec3(sValue));
-    } else if (pIVec3Arg) {
-        pIVec3Arg->setValue(stringToIVec3(sValue));
-    } else if (pFVectorArg) {
-        vector<float> v;
-        fromString(sValue, v);
-        pFVectorArg->setValue(v);
-    } else if (pIVectorArg) {
-        vector<int> v;
-        fromString(sValue, v);
-        pIVectorArg->setValue(v);
-    } else if (pVec2VectorArg) {
-        vector<glm::vec2> v;
-        fromString(sValue, v);
-        pVec2VectorArg->setValue(v);
-    } else if (pIVec3VectorArg) {
-        vector<glm::ivec3> v;
-        fromString(sValue, v);
-        pIVec3VectorArg->setValue(v);
-    } else if (pCollVec2VectorArg) {
-        CollVec2Vector v;
-        fromString(sValue, v);
-        pCollVec2VectorArg->setValue(v);
-    } else {
-        AVG_ASSERT(false);
-    }   
+    AVG_ASSERT(dispatch.m_pPySetter);
+    ArgBasePtr pArg(dispatch.m_pDefault->createCopy());
+    dispatch.m_pPySetter(pArg.get(), sName, value);
+    m_Args[sName] = pArg;
+}
+
+void ArgList::setArgValue(const ArgDispatch& dispatch, const std::string & sName,
+        const std::string & sValue)
+{
+    AVG_ASSERT(dispatch.m_pStringSetter);
+    ArgBasePtr pArg(dispatch.m_pDefault->createCopy());
+    dispatch.m_pStringSetter(pArg.get(), sValue);
+    m_Args[sName] = pArg;
 }
 
 void ArgList::copyArgsFrom(const ArgList& argTemplates)
@@ -268,9 +296,7 @@ void ArgList::copyArgsFrom(const ArgList& argTemplates)
     for (ArgMap::const_iterator it = argTemplates.m_Args.begin();
             it != argTemplates.m_Args.end(); it++)
     {
-        string sKey = it->first;
-        ArgBasePtr pArg = ArgBasePtr(it->second->createCopy());
-        m_Args[sKey] = pArg;
+        setArg(*(it->second));
     }
 }
 
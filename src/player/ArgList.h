@@ -29,6 +29,8 @@
 #include "BoostPython.h"
 #include "Arg.h"
 
+#include "../base/Exception.h"
+
 #include <libxml/parser.h>
 
 #include <string>
@@ -38,6 +40,21 @@ namespace avg {
 
 typedef std::map<std::string, ArgBasePtr> ArgMap;
 
+typedef void (*StringArgSetter)(ArgBase* pArg, const std::string& sValue);
+typedef void (*PyArgSetter)(ArgBase* pArg, const std::string& sName,
+        const py::object& value);
+
+// Entry of the attribute dispatch table of an argument template list. The setters
+// are resolved once when the argument is added, so instantiating an object doesn't
+// need to figure out the type of each argument again.
+struct ArgDispatch
+{
+    ArgBasePtr m_pDefault;
+    StringArgSetter m_pStringSetter;
+    PyArgSetter m_pPySetter;
+};
+typedef std::map<std::string, ArgDispatch> ArgDispatchMap;
+
 class ExportedObject;
 
 class AVG_API ArgList
@@ -53,6 +70,8 @@ public:
    
     template<class T>
     const T& getArgVal(const std::string& sName) const;
+    template<class T>
+    void setArgVal(const std::string& sName, const T& value);
     
     void getOverlayedArgVal(glm::vec2* pResult, const std::string& sName,
             const std::string& sOverlay1, const std::string& sOverlay2,
@@ -63,13 +82,19 @@ public:
     void setArg(const ArgBase& newArg);
     void setArgs(const ArgList& args);
     void setMembers(ExportedObject * pObj) const;
+    // Inverse of setMembers(): Replaces the values with the current state of pObj.
+    void getMembers(const ExportedObject * pObj);
     
     void copyArgsFrom(const ArgList& argTemplates);
 
 private:
-    void setArgValue(const std::string & sName, const py::object& value);
-    void setArgValue(const std::string & sName, const std::string & sValue);
+    const ArgDispatch& getDispatch(const std::string& sName) const;
+    void setArgValue(const ArgDispatch& dispatch, const std::string& sName, 
+            const py::object& value);
+    void setArgValue(const ArgDispatch& dispatch, const std::string& sName, 
+            const std::string& sValue);
     ArgMap m_Args;
+    ArgDispatchMap m_Dispatch;
 };
     
 template<class T>
@@ -77,6 +102,17 @@ const T& ArgList::getArgVal(const std::string& sName) const
 {
     return (dynamic_cast<Arg<T>* >(&*getArg(sName)))->getValue();
 }
+
+template<class T>
+void ArgList::setArgVal(const std::string& sName, const T& value)
+{
+    // The arg might be shared with the argument templates, so it's copied first.
+    ArgBasePtr pArg(getArg(sName)->createCopy());
+    Arg<T>* pTypedArg = dynamic_cast<Arg<T>* >(pArg.get());
+    AVG_ASSERT(pTypedArg);
+    pTypedArg->setValue(value);
+    m_Args[sName] = pArg;
+}
     
 
 }
@@ -28,7 +28,11 @@
 #include  <stdio.h>
 #include  <stdlib.h>
 
+#include <algorithm>
+
 #include "../base/OSHelper.h"
+#include "../base/ThreadHelper.h"
+#include "../base/TimeSource.h"
 
 using namespace std;
 
@@ -37,6 +41,8 @@ namespace avg {
 BitmapManager * BitmapManager::s_pBitmapManager=0;
 
 BitmapManager::BitmapManager()
+    : m_DeliveryBudget(0),
+      m_NextSeqNum(0)
 {
     if (s_pBitmapManager) {
         throw Exception(AVG_ERR_UNKNOWN, "BitmapMananger has already been instantiated.");
@@ -59,6 +65,8 @@ BitmapManager::~BitmapManager()
         m_pMsgQueue->pop();
     }
     stopThreads();
+    m_Jobs.clear();
+    m_pFailedMsgs.clear();
     s_pBitmapManager = 0;
 }
 
@@ -70,22 +78,24 @@ BitmapManager* BitmapManager::get()
     return s_pBitmapManager;
 }
 
-void BitmapManager::loadBitmapPy(const UTF8String& sUtf8FileName,
-        const boost::python::object& pyFunc, PixelFormat pf)
+BitmapManagerMsgPtr BitmapManager::loadBitmapPy(const UTF8String& sUtf8FileName,
+        const boost::python::object& pyFunc, PixelFormat pf, int priority)
 {
     std::string sFileName = convertUTF8ToFilename(sUtf8FileName);
     BitmapManagerMsgPtr pMsg = BitmapManagerMsgPtr(
             new BitmapManagerMsg(sUtf8FileName, pyFunc, pf));
-    internalLoadBitmap(pMsg);
+    internalLoadBitmap(pMsg, priority);
+    return pMsg;
 }
 
-void BitmapManager::loadBitmap(const UTF8String& sUtf8FileName,
-        IBitmapLoadedListener* pLoadedListener, PixelFormat pf)
+BitmapManagerMsgPtr BitmapManager::loadBitmap(const UTF8String& sUtf8FileName,
+        IBitmapLoadedListener* pLoadedListener, PixelFormat pf, int priority)
 {
     std::string sFileName = convertUTF8ToFilename(sUtf8FileName);
     BitmapManagerMsgPtr pMsg = BitmapManagerMsgPtr(
             new BitmapManagerMsg(sUtf8FileName, pLoadedListener, pf));
-    internalLoadBitmap(pMsg);
+    internalLoadBitmap(pMsg, priority);
+    return pMsg;
 }
 
 void BitmapManager::setNumThreads(int numThreads)
@@ -94,15 +104,137 @@ void BitmapManager::setNumThreads(int numThreads)
     startThreads(numThreads);
 }
 
+void BitmapManager::setDeliveryBudget(float budget)
+{
+    if (budget < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "BitmapManager delivery budget must not be negative.");
+    }
+    m_DeliveryBudget = budget;
+}
+
+float BitmapManager::getDeliveryBudget() const
+{
+    return m_DeliveryBudget;
+}
+
+int BitmapManager::getNumPendingJobs() const
+{
+    lock_guard lock(m_Mutex);
+    return int(m_Jobs.size());
+}
+
+void BitmapManager::cancelRequest(BitmapManagerMsg* pMsg)
+{
+    BitmapManagerMsgPtr pCancelledMsg;
+    {
+        lock_guard lock(m_Mutex);
+        if (pMsg->m_bCancelled) {
+            return;
+        }
+        pMsg->m_bCancelled = true;
+        JobMap::iterator it = m_Jobs.find(JobKey(pMsg->getFilename(), pMsg->m_PF));
+        if (it != m_Jobs.end()) {
+            LoadJobPtr pJob = it->second;
+            std::vector<BitmapManagerMsgPtr>& pRequests = pJob->m_pRequests;
+            for (unsigned i=0; i<pRequests.size(); ++i) {
+                if (pRequests[i].get() == pMsg) {
+                    pCancelledMsg = pRequests[i];
+                    pRequests.erase(pRequests.begin()+i);
+                    break;
+                }
+            }
+            if (pRequests.empty() && !pJob->m_bLoading) {
+                m_Jobs.erase(it);
+            }
+        }
+    }
+    // Drop the python callback here so it's never released in a loader thread.
+    pMsg->m_OnLoadedCb = boost::python::object();
+}
+
+void BitmapManager::setRequestPriority(BitmapManagerMsg* pMsg, int priority)
+{
+    lock_guard lock(m_Mutex);
+    pMsg->m_Priority = priority;
+}
+
+BitmapManager::LoadJobPtr BitmapManager::startNextJob()
+{
+    // Linear search: Even with thousands of queued jobs, this is negligible compared 
+    // to decoding an image.
+    lock_guard lock(m_Mutex);
+    LoadJobPtr pBestJob;
+    int bestPriority = 0;
+    for (JobMap::iterator it = m_Jobs.begin(); it != m_Jobs.end(); ++it) {
+        LoadJobPtr& pJob = it->second;
+        if (pJob->m_bLoading) {
+            continue;
+        }
+        int priority = pJob->m_pRequests[0]->m_Priority;
+        for (unsigned i=1; i<pJob->m_pRequests.size(); ++i) {
+            priority = std::max(priority, pJob->m_pRequests[i]->m_Priority);
+        }
+        if (!pBestJob || priority > bestPriority || 
+                (priority == bestPriority && pJob->m_SeqNum < pBestJob->m_SeqNum))
+        {
+            pBestJob = pJob;
+            bestPriority = priority;
+        }
+    }
+    if (pBestJob) {
+        pBestJob->m_bLoading = true;
+    }
+    return pBestJob;
+}
+
+void BitmapManager::finishJob(const LoadJobPtr& pJob, BitmapPtr pBmp, 
+        const Exception* pEx)
+{
+    std::vector<BitmapManagerMsgPtr> pRequests;
+    {
+        lock_guard lock(m_Mutex);
+        m_Jobs.erase(JobKey(pJob->m_sFilename, pJob->m_PF));
+        pRequests.swap(pJob->m_pRequests);
+    }
+    // Every requester gets a bitmap of its own. All copies are made before the first 
+    // message is pushed, since the main thread may modify a bitmap as soon as its 
+    // callback runs. The last requester gets the original.
+    for (unsigned i=0; i<pRequests.size(); ++i) {
+        BitmapManagerMsgPtr pMsg = pRequests[i];
+        if (pEx) {
+            pMsg->setError(*pEx);
+        } else if (i == pRequests.size()-1) {
+            pMsg->setBitmap(pBmp);
+        } else {
+            pMsg->setBitmap(BitmapPtr(new Bitmap(*pBmp)));
+        }
+    }
+    for (unsigned i=0; i<pRequests.size(); ++i) {
+        m_pMsgQueue->push(pRequests[i]);
+    }
+}
+
 void BitmapManager::onFrameEnd()
 {
-    while (!m_pMsgQueue->empty()) {
-        BitmapManagerMsgPtr pMsg = m_pMsgQueue->pop();
-        pMsg->executeCallback();
+    long long startTime = TimeSource::get()->getCurrentMicrosecs();
+    BitmapManagerMsgPtr pMsg = popFinishedMsg();
+    while (pMsg) {
+        if (!pMsg->isCancelled()) {
+            pMsg->executeCallback();
+            if (m_DeliveryBudget > 0) {
+                float elapsed = (TimeSource::get()->getCurrentMicrosecs()-startTime)
+                        /1000.f;
+                if (elapsed >= m_DeliveryBudget) {
+                    break;
+                }
+            }
+        }
+        pMsg = popFinishedMsg();
     }
 }
 
-void BitmapManager::internalLoadBitmap(BitmapManagerMsgPtr pMsg)
+void BitmapManager::internalLoadBitmap(BitmapManagerMsgPtr pMsg, int priority)
 {
 #ifdef WIN32
     int rc = _access(pMsg->getFilename().c_str(), 04);
@@ -110,14 +242,47 @@ void BitmapManager::internalLoadBitmap(BitmapManagerMsgPtr pMsg)
     int rc = access(pMsg->getFilename().c_str(), R_OK);
 #endif
 
+    pMsg->m_Priority = priority;
     if (rc != 0) {
         pMsg->setError(Exception(AVG_ERR_FILEIO, 
                 std::string("BitmapManager can't open output file '") +
                 pMsg->getFilename() + "'. Reason: " +
                 strerror(errno)));
-        m_pMsgQueue->push(pMsg);
+        m_pFailedMsgs.push_back(pMsg);
+    } else {
+        bool bNewJob = false;
+        {
+            lock_guard lock(m_Mutex);
+            JobKey key(pMsg->getFilename(), pMsg->m_PF);
+            LoadJobPtr& pJob = m_Jobs[key];
+            if (!pJob) {
+                pJob = LoadJobPtr(new LoadJob);
+                pJob->m_sFilename = pMsg->getFilename();
+                pJob->m_PF = pMsg->m_PF;
+                pJob->m_SeqNum = m_NextSeqNum;
+                pJob->m_StartTime = pMsg->getStartTime();
+                pJob->m_bLoading = false;
+                m_NextSeqNum++;
+                bNewJob = true;
+            }
+            pJob->m_pRequests.push_back(pMsg);
+        }
+        if (bNewJob) {
+            // The threads pick the most important job, which isn't necessarily this 
+            // one.
+            m_pCmdQueue->pushCmd(boost::bind(&BitmapManagerThread::loadNextBitmap, _1));
+        }
+    }
+}
+
+BitmapManagerMsgPtr BitmapManager::popFinishedMsg()
+{
+    if (!m_pFailedMsgs.empty()) {
+        BitmapManagerMsgPtr pMsg = m_pFailedMsgs.front();
+        m_pFailedMsgs.pop_front();
+        return pMsg;
     } else {
-        m_pCmdQueue->pushCmd(boost::bind(&BitmapManagerThread::loadBitmap, _1, pMsg));
+        return m_pMsgQueue->pop(false);
     }
 }
 
@@ -125,7 +290,7 @@ void BitmapManager::startThreads(int numThreads)
 {
     for (int i=0; i<numThreads; ++i) {
         boost::thread* pThread = new boost::thread(
-                BitmapManagerThread(*m_pCmdQueue, *m_pMsgQueue));
+                BitmapManagerThread(*m_pCmdQueue, *this));
         m_pBitmapManagerThreads.push_back(pThread);
     }
 }
@@ -32,25 +32,55 @@
 #include <boost/thread.hpp>
 
 #include <vector>
+#include <deque>
+#include <map>
 
 namespace avg {
 
 class AVG_API BitmapManager : public IFrameEndListener
 {
     public:
+        // All requests for the same file and pixel format that are queued or being 
+        // loaded share one decode.
+        struct LoadJob {
+            UTF8String m_sFilename;
+            PixelFormat m_PF;
+            long long m_SeqNum;
+            float m_StartTime;
+            bool m_bLoading;
+            std::vector<BitmapManagerMsgPtr> m_pRequests;
+        };
+        typedef boost::shared_ptr<LoadJob> LoadJobPtr;
+
         BitmapManager();
         ~BitmapManager();
         static BitmapManager* get();
-        void loadBitmapPy(const UTF8String& sUtf8FileName,
-                const boost::python::object& pyFunc, PixelFormat pf=NO_PIXELFORMAT);
-        void loadBitmap(const UTF8String& sUtf8FileName,
-                IBitmapLoadedListener* pLoadedListener, PixelFormat pf=NO_PIXELFORMAT);
+        BitmapManagerMsgPtr loadBitmapPy(const UTF8String& sUtf8FileName,
+                const boost::python::object& pyFunc, PixelFormat pf=NO_PIXELFORMAT,
+                int priority=0);
+        BitmapManagerMsgPtr loadBitmap(const UTF8String& sUtf8FileName,
+                IBitmapLoadedListener* pLoadedListener, PixelFormat pf=NO_PIXELFORMAT,
+                int priority=0);
         void setNumThreads(int numThreads);
+        void setDeliveryBudget(float budget);
+        float getDeliveryBudget() const;
+        int getNumPendingJobs() const;
+
+        void cancelRequest(BitmapManagerMsg* pMsg);
+        void setRequestPriority(BitmapManagerMsg* pMsg, int priority);
+
+        // Called by the loader threads.
+        LoadJobPtr startNextJob();
+        void finishJob(const LoadJobPtr& pJob, BitmapPtr pBmp, const Exception* pEx);
 
         virtual void onFrameEnd();
         
     private:
-        void internalLoadBitmap(BitmapManagerMsgPtr pMsg);
+        typedef std::pair<std::string, PixelFormat> JobKey;
+        typedef std::map<JobKey, LoadJobPtr> JobMap;
+
+        void internalLoadBitmap(BitmapManagerMsgPtr pMsg, int priority);
+        BitmapManagerMsgPtr popFinishedMsg();
         void startThreads(int numThreads);
         void stopThreads();
 
@@ -59,6 +89,14 @@ class AVG_API BitmapManager : public IFrameEndListener
         std::vector<boost::thread*> m_pBitmapManagerThreads;
         BitmapManagerThread::CQueuePtr m_pCmdQueue;
         BitmapManagerMsgQueuePtr m_pMsgQueue;
+        // Requests that failed before they reached a loader thread.
+        std::deque<BitmapManagerMsgPtr> m_pFailedMsgs;
+        float m_DeliveryBudget;
+
+        // Protected by m_Mutex.
+        mutable boost::mutex m_Mutex;
+        JobMap m_Jobs;
+        long long m_NextSeqNum;
 };
 
 }
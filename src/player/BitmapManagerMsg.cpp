@@ -20,6 +20,7 @@
 //
 
 #include "BitmapManagerMsg.h"
+#include "BitmapManager.h"
 #include "IBitmapLoadedListener.h"
 
 #include "../base/ObjectCounter.h"
@@ -62,6 +63,28 @@ void BitmapManagerMsg::init(const UTF8String& sFilename, PixelFormat pf)
     m_PF = pf;
     m_MsgType = REQUEST;
     m_pEx = 0;
+    m_Priority = 0;
+    m_bCancelled = false;
+}
+
+void BitmapManagerMsg::cancel()
+{
+    BitmapManager::get()->cancelRequest(this);
+}
+
+bool BitmapManagerMsg::isCancelled() const
+{
+    return m_bCancelled;
+}
+
+void BitmapManagerMsg::setPriority(int priority)
+{
+    BitmapManager::get()->setRequestPriority(this, priority);
+}
+
+int BitmapManagerMsg::getPriority() const
+{
+    return m_Priority;
 }
 
 void BitmapManagerMsg::executeCallback()
@@ -48,6 +48,12 @@ public:
     virtual ~BitmapManagerMsg();
     void init(const UTF8String& sFilename, PixelFormat pf);
 
+    // Handle interface. Cancelled requests never invoke their callback.
+    void cancel();
+    bool isCancelled() const;
+    void setPriority(int priority);
+    int getPriority() const;
+
     void executeCallback();
     const UTF8String getFilename();
     float getStartTime();
@@ -58,6 +64,8 @@ public:
     MsgType getType() { return m_MsgType; };
 
 private:
+    friend class BitmapManager;
+
     UTF8String m_sFilename;
     float m_StartTime;
     BitmapPtr m_pBmp;
@@ -66,6 +74,10 @@ private:
     PixelFormat m_PF;
     MsgType m_MsgType;
     Exception* m_pEx;
+
+    // Protected by the BitmapManager mutex.
+    int m_Priority;
+    bool m_bCancelled;
 };
 
 typedef boost::shared_ptr<BitmapManagerMsg> BitmapManagerMsgPtr;
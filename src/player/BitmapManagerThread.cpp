@@ -20,6 +20,7 @@
 //
 
 #include "BitmapManagerThread.h"
+#include "BitmapManager.h"
 
 #include "../base/Exception.h"
 #include "../base/ScopeTimer.h"
@@ -32,9 +33,9 @@
 
 namespace avg {
 
-BitmapManagerThread::BitmapManagerThread(CQueue& cmdQ, BitmapManagerMsgQueue& MsgQueue)
+BitmapManagerThread::BitmapManagerThread(CQueue& cmdQ, BitmapManager& bitmapManager)
     : WorkerThread<BitmapManagerThread>("BitmapManager", cmdQ),
-      m_MsgQueue(MsgQueue),
+      m_BitmapManager(bitmapManager),
       m_TotalLatency(0),
       m_NumBmpsLoaded(0)
 {
@@ -57,20 +58,25 @@ void BitmapManagerThread::deinit()
 
 static ProfilingZoneID LoaderProfilingZone("loadBitmap", true);
 
-void BitmapManagerThread::loadBitmap(BitmapManagerMsgPtr pRequest)
+void BitmapManagerThread::loadNextBitmap()
 {
+    BitmapManager::LoadJobPtr pJob = m_BitmapManager.startNextJob();
+    if (!pJob) {
+        // The job this command was queued for has been cancelled.
+        return;
+    }
     BitmapPtr pBmp;
     ScopeTimer timer(LoaderProfilingZone);
-    float startTime = pRequest->getStartTime();
     try {
-        pBmp = avg::loadBitmap(pRequest->getFilename(), pRequest->getPixelFormat());
-        pRequest->setBitmap(pBmp);
+        pBmp = avg::loadBitmap(pJob->m_sFilename, pJob->m_PF);
     } catch (const Exception& ex) {
-        pRequest->setError(ex);
+        m_BitmapManager.finishJob(pJob, BitmapPtr(), &ex);
+    }
+    if (pBmp) {
+        m_BitmapManager.finishJob(pJob, pBmp, 0);
     }
-    m_MsgQueue.push(pRequest);
     m_NumBmpsLoaded++;
-    float curLatency = TimeSource::get()->getCurrentMicrosecs()/1000 - startTime;
+    float curLatency = TimeSource::get()->getCurrentMicrosecs()/1000 - pJob->m_StartTime;
     m_TotalLatency += curLatency;
     ThreadProfiler::get()->reset();
 }
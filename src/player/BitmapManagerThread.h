@@ -34,17 +34,19 @@
 
 namespace avg {
 
+class BitmapManager;
+
 class AVG_API BitmapManagerThread : public WorkerThread<BitmapManagerThread>
 {
     public:
-        BitmapManagerThread(CQueue& cmdQ, BitmapManagerMsgQueue& MsgQueue);
+        BitmapManagerThread(CQueue& cmdQ, BitmapManager& bitmapManager);
                 
-        void loadBitmap(BitmapManagerMsgPtr pRequest);
+        void loadNextBitmap();
         
     private:
         virtual bool work();
         virtual void deinit();
-        BitmapManagerMsgQueue& m_MsgQueue;
+        BitmapManager& m_BitmapManager;
 
         float m_TotalLatency;
         int m_NumBmpsLoaded;
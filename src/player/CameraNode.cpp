@@ -123,6 +123,11 @@ CameraNode::~CameraNode()
     m_pCamera = CameraPtr();
 }
 
+void CameraNode::getArgs(ArgList& args) const
+{
+    throw Exception(AVG_ERR_UNSUPPORTED, "Camera nodes can't be copied.");
+}
+
 void CameraNode::connectDisplay()
 {
     RasterNode::connectDisplay();
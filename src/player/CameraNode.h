@@ -48,6 +48,7 @@ class AVG_API CameraNode : public RasterNode
         
         CameraNode(const ArgList& args);
         virtual ~CameraNode();
+        virtual void getArgs(ArgList& args) const;
 
         virtual void connectDisplay();
         virtual void connect(CanvasPtr pCanvas);
@@ -25,6 +25,7 @@
 #include "AVGNode.h"
 #include "Shape.h"
 #include "OffscreenCanvas.h"
+#include "RenderBatcher.h"
 
 #include "../base/Exception.h"
 #include "../base/Logger.h"
@@ -42,10 +43,12 @@ namespace avg {
 Canvas::Canvas(Player * pPlayer)
     : m_pPlayer(pPlayer),
       m_bIsPlaying(false),
+      m_bBatchRendering(false),
       m_PlaybackEndSignal(&IPlaybackEndListener::onPlaybackEnd),
       m_FrameEndSignal(&IFrameEndListener::onFrameEnd),
       m_PreRenderSignal(&IPreRenderListener::onPreRender),
-      m_ClipLevel(0)
+      m_ClipLevel(0),
+      m_bDirty(true)
 {
 }
 
@@ -68,6 +71,8 @@ void Canvas::initPlayback(int multiSampleSamples)
     m_pRootNode->connectDisplay();
     m_MultiSampleSamples = multiSampleSamples;
     m_pVertexArray = VertexArrayPtr(new VertexArray(2000, 3000));
+    m_pRenderBatcher = RenderBatcherPtr(new RenderBatcher());
+    m_bDirty = true;
 }
 
 void Canvas::stopPlayback(bool bIsAbort)
@@ -81,6 +86,7 @@ void Canvas::stopPlayback(bool bIsAbort)
         m_IDMap.clear();
         m_bIsPlaying = false;
         m_pVertexArray = VertexArrayPtr();
+        m_pRenderBatcher = RenderBatcherPtr();
     }
 }
 
@@ -144,6 +150,8 @@ void Canvas::doFrame(bool bPythonAvailable)
     emitPreRenderSignal();
     if (!m_pPlayer->isStopping()) {
         ScopeTimer Timer(RenderProfilingZone);
+        GLContext* pContext = GLContext::getMain();
+        pContext->resetDrawCallCount();
         Player::get()->startTraversingTree();
         if (bPythonAvailable) {
             Py_BEGIN_ALLOW_THREADS;
@@ -159,6 +167,8 @@ void Canvas::doFrame(bool bPythonAvailable)
             renderTree();
         }
         Player::get()->endTraversingTree();
+        RenderProfilingZone.getProfiler()->addZoneCount(RenderProfilingZone,
+                pContext->getDrawCallCount());
     }
     emitFrameEndSignal();
 }
@@ -233,11 +243,15 @@ static ProfilingZoneID VATransferProfilingZone("VA Transfer");
 void Canvas::preRender()
 {
     ScopeTimer Timer(PreRenderProfilingZone);
+    GLContext::getMain()->getTextureUploadQueue().processUploads();
+    m_bBatchRendering = m_pPlayer->isBatchRendering();
     m_pVertexArray->reset();
     m_pRootNode->preRender(m_pVertexArray, true, 1.0f);
     {
         ScopeTimer Timer(VATransferProfilingZone);
         m_pVertexArray->update();
+        VATransferProfilingZone.getProfiler()->addZoneCount(VATransferProfilingZone,
+                m_pVertexArray->getNumUploadedBytes());
     }
 }
 
@@ -256,10 +270,42 @@ void Canvas::render(IntPoint windowSize, bool bOffscreen)
     }
     m_pVertexArray->activate();
     m_pRootNode->maybeRender(projMat);
+    if (m_bBatchRendering) {
+        m_pRenderBatcher->flush();
+    }
 
     renderOutlines(projMat);
 }
 
+bool Canvas::isBatchRendering() const
+{
+    return m_bBatchRendering;
+}
+
+RenderBatcher* Canvas::getRenderBatcher() const
+{
+    if (m_bBatchRendering) {
+        return m_pRenderBatcher.get();
+    } else {
+        return 0;
+    }
+}
+
+void Canvas::setDirty()
+{
+    m_bDirty = true;
+}
+
+bool Canvas::isDirty() const
+{
+    return m_bDirty;
+}
+
+void Canvas::resetDirty()
+{
+    m_bDirty = false;
+}
+
 void Canvas::renderOutlines(const glm::mat4& transform)
 {
     GLContext* pContext = GLContext::getMain();
@@ -279,6 +325,10 @@ void Canvas::renderOutlines(const glm::mat4& transform)
 
 void Canvas::clip(const glm::mat4& transform, SubVertexArray& va, GLenum stencilOp)
 {
+    if (m_bBatchRendering) {
+        // Pending draws need to be rendered using the old stencil state.
+        m_pRenderBatcher->flush();
+    }
     // Disable drawing to color buffer
     glColorMask(0, 0, 0, 0);
 
@@ -52,11 +52,13 @@ class Canvas;
 class FBO;
 class VertexArray;
 class SubVertexArray;
+class RenderBatcher;
 
 typedef boost::shared_ptr<Node> NodePtr;
 typedef boost::shared_ptr<CanvasNode> CanvasNodePtr;
 typedef boost::shared_ptr<FBO> FBOPtr;
 typedef boost::shared_ptr<VertexArray> VertexArrayPtr;
+typedef boost::shared_ptr<RenderBatcher> RenderBatcherPtr;
 
 class Canvas;
 typedef boost::shared_ptr<Canvas> CanvasPtr;
@@ -92,12 +94,20 @@ class AVG_API Canvas: public ExportedObject
         std::vector<NodePtr> getElementsByPos(const glm::vec2& Pos) const;
 
         virtual void render(IntPoint windowSize, bool bOffscreen);
+        bool isBatchRendering() const;
+        RenderBatcher* getRenderBatcher() const;
+
+        // Called by nodes whenever something that influences the rendered image
+        // changes. Offscreen canvases skip rendering as long as they're clean.
+        void setDirty();
+        bool isDirty() const;
 
     protected:
         Player * getPlayer() const;
         void preRender();
         void emitPreRenderSignal(); 
         void emitFrameEndSignal();
+        void resetDirty();
 
     private:
         virtual void renderTree()=0;
@@ -108,6 +118,8 @@ class AVG_API Canvas: public ExportedObject
         CanvasNodePtr m_pRootNode;
         bool m_bIsPlaying;
         VertexArrayPtr m_pVertexArray;
+        RenderBatcherPtr m_pRenderBatcher;
+        bool m_bBatchRendering;
        
         typedef std::map<std::string, NodePtr> NodeIDMap;
         NodeIDMap m_IDMap;
@@ -118,6 +130,7 @@ class AVG_API Canvas: public ExportedObject
 
         int m_MultiSampleSamples;
         int m_ClipLevel;
+        bool m_bDirty;
 };
 
 }
@@ -52,6 +52,11 @@ CanvasNode::~CanvasNode()
 {
 }
 
+void CanvasNode::getArgs(ArgList& args) const
+{
+    throw Exception(AVG_ERR_UNSUPPORTED, "Canvas nodes can't be copied.");
+}
+
 string CanvasNode::getEffectiveMediaDir()
 {
     string sMediaDir = getMediaDir();
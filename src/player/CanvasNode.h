@@ -36,6 +36,7 @@ class AVG_API CanvasNode : public DivNode
         
         CanvasNode(const ArgList& args);
         virtual ~CanvasNode();
+        virtual void getArgs(ArgList& args) const;
 
         virtual std::string getEffectiveMediaDir();
 
@@ -102,6 +102,16 @@ void CircleNode::setTexCoord2(float tc)
     setDrawNeeded();
 }
 
+FRect CircleNode::calcHitBounds()
+{
+    if (reactsToMouseEvents()) {
+        glm::vec2 radius(m_Radius, m_Radius);
+        return FRect(m_Pos-radius, m_Pos+radius);
+    } else {
+        return getEmptyHitBounds();
+    }
+}
+
 void CircleNode::getElementsByPos(const glm::vec2& pos, vector<NodePtr>& pElements)
 {
     if (glm::length(pos-m_Pos) <= m_Radius && reactsToMouseEvents()) {
@@ -53,6 +53,9 @@ class AVG_API CircleNode : public FilledVectorNode
         virtual void calcVertexes(const VertexDataPtr& pVertexData, Pixel32 color);
         virtual void calcFillVertexes(const VertexDataPtr& pVertexData, Pixel32 color);
 
+    protected:
+        virtual FRect calcHitBounds();
+
     private:
         void appendCirclePoint(const VertexDataPtr& pVertexData, const glm::vec2& iPt, 
                 const glm::vec2& oPt, Pixel32 color, int& i, int& curVertex);
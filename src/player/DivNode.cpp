@@ -120,6 +120,25 @@ void DivNode::appendChild(NodePtr pNewNode)
     insertChild(pNewNode, unsigned(m_Children.size()));
 }
 
+void DivNode::appendChildren(const vector<NodePtr>& pNewNodes)
+{
+    // Check all nodes first so an invalid node doesn't leave a partial insert behind.
+    for (unsigned i = 0; i < pNewNodes.size(); ++i) {
+        checkNewChild(pNewNodes[i], "appendChildren");
+        for (unsigned j = 0; j < i; ++j) {
+            if (pNewNodes[j] == pNewNodes[i]) {
+                throw Exception(AVG_ERR_UNSUPPORTED, getID()+
+                        "::appendChildren: Node with id "+pNewNodes[i]->getID()+
+                        " is in the list more than once.");
+            }
+        }
+    }
+    m_Children.reserve(m_Children.size()+pNewNodes.size());
+    for (unsigned i = 0; i < pNewNodes.size(); ++i) {
+        insertChild(pNewNodes[i], unsigned(m_Children.size()));
+    }
+}
+
 void DivNode::insertChildBefore(NodePtr pNewNode, NodePtr pOldChild)
 {
     if (!pOldChild) {
@@ -142,24 +161,10 @@ void DivNode::insertChildAfter(NodePtr pNewNode, NodePtr pOldChild)
 
 void DivNode::insertChild(NodePtr pChild, unsigned i)
 {
-    if (!pChild) {
-        throw Exception(AVG_ERR_NO_NODE,
-                getID()+"::insertChild called without a node.");
-    }
-    if (pChild->getState() == NS_CONNECTED || pChild->getState() == NS_CANRENDER) {
-        throw(Exception(AVG_ERR_ALREADY_CONNECTED,
-                "Can't connect node with id "+pChild->getID()+
-                ": already connected."));
-    }
+    checkNewChild(pChild, "insertChild");
     if (getState() == NS_CONNECTED || getState() == NS_CANRENDER) {
         getCanvas()->registerNode(pChild);
     }
-    pChild->checkSetParentError(this); 
-    if (!isChildTypeAllowed(pChild->getTypeStr())) {
-        throw(Exception(AVG_ERR_ALREADY_CONNECTED,
-                "Can't insert a node of type "+pChild->getTypeStr()+
-                " into a node of type "+getTypeStr()+"."));
-    }
     if (i > m_Children.size()) {
         throw(Exception(AVG_ERR_OUT_OF_RANGE,
                 pChild->getID()+"::insertChild: index out of bounds."));
@@ -175,6 +180,7 @@ void DivNode::insertChild(NodePtr pChild, unsigned i)
     if (getState() == NS_CANRENDER) {
         pChild->connectDisplay();
     }
+    pChild->invalidateHitBounds();
 }
 
 void DivNode::reorderChild(NodePtr pChild, unsigned j)
@@ -187,6 +193,7 @@ void DivNode::reorderChild(NodePtr pChild, unsigned j)
     m_Children.erase(m_Children.begin()+i);
     std::vector<NodePtr>::iterator pos = m_Children.begin()+j;
     m_Children.insert(pos, pChild);
+    setCanvasDirty();
 }
 
 void DivNode::reorderChild(unsigned i, unsigned j)
@@ -199,6 +206,7 @@ void DivNode::reorderChild(unsigned i, unsigned j)
     m_Children.erase(m_Children.begin()+i);
     std::vector<NodePtr>::iterator pos = m_Children.begin()+j;
     m_Children.insert(pos, pChild);
+    setCanvasDirty();
 }
 
 unsigned DivNode::indexOf(NodePtr pChild)
@@ -239,6 +247,7 @@ void DivNode::removeChild(NodePtr pChild, bool bKill)
                 getID()+"::removeChild: index "+toString(i)+" out of bounds."));
     }
     m_Children.erase(m_Children.begin()+i);
+    invalidateHitBounds();
 }
 
 void DivNode::removeChild(unsigned i, bool bKill)
@@ -255,6 +264,7 @@ bool DivNode::getCrop() const
 void DivNode::setCrop(bool bCrop)
 {
     m_bCrop = bCrop;
+    setCanvasDirty();
 }
 
 const UTF8String& DivNode::getMediaDir() const
@@ -277,6 +287,9 @@ void DivNode::getElementsByPos(const glm::vec2& pos, vector<NodePtr>& pElements)
     {
         for (int i = getNumChildren()-1; i >= 0; i--) {
             NodePtr pCurChild = getChild(i);
+            if (!pCurChild->mayContainHit(pos)) {
+                continue;
+            }
             glm::vec2 relPos = pCurChild->toLocal(pos);
             pCurChild->getElementsByPos(relPos, pElements);
             if (!pElements.empty()) {
@@ -292,6 +305,33 @@ void DivNode::getElementsByPos(const glm::vec2& pos, vector<NodePtr>& pElements)
     }
 }
 
+FRect DivNode::calcHitBounds()
+{
+    if (!reactsToMouseEvents()) {
+        return getEmptyHitBounds();
+    }
+    if (getSize() != glm::vec2(0,0)) {
+        // Hits outside of the div are never passed on to the children.
+        return AreaNode::calcHitBounds();
+    }
+    FRect childBounds = getEmptyHitBounds();
+    for (unsigned i = 0; i < getNumChildren(); ++i) {
+        const FRect& curBounds = getChild(i)->getHitBounds();
+        if (!isEmptyHitBounds(curBounds)) {
+            if (isEmptyHitBounds(childBounds)) {
+                childBounds = curBounds;
+            } else {
+                childBounds.expand(curBounds);
+            }
+        }
+    }
+    if (isEmptyHitBounds(childBounds)) {
+        return childBounds;
+    } else {
+        return getTransformedBounds(childBounds);
+    }
+}
+
 void DivNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
         float parentEffectiveOpacity)
 {
@@ -384,6 +424,25 @@ IntPoint DivNode::getMediaSize()
     return IntPoint(0, 0);
 }
  
+void DivNode::checkNewChild(const NodePtr& pChild, const string& sFuncName)
+{
+    if (!pChild) {
+        throw Exception(AVG_ERR_NO_NODE,
+                getID()+"::"+sFuncName+" called without a node.");
+    }
+    if (pChild->getState() == NS_CONNECTED || pChild->getState() == NS_CANRENDER) {
+        throw(Exception(AVG_ERR_ALREADY_CONNECTED,
+                "Can't connect node with id "+pChild->getID()+
+                ": already connected."));
+    }
+    pChild->checkSetParentError(this); 
+    if (!isChildTypeAllowed(pChild->getTypeStr())) {
+        throw(Exception(AVG_ERR_ALREADY_CONNECTED,
+                "Can't insert a node of type "+pChild->getTypeStr()+
+                " into a node of type "+getTypeStr()+"."));
+    }
+}
+
 bool DivNode::isChildTypeAllowed(const string& sType)
 {
     return getDefinition()->isChildAllowed(sType);
@@ -47,6 +47,7 @@ class AVG_API DivNode : public AreaNode
         unsigned getNumChildren();
         const NodePtr& getChild(unsigned i);
         void appendChild(NodePtr pNewNode);
+        void appendChildren(const std::vector<NodePtr>& pNewNodes);
         void insertChildBefore(NodePtr pNewNode, NodePtr pOldChild);
         void insertChildAfter(NodePtr pNewNode, NodePtr pOldChild);
         virtual void insertChild(NodePtr pNewNode, unsigned i);
@@ -78,7 +79,11 @@ class AVG_API DivNode : public AreaNode
         virtual std::string dump(int indent = 0);
         IntPoint getMediaSize();
    
+    protected:
+        virtual FRect calcHitBounds();
+
     private:
+        void checkNewChild(const NodePtr& pChild, const std::string& sFuncName);
         bool isChildTypeAllowed(const std::string& sType);
 
         UTF8String m_sMediaDir;
@@ -56,6 +56,9 @@ class AVG_API ExportedObject: public boost::enable_shared_from_this<ExportedObje
         virtual void setTypeInfo(const TypeDefinition * pDefinition);
         
         virtual void setArgs(const ArgList& args) {};
+        // Called by ArgList::getMembers(). Needs to add the state that isn't covered
+        // by member offsets.
+        virtual void getArgs(ArgList& args) const {};
         std::string getTypeStr() const;
         virtual const TypeDefinition* getDefinition() const;
 
@@ -22,6 +22,8 @@
 #include "FilledVectorNode.h"
 
 #include "TypeDefinition.h"
+#include "Canvas.h"
+#include "RenderBatcher.h"
 #include "Image.h"
 #include "DivNode.h"
 
@@ -171,7 +173,13 @@ void FilledVectorNode::render()
     ScopeTimer Timer(RenderProfilingZone);
     float curOpacity = getParent()->getEffectiveOpacity()*m_FillOpacity;
     if (curOpacity > 0.01) {
-        m_pFillShape->draw(getTransform(), curOpacity);
+        RenderBatcher* pBatcher = getCanvas()->getRenderBatcher();
+        if (pBatcher) {
+            m_pFillShape->addToBatch(pBatcher, getTransform(), curOpacity, 
+                    getBlendMode());
+        } else {
+            m_pFillShape->draw(getTransform(), curOpacity);
+        }
     }
     VectorNode::render();
 }
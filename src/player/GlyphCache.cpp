@@ -0,0 +1,276 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#include "GlyphCache.h"
+
+#include "../base/Exception.h"
+
+#include "../graphics/Filterfill.h"
+
+#include <pango/pangoft2.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace avg {
+
+// Keeps linear filtering from picking up neighbouring glyphs.
+static const int GLYPH_PADDING = 1;
+
+static const int PAGE_SIZE = 512;
+
+GlyphPage::GlyphPage(const IntPoint& size)
+    : m_Size(size),
+      m_bTexDirty(true),
+      m_RowPos(0,0),
+      m_RowHeight(0)
+{
+    m_pBmp = BitmapPtr(new Bitmap(m_Size, A8, "GlyphPage"));
+    FilterFill<unsigned char>(0).applyInPlace(m_pBmp);
+}
+
+GlyphPage::~GlyphPage()
+{
+    GlyphMap::iterator it;
+    for (it = m_Glyphs.begin(); it != m_Glyphs.end(); ++it) {
+        g_object_unref(it->first.first);
+    }
+}
+
+const GlyphPage::Glyph* GlyphPage::getGlyph(PangoFont* pFont, PangoGlyph glyph)
+{
+    pair<PangoFont*, PangoGlyph> key(pFont, glyph);
+    GlyphMap::iterator it = m_Glyphs.find(key);
+    if (it != m_Glyphs.end()) {
+        return &(it->second);
+    }
+
+    PangoRectangle inkRect;
+    pango_font_get_glyph_extents(pFont, glyph, &inkRect, 0);
+    IntPoint tl(PANGO_PIXELS_FLOOR(inkRect.x), PANGO_PIXELS_FLOOR(inkRect.y));
+    IntPoint br(PANGO_PIXELS_CEIL(inkRect.x+inkRect.width), 
+            PANGO_PIXELS_CEIL(inkRect.y+inkRect.height));
+    Glyph newGlyph;
+    newGlyph.m_Offset = tl;
+    newGlyph.m_Size = br-tl;
+    newGlyph.m_Pos = IntPoint(0,0);
+    if (newGlyph.m_Size.x > 0 && newGlyph.m_Size.y > 0) {
+        if (!allocate(newGlyph.m_Size, newGlyph.m_Pos)) {
+            return 0;
+        }
+        FT_Bitmap bitmap;
+        bitmap.rows = newGlyph.m_Size.y;
+        bitmap.width = newGlyph.m_Size.x;
+        bitmap.pitch = m_pBmp->getStride();
+        bitmap.buffer = m_pBmp->getPixels() + newGlyph.m_Pos.y*m_pBmp->getStride() +
+                newGlyph.m_Pos.x;
+        bitmap.num_grays = 256;
+        bitmap.pixel_mode = ft_pixel_mode_grays;
+
+        PangoGlyphString* pGlyphs = pango_glyph_string_new();
+        pango_glyph_string_set_size(pGlyphs, 1);
+        pGlyphs->glyphs[0].glyph = glyph;
+        pGlyphs->glyphs[0].geometry.width = 0;
+        pGlyphs->glyphs[0].geometry.x_offset = 0;
+        pGlyphs->glyphs[0].geometry.y_offset = 0;
+        pGlyphs->glyphs[0].attr.is_cluster_start = 1;
+        pGlyphs->log_clusters[0] = 0;
+        pango_ft2_render(&bitmap, pFont, pGlyphs, -tl.x, -tl.y);
+        pango_glyph_string_free(pGlyphs);
+        m_bTexDirty = true;
+    } else {
+        // Whitespace.
+        newGlyph.m_Size = IntPoint(0,0);
+    }
+    g_object_ref(pFont);
+    it = m_Glyphs.insert(make_pair(key, newGlyph)).first;
+    return &(it->second);
+}
+
+const IntPoint& GlyphPage::getSize() const
+{
+    return m_Size;
+}
+
+int GlyphPage::getNumGlyphs() const
+{
+    return int(m_Glyphs.size());
+}
+
+GLTexturePtr GlyphPage::getTexture()
+{
+    if (!m_pTex) {
+        m_pTex = GLTexturePtr(new GLTexture(m_Size, A8));
+        m_bTexDirty = true;
+    }
+    return m_pTex;
+}
+
+void GlyphPage::uploadTexture()
+{
+    getTexture();
+    if (m_bTexDirty) {
+        m_pTex->moveBmpToTexture(m_pBmp);
+        m_bTexDirty = false;
+    }
+}
+
+void GlyphPage::releaseTexture()
+{
+    m_pTex = GLTexturePtr();
+    m_bTexDirty = true;
+}
+
+bool GlyphPage::hasTexture() const
+{
+    return bool(m_pTex);
+}
+
+bool GlyphPage::allocate(const IntPoint& size, IntPoint& pos)
+{
+    IntPoint paddedSize = size + IntPoint(GLYPH_PADDING, GLYPH_PADDING);
+    if (m_RowPos.x + paddedSize.x > m_Size.x) {
+        m_RowPos = IntPoint(0, m_RowPos.y + m_RowHeight);
+        m_RowHeight = 0;
+    }
+    if (m_RowPos.x + paddedSize.x > m_Size.x || m_RowPos.y + paddedSize.y > m_Size.y) {
+        return false;
+    }
+    pos = m_RowPos;
+    m_RowPos.x += paddedSize.x;
+    m_RowHeight = max(m_RowHeight, paddedSize.y);
+    return true;
+}
+
+
+GlyphCache* GlyphCache::s_pGlyphCache = 0;
+
+GlyphCache::GlyphCache()
+{
+    if (s_pGlyphCache) {
+        throw Exception(AVG_ERR_UNKNOWN, "GlyphCache has already been instantiated.");
+    }
+    s_pGlyphCache = this;
+}
+
+GlyphCache::~GlyphCache()
+{
+    s_pGlyphCache = 0;
+}
+
+GlyphCache* GlyphCache::get()
+{
+    if (!s_pGlyphCache) {
+        s_pGlyphCache = new GlyphCache();
+    }
+    return s_pGlyphCache;
+}
+
+GlyphPagePtr GlyphCache::getCurPage(const PangoFontDescription* pDesc, bool bHint)
+{
+    PageMap::iterator it = m_CurPages.find(getKey(pDesc, bHint));
+    if (it == m_CurPages.end()) {
+        return addPage(pDesc, bHint);
+    } else {
+        return it->second;
+    }
+}
+
+GlyphPagePtr GlyphCache::addPage(const PangoFontDescription* pDesc, bool bHint)
+{
+    GlyphPagePtr pPage(new GlyphPage(IntPoint(PAGE_SIZE, PAGE_SIZE)));
+    m_CurPages[getKey(pDesc, bHint)] = pPage;
+    removeExpiredPages();
+    m_AllPages.push_back(pPage);
+    return pPage;
+}
+
+void GlyphCache::releaseTextures()
+{
+    // Called before the GL context goes away. The bitmaps are kept, so the textures
+    // can be recreated on demand.
+    removeExpiredPages();
+    PageList::iterator it;
+    for (it = m_AllPages.begin(); it != m_AllPages.end(); ++it) {
+        GlyphPagePtr pPage = it->lock();
+        if (pPage) {
+            pPage->releaseTexture();
+        }
+    }
+}
+
+void GlyphCache::clear()
+{
+    m_CurPages.clear();
+}
+
+int GlyphCache::getNumPages() const
+{
+    int numPages = 0;
+    PageList::const_iterator it;
+    for (it = m_AllPages.begin(); it != m_AllPages.end(); ++it) {
+        if (!it->expired()) {
+            numPages++;
+        }
+    }
+    return numPages;
+}
+
+int GlyphCache::getNumTextures() const
+{
+    int numTextures = 0;
+    PageList::const_iterator it;
+    for (it = m_AllPages.begin(); it != m_AllPages.end(); ++it) {
+        GlyphPagePtr pPage = it->lock();
+        if (pPage && pPage->hasTexture()) {
+            numTextures++;
+        }
+    }
+    return numTextures;
+}
+
+string GlyphCache::getKey(const PangoFontDescription* pDesc, bool bHint) const
+{
+    char* pszDesc = pango_font_description_to_string(pDesc);
+    string sKey(pszDesc);
+    g_free(pszDesc);
+    if (bHint) {
+        sKey += "|hint";
+    }
+    return sKey;
+}
+
+void GlyphCache::removeExpiredPages()
+{
+    PageList::iterator it = m_AllPages.begin();
+    while (it != m_AllPages.end()) {
+        if (it->expired()) {
+            it = m_AllPages.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}
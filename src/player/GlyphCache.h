@@ -0,0 +1,121 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#ifndef _GlyphCache_H_
+#define _GlyphCache_H_
+
+#include "../api.h"
+
+#include "../base/GLMHelper.h"
+#include "../graphics/Bitmap.h"
+#include "../graphics/GLTexture.h"
+
+#include <pango/pango.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <string>
+#include <map>
+#include <vector>
+
+namespace avg {
+
+// One texture page of a glyph atlas. Glyphs are rasterized once and packed into the
+// page row by row. They never move, so texture coordinates stay valid as long as the 
+// page exists.
+class AVG_API GlyphPage
+{
+    public:
+        struct Glyph {
+            IntPoint m_Pos;     // Position in the page.
+            IntPoint m_Size;
+            IntPoint m_Offset;  // Top left corner relative to the glyph origin.
+        };
+
+        GlyphPage(const IntPoint& size);
+        virtual ~GlyphPage();
+
+        // Rasterizes the glyph if it isn't in the page yet. Returns 0 if the page
+        // is full.
+        const Glyph* getGlyph(PangoFont* pFont, PangoGlyph glyph);
+        const IntPoint& getSize() const;
+        int getNumGlyphs() const;
+
+        GLTexturePtr getTexture();
+        void uploadTexture();
+        void releaseTexture();
+        bool hasTexture() const;
+
+    private:
+        bool allocate(const IntPoint& size, IntPoint& pos);
+
+        typedef std::map<std::pair<PangoFont*, PangoGlyph>, Glyph> GlyphMap;
+        GlyphMap m_Glyphs;
+
+        IntPoint m_Size;
+        BitmapPtr m_pBmp;
+        GLTexturePtr m_pTex;
+        bool m_bTexDirty;
+
+        IntPoint m_RowPos;
+        int m_RowHeight;
+};
+
+typedef boost::shared_ptr<GlyphPage> GlyphPagePtr;
+
+// Process-wide cache that lets all WordsNodes using the same font description and 
+// hinting setting share glyph pages. Only the page that new glyphs are added to is
+// kept alive here; full pages live as long as there are nodes that use them. The
+// cache still tracks full pages so their textures can be released with the GL
+// context.
+class AVG_API GlyphCache
+{
+    public:
+        GlyphCache();
+        virtual ~GlyphCache();
+        static GlyphCache* get();
+
+        GlyphPagePtr getCurPage(const PangoFontDescription* pDesc, bool bHint);
+        GlyphPagePtr addPage(const PangoFontDescription* pDesc, bool bHint);
+        void releaseTextures();
+        void clear();
+
+        int getNumPages() const;
+        int getNumTextures() const;
+
+    private:
+        std::string getKey(const PangoFontDescription* pDesc, bool bHint) const;
+        void removeExpiredPages();
+
+        typedef std::map<std::string, GlyphPagePtr> PageMap;
+        PageMap m_CurPages;
+        typedef std::vector<boost::weak_ptr<GlyphPage> > PageList;
+        PageList m_AllPages;
+
+        static GlyphCache* s_pGlyphCache;
+};
+
+}
+
+#endif
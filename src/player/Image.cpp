@@ -28,9 +28,11 @@
 #include "../graphics/Filterfliprgb.h"
 #include "../graphics/TextureMover.h"
 #include "../graphics/BitmapLoader.h"
+#include "../graphics/GLContext.h"
 
 #include "OGLSurface.h"
 #include "OffscreenCanvas.h"
+#include "ImageCache.h"
 
 #include <iostream>
 #include <sstream>
@@ -52,6 +54,7 @@ Image::Image(OGLSurface * pSurface, const MaterialInfo& material)
 
 Image::~Image()
 {
+    cancelUpload();
     if (m_State == GPU && m_Source != NONE) {
         m_pSurface->destroy();
     }
@@ -86,8 +89,19 @@ void Image::moveToCPU()
     if (m_State == GPU) {
         switch (m_Source) {
             case FILE:
+                // The image cache still holds the file contents.
+                flushUpload();
+                break;
             case BITMAP:
-                m_pBmp = m_pSurface->getTex()->moveTextureToBmp();
+                if (m_pPendingTex) {
+                    // The newest bitmap hasn't been uploaded yet, so there's no need to
+                    // read it back from the texture.
+                    m_pBmp = GLContext::getMain()->getTextureUploadQueue().takeUpload(
+                            m_pPendingTex);
+                    m_pPendingTex = GLTexturePtr();
+                } else {
+                    m_pBmp = m_pSurface->getTex()->moveTextureToBmp();
+                }
                 break;
             case SCENE:
                 break;
@@ -114,6 +128,7 @@ void Image::discard()
 void Image::setEmpty()
 {
     assertValid();
+    cancelUpload();
     if (m_State == GPU) {
         m_pSurface->destroy();
     }
@@ -124,31 +139,12 @@ void Image::setEmpty()
 void Image::setFilename(const std::string& sFilename, TextureCompression comp)
 {
     assertValid();
-    AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, "Loading " << sFilename);
-    BitmapPtr pBmp = loadBitmap(sFilename);
-    if (comp == TEXTURECOMPRESSION_B5G6R5 && pBmp->hasAlpha()) {
-        throw Exception(AVG_ERR_UNSUPPORTED, 
-                "B5G6R5-compressed textures with an alpha channel are not supported.");
-    }
+    CachedImagePtr pCachedImage = ImageCache::get()->load(sFilename, comp, m_Material);
+    cancelUpload();
     changeSource(FILE);
-    m_pBmp = pBmp;
-
+    m_pCachedImage = pCachedImage;
     m_sFilename = sFilename;
 
-    switch (comp) {
-        case TEXTURECOMPRESSION_B5G6R5:
-            m_pBmp = BitmapPtr(new Bitmap(pBmp->getSize(), B5G6R5, sFilename));
-            if (!BitmapLoader::get()->isBlueFirst()) {
-                FilterFlipRGB().applyInPlace(pBmp);
-            }
-            m_pBmp->copyPixels(*pBmp);
-            break;
-        case TEXTURECOMPRESSION_NONE:
-            break;
-        default:
-            assert(false);
-    }
-
     if (m_State == GPU) {
         m_pSurface->destroy();
         setupSurface();
@@ -182,21 +178,21 @@ void Image::setBitmap(BitmapPtr pBmp, TextureCompression comp)
             assert(false);
     }
     if (m_State == GPU) {
-        GLTexturePtr pTex = m_pSurface->getTex();
-        if (bSourceChanged || m_pSurface->getSize() != pBmp->getSize() ||
-                m_pSurface->getPixelFormat() != pf)
+        GLTexturePtr pTex = m_pPendingTex;
+        if (!pTex && m_pSurface->isCreated()) {
+            pTex = m_pSurface->getTex();
+        }
+        if (bSourceChanged || !pTex || pTex->getSize() != pBmp->getSize() ||
+                pTex->getPF() != pf)
         {
             pTex = GLTexturePtr(new GLTexture(pBmp->getSize(), pf, 
                     m_Material.getUseMipmaps(), 0, m_Material.getWrapSMode(), 
                     m_Material.getWrapTMode()));
-            m_pSurface->create(pf, pTex);
         }
-        TextureMoverPtr pMover = TextureMover::create(pBmp->getSize(), pf,
-                GL_STATIC_DRAW);
-        BitmapPtr pMoverBmp = pMover->lock();
-        pMoverBmp->copyPixels(*pBmp);
-        pMover->unlock();
-        pMover->moveToTexture(*pTex);
+        // The caller may change pBmp after this, so the upload needs a copy.
+        BitmapPtr pUploadBmp(new Bitmap(pBmp->getSize(), pf, ""));
+        pUploadBmp->copyPixels(*pBmp);
+        scheduleUpload(pUploadBmp, pTex);
         m_pBmp = BitmapPtr();
     } else {
         m_pBmp = BitmapPtr(new Bitmap(pBmp->getSize(), pf, ""));
@@ -211,6 +207,7 @@ void Image::setCanvas(OffscreenCanvasPtr pCanvas)
     if (m_Source == SCENE && pCanvas == m_pCanvas) {
         return;
     }
+    cancelUpload();
     changeSource(SCENE);
     m_pCanvas = pCanvas;
     if (m_State == GPU) {
@@ -238,10 +235,13 @@ BitmapPtr Image::getBitmap()
             case CPU:
                 if (m_Source == SCENE) {
                     return BitmapPtr();
+                } else if (m_Source == FILE) {
+                    return BitmapPtr(new Bitmap(*m_pCachedImage->getBitmap()));
                 } else {
                     return BitmapPtr(new Bitmap(*m_pBmp));
                 }
             case GPU:
+                flushUpload();
                 return m_pSurface->getTex()->moveTextureToBmp();
             default:
                 AVG_ASSERT(false);
@@ -259,10 +259,15 @@ IntPoint Image::getSize()
             case CPU:
                 if (m_Source == SCENE) {
                     return m_pCanvas->getSize();
+                } else if (m_Source == FILE) {
+                    return m_pCachedImage->getSize();
                 } else {
                     return m_pBmp->getSize();
                 }
             case GPU:
+                if (m_pPendingTex && !m_pSurface->isCreated()) {
+                    return m_pPendingTex->getSize();
+                }
                 return m_pSurface->getSize();
             default:
                 AVG_ASSERT(false);
@@ -282,7 +287,9 @@ PixelFormat Image::getPixelFormat()
     if (m_Source != NONE) {
         switch (m_State) {
             case CPU:
-                if (m_Source != SCENE) {
+                if (m_Source == FILE) {
+                    pf = m_pCachedImage->getPixelFormat();
+                } else if (m_Source != SCENE) {
                     pf = m_pBmp->getPixelFormat();
                 }
             case GPU:
@@ -310,6 +317,11 @@ Image::Source Image::getSource()
     return m_Source;
 }
 
+bool Image::hasTexture()
+{
+    return m_Source != NONE && m_State == GPU && m_pSurface->isCreated();
+}
+
 Image::TextureCompression Image::string2compression(const string& s)
 {
     if (s == "none") {
@@ -337,16 +349,57 @@ string Image::compression2String(TextureCompression compression)
 
 void Image::setupSurface()
 {
+    if (m_Source == FILE) {
+        GLTexturePtr pTex = m_pCachedImage->getTexture();
+        m_pSurface->create(pTex->getPF(), pTex);
+        return;
+    }
     PixelFormat pf = m_pBmp->getPixelFormat();
 //    cerr << "setupSurface: " << pf << endl;
     GLTexturePtr pTex(new GLTexture(m_pBmp->getSize(), pf, m_Material.getUseMipmaps(), 
             0, m_Material.getWrapSMode(), m_Material.getWrapTMode()));
-    m_pSurface->create(pf, pTex);
-    TextureMoverPtr pMover = TextureMover::create(m_pBmp->getSize(), pf, GL_STATIC_DRAW);
-    pMover->moveBmpToTexture(m_pBmp, *pTex);
+    scheduleUpload(m_pBmp, pTex);
     m_pBmp = BitmapPtr();
 }
 
+void Image::onTextureUploaded(GLTexturePtr pTex)
+{
+    AVG_ASSERT(pTex == m_pPendingTex);
+    m_pPendingTex = GLTexturePtr();
+    if (!m_pSurface->isCreated() || m_pSurface->getTex() != pTex) {
+        m_pSurface->create(pTex->getPF(), pTex);
+    }
+}
+
+void Image::scheduleUpload(BitmapPtr pBmp, GLTexturePtr pTex)
+{
+    TextureUploadQueue& queue = GLContext::getMain()->getTextureUploadQueue();
+    if (m_pPendingTex && m_pPendingTex != pTex) {
+        queue.cancelUpload(m_pPendingTex);
+    }
+    m_pPendingTex = pTex;
+    queue.pushUpload(pBmp, pTex, this);
+}
+
+void Image::flushUpload()
+{
+    if (m_pPendingTex) {
+        GLContext::getMain()->getTextureUploadQueue().flushUpload(m_pPendingTex);
+        AVG_ASSERT(!m_pPendingTex);
+    }
+}
+
+void Image::cancelUpload()
+{
+    if (m_pPendingTex) {
+        GLContext* pContext = GLContext::getMain();
+        if (pContext) {
+            pContext->getTextureUploadQueue().cancelUpload(m_pPendingTex);
+        }
+        m_pPendingTex = GLTexturePtr();
+    }
+}
+
 bool Image::changeSource(Source newSource)
 {
     if (newSource != m_Source) {
@@ -354,11 +407,13 @@ bool Image::changeSource(Source newSource)
             case NONE:
                 break;
             case FILE:
+                m_pCachedImage = CachedImagePtr();
+                m_sFilename = "";
+                break;
             case BITMAP:
                 if (m_State == CPU) {
                     m_pBmp = BitmapPtr();
                 }
-                m_sFilename = "";
                 break;
             case SCENE:
                 m_pCanvas = OffscreenCanvasPtr();
@@ -377,16 +432,19 @@ void Image::assertValid() const
 {
     AVG_ASSERT(m_pSurface);
     AVG_ASSERT((m_Source == FILE) == (m_sFilename != ""));
+    AVG_ASSERT((m_Source == FILE) == bool(m_pCachedImage));
     AVG_ASSERT((m_Source == SCENE) == bool(m_pCanvas));
     switch (m_State) {
         case CPU:
-            AVG_ASSERT((m_Source == FILE || m_Source == BITMAP) == bool(m_pBmp));
+            AVG_ASSERT((m_Source == BITMAP) == bool(m_pBmp));
             AVG_ASSERT(!(m_pSurface->isCreated()));
+            AVG_ASSERT(!m_pPendingTex);
             break;
         case GPU:
             AVG_ASSERT(!m_pBmp);
+            AVG_ASSERT(!m_pPendingTex || m_Source == BITMAP);
             if (m_Source != NONE) {
-                AVG_ASSERT(m_pSurface->isCreated());
+                AVG_ASSERT(m_pSurface->isCreated() || m_pPendingTex);
             } else {
                 AVG_ASSERT(!m_pSurface->isCreated());
             }
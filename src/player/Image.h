@@ -28,6 +28,7 @@
 
 #include "../base/GLMHelper.h"
 #include "../graphics/Bitmap.h"
+#include "../graphics/TextureUploadQueue.h"
 
 #include <boost/shared_ptr.hpp>
 #include <string>
@@ -37,8 +38,13 @@ namespace avg {
 class OGLSurface;
 class OffscreenCanvas;
 typedef boost::shared_ptr<OffscreenCanvas> OffscreenCanvasPtr;
+class CachedImage;
+typedef boost::shared_ptr<CachedImage> CachedImagePtr;
 
-class AVG_API Image
+// In the GPU state, bitmaps are moved to textures by the context's 
+// TextureUploadQueue. Until an upload is done, the surface keeps showing the 
+// previous texture or, if there is none, isn't created.
+class AVG_API Image: public ITextureUploadListener
 {
     public:
         enum State {CPU, GPU};
@@ -70,19 +76,28 @@ class AVG_API Image
         OGLSurface* getSurface();
         State getState();
         Source getSource();
+        // False while the first upload of a bitmap is pending.
+        bool hasTexture();
 
         static TextureCompression string2compression(const std::string& s);
         static std::string compression2String(TextureCompression compression);
 
+        virtual void onTextureUploaded(GLTexturePtr pTex);
+
     private:
         void setupSurface();
+        void scheduleUpload(BitmapPtr pBmp, GLTexturePtr pTex);
+        void flushUpload();
+        void cancelUpload();
         bool changeSource(Source newSource);
         void assertValid() const;
 
         std::string m_sFilename;
+        CachedImagePtr m_pCachedImage;
         BitmapPtr m_pBmp;
         OGLSurface * m_pSurface;
         OffscreenCanvasPtr m_pCanvas;
+        GLTexturePtr m_pPendingTex;
 
         State m_State;
         Source m_Source;
@@ -0,0 +1,359 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "ImageCache.h"
+
+#include "../base/Exception.h"
+#include "../base/Logger.h"
+
+#include "../graphics/BitmapLoader.h"
+#include "../graphics/Filterfliprgb.h"
+#include "../graphics/TextureMover.h"
+
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace avg {
+
+CachedImage::CachedImage(const string& sFilename, Image::TextureCompression comp,
+        const MaterialInfo& material, ImageCache* pCache)
+    : m_sFilename(sFilename),
+      m_Compression(comp),
+      m_Material(material),
+      m_pCache(pCache)
+{
+    m_pBmp = loadFile();
+    m_Size = m_pBmp->getSize();
+    m_PF = m_pBmp->getPixelFormat();
+    m_MemUsed = getMemUsed();
+}
+
+CachedImage::~CachedImage()
+{
+}
+
+const string& CachedImage::getFilename() const
+{
+    return m_sFilename;
+}
+
+const IntPoint& CachedImage::getSize() const
+{
+    return m_Size;
+}
+
+PixelFormat CachedImage::getPixelFormat() const
+{
+    return m_PF;
+}
+
+BitmapPtr CachedImage::getBitmap()
+{
+    if (m_pBmp) {
+        return m_pBmp;
+    } else if (m_pTex) {
+        return m_pTex->moveTextureToBmp();
+    } else {
+        m_pBmp = loadFile();
+        updateMemUsed();
+        return m_pBmp;
+    }
+}
+
+GLTexturePtr CachedImage::getTexture()
+{
+    if (!m_pTex) {
+        BitmapPtr pBmp = getBitmap();
+        m_pTex = GLTexturePtr(new GLTexture(m_Size, m_PF, m_Material.getUseMipmaps(),
+                0, m_Material.getWrapSMode(), m_Material.getWrapTMode()));
+        TextureMoverPtr pMover = TextureMover::create(m_Size, m_PF, GL_STATIC_DRAW);
+        pMover->moveBmpToTexture(pBmp, *m_pTex);
+        m_pBmp = BitmapPtr();
+        updateMemUsed();
+    }
+    return m_pTex;
+}
+
+bool CachedImage::hasTexture() const
+{
+    return bool(m_pTex);
+}
+
+void CachedImage::releaseTexture(bool bKeepBitmap)
+{
+    if (m_pTex) {
+        if (bKeepBitmap && !m_pBmp) {
+            m_pBmp = m_pTex->moveTextureToBmp();
+        }
+        m_pTex = GLTexturePtr();
+        updateMemUsed();
+    }
+}
+
+long long CachedImage::getMemUsed() const
+{
+    long long memUsed = 0;
+    if (m_pBmp) {
+        memUsed += m_pBmp->getMemNeeded();
+    }
+    if (m_pTex) {
+        IntPoint glSize = m_pTex->getGLSize();
+        long long texMem = (long long)glSize.x*glSize.y*getBytesPerPixel(m_PF);
+        if (m_Material.getUseMipmaps()) {
+            texMem = texMem*4/3;
+        }
+        memUsed += texMem;
+    }
+    return memUsed;
+}
+
+BitmapPtr CachedImage::loadFile() const
+{
+    AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, 
+            "Loading " << m_sFilename);
+    BitmapPtr pBmp = loadBitmap(m_sFilename);
+    switch (m_Compression) {
+        case Image::TEXTURECOMPRESSION_B5G6R5: {
+                if (pBmp->hasAlpha()) {
+                    throw Exception(AVG_ERR_UNSUPPORTED, "B5G6R5-compressed textures "
+                            "with an alpha channel are not supported.");
+                }
+                BitmapPtr pDestBmp(new Bitmap(pBmp->getSize(), B5G6R5, m_sFilename));
+                if (!BitmapLoader::get()->isBlueFirst()) {
+                    FilterFlipRGB().applyInPlace(pBmp);
+                }
+                pDestBmp->copyPixels(*pBmp);
+                return pDestBmp;
+            }
+        case Image::TEXTURECOMPRESSION_NONE:
+            return pBmp;
+        default:
+            AVG_ASSERT(false);
+            return BitmapPtr();
+    }
+}
+
+void CachedImage::updateMemUsed()
+{
+    long long memUsed = getMemUsed();
+    if (m_pCache) {
+        m_pCache->m_MemUsed += memUsed-m_MemUsed;
+    }
+    m_MemUsed = memUsed;
+}
+
+void CachedImage::detach()
+{
+    m_pCache = 0;
+}
+
+
+ImageCache* ImageCache::s_pImageCache = 0;
+
+ImageCache::ImageCache()
+    : m_Budget(64*1024*1024),
+      m_MemUsed(0),
+      m_NumHits(0),
+      m_NumMisses(0)
+{
+    if (s_pImageCache) {
+        throw Exception(AVG_ERR_UNKNOWN, "ImageCache has already been instantiated.");
+    }
+    s_pImageCache = this;
+}
+
+ImageCache::~ImageCache()
+{
+    EntryList::iterator it;
+    for (it = m_Entries.begin(); it != m_Entries.end(); ++it) {
+        it->second->detach();
+    }
+    s_pImageCache = 0;
+}
+
+ImageCache* ImageCache::get()
+{
+    if (!s_pImageCache) {
+        s_pImageCache = new ImageCache();
+    }
+    return s_pImageCache;
+}
+
+CachedImagePtr ImageCache::load(const string& sFilename, 
+        Image::TextureCompression comp, const MaterialInfo& material)
+{
+    Key key(sFilename, comp, material);
+    EntryMap::iterator it = m_EntryMap.find(key);
+    if (it != m_EntryMap.end()) {
+        m_NumHits++;
+        EntryList::iterator entryIt = it->second;
+        m_Entries.splice(m_Entries.begin(), m_Entries, entryIt);
+        return entryIt->second;
+    }
+    m_NumMisses++;
+    CachedImagePtr pImage(new CachedImage(sFilename, comp, material, this));
+    m_Entries.push_front(make_pair(key, pImage));
+    m_EntryMap[key] = m_Entries.begin();
+    m_MemUsed += pImage->getMemUsed();
+    evict();
+    return pImage;
+}
+
+void ImageCache::releaseTextures()
+{
+    // Called before the GL context goes away. Entries that are still in use keep
+    // their contents in CPU memory, unused entries that only have a texture are 
+    // dropped.
+    EntryList::iterator it = m_Entries.begin();
+    while (it != m_Entries.end()) {
+        const CachedImagePtr& pImage = it->second;
+        bool bInUse = !pImage.unique();
+        if (!bInUse && pImage->hasTexture()) {
+            it = erase(it);
+        } else {
+            pImage->releaseTexture(bInUse);
+            ++it;
+        }
+    }
+}
+
+void ImageCache::clear()
+{
+    EntryList::iterator it = m_Entries.begin();
+    while (it != m_Entries.end()) {
+        if (it->second.unique()) {
+            it = erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ImageCache::setBudget(long long numBytes)
+{
+    m_Budget = numBytes;
+    evict();
+}
+
+long long ImageCache::getBudget() const
+{
+    return m_Budget;
+}
+
+long long ImageCache::getMemUsed() const
+{
+    return m_MemUsed;
+}
+
+int ImageCache::getNumEntries() const
+{
+    return int(m_Entries.size());
+}
+
+int ImageCache::getNumHits() const
+{
+    return m_NumHits;
+}
+
+int ImageCache::getNumMisses() const
+{
+    return m_NumMisses;
+}
+
+float ImageCache::getHitRate() const
+{
+    if (m_NumHits+m_NumMisses == 0) {
+        return 0;
+    } else {
+        return float(m_NumHits)/(m_NumHits+m_NumMisses);
+    }
+}
+
+void ImageCache::resetStatistics()
+{
+    m_NumHits = 0;
+    m_NumMisses = 0;
+}
+
+void ImageCache::evict()
+{
+    EntryList::iterator it = m_Entries.end();
+    while (m_MemUsed > m_Budget && it != m_Entries.begin()) {
+        --it;
+        if (it->second.unique()) {
+            it = erase(it);
+        }
+    }
+}
+
+ImageCache::EntryList::iterator ImageCache::erase(EntryList::iterator it)
+{
+    CachedImagePtr pImage = it->second;
+    m_MemUsed -= pImage->m_MemUsed;
+    pImage->detach();
+    m_EntryMap.erase(it->first);
+    return m_Entries.erase(it);
+}
+
+
+ImageCache::Key::Key(const string& sFilename, Image::TextureCompression comp,
+        const MaterialInfo& material)
+    : m_sFilename(sFilename),
+      m_ModTime(0),
+      m_FileSize(0),
+      m_Compression(comp),
+      m_WrapSMode(material.getWrapSMode()),
+      m_WrapTMode(material.getWrapTMode()),
+      m_bUseMipmaps(material.getUseMipmaps())
+{
+    struct stat fileStat;
+    if (stat(sFilename.c_str(), &fileStat) == 0) {
+        m_ModTime = fileStat.st_mtime;
+        m_FileSize = fileStat.st_size;
+    }
+}
+
+bool ImageCache::Key::operator <(const Key& other) const
+{
+    if (m_sFilename != other.m_sFilename) {
+        return m_sFilename < other.m_sFilename;
+    }
+    if (m_ModTime != other.m_ModTime) {
+        return m_ModTime < other.m_ModTime;
+    }
+    if (m_FileSize != other.m_FileSize) {
+        return m_FileSize < other.m_FileSize;
+    }
+    if (m_Compression != other.m_Compression) {
+        return m_Compression < other.m_Compression;
+    }
+    if (m_WrapSMode != other.m_WrapSMode) {
+        return m_WrapSMode < other.m_WrapSMode;
+    }
+    if (m_WrapTMode != other.m_WrapTMode) {
+        return m_WrapTMode < other.m_WrapTMode;
+    }
+    return m_bUseMipmaps < other.m_bUseMipmaps;
+}
+
+}
@@ -0,0 +1,148 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _ImageCache_H_
+#define _ImageCache_H_
+
+#include "../api.h"
+
+#include "Image.h"
+#include "MaterialInfo.h"
+
+#include "../graphics/Bitmap.h"
+#include "../graphics/GLTexture.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <list>
+#include <map>
+
+namespace avg {
+
+class ImageCache;
+
+// Decoded contents of one image file. The bitmap is kept until a texture has been
+// created from it; after that, the texture is the only copy.
+class AVG_API CachedImage
+{
+    public:
+        CachedImage(const std::string& sFilename, Image::TextureCompression comp,
+                const MaterialInfo& material, ImageCache* pCache=0);
+        virtual ~CachedImage();
+
+        const std::string& getFilename() const;
+        const IntPoint& getSize() const;
+        PixelFormat getPixelFormat() const;
+        BitmapPtr getBitmap();
+        GLTexturePtr getTexture();
+        bool hasTexture() const;
+        void releaseTexture(bool bKeepBitmap);
+        long long getMemUsed() const;
+
+    private:
+        friend class ImageCache;
+
+        BitmapPtr loadFile() const;
+        void updateMemUsed();
+        void detach();
+
+        std::string m_sFilename;
+        Image::TextureCompression m_Compression;
+        MaterialInfo m_Material;
+        IntPoint m_Size;
+        PixelFormat m_PF;
+
+        BitmapPtr m_pBmp;
+        GLTexturePtr m_pTex;
+
+        ImageCache* m_pCache;
+        long long m_MemUsed;
+};
+
+typedef boost::shared_ptr<CachedImage> CachedImagePtr;
+
+// Process-wide cache that lets all Images showing the same file share one bitmap and
+// texture. Entries are keyed by file name, modification time, compression and
+// material. Entries that are in use are never evicted. Entries that aren't used
+// by any Image anymore are kept around in LRU order as long as the total memory
+// used stays within budget. The total is kept up to date by the entries themselves,
+// so getMemUsed() doesn't need to walk the cache.
+class AVG_API ImageCache
+{
+    public:
+        ImageCache();
+        virtual ~ImageCache();
+        static ImageCache* get();
+
+        CachedImagePtr load(const std::string& sFilename, 
+                Image::TextureCompression comp, const MaterialInfo& material);
+        void releaseTextures();
+        void clear();
+
+        void setBudget(long long numBytes);
+        long long getBudget() const;
+        long long getMemUsed() const;
+        int getNumEntries() const;
+
+        int getNumHits() const;
+        int getNumMisses() const;
+        float getHitRate() const;
+        void resetStatistics();
+
+    private:
+        struct Key {
+            Key(const std::string& sFilename, Image::TextureCompression comp,
+                    const MaterialInfo& material);
+            bool operator <(const Key& other) const;
+
+            std::string m_sFilename;
+            long long m_ModTime;
+            long long m_FileSize;
+            Image::TextureCompression m_Compression;
+            int m_WrapSMode;
+            int m_WrapTMode;
+            bool m_bUseMipmaps;
+        };
+
+        friend class CachedImage;
+
+        typedef std::list<std::pair<Key, CachedImagePtr> > EntryList;
+        typedef std::map<Key, EntryList::iterator> EntryMap;
+
+        void evict();
+        EntryList::iterator erase(EntryList::iterator it);
+
+        EntryList m_Entries;
+        EntryMap m_EntryMap;
+        long long m_Budget;
+        long long m_MemUsed;
+
+        int m_NumHits;
+        int m_NumMisses;
+
+        static ImageCache* s_pImageCache;
+};
+
+}
+
+#endif
@@ -60,6 +60,12 @@ ImageNode::ImageNode(const ArgList& args)
     ObjectCounter::get()->incRef(&typeid(*this));
 }
 
+void ImageNode::getArgs(ArgList& args) const
+{
+    RasterNode::getArgs(args);
+    args.setArgVal<string>("compression", Image::compression2String(m_Compression));
+}
+
 ImageNode::~ImageNode()
 {
     // XXX: The following assert checks that disconnect(true) has been called.
@@ -155,7 +161,7 @@ void ImageNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     Node::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
     if (isVisible()) {
         bool bHasCanvas = bool(m_pImage->getCanvas());
-        if (m_pImage->getSource() != Image::NONE) {
+        if (m_pImage->hasTexture()) {
             renderFX(getSize(), Pixel32(255, 255, 255, 255), bHasCanvas, bHasCanvas);
         }
     }
@@ -167,7 +173,7 @@ static ProfilingZoneID RenderProfilingZone("ImageNode::render");
 void ImageNode::render()
 {
     ScopeTimer Timer(RenderProfilingZone);
-    if (m_pImage->getSource() != Image::NONE) {
+    if (m_pImage->hasTexture()) {
         blt32(getTransform(), getSize(), getEffectiveOpacity(), getBlendMode(), 
                 bool(m_pImage->getCanvas()));
     }
@@ -178,6 +184,11 @@ IntPoint ImageNode::getMediaSize()
     return m_pImage->getSize();
 }
 
+bool ImageNode::supportsBatching() const
+{
+    return true;
+}
+
 void ImageNode::checkReload()
 {
     if (isCanvasURL(m_href)) {
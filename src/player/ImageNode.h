@@ -40,6 +40,7 @@ class AVG_API ImageNode : public RasterNode
         
         ImageNode(const ArgList& args);
         virtual ~ImageNode();
+        virtual void getArgs(ArgList& args) const;
         virtual void connectDisplay();
         virtual void connect(CanvasPtr pCanvas);
         virtual void disconnect(bool bKill);
@@ -59,6 +60,9 @@ class AVG_API ImageNode : public RasterNode
         virtual BitmapPtr getBitmap();
         virtual IntPoint getMediaSize();
 
+    protected:
+        virtual bool supportsBatching() const;
+
     private:
         bool isCanvasURL(const std::string& sURL);
         void checkCanvasValid(const CanvasPtr& pCanvas);
@@ -26,6 +26,8 @@
 
 #include "TypeDefinition.h"
 #include "VectorNode.h"
+#include "Canvas.h"
+#include "RenderBatcher.h"
 
 #include <cstdlib>
 #include <string>
@@ -150,13 +152,21 @@ void MeshNode::calcVertexes(const VertexDataPtr& pVertexData, Pixel32 color)
 
 void MeshNode::render()
 {
+    // Culling state changes can't be part of a batch.
+    RenderBatcher* pBatcher = getCanvas()->getRenderBatcher();
     if (m_bBackfaceCull) {
+        if (pBatcher) {
+            pBatcher->flush();
+        }
         glEnable(GL_CULL_FACE);
     }
     
     VectorNode::render();
     
     if (m_bBackfaceCull) {
+        if (pBatcher) {
+            pBatcher->flush();
+        }
         glDisable(GL_CULL_FACE);
     }
 }
@@ -28,6 +28,7 @@
 #include "Player.h"
 #include "CursorEvent.h"
 #include "PublisherDefinition.h"
+#include "NodeTemplate.h"
 
 #include "../base/Exception.h"
 #include "../base/Logger.h"
@@ -67,6 +68,7 @@ void Node::registerType()
     pPubDef->addMessage("PEN_OUT");
     pPubDef->addMessage("END_OF_FILE");
     pPubDef->addMessage("SIZE_CHANGED");
+    pPubDef->addMessage("TEXT_RENDERED");
 
     TypeDefinition def = TypeDefinition("node")
         .addArg(Arg<string>("id", "", false, offsetof(Node, m_ID)))
@@ -80,7 +82,8 @@ Node::Node(const std::string& sPublisherName)
     : Publisher(sPublisherName),
       m_pParent(0),
       m_pCanvas(),
-      m_State(NS_UNCONNECTED)
+      m_State(NS_UNCONNECTED),
+      m_bHitBoundsValid(false)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -126,6 +129,11 @@ void Node::removeParent()
     m_pParent = 0;
 }
 
+NodePtr Node::clone(bool bDeep)
+{
+    return NodeTemplate(getSharedThis(), bDeep).instantiate();
+}
+
 DivNodePtr Node::getParent() const
 {
     if (m_pParent == 0) {
@@ -157,11 +165,14 @@ void Node::connect(CanvasPtr pCanvas)
 {
     m_pCanvas = pCanvas;
     setState(NS_CONNECTED);
+    setCanvasDirty();
+    invalidateHitBounds();
 }
 
 void Node::disconnect(bool bKill)
 {
     AVG_ASSERT(getState() != NS_UNCONNECTED);
+    setCanvasDirty();
     m_pCanvas.lock()->removeNodeID(getID());
     setState(NS_UNCONNECTED);
     if (bKill) {
@@ -204,6 +215,7 @@ void Node::setOpacity(float opacity)
     } else if (m_Opacity > 1.0) {
         m_Opacity = 1.0;
     }
+    setCanvasDirty();
 }
 
 bool Node::getActive() const 
@@ -215,6 +227,8 @@ void Node::setActive(bool bActive)
 {
     if (bActive != m_bActive) {
         m_bActive = bActive;
+        setCanvasDirty();
+        invalidateHitBounds();
     }
 }
 
@@ -226,6 +240,7 @@ bool Node::getSensitive() const
 void Node::setSensitive(bool bSensitive)
 {
     m_bSensitive = bSensitive;
+    invalidateHitBounds();
 }
 
 void Node::setMouseEventCapture()
@@ -366,6 +381,30 @@ void Node::getElementsByPos(const glm::vec2& pos, vector<NodePtr>& pElements)
 {
 }
 
+// Bounds are widened by this amount so float rounding differences between the bounds
+// and the exact hit tests can't cause false negatives.
+static const float HIT_BOUNDS_TOLERANCE = 1.f;
+
+bool Node::mayContainHit(const glm::vec2& pos)
+{
+    const FRect& bounds = getHitBounds();
+    return pos.x >= bounds.tl.x && pos.y >= bounds.tl.y &&
+            pos.x <= bounds.br.x && pos.y <= bounds.br.y;
+}
+
+const FRect& Node::getHitBounds()
+{
+    if (!m_bHitBoundsValid) {
+        m_HitBounds = calcHitBounds();
+        if (!isEmptyHitBounds(m_HitBounds)) {
+            m_HitBounds.tl -= glm::vec2(HIT_BOUNDS_TOLERANCE, HIT_BOUNDS_TOLERANCE);
+            m_HitBounds.br += glm::vec2(HIT_BOUNDS_TOLERANCE, HIT_BOUNDS_TOLERANCE);
+        }
+        m_bHitBoundsValid = true;
+    }
+    return m_HitBounds;
+}
+
 void Node::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
         float parentEffectiveOpacity)
 {
@@ -508,6 +547,41 @@ NodePtr Node::getSharedThis()
     return dynamic_pointer_cast<Node>(ExportedObject::getSharedThis());
 }
 
+void Node::invalidateHitBounds()
+{
+    // Ancestor bounds can depend on this node, so they're invalidated as well.
+    m_bHitBoundsValid = false;
+    Node* pNode = m_pParent;
+    while (pNode) {
+        pNode->m_bHitBoundsValid = false;
+        pNode = pNode->m_pParent;
+    }
+}
+
+FRect Node::calcHitBounds()
+{
+    // Plain nodes never react to the mouse.
+    return getEmptyHitBounds();
+}
+
+FRect Node::getEmptyHitBounds()
+{
+    return FRect(0, 0, -1, -1);
+}
+
+bool Node::isEmptyHitBounds(const FRect& bounds)
+{
+    return bounds.br.x < bounds.tl.x;
+}
+
+void Node::setCanvasDirty()
+{
+    CanvasPtr pCanvas = m_pCanvas.lock();
+    if (pCanvas) {
+        pCanvas->setDirty();
+    }
+}
+
 void Node::connectOneEventHandler(const EventID& id, PyObject * pObj, 
         PyObject * pFunc)
 {
@@ -83,6 +83,9 @@ class AVG_API Node: public Publisher
         virtual void connect(CanvasPtr pCanvas);
         virtual void disconnect(bool bKill);
         void unlink(bool bKill=false);
+        // Creates an unconnected copy of the node (and its children if bDeep is set).
+        // See NodeTemplate for what is copied.
+        NodePtr clone(bool bDeep=true);
 
         virtual void checkReload() {};
 
@@ -113,6 +116,13 @@ class AVG_API Node: public Publisher
         NodePtr getElementByPos(const glm::vec2& pos);
         virtual void getElementsByPos(const glm::vec2& pos, 
                 std::vector<NodePtr>& pElements);
+        // Cheap test used to cull subtrees during hit-testing. pos is in parent 
+        // coordinates. Returns false only if getElementsByPos(toLocal(pos)) is 
+        // guaranteed to find nothing.
+        bool mayContainHit(const glm::vec2& pos);
+        const FRect& getHitBounds();
+        // Needs to be called whenever the area a node reacts to changes.
+        void invalidateHitBounds();
 
         virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
                 float parentEffectiveOpacity);
@@ -142,6 +152,15 @@ class AVG_API Node: public Publisher
         virtual bool isVisible() const;
         bool getEffectiveActive() const;
         NodePtr getSharedThis();
+        // Tells the canvas that the rendered image changed.
+        void setCanvasDirty();
+
+        // Hit bounds are axis-aligned bounding boxes of everything in the subtree 
+        // that reacts to the mouse, in parent coordinates. They are recalculated 
+        // lazily.
+        virtual FRect calcHitBounds();
+        static FRect getEmptyHitBounds();
+        static bool isEmptyHitBounds(const FRect& bounds);
 
     private:
         std::string m_ID;
@@ -186,6 +205,9 @@ class AVG_API Node: public Publisher
         bool m_bSensitive;
         float m_EffectiveOpacity;
         bool m_bEffectiveActive;
+
+        FRect m_HitBounds;
+        bool m_bHitBoundsValid;
 };
 
 }
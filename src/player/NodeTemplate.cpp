@@ -0,0 +1,125 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "NodeTemplate.h"
+
+#include "Node.h"
+#include "DivNode.h"
+#include "TypeDefinition.h"
+
+#include "../base/Exception.h"
+#include "../base/StringHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+static const TypeDefinition* getNodeDefinition(const NodePtr& pNode)
+{
+    if (!pNode) {
+        throw Exception(AVG_ERR_NO_NODE, "NodeTemplate created without a node.");
+    }
+    return pNode->getDefinition();
+}
+
+NodeTemplate::NodeTemplate(const NodePtr& pNode, bool bDeep)
+    : m_pDefinition(getNodeDefinition(pNode)),
+      m_Args(m_pDefinition->getDefaultArgs())
+{
+    m_Args.getMembers(pNode.get());
+    // Ids need to be unique.
+    m_Args.setArgVal<string>("id", "");
+    if (bDeep) {
+        DivNodePtr pDivNode = boost::dynamic_pointer_cast<DivNode>(pNode);
+        if (pDivNode) {
+            for (unsigned i = 0; i < pDivNode->getNumChildren(); ++i) {
+                m_pChildren.push_back(NodeTemplatePtr(
+                        new NodeTemplate(pDivNode->getChild(i), true)));
+            }
+        }
+    }
+}
+
+NodeTemplate::~NodeTemplate()
+{
+}
+
+NodePtr NodeTemplate::instantiate(const DivNodePtr& pParent) const
+{
+    NodePtr pNode = createNode();
+    if (pParent) {
+        pParent->appendChild(pNode);
+    }
+    return pNode;
+}
+
+vector<NodePtr> NodeTemplate::instantiateMany(int numNodes, const DivNodePtr& pParent)
+        const
+{
+    if (numNodes < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "NodeTemplate::instantiateMany: Number of nodes must not be negative ("
+                +toString(numNodes)+").");
+    }
+    vector<NodePtr> pNodes;
+    pNodes.reserve(numNodes);
+    for (int i = 0; i < numNodes; ++i) {
+        pNodes.push_back(createNode());
+    }
+    if (pParent) {
+        pParent->appendChildren(pNodes);
+    }
+    return pNodes;
+}
+
+const string& NodeTemplate::getTypeStr() const
+{
+    return m_pDefinition->getName();
+}
+
+int NodeTemplate::getNumNodes() const
+{
+    int numNodes = 1;
+    for (unsigned i = 0; i < m_pChildren.size(); ++i) {
+        numNodes += m_pChildren[i]->getNumNodes();
+    }
+    return numNodes;
+}
+
+NodePtr NodeTemplate::createNode() const
+{
+    ObjectBuilder builder = m_pDefinition->getBuilder();
+    NodePtr pNode = boost::dynamic_pointer_cast<Node>(builder(m_Args));
+    pNode->setTypeInfo(m_pDefinition);
+    if (!m_pChildren.empty()) {
+        DivNodePtr pDivNode = boost::dynamic_pointer_cast<DivNode>(pNode);
+        vector<NodePtr> pChildren;
+        pChildren.reserve(m_pChildren.size());
+        for (unsigned i = 0; i < m_pChildren.size(); ++i) {
+            pChildren.push_back(m_pChildren[i]->createNode());
+        }
+        pDivNode->appendChildren(pChildren);
+    }
+    return pNode;
+}
+
+}
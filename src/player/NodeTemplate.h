@@ -0,0 +1,72 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _NodeTemplate_H_
+#define _NodeTemplate_H_
+
+#include "../api.h"
+
+#include "ArgList.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class Node;
+typedef boost::shared_ptr<Node> NodePtr;
+class DivNode;
+typedef boost::shared_ptr<DivNode> DivNodePtr;
+class TypeDefinition;
+
+class NodeTemplate;
+typedef boost::shared_ptr<NodeTemplate> NodeTemplatePtr;
+
+// Snapshot of the typed attributes of a node and (if bDeep is set) its subtree.
+// Instantiating it builds the nodes directly from the stored arguments, without 
+// parsing xml or converting python values. Node ids, event handlers, python
+// subclasses and state that isn't an attribute aren't part of the snapshot.
+class AVG_API NodeTemplate
+{
+public:
+    NodeTemplate(const NodePtr& pNode, bool bDeep=true);
+    virtual ~NodeTemplate();
+
+    NodePtr instantiate(const DivNodePtr& pParent=DivNodePtr()) const;
+    std::vector<NodePtr> instantiateMany(int numNodes, 
+            const DivNodePtr& pParent=DivNodePtr()) const;
+
+    const std::string& getTypeStr() const;
+    int getNumNodes() const;
+
+private:
+    NodePtr createNode() const;
+
+    const TypeDefinition* m_pDefinition;
+    ArgList m_Args;
+    std::vector<NodeTemplatePtr> m_pChildren;
+};
+
+}
+
+#endif
@@ -30,6 +30,7 @@
 #include "../graphics/GLContext.h"
 #include "../graphics/GLTexture.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -51,7 +52,8 @@ OGLSurface::OGLSurface()
       m_Brightness(1,1,1),
       m_Contrast(1,1,1),
       m_AlphaGamma(1),
-      m_bIsDirty(true)
+      m_bIsDirty(true),
+      m_Version(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -71,6 +73,7 @@ void OGLSurface::create(PixelFormat pf, GLTexturePtr pTex0, GLTexturePtr pTex1,
     m_pTextures[2] = pTex2;
     m_pTextures[3] = pTex3;
     m_bIsDirty = true;
+    m_Version++;
 
     // Make sure pixel format and number of textures line up.
     if (pixelFormatIsPlanar(pf)) {
@@ -89,6 +92,7 @@ void OGLSurface::setMask(GLTexturePtr pTex)
 {
     m_pMaskTexture = pTex;
     m_bIsDirty = true;
+    m_Version++;
 }
 
 void OGLSurface::destroy()
@@ -97,6 +101,7 @@ void OGLSurface::destroy()
     m_pTextures[1] = GLTexturePtr();
     m_pTextures[2] = GLTexturePtr();
     m_pTextures[3] = GLTexturePtr();
+    m_Version++;
 }
 
 void OGLSurface::activate(const IntPoint& logicalSize, bool bPremultipliedAlpha) const
@@ -175,6 +180,7 @@ void OGLSurface::setMaskCoords(glm::vec2 maskPos, glm::vec2 maskSize)
     m_MaskPos = maskPos;
     m_MaskSize = maskSize;
     m_bIsDirty = true;
+    m_Version++;
 }
 
 PixelFormat OGLSurface::getPixelFormat()
@@ -204,12 +210,14 @@ void OGLSurface::setColorParams(const glm::vec3& gamma, const glm::vec3& brightn
     m_Brightness = brightness;
     m_Contrast = contrast;
     m_bIsDirty = true;
+    m_Version++;
 }
 
 void OGLSurface::setAlphaGamma(float gamma)
 {
     m_AlphaGamma = gamma;
     m_bIsDirty = true;
+    m_Version++;
 }
 
 bool OGLSurface::isDirty() const
@@ -223,6 +231,25 @@ bool OGLSurface::isDirty() const
     return bIsDirty;
 }
 
+unsigned OGLSurface::getVersion() const
+{
+    return m_Version;
+}
+
+unsigned OGLSurface::getContentVersion() const
+{
+    unsigned version = 0;
+    if (isCreated()) {
+        for (unsigned i=0; i<getNumPixelFormatPlanes(m_pf); ++i) {
+            version = std::max(version, m_pTextures[i]->getContentVersion());
+        }
+    }
+    if (m_pMaskTexture) {
+        version = std::max(version, m_pMaskTexture->getContentVersion());
+    }
+    return version;
+}
+
 void OGLSurface::resetDirty()
 {
     m_bIsDirty = false;
@@ -231,6 +258,25 @@ void OGLSurface::resetDirty()
     }
 }
 
+bool OGLSurface::isBatchCompatible(const OGLSurface& other) const
+{
+    // Two surfaces are compatible if activating either one results in the same
+    // shader and texture state.
+    if (m_pMaskTexture || other.m_pMaskTexture) {
+        return false;
+    }
+    if (m_pf != other.m_pf) {
+        return false;
+    }
+    for (unsigned i=0; i<4; ++i) {
+        if (m_pTextures[i] != other.m_pTextures[i]) {
+            return false;
+        }
+    }
+    return (m_Gamma == other.m_Gamma && m_Brightness == other.m_Brightness &&
+            m_Contrast == other.m_Contrast && m_AlphaGamma == other.m_AlphaGamma);
+}
+
 glm::mat4 OGLSurface::calcColorspaceMatrix() const
 {
     glm::mat4 mat;
@@ -66,6 +66,12 @@ public:
 
     bool isDirty() const;
     void resetDirty();
+    // getVersion() changes whenever textures are replaced or shading parameters
+    // change, getContentVersion() whenever the texture contents change.
+    unsigned getVersion() const;
+    unsigned getContentVersion() const;
+
+    bool isBatchCompatible(const OGLSurface& other) const;
 
 private:
     glm::mat4 calcColorspaceMatrix() const;
@@ -84,6 +90,7 @@ private:
     float m_AlphaGamma;
 
     bool m_bIsDirty;
+    unsigned m_Version;
 
 };
 
@@ -42,6 +42,8 @@ namespace avg {
 OffscreenCanvas::OffscreenCanvas(Player * pPlayer)
     : Canvas(pPlayer),
       m_bIsRendered(false),
+      m_NumRenderedFrames(0),
+      m_NumSkippedFrames(0),
       m_pCameraNodeRef(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
@@ -75,6 +77,8 @@ void OffscreenCanvas::initPlayback()
             true, m_bUseMipmaps));
     Canvas::initPlayback(getMultiSampleSamples());
     m_bIsRendered = false;
+    m_NumRenderedFrames = 0;
+    m_NumSkippedFrames = 0;
 }
 
 void OffscreenCanvas::stopPlayback(bool bIsAbort)
@@ -130,10 +134,21 @@ void OffscreenCanvas::setAutoRender(bool bAutoRender)
 void OffscreenCanvas::manualRender()
 {
     emitPreRenderSignal(); 
+    setDirty();
     renderTree(); 
     emitFrameEndSignal(); 
 }
 
+int OffscreenCanvas::getNumRenderedFrames() const
+{
+    return m_NumRenderedFrames;
+}
+
+int OffscreenCanvas::getNumSkippedFrames() const
+{
+    return m_NumSkippedFrames;
+}
+
 std::string OffscreenCanvas::getID() const
 {
     return getRootNode()->getID();
@@ -258,7 +273,14 @@ void OffscreenCanvas::renderTree()
         throw(Exception(AVG_ERR_UNSUPPORTED, 
                 "OffscreenCanvas::renderTree(): Player.play() needs to be called before rendering offscreen canvases."));
     }
+    // preRender() runs every frame so videos, cameras and text keep updating. Nodes
+    // mark the canvas dirty if anything they contribute to the image changed.
     preRender();
+    if (m_bIsRendered && !isDirty()) {
+        m_NumSkippedFrames++;
+        return;
+    }
+    resetDirty();
     m_pFBO->activate();
     {
         ScopeTimer Timer(OffscreenRenderProfilingZone);
@@ -266,6 +288,10 @@ void OffscreenCanvas::renderTree()
     }
     m_pFBO->copyToDestTexture();
     m_bIsRendered = true;
+    m_NumRenderedFrames++;
+    for (unsigned i = 0; i < m_pDependentCanvases.size(); ++i) {
+        m_pDependentCanvases[i]->setDirty();
+    }
 }
 
 }
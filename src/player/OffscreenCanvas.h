@@ -51,6 +51,8 @@ class AVG_API OffscreenCanvas: public Canvas
         bool getAutoRender() const;
         void setAutoRender(bool bAutoRender);
         void manualRender(); // This is the render that can be called from python.
+        int getNumRenderedFrames() const;
+        int getNumSkippedFrames() const;
 
         std::string getID() const;
         bool isRunning() const;
@@ -81,6 +83,8 @@ class AVG_API OffscreenCanvas: public Canvas
         std::vector<CanvasPtr> m_pDependentCanvases;
 
         bool m_bIsRendered;
+        int m_NumRenderedFrames;
+        int m_NumSkippedFrames;
         CameraNode* m_pCameraNodeRef;
 };
 
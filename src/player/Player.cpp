@@ -60,6 +60,9 @@
 #include "EventDispatcher.h"
 #include "PublisherDefinition.h"
 #include "BitmapManager.h"
+#include "ImageCache.h"
+#include "GlyphCache.h"
+#include "TextRenderManager.h"
 
 #include "../base/FileHelper.h"
 #include "../base/StringHelper.h"
@@ -69,6 +72,7 @@
 #include "../base/ConfigMgr.h"
 #include "../base/XMLHelper.h"
 #include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
 #include "../base/WorkerThread.h"
 #include "../base/DAG.h"
 
@@ -103,6 +107,9 @@ namespace avg {
 
 Player * Player::s_pPlayer=0;
 
+// Number of frames kept for getFrameStats().
+static const unsigned NUM_FRAME_STATS = 1800;
+
 Player::Player()
     : Publisher("Player"),
       m_pDisplayEngine(),
@@ -114,9 +121,13 @@ Player::Player()
       m_bKeepWindowOpen(false),
       m_bStopOnEscape(true),
       m_bIsPlaying(false),
+      m_bBatchRendering(false),
       m_bFakeFPS(false),
       m_FakeFPS(0),
       m_FrameTime(0),
+      m_FrameStats(NUM_FRAME_STATS),
+      m_TexUploadMaxBytes(0),
+      m_TexUploadMaxTime(0),
       m_Volume(1),
       m_bPythonAvailable(true),
       m_pLastMouseEvent(new MouseEvent(Event::CURSOR_MOTION, false, false, false, 
@@ -293,6 +304,16 @@ void Player::enableGLErrorChecks(bool bEnable)
 {
     GLContext::enableErrorChecks(bEnable);
 }
+
+void Player::setBatchRendering(bool bBatchRendering)
+{
+    m_bBatchRendering = bBatchRendering;
+}
+
+bool Player::isBatchRendering() const
+{
+    return m_bBatchRendering;
+}
         
 glm::vec2 Player::getScreenResolution()
 {
@@ -549,6 +570,7 @@ void Player::initPlayback(const std::string& sShaderPath)
 
     m_FrameTime = 0;
     m_NumFrames = 0;
+    m_FrameStats.clear();
 }
 
 bool Player::isPlaying()
@@ -639,6 +661,46 @@ float Player::getFrameDuration()
     }
 }
 
+FrameStatsSummary Player::getFrameStats() const
+{
+    return m_FrameStats.getSummary();
+}
+
+void Player::dumpFrameStats(const string& sFilename) const
+{
+    m_FrameStats.dumpCSV(sFilename);
+}
+
+void Player::setTextureUploadBudget(long long maxBytes, float maxTime)
+{
+    if (maxBytes < 0 || maxTime < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Player.setTextureUploadBudget: Budget must not be negative.");
+    }
+    m_TexUploadMaxBytes = maxBytes;
+    m_TexUploadMaxTime = maxTime;
+}
+
+TextureUploadStats Player::getTextureUploadStats() const
+{
+    GLContext* pContext = GLContext::getMain();
+    if (pContext) {
+        return pContext->getTextureUploadQueue().getStats();
+    } else {
+        return TextureUploadStats();
+    }
+}
+
+int Player::getDrawCallCount() const
+{
+    GLContext* pContext = GLContext::getMain();
+    if (pContext) {
+        return pContext->getDrawCallCount();
+    } else {
+        return 0;
+    }
+}
+
 TrackerInputDevice * Player::getTracker()
 {
     TrackerInputDevice* pTracker = dynamic_cast<TrackerInputDevice*>(
@@ -1067,8 +1129,13 @@ static ProfilingZoneID OffscreenProfilingZone("Offscreen rendering");
 
 void Player::doFrame(bool bFirstFrame)
 {
+    TimeSource* pTimeSource = TimeSource::get();
+    long long startTime = pTimeSource->getCurrentMicrosecs();
     {
         ScopeTimer Timer(MainProfilingZone);
+        TextureUploadQueue& uploadQueue = GLContext::getMain()->getTextureUploadQueue();
+        uploadQueue.setBudget(m_TexUploadMaxBytes, m_TexUploadMaxTime);
+        uploadQueue.startFrame();
         if (!bFirstFrame) {
             m_NumFrames++;
             if (m_bFakeFPS) {
@@ -1080,21 +1147,33 @@ void Player::doFrame(bool bFirstFrame)
                 ScopeTimer Timer(TimersProfilingZone);
                 handleTimers();
             }
+            long long timersEndTime = pTimeSource->getCurrentMicrosecs();
             {
                 ScopeTimer Timer(EventsProfilingZone);
                 m_pEventDispatcher->dispatch();
                 sendFakeEvents();
                 removeDeadEventCaptures();
             }
+            long long eventsEndTime = pTimeSource->getCurrentMicrosecs();
+            m_CurFrameRecord.m_Durations[FrameStats::TIMERS] = timersEndTime-startTime;
+            m_CurFrameRecord.m_Durations[FrameStats::EVENTS] =
+                    eventsEndTime-timersEndTime;
         }
+        long long offscreenStartTime = pTimeSource->getCurrentMicrosecs();
         for (unsigned i = 0; i < m_pCanvases.size(); ++i) {
             ScopeTimer Timer(OffscreenProfilingZone);
             dispatchOffscreenRendering(m_pCanvases[i].get());
         }
+        long long renderStartTime = pTimeSource->getCurrentMicrosecs();
         {
             ScopeTimer Timer(MainCanvasProfilingZone);
             m_pMainCanvas->doFrame(m_bPythonAvailable);
         }
+        long long renderEndTime = pTimeSource->getCurrentMicrosecs();
+        m_CurFrameRecord.m_Durations[FrameStats::OFFSCREEN] =
+                renderStartTime-offscreenStartTime;
+        m_CurFrameRecord.m_Durations[FrameStats::RENDER] =
+                renderEndTime-renderStartTime;
         GLContext::mandatoryCheckError("End of frame");
         if (m_bPythonAvailable) {
             Py_BEGIN_ALLOW_THREADS;
@@ -1109,6 +1188,12 @@ void Player::doFrame(bool bFirstFrame)
             endFrame();
         }
     }
+    if (!bFirstFrame) {
+        m_CurFrameRecord.m_FrameTime = m_FrameTime;
+        m_CurFrameRecord.m_Durations[FrameStats::FRAME] =
+                pTimeSource->getCurrentMicrosecs()-startTime;
+        m_FrameStats.addFrame(m_CurFrameRecord);
+    }
     ThreadProfiler::get()->reset();
     if (m_NumFrames == 5) {
         ThreadProfiler::get()->restart();
@@ -1117,9 +1202,16 @@ void Player::doFrame(bool bFirstFrame)
 
 void Player::endFrame()
 {
+    TimeSource* pTimeSource = TimeSource::get();
+    long long waitStartTime = pTimeSource->getCurrentMicrosecs();
     m_pDisplayEngine->frameWait();
+    long long swapStartTime = pTimeSource->getCurrentMicrosecs();
     m_pDisplayEngine->swapBuffers();
+    long long swapEndTime = pTimeSource->getCurrentMicrosecs();
     m_pDisplayEngine->checkJitter();
+    m_CurFrameRecord.m_Durations[FrameStats::WAIT] = swapStartTime-waitStartTime;
+    m_CurFrameRecord.m_Durations[FrameStats::SWAP] = swapEndTime-swapStartTime;
+    m_CurFrameRecord.m_bLate = m_pDisplayEngine->wasFrameLate();
 }
 
 float Player::getFramerate()
@@ -1198,6 +1290,7 @@ void Player::initConfig()
     m_GLConfig.m_bUsePOTTextures = pMgr->getBoolOption("scr", "usepow2textures", false);
 
     m_GLConfig.m_bUsePixelBuffers = pMgr->getBoolOption("scr", "usepixelbuffers", true);
+    m_bBatchRendering = pMgr->getBoolOption("scr", "batchrendering", false);
     int multiSampleSamples = pMgr->getIntOption("scr", "multisamplesamples", 8);
     if (multiSampleSamples < 1) {
         AVG_LOG_ERROR("multisamplesamples must be >= 1. Aborting")
@@ -1290,7 +1383,7 @@ void Player::initMainCanvas(NodePtr pRootNode)
 NodePtr Player::internalLoad(const string& sAVG, const string& sFilename)
 {
     XMLParser parser;
-    parser.setDTD(TypeRegistry::get()->getDTD(), "avg.dtd");
+    parser.setDTD(TypeRegistry::get()->getParsedDTD(), "avg.dtd");
     parser.parse(sAVG, sFilename);
     xmlNodePtr xmlNode = parser.getRootNode();
     NodePtr pNode = createNodeFromXml(parser.getDoc(), xmlNode);
@@ -1354,7 +1447,7 @@ NodePtr Player::createNodeFromXmlString(const string& sXML)
     xmlDoValidityCheckingDefaultValue =0;
 
     XMLParser parser;
-    parser.setDTD(TypeRegistry::get()->getDTD(), "avg.dtd");
+    parser.setDTD(TypeRegistry::get()->getParsedDTD(), "avg.dtd");
     parser.parse(sXML, "");
 
 //        cvp->error = xmlParserValidityError;
@@ -1720,6 +1813,9 @@ void Player::cleanup(bool bIsAbort)
     if (m_pMainCanvas) {
         unregisterFrameEndListener(BitmapManager::get());
         delete BitmapManager::get();
+        if (TextRenderManager::exists()) {
+            delete TextRenderManager::get();
+        }
         m_pMainCanvas->stopPlayback(bIsAbort);
         m_pMainCanvas = MainCanvasPtr();
     }
@@ -1731,6 +1827,8 @@ void Player::cleanup(bool bIsAbort)
         m_pCanvases[i]->stopPlayback(bIsAbort);
     }
     m_pCanvases.clear();
+    ImageCache::get()->releaseTextures();
+    GlyphCache::get()->releaseTextures();
 
     if (m_pDisplayEngine) {
         m_DP.m_WindowSize = IntPoint(0,0);
@@ -32,7 +32,9 @@
 #include "BoostPython.h"
 
 #include "../audio/AudioParams.h"
+#include "../base/FrameStats.h"
 #include "../graphics/GLConfig.h"
+#include "../graphics/TextureUploadQueue.h"
 
 #include <libxml/parser.h>
 #include <boost/shared_ptr.hpp>
@@ -94,6 +96,8 @@ class AVG_API Player: public Publisher
         void setMultiSampleSamples(int multiSampleSamples);
         void setAudioOptions(int samplerate, int channels);
         void enableGLErrorChecks(bool bEnable);
+        void setBatchRendering(bool bBatchRendering);
+        bool isBatchRendering() const;
         glm::vec2 getScreenResolution();
         float getPixelsPerMM();
         glm::vec2 getPhysicalScreenDimensions();
@@ -124,6 +128,11 @@ class AVG_API Player: public Publisher
         void setFakeFPS(float fps);
         long long getFrameTime();
         float getFrameDuration();
+        FrameStatsSummary getFrameStats() const;
+        void dumpFrameStats(const std::string& sFilename) const;
+        void setTextureUploadBudget(long long maxBytes, float maxTime);
+        TextureUploadStats getTextureUploadStats() const;
+        int getDrawCallCount() const;
 
         NodePtr createNode(const std::string& sType, const py::dict& PyDict,
                 const py::object& self=py::object());
@@ -257,6 +266,7 @@ class AVG_API Player: public Publisher
         bool m_bKeepWindowOpen;
         bool m_bStopOnEscape;
         bool m_bIsPlaying;
+        bool m_bBatchRendering;
 
         // Time calculation
         bool m_bFakeFPS;
@@ -264,6 +274,10 @@ class AVG_API Player: public Publisher
         long long m_FrameTime;
         long long m_PlayStartTime;
         long long m_NumFrames;
+        FrameStats m_FrameStats;
+        long long m_TexUploadMaxBytes;
+        float m_TexUploadMaxTime;
+        FrameStats::Record m_CurFrameRecord;
 
         float m_Volume;
 
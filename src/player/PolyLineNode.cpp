@@ -63,6 +63,12 @@ PolyLineNode::~PolyLineNode()
 {
 }
 
+void PolyLineNode::getArgs(ArgList& args) const
+{
+    VectorNode::getArgs(args);
+    args.setArgVal<string>("linejoin", getLineJoin());
+}
+
 const vector<glm::vec2>& PolyLineNode::getPos() const 
 {
     return m_Pts;
@@ -39,6 +39,7 @@ class AVG_API PolyLineNode : public VectorNode
         
         PolyLineNode(const ArgList& args);
         virtual ~PolyLineNode();
+        virtual void getArgs(ArgList& args) const;
 
         const std::vector<glm::vec2>& getPos() const;
         void setPos(const std::vector<glm::vec2>& pts);
@@ -81,6 +81,12 @@ PolygonNode::~PolygonNode()
 {
 }
 
+void PolygonNode::getArgs(ArgList& args) const
+{
+    FilledVectorNode::getArgs(args);
+    args.setArgVal<string>("linejoin", getLineJoin());
+}
+
 const vector<glm::vec2>& PolygonNode::getPos() const 
 {
     return m_Pts;
@@ -136,6 +142,18 @@ void PolygonNode::setLineJoin(const string& s)
     setDrawNeeded();
 }
 
+FRect PolygonNode::calcHitBounds()
+{
+    if (!reactsToMouseEvents() || m_Pts.empty()) {
+        return getEmptyHitBounds();
+    }
+    FRect bounds(m_Pts[0], m_Pts[0]);
+    for (unsigned i = 1; i < m_Pts.size(); ++i) {
+        bounds.expand(FRect(m_Pts[i], m_Pts[i]));
+    }
+    return bounds;
+}
+
 void PolygonNode::getElementsByPos(const glm::vec2& pos, vector<NodePtr>& pElements)
 {
     if (reactsToMouseEvents() && pointInPolygon(pos, m_Pts)) {
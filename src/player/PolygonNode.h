@@ -41,6 +41,7 @@ class AVG_API PolygonNode : public FilledVectorNode
         
         PolygonNode(const ArgList& args);
         virtual ~PolygonNode();
+        virtual void getArgs(ArgList& args) const;
 
         const std::vector<glm::vec2>& getPos() const;
         void setPos(const std::vector<glm::vec2>& pts);
@@ -59,6 +60,9 @@ class AVG_API PolygonNode : public FilledVectorNode
         virtual void calcVertexes(const VertexDataPtr& pVertexData, Pixel32 color);
         virtual void calcFillVertexes(const VertexDataPtr& pVertexData, Pixel32 color);
 
+    protected:
+        virtual FRect calcHitBounds();
+
     private:
         std::vector<glm::vec2> m_Pts;
         std::vector<float> m_CumulDist;
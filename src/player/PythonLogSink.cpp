@@ -38,6 +38,8 @@ PythonLogSink::PythonLogSink(PyObject *pyLogger):
 
 PythonLogSink::~PythonLogSink()
 {
+    // The last reference to a removed sink may be dropped by the log thread.
+    aquirePyGIL aquireGil;
     Py_DecRef(m_pyLogger);
 }
 
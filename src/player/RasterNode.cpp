@@ -24,6 +24,8 @@
 #include "TypeDefinition.h"
 #include "OGLSurface.h"
 #include "FXNode.h"
+#include "Canvas.h"
+#include "RenderBatcher.h"
 
 #include "../graphics/ImagingProjection.h"
 #include "../graphics/ShaderRegistry.h"
@@ -67,6 +69,9 @@ RasterNode::RasterNode()
     : m_pSurface(0),
       m_Material(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, false),
       m_TileSize(-1,-1),
+      m_bBatched(false),
+      m_LastSurfaceVersion(0),
+      m_LastSurfaceContentVersion(0),
       m_bFXDirty(true)
 {
 }
@@ -93,6 +98,12 @@ void RasterNode::setArgs(const ArgList& args)
     m_pSurface = new OGLSurface();
 }
 
+void RasterNode::getArgs(ArgList& args) const
+{
+    AreaNode::getArgs(args);
+    args.setArgVal<bool>("mipmap", getMipmap());
+}
+
 void RasterNode::connectDisplay()
 {
     AreaNode::connectDisplay();
@@ -196,6 +207,7 @@ void RasterNode::setWarpedVertexCoords(const VertexGrid& grid)
                 "setWarpedVertexCoords() called with incorrect grid size.");
     }
     m_TileVertices = grid;
+    setCanvasDirty();
 }
 
 int RasterNode::getMaxTileWidth() const
@@ -229,6 +241,7 @@ void RasterNode::setBlendModeStr(const string& sBlendMode)
     }
     m_sBlendMode = sBlendMode;
     m_BlendMode = blendMode;
+    setCanvasDirty();
 }
 
 const UTF8String& RasterNode::getMaskHRef() const
@@ -327,19 +340,62 @@ void RasterNode::setEffect(FXNodePtr pFXNode)
 
 void RasterNode::calcVertexArray(const VertexArrayPtr& pVA, const Pixel32& color)
 {
+    m_bBatched = false;
+    unsigned surfaceVersion = m_pSurface->getVersion();
+    unsigned surfaceContentVersion = m_pSurface->getContentVersion();
+    if (surfaceVersion != m_LastSurfaceVersion ||
+            surfaceContentVersion != m_LastSurfaceContentVersion || 
+            color != m_LastColor)
+    {
+        if (surfaceVersion != m_LastSurfaceVersion) {
+            // Textures can be replaced asynchronously, e.g. when an upload finishes.
+            newSurface();
+        }
+        m_LastSurfaceVersion = surfaceVersion;
+        m_LastSurfaceContentVersion = surfaceContentVersion;
+        m_LastColor = color;
+        setCanvasDirty();
+    }
     if (isVisible() && m_pSurface->isCreated()) {
+        m_bBatched = supportsBatching() && !m_pFXNode && !hasMask() && 
+                getCanvas()->isBatchRendering();
         pVA->startSubVA(m_SubVA);
-        for (unsigned y = 0; y < m_TileVertices.size()-1; y++) {
-            for (unsigned x = 0; x < m_TileVertices[0].size()-1; x++) {
-                int curVertex = m_SubVA.getNumVerts();
-                m_SubVA.appendPos(m_TileVertices[y][x], m_TexCoords[y][x], color); 
-                m_SubVA.appendPos(m_TileVertices[y][x+1], m_TexCoords[y][x+1], color); 
-                m_SubVA.appendPos(m_TileVertices[y+1][x+1], m_TexCoords[y+1][x+1], color);
-                m_SubVA.appendPos(m_TileVertices[y+1][x], m_TexCoords[y+1][x], color); 
-                m_SubVA.appendQuadIndexes(
-                        curVertex+1, curVertex, curVertex+2, curVertex+3);
+        appendVertexes(m_bBatched, color);
+    }
+}
+
+void RasterNode::appendVertexes(bool bBatched, const Pixel32& color)
+{
+    if (bBatched) {
+        // Vertices are stored in parent coordinates so all siblings can be 
+        // rendered using the same transform.
+        glm::vec2 size = getSize();
+        glm::mat4 transform = glm::scale(getLocalTransform(), 
+                glm::vec3(size.x, size.y, 1));
+        VertexGrid grid = m_TileVertices;
+        for (unsigned y = 0; y < grid.size(); y++) {
+            for (unsigned x = 0; x < grid[y].size(); x++) {
+                glm::vec4 pt = transform*glm::vec4(grid[y][x], 0, 1);
+                grid[y][x] = glm::vec2(pt.x, pt.y);
             }
         }
+        appendTiles(grid, color);
+    } else {
+        appendTiles(m_TileVertices, color);
+    }
+}
+
+void RasterNode::appendTiles(const VertexGrid& grid, const Pixel32& color)
+{
+    for (unsigned y = 0; y < grid.size()-1; y++) {
+        for (unsigned x = 0; x < grid[0].size()-1; x++) {
+            int curVertex = m_SubVA.getNumVerts();
+            m_SubVA.appendPos(grid[y][x], m_TexCoords[y][x], color); 
+            m_SubVA.appendPos(grid[y][x+1], m_TexCoords[y][x+1], color); 
+            m_SubVA.appendPos(grid[y+1][x+1], m_TexCoords[y+1][x+1], color);
+            m_SubVA.appendPos(grid[y+1][x], m_TexCoords[y+1][x], color); 
+            m_SubVA.appendQuadIndexes(curVertex+1, curVertex, curVertex+2, curVertex+3);
+        }
     }
 }
 
@@ -376,6 +432,16 @@ bool RasterNode::hasMask() const
     return m_sMaskFilename != "";
 }
 
+bool RasterNode::hasEffect() const
+{
+    return m_pFXNode != FXNodePtr();
+}
+
+SubVertexArray& RasterNode::getSubVA()
+{
+    return m_SubVA;
+}
+
 void RasterNode::setMaskCoords()
 {
     if (m_sMaskFilename != "") {
@@ -446,6 +512,7 @@ void RasterNode::renderFX(const glm::vec2& destSize, const Pixel32& color,
         m_bFXDirty = false;
         m_pSurface->resetDirty();
         m_pFXNode->resetDirty();
+        setCanvasDirty();
     }
 }
 
@@ -495,6 +562,16 @@ void RasterNode::blt(const glm::mat4& transform, const glm::vec2& destSize,
         GLContext::BlendMode mode, float opacity, const Pixel32& color,
         bool bPremultipliedAlpha)
 {
+    RenderBatcher* pBatcher = getCanvas()->getRenderBatcher();
+    if (m_bBatched) {
+        AVG_ASSERT(pBatcher);
+        pBatcher->addDraw(getParentTransform(), m_pSurface, mode, bPremultipliedAlpha,
+                opacity, m_SubVA);
+        return;
+    }
+    if (pBatcher) {
+        pBatcher->flush();
+    }
     GLContext* pContext = GLContext::getMain();
     FRect destRect;
     
@@ -528,6 +605,11 @@ void RasterNode::blt(const glm::mat4& transform, const glm::vec2& destSize,
     m_SubVA.draw();
 }
 
+bool RasterNode::supportsBatching() const
+{
+    return false;
+}
+
 IntPoint RasterNode::getNumTiles()
 {
     IntPoint size = m_pSurface->getSize();
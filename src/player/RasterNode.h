@@ -56,6 +56,7 @@ class AVG_API RasterNode: public AreaNode
         virtual ~RasterNode ();
         virtual void connectDisplay();
         virtual void setArgs(const ArgList& args);
+        virtual void getArgs(ArgList& args) const;
         virtual void disconnect(bool bKill);
         virtual void checkReload();
 
@@ -102,9 +103,14 @@ class AVG_API RasterNode: public AreaNode
         void blta8(const glm::mat4& transform, const glm::vec2& destSize, float opacity, 
                 const Pixel32& color, GLContext::BlendMode mode);
 
+        virtual bool supportsBatching() const;
+        virtual void appendVertexes(bool bBatched, const Pixel32& color);
+        SubVertexArray& getSubVA();
+
         virtual OGLSurface * getSurface();
         const MaterialInfo& getMaterial() const;
         bool hasMask() const;
+        bool hasEffect() const;
         void setMaskCoords();
         void renderFX(const glm::vec2& destSize, const Pixel32& color, 
                 bool bPremultipliedAlpha, bool bForceRender=false);
@@ -121,6 +127,7 @@ class AVG_API RasterNode: public AreaNode
                 GLContext::BlendMode mode, float opacity, const Pixel32& color,
                 bool bPremultipliedAlpha);
 
+        void appendTiles(const VertexGrid& grid, const Pixel32& color);
         IntPoint getNumTiles();
         void calcVertexGrid(VertexGrid& grid);
         void calcTileVertex(int x, int y, glm::vec2& Vertex);
@@ -142,8 +149,14 @@ class AVG_API RasterNode: public AreaNode
         IntPoint m_TileSize;
         VertexGrid m_TileVertices;
         SubVertexArray m_SubVA;
+        bool m_bBatched;
         std::vector<std::vector<glm::vec2> > m_TexCoords;
 
+        // Used to detect changes that require offscreen canvases to be re-rendered.
+        unsigned m_LastSurfaceVersion;
+        unsigned m_LastSurfaceContentVersion;
+        Pixel32 m_LastColor;
+
         glm::vec3 m_Gamma;
         glm::vec3 m_Intensity;
         glm::vec3 m_Contrast;
@@ -60,6 +60,12 @@ RectNode::~RectNode()
 {
 }
 
+void RectNode::getArgs(ArgList& args) const
+{
+    FilledVectorNode::getArgs(args);
+    args.setArgVal<glm::vec2>("size", getSize());
+}
+
 const glm::vec2& RectNode::getPos() const 
 {
     return m_Rect.tl;
@@ -128,6 +134,22 @@ glm::vec2 RectNode::toGlobal(const glm::vec2& localPos) const
     return globalPos + m_Rect.tl;
 }
 
+FRect RectNode::calcHitBounds()
+{
+    if (!reactsToMouseEvents()) {
+        return getEmptyHitBounds();
+    }
+    if (m_Angle == 0) {
+        return m_Rect;
+    } else {
+        // The rectangle rotates around its center, so it always stays inside the
+        // circle through its corners.
+        glm::vec2 center = m_Rect.tl + m_Rect.size()/2.f;
+        float radius = glm::length(m_Rect.size())/2.f;
+        return FRect(center-glm::vec2(radius, radius), center+glm::vec2(radius, radius));
+    }
+}
+
 void RectNode::getElementsByPos(const glm::vec2& pos, vector<NodePtr>& pElements)
 {
     if (pos.x >= 0 && pos.y >= 0 && pos.x < m_Rect.size().x && pos.y < m_Rect.size().y 
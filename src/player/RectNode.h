@@ -36,6 +36,7 @@ class AVG_API RectNode : public FilledVectorNode
         
         RectNode(const ArgList& args);
         virtual ~RectNode();
+        virtual void getArgs(ArgList& args) const;
 
         const glm::vec2& getPos() const;
         void setPos(const glm::vec2& pt);
@@ -56,6 +57,9 @@ class AVG_API RectNode : public FilledVectorNode
         virtual void calcVertexes(const VertexDataPtr& pVertexData, Pixel32 color);
         virtual void calcFillVertexes(const VertexDataPtr& pVertexData, Pixel32 color);
 
+    protected:
+        virtual FRect calcHitBounds();
+
     private:
         FRect m_Rect;
         std::vector<float> m_TexCoords;
@@ -0,0 +1,120 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "RenderBatcher.h"
+
+#include "OGLSurface.h"
+
+#include "../base/Exception.h"
+
+#include "../graphics/StandardShader.h"
+#include "../graphics/VertexArray.h"
+#include "../graphics/SubVertexArray.h"
+
+using namespace std;
+
+namespace avg {
+
+RenderBatcher::RenderBatcher()
+    : m_bPending(false),
+      m_pSurface(0),
+      m_pVA(0),
+      m_StartIndex(0),
+      m_NumIndexes(0)
+{
+}
+
+RenderBatcher::~RenderBatcher()
+{
+}
+
+void RenderBatcher::addDraw(const glm::mat4& transform, const OGLSurface* pSurface,
+        GLContext::BlendMode mode, bool bPremultipliedAlpha, float opacity,
+        const SubVertexArray& subVA)
+{
+    if (subVA.getNumIndexes() == 0) {
+        return;
+    }
+    if (m_bPending && canAppend(transform, pSurface, mode, bPremultipliedAlpha, opacity,
+            subVA))
+    {
+        m_NumIndexes += subVA.getNumIndexes();
+    } else {
+        flush();
+        m_bPending = true;
+        m_Transform = transform;
+        m_pSurface = pSurface;
+        m_BlendMode = mode;
+        m_bPremultipliedAlpha = bPremultipliedAlpha;
+        m_Opacity = opacity;
+        m_pVA = subVA.getVertexArray();
+        m_StartIndex = subVA.getStartIndex();
+        m_NumIndexes = subVA.getNumIndexes();
+    }
+}
+
+void RenderBatcher::flush()
+{
+    if (!m_bPending) {
+        return;
+    }
+    GLContext* pContext = GLContext::getMain();
+    StandardShaderPtr pShader = pContext->getStandardShader();
+    pContext->setBlendColor(glm::vec4(1.0f, 1.0f, 1.0f, m_Opacity));
+    pContext->setBlendMode(m_BlendMode, m_bPremultipliedAlpha);
+    pShader->setAlpha(m_Opacity);
+    pShader->setTransform(m_Transform);
+    if (m_pSurface) {
+        m_pSurface->activate(IntPoint(1,1), m_bPremultipliedAlpha);
+    } else {
+        pShader->setUntextured();
+        pShader->activate();
+    }
+    m_pVA->draw(m_StartIndex, m_NumIndexes, 0, 0);
+    m_bPending = false;
+    m_pSurface = 0;
+}
+
+bool RenderBatcher::canAppend(const glm::mat4& transform, const OGLSurface* pSurface,
+        GLContext::BlendMode mode, bool bPremultipliedAlpha, float opacity,
+        const SubVertexArray& subVA) const
+{
+    if (subVA.getVertexArray() != m_pVA || 
+            subVA.getStartIndex() != m_StartIndex+m_NumIndexes)
+    {
+        return false;
+    }
+    if (mode != m_BlendMode || bPremultipliedAlpha != m_bPremultipliedAlpha ||
+            opacity != m_Opacity || transform != m_Transform)
+    {
+        return false;
+    }
+    if (pSurface == m_pSurface) {
+        return true;
+    }
+    if (!pSurface || !m_pSurface) {
+        return false;
+    }
+    return pSurface->isBatchCompatible(*m_pSurface);
+}
+
+}
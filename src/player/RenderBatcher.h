@@ -0,0 +1,76 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _RenderBatcher_H_
+#define _RenderBatcher_H_
+
+#include "../api.h"
+
+#include "../base/GLMHelper.h"
+#include "../graphics/GLContext.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace avg {
+
+class OGLSurface;
+class VertexArray;
+class SubVertexArray;
+
+// Collects consecutive draws that share render state and submits them as one
+// ranged draw from the canvas vertex array. Draws can only be merged if their index
+// ranges are adjacent in the vertex array and their vertices are in the same
+// coordinate system.
+class AVG_API RenderBatcher
+{
+public:
+    RenderBatcher();
+    virtual ~RenderBatcher();
+
+    // pSurface == 0 means untextured.
+    void addDraw(const glm::mat4& transform, const OGLSurface* pSurface,
+            GLContext::BlendMode mode, bool bPremultipliedAlpha, float opacity,
+            const SubVertexArray& subVA);
+    void flush();
+
+private:
+    bool canAppend(const glm::mat4& transform, const OGLSurface* pSurface,
+            GLContext::BlendMode mode, bool bPremultipliedAlpha, float opacity,
+            const SubVertexArray& subVA) const;
+
+    bool m_bPending;
+    glm::mat4 m_Transform;
+    const OGLSurface* m_pSurface;
+    GLContext::BlendMode m_BlendMode;
+    bool m_bPremultipliedAlpha;
+    float m_Opacity;
+
+    VertexArray* m_pVA;
+    unsigned m_StartIndex;
+    unsigned m_NumIndexes;
+};
+
+typedef boost::shared_ptr<RenderBatcher> RenderBatcherPtr;
+
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include "../graphics/OGLShader.h"
 
 #include "OGLSurface.h"
+#include "RenderBatcher.h"
 
 #include <iostream>
 #include <sstream>
@@ -83,7 +84,8 @@ ImagePtr Shape::getImage()
 
 bool Shape::isTextured() const
 {
-    return m_pImage->getSource() != Image::NONE;
+    // The surface isn't created until the first texture upload is done.
+    return m_pImage->getSource() != Image::NONE && m_pSurface->isCreated();
 }
 
 VertexDataPtr Shape::getVertexData()
@@ -120,6 +122,16 @@ void Shape::draw(const glm::mat4& transform, float opacity)
     m_SubVA.draw();
 }
 
+void Shape::addToBatch(RenderBatcher* pBatcher, const glm::mat4& transform, 
+        float opacity, GLContext::BlendMode mode)
+{
+    OGLSurface* pSurface = 0;
+    if (isTextured()) {
+        pSurface = m_pSurface;
+    }
+    pBatcher->addDraw(transform, pSurface, mode, false, opacity, m_SubVA);
+}
+
 void Shape::discard()
 {
     m_pVertexData = VertexDataPtr();
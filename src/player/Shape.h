@@ -29,12 +29,15 @@
 #include "../base/GLMHelper.h"
 #include "../graphics/Bitmap.h"
 #include "../graphics/SubVertexArray.h"
+#include "../graphics/GLContext.h"
 
 #include <boost/shared_ptr.hpp>
 #include <string>
 
 namespace avg {
 
+class RenderBatcher;
+
 class AVG_API Shape
 {
     public:
@@ -50,6 +53,8 @@ class AVG_API Shape
         VertexDataPtr getVertexData();
         void setVertexArray(const VertexArrayPtr& pVA);
         void draw(const glm::mat4& transform, float opacity);
+        void addToBatch(RenderBatcher* pBatcher, const glm::mat4& transform, 
+                float opacity, GLContext::BlendMode mode);
 
         void discard();
 
@@ -71,6 +71,13 @@ TextEngine::TextEngine(bool bHint)
     init();
 }
 
+TextEngine::TextEngine(bool bHint, const vector<string>& sFontDirs)
+    : m_bHint(bHint),
+      m_sFontDirs(sFontDirs)
+{
+    init();
+}
+
 TextEngine::~TextEngine()
 {
     deinit();
@@ -126,6 +133,11 @@ void TextEngine::addFontDir(const std::string& sDir)
     init();
 }
 
+const vector<string>& TextEngine::getFontDirs() const
+{
+    return m_sFontDirs;
+}
+
 PangoContext * TextEngine::getPangoContext()
 {
     return m_pPangoContext;
@@ -36,6 +36,8 @@ namespace avg {
 class TextEngine {
 public:
     static TextEngine& get(bool bHint);
+    // Creates an engine with a private font map for use in a different thread.
+    TextEngine(bool bHint, const std::vector<std::string>& sFontDirs);
     virtual ~TextEngine();
 
     PangoContext * getPangoContext();
@@ -43,6 +45,7 @@ public:
     const std::vector<std::string>& getFontFamilies();
     const std::vector<std::string>& getFontVariants(const std::string& sFontName);
     void addFontDir(const std::string& sDir);
+    const std::vector<std::string>& getFontDirs() const;
 
     PangoFontDescription * getFontDescription(const std::string& sFamily, 
             const std::string& sVariant);
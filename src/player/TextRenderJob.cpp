@@ -0,0 +1,170 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#include "TextRenderJob.h"
+
+#include "../base/TimeSource.h"
+
+#include "../graphics/Filterfill.h"
+
+#include <pango/pangoft2.h>
+
+using namespace std;
+
+namespace avg {
+
+TextRenderJob::TextRenderJob(WordsNode* pNode, const string& sText, 
+        PangoAttrList* pAttrList, const PangoFontDescription* pFontDescription,
+        const FontStyle& fontStyle, int width)
+    : m_pNode(pNode),
+      m_sText(sText),
+      m_pAttrList(pAttrList),
+      m_WrapMode(fontStyle.getWrapModeVal()),
+      m_Alignment(fontStyle.getAlignmentVal()),
+      m_bJustify(fontStyle.getJustify()),
+      m_Width(width),
+      m_Indent(fontStyle.getIndent()),
+      m_LineSpacing(fontStyle.getLineSpacing()),
+      m_bHint(fontStyle.getHint()),
+      m_bSubmitted(false),
+      m_bCancelled(false)
+{
+    m_pFontDescription = pango_font_description_copy(pFontDescription);
+    m_StartTime = TimeSource::get()->getCurrentMicrosecs()/1000;
+}
+
+TextRenderJob::~TextRenderJob()
+{
+    pango_attr_list_unref(m_pAttrList);
+    pango_font_description_free(m_pFontDescription);
+}
+
+PangoLayout* TextRenderJob::createLayout(PangoContext* pContext) const
+{
+    PangoLayout* pLayout = pango_layout_new(pContext);
+    pango_layout_set_font_description(pLayout, m_pFontDescription);
+    pango_layout_set_text(pLayout, m_sText.c_str(), -1);
+    // Layouts in different threads mustn't share attribute lists.
+    PangoAttrList* pAttrList = pango_attr_list_copy(m_pAttrList);
+    pango_layout_set_attributes(pLayout, pAttrList);
+    pango_attr_list_unref(pAttrList);
+
+    pango_layout_set_wrap(pLayout, m_WrapMode);
+    pango_layout_set_alignment(pLayout, m_Alignment);
+    pango_layout_set_justify(pLayout, m_bJustify);
+    if (m_Width != 0) {
+        pango_layout_set_width(pLayout, m_Width * PANGO_SCALE);
+    }
+    int indent = m_Indent * PANGO_SCALE;
+    pango_layout_set_indent(pLayout, indent);
+    if (indent < 0) {
+        // For hanging indentation, we add a tabstop to support lists
+        PangoTabArray* pTabs = pango_tab_array_new_with_positions(1, false,
+                PANGO_TAB_LEFT, -indent);
+        pango_layout_set_tabs(pLayout, pTabs);
+        pango_tab_array_free(pTabs);
+    }
+    pango_layout_set_spacing(pLayout, (int)(m_LineSpacing*PANGO_SCALE));
+    return pLayout;
+}
+
+void TextRenderJob::render(PangoContext* pContext)
+{
+    PangoLayout* pLayout = createLayout(pContext);
+    pango_layout_get_pixel_extents(pLayout, &m_InkRect, &m_LogicalRect);
+
+    IntPoint size(m_InkRect.width, m_InkRect.height);
+    if (m_Width != 0) {
+        size.x = m_Width;
+    }
+    if (size.x == 0) {
+        size.x = 1;
+    }
+    if (size.y == 0) {
+        size.y = 1;
+    }
+    m_pBmp = BitmapPtr(new Bitmap(size, A8, "TextRenderJob"));
+    FilterFill<unsigned char>(0).applyInPlace(m_pBmp);
+    FT_Bitmap bitmap;
+    bitmap.rows = size.y;
+    bitmap.width = size.x;
+    bitmap.pitch = m_pBmp->getStride();
+    bitmap.buffer = m_pBmp->getPixels();
+    bitmap.num_grays = 256;
+    bitmap.pixel_mode = ft_pixel_mode_grays;
+    pango_ft2_render_layout(&bitmap, pLayout, -m_InkRect.x, -m_InkRect.y);
+
+    g_object_unref(pLayout);
+}
+
+WordsNode* TextRenderJob::getNode() const
+{
+    return m_pNode;
+}
+
+bool TextRenderJob::getHint() const
+{
+    return m_bHint;
+}
+
+long long TextRenderJob::getStartTime() const
+{
+    return m_StartTime;
+}
+
+void TextRenderJob::setSubmitted()
+{
+    m_bSubmitted = true;
+}
+
+bool TextRenderJob::isSubmitted() const
+{
+    return m_bSubmitted;
+}
+
+void TextRenderJob::cancel()
+{
+    m_bCancelled = true;
+}
+
+bool TextRenderJob::isCancelled() const
+{
+    return m_bCancelled;
+}
+
+BitmapPtr TextRenderJob::getBitmap() const
+{
+    return m_pBmp;
+}
+
+const PangoRectangle& TextRenderJob::getInkRect() const
+{
+    return m_InkRect;
+}
+
+const PangoRectangle& TextRenderJob::getLogicalRect() const
+{
+    return m_LogicalRect;
+}
+
+}
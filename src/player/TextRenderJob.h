@@ -0,0 +1,101 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#ifndef _TextRenderJob_H_
+#define _TextRenderJob_H_
+
+#include "../api.h"
+
+#include "FontStyle.h"
+
+#include "../base/Queue.h"
+#include "../graphics/Bitmap.h"
+
+#include <pango/pango.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+
+#include <string>
+
+namespace avg {
+
+class WordsNode;
+
+// Everything needed to lay out and rasterize the text of a WordsNode, so this can 
+// happen in a TextRenderThread. The job only holds copies of the node's data; the 
+// node pointer is only touched in the main thread and only if the job hasn't been 
+// cancelled.
+class AVG_API TextRenderJob
+{
+public:
+    TextRenderJob(WordsNode* pNode, const std::string& sText, PangoAttrList* pAttrList,
+            const PangoFontDescription* pFontDescription, const FontStyle& fontStyle,
+            int width);
+    virtual ~TextRenderJob();
+
+    PangoLayout* createLayout(PangoContext* pContext) const;
+    void render(PangoContext* pContext);
+
+    WordsNode* getNode() const;
+    bool getHint() const;
+    long long getStartTime() const;
+
+    void setSubmitted();
+    bool isSubmitted() const;
+    void cancel();
+    bool isCancelled() const;
+
+    BitmapPtr getBitmap() const;
+    const PangoRectangle& getInkRect() const;
+    const PangoRectangle& getLogicalRect() const;
+
+private:
+    WordsNode* m_pNode;
+    std::string m_sText;
+    PangoAttrList* m_pAttrList;
+    PangoFontDescription* m_pFontDescription;
+    PangoWrapMode m_WrapMode;
+    PangoAlignment m_Alignment;
+    bool m_bJustify;
+    int m_Width;
+    int m_Indent;
+    float m_LineSpacing;
+    bool m_bHint;
+    long long m_StartTime;
+
+    bool m_bSubmitted;
+    boost::atomic<bool> m_bCancelled;
+
+    BitmapPtr m_pBmp;
+    PangoRectangle m_InkRect;
+    PangoRectangle m_LogicalRect;
+};
+
+typedef boost::shared_ptr<TextRenderJob> TextRenderJobPtr;
+typedef Queue<TextRenderJob> TextRenderJobQueue;
+typedef boost::shared_ptr<TextRenderJobQueue> TextRenderJobQueuePtr;
+
+}
+
+#endif
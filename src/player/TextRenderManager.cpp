@@ -0,0 +1,139 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#include "TextRenderManager.h"
+#include "WordsNode.h"
+#include "Player.h"
+
+#include "../base/Exception.h"
+
+using namespace std;
+
+namespace avg {
+
+TextRenderManager * TextRenderManager::s_pTextRenderManager = 0;
+
+TextRenderManager::TextRenderManager()
+{
+    if (s_pTextRenderManager) {
+        throw Exception(AVG_ERR_UNKNOWN, 
+                "TextRenderManager has already been instantiated.");
+    }
+    
+    m_pCmdQueue = TextRenderThread::CQueuePtr(new TextRenderThread::CQueue);
+    m_pResultQueue = TextRenderJobQueuePtr(new TextRenderJobQueue);
+
+    startThreads(1);
+
+    s_pTextRenderManager = this;
+    Player::get()->registerFrameEndListener(this);
+}
+
+TextRenderManager::~TextRenderManager()
+{
+    Player::get()->unregisterFrameEndListener(this);
+    while (!m_pCmdQueue->empty()) {
+        m_pCmdQueue->pop();
+    }
+    stopThreads();
+    while (!m_pResultQueue->empty()) {
+        m_pResultQueue->pop();
+    }
+    s_pTextRenderManager = 0;
+}
+
+TextRenderManager* TextRenderManager::get()
+{
+    if (!s_pTextRenderManager) {
+        s_pTextRenderManager = new TextRenderManager();
+    }
+    return s_pTextRenderManager;
+}
+
+bool TextRenderManager::exists()
+{
+    return s_pTextRenderManager != 0;
+}
+
+void TextRenderManager::renderText(TextRenderJobPtr pJob)
+{
+    pJob->setSubmitted();
+    m_pCmdQueue->pushCmd(boost::bind(&TextRenderThread::renderText, _1, pJob));
+}
+
+void TextRenderManager::textDisplayed(NodePtr pNode)
+{
+    m_pDisplayedNodes.push_back(pNode);
+}
+
+void TextRenderManager::setNumThreads(int numThreads)
+{
+    stopThreads();
+    startThreads(numThreads);
+}
+
+int TextRenderManager::getNumThreads() const
+{
+    return int(m_pThreads.size());
+}
+
+void TextRenderManager::onFrameEnd()
+{
+    // Python handlers may change texts, so work on a copy.
+    vector<NodePtr> pDisplayedNodes;
+    pDisplayedNodes.swap(m_pDisplayedNodes);
+    for (unsigned i = 0; i < pDisplayedNodes.size(); ++i) {
+        pDisplayedNodes[i]->notifySubscribers("TEXT_RENDERED");
+    }
+    while (!m_pResultQueue->empty()) {
+        TextRenderJobPtr pJob = m_pResultQueue->pop();
+        if (!pJob->isCancelled()) {
+            pJob->getNode()->onTextRendered(pJob);
+        }
+    }
+}
+
+void TextRenderManager::startThreads(int numThreads)
+{
+    for (int i = 0; i < numThreads; ++i) {
+        boost::thread* pThread = new boost::thread(
+                TextRenderThread(*m_pCmdQueue, *m_pResultQueue));
+        m_pThreads.push_back(pThread);
+    }
+}
+
+void TextRenderManager::stopThreads()
+{
+    int numThreads = m_pThreads.size();
+    for (int i = 0; i < numThreads; ++i) {
+        m_pCmdQueue->pushCmd(boost::bind(&TextRenderThread::stop, _1));
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        boost::thread* pThread = m_pThreads[i];
+        pThread->join();
+        delete pThread;
+    }
+    m_pThreads.clear();
+}
+
+}
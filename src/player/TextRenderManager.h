@@ -0,0 +1,75 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#ifndef _TextRenderManager_H_
+#define _TextRenderManager_H_
+
+#include "../api.h"
+
+#include "TextRenderThread.h"
+#include "TextRenderJob.h"
+
+#include "../base/IFrameEndListener.h"
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class Node;
+typedef boost::shared_ptr<Node> NodePtr;
+
+// Lays out and rasterizes the text of WordsNodes with asyncrender=True in worker 
+// threads. Finished jobs are handed back to their nodes at the end of the frame.
+class AVG_API TextRenderManager : public IFrameEndListener
+{
+    public:
+        TextRenderManager();
+        ~TextRenderManager();
+        static TextRenderManager* get();
+        static bool exists();
+
+        void renderText(TextRenderJobPtr pJob);
+        void textDisplayed(NodePtr pNode);
+        void setNumThreads(int numThreads);
+        int getNumThreads() const;
+
+        virtual void onFrameEnd();
+
+    private:
+        void startThreads(int numThreads);
+        void stopThreads();
+
+        static TextRenderManager * s_pTextRenderManager;
+
+        std::vector<boost::thread*> m_pThreads;
+        TextRenderThread::CQueuePtr m_pCmdQueue;
+        TextRenderJobQueuePtr m_pResultQueue;
+        std::vector<NodePtr> m_pDisplayedNodes;
+};
+
+}
+
+#endif
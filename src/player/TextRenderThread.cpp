@@ -0,0 +1,81 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#include "TextRenderThread.h"
+#include "TextEngine.h"
+
+#include "../base/Logger.h"
+#include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
+
+namespace avg {
+
+TextRenderThread::TextRenderThread(CQueue& cmdQ, TextRenderJobQueue& resultQueue)
+    : WorkerThread<TextRenderThread>("TextRender", cmdQ),
+      m_ResultQueue(resultQueue),
+      m_TotalLatency(0),
+      m_NumJobsDone(0)
+{
+    // Font maps are created here in the main thread since fontconfig setup changes 
+    // global state.
+    m_pHintEngine = boost::shared_ptr<TextEngine>(new TextEngine(true, 
+            TextEngine::get(true).getFontDirs()));
+    m_pNoHintEngine = boost::shared_ptr<TextEngine>(new TextEngine(false, 
+            TextEngine::get(false).getFontDirs()));
+}
+
+bool TextRenderThread::work()
+{
+    waitForCommand();
+    return true;
+}
+
+void TextRenderThread::deinit()
+{
+    if (m_NumJobsDone > 0) {
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                "Average latency for async text rendering: " << 
+                m_TotalLatency/m_NumJobsDone << " ms");
+    }
+}
+
+static ProfilingZoneID RenderTextProfilingZone("TextRenderThread: render text", true);
+
+void TextRenderThread::renderText(TextRenderJobPtr pJob)
+{
+    if (pJob->isCancelled()) {
+        return;
+    }
+    ScopeTimer timer(RenderTextProfilingZone);
+    if (pJob->getHint()) {
+        pJob->render(m_pHintEngine->getPangoContext());
+    } else {
+        pJob->render(m_pNoHintEngine->getPangoContext());
+    }
+    m_ResultQueue.push(pJob);
+    m_NumJobsDone++;
+    m_TotalLatency += TimeSource::get()->getCurrentMicrosecs()/1000 - 
+            pJob->getStartTime();
+}
+
+}
@@ -0,0 +1,64 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#ifndef _TextRenderThread_H_
+#define _TextRenderThread_H_
+
+#include "../api.h"
+
+#include "TextRenderJob.h"
+
+#include "../base/WorkerThread.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+#include <string>
+
+namespace avg {
+
+class TextEngine;
+
+class AVG_API TextRenderThread : public WorkerThread<TextRenderThread>
+{
+    public:
+        TextRenderThread(CQueue& cmdQ, TextRenderJobQueue& resultQueue);
+
+        void renderText(TextRenderJobPtr pJob);
+
+    private:
+        virtual bool work();
+        virtual void deinit();
+        
+        TextRenderJobQueue& m_ResultQueue;
+        // Pango isn't thread-safe, so each thread has its own font maps.
+        boost::shared_ptr<TextEngine> m_pHintEngine;
+        boost::shared_ptr<TextEngine> m_pNoHintEngine;
+
+        float m_TotalLatency;
+        int m_NumJobsDone;
+};
+
+}
+
+#endif
@@ -48,8 +48,6 @@
 #include <map>
 #include <list>
 #include <vector>
-#include <queue>
-#include <set>
 #include <iostream>
 
 using namespace std;
@@ -259,29 +257,6 @@ void TrackerInputDevice::update(BlobVectorPtr pTrackBlobs,
     }
 }
 
-// Temporary structure to be put into heap of blob distances. Used only in 
-// trackBlobIDs.
-struct BlobDistEntry {
-    BlobDistEntry(float dist, BlobPtr pNewBlob, BlobPtr pOldBlob) 
-        : m_Dist(dist),
-          m_pNewBlob(pNewBlob),
-          m_pOldBlob(pOldBlob)
-    {
-    }
-
-    float m_Dist;
-    BlobPtr m_pNewBlob;
-    BlobPtr m_pOldBlob;
-};
-typedef boost::shared_ptr<struct BlobDistEntry> BlobDistEntryPtr;
-
-// The heap is sorted by least distance, so this operator does the
-// _opposite_ of what is expected!
-bool operator < (const BlobDistEntryPtr& e1, const BlobDistEntryPtr& e2) 
-{
-    return e1->m_Dist > e2->m_Dist;
-}
-
 void TrackerInputDevice::trackBlobIDs(BlobVectorPtr pNewBlobs, long long time, 
         bool bTouch)
 {
@@ -297,44 +272,25 @@ void TrackerInputDevice::trackBlobIDs(BlobVectorPtr pNewBlobs, long long time,
         pEvents = &m_TrackEvents;
         source = Event::TRACK;
     }
-    BlobVector oldBlobs;
+    m_OldBlobs.clear();
+    m_OldCenters.clear();
     for (TouchStatusMap::iterator it = pEvents->begin(); it != pEvents->end(); ++it) {
         (*it).second->setStale();
-        oldBlobs.push_back((*it).first);
+        m_OldBlobs.push_back((*it).first);
+        m_OldCenters.push_back((*it).first->getEstimatedNextCenter());
     }
-    // Create a heap that contains all distances of old to new blobs < MaxDist
-    float MaxDist = m_TrackerConfig.getFloatParam(sConfigPath+"similarity/@value");
-    float MaxDistSquared = MaxDist*MaxDist;
-    priority_queue<BlobDistEntryPtr> distHeap;
+    m_NewCenters.clear();
     for (BlobVector::iterator it = pNewBlobs->begin(); it != pNewBlobs->end(); ++it) {
-        BlobPtr pNewBlob = *it;
-        for(BlobVector::iterator it2 = oldBlobs.begin(); it2 != oldBlobs.end(); ++it2) { 
-            BlobPtr pOldBlob = *it2;
-            float distSquared = glm::distance2(pNewBlob->getCenter(),
-                    pOldBlob->getEstimatedNextCenter());
-            if (distSquared <= MaxDistSquared) {
-                BlobDistEntryPtr pEntry = BlobDistEntryPtr(
-                        new BlobDistEntry(distSquared, pNewBlob, pOldBlob));
-                distHeap.push(pEntry);
-            }
-        }
+        m_NewCenters.push_back((*it)->getCenter());
     }
-    // Match up the closest blobs.
-    set<BlobPtr> matchedNewBlobs;
-    set<BlobPtr> matchedOldBlobs;
-    int numMatchedBlobs = 0;
-    while (!distHeap.empty()) {
-        BlobDistEntryPtr pEntry = distHeap.top();
-        distHeap.pop();
-        if (matchedNewBlobs.find(pEntry->m_pNewBlob) == matchedNewBlobs.end() &&
-            matchedOldBlobs.find(pEntry->m_pOldBlob) == matchedOldBlobs.end())
-        {
-            // Found a pair of matched blobs.
-            numMatchedBlobs++;
-            BlobPtr pNewBlob = pEntry->m_pNewBlob; 
-            BlobPtr pOldBlob = pEntry->m_pOldBlob; 
-            matchedNewBlobs.insert(pNewBlob);
-            matchedOldBlobs.insert(pOldBlob);
+    float maxDist = m_TrackerConfig.getFloatParam(sConfigPath+"similarity/@value");
+    m_BlobMatcher.match(m_OldCenters, m_NewCenters, maxDist);
+
+    for (unsigned i = 0; i < pNewBlobs->size(); ++i) {
+        BlobPtr pNewBlob = (*pNewBlobs)[i];
+        int oldIndex = m_BlobMatcher.getMatch(i);
+        if (oldIndex != -1) {
+            BlobPtr pOldBlob = m_OldBlobs[oldIndex];
             AVG_ASSERT (pEvents->find(pOldBlob) != pEvents->end());
             TrackerTouchStatusPtr pTouchStatus;
             pTouchStatus = pEvents->find(pOldBlob)->second;
@@ -345,17 +301,15 @@ void TrackerInputDevice::trackBlobIDs(BlobVectorPtr pNewBlobs, long long time,
             // Update the mapping.
             (*pEvents)[pNewBlob] = pTouchStatus;
             pEvents->erase(pOldBlob);
-        }
-    }
-    // Blobs have been matched. Left-overs are new blobs.
-    for (BlobVector::iterator it = pNewBlobs->begin(); it != pNewBlobs->end(); ++it) {
-        if (matchedNewBlobs.find(*it) == matchedNewBlobs.end()) {
+        } else {
+            // Left-overs are new blobs.
             TrackerTouchStatusPtr pTouchStatus = TrackerTouchStatusPtr(
-                    new TrackerTouchStatus(*it, time, m_pDeDistort, m_DisplayROI, 
+                    new TrackerTouchStatus(pNewBlob, time, m_pDeDistort, m_DisplayROI, 
                             source));
-            (*pEvents)[(*it)] = pTouchStatus;
+            (*pEvents)[pNewBlob] = pTouchStatus;
         }
     }
+    m_OldBlobs.clear();
 
     // All event streams that are still stale haven't been updated: blob is gone, 
     // set the sentinel for this.
@@ -29,6 +29,7 @@
 
 #include "../imaging/TrackerThread.h"
 #include "../imaging/Blob.h"
+#include "../imaging/BlobMatcher.h"
 
 #include "../graphics/Bitmap.h"
 #include "../graphics/Filter.h"
@@ -102,6 +103,10 @@ class AVG_API TrackerInputDevice: public IBlobTarget, public InputDevice
 
         // Used by tracker thread
         void trackBlobIDs(BlobVectorPtr new_blobs, long long time, bool bTouch);
+        BlobMatcher m_BlobMatcher;
+        BlobVector m_OldBlobs;
+        std::vector<glm::vec2> m_OldCenters;
+        std::vector<glm::vec2> m_NewCenters;
 
         // Used by both threads
         TouchStatusMap m_TouchEvents;
@@ -26,6 +26,7 @@
 
 #include "../base/MathHelper.h"
 #include "../base/Exception.h"
+#include "../base/XMLHelper.h"
 
 #include <set>
 
@@ -36,11 +37,14 @@ namespace avg {
 TypeRegistry* TypeRegistry::s_pInstance = 0;
 
 TypeRegistry::TypeRegistry()
+    : m_bDTDValid(false),
+      m_pParsedDTD(0)
 {
 }
 
 TypeRegistry::~TypeRegistry()
 {
+    invalidateDTD();
 }
 
 TypeRegistry* TypeRegistry::get()
@@ -54,6 +58,7 @@ TypeRegistry* TypeRegistry::get()
 void TypeRegistry::registerType(const TypeDefinition& def, const char* pParentNames[])
 {
     m_TypeDefs.insert(TypeDefMap::value_type(def.getName(), def));
+    invalidateDTD();
 
     if (pParentNames) {
         string sChildArray[1];
@@ -74,6 +79,7 @@ void TypeRegistry::registerType(const TypeDefinition& def, const char* pParentNa
 void TypeRegistry::updateDefinition(const TypeDefinition& def)
 {
     m_TypeDefs[def.getName()] = def;
+    invalidateDTD();
 }
 
 ExportedObjectPtr TypeRegistry::createObject(const string& sType, 
@@ -101,6 +107,9 @@ ExportedObjectPtr TypeRegistry::createObject(const string& sType, const py::dict
 
 string TypeRegistry::getDTD() const
 {
+    if (m_bDTDValid) {
+        return m_sDTD;
+    }
     if (m_TypeDefs.empty()) {
         return string("");
     }
@@ -125,7 +134,17 @@ string TypeRegistry::getDTD() const
         }
     }
    
-    return ss.str();
+    m_sDTD = ss.str();
+    m_bDTDValid = true;
+    return m_sDTD;
+}
+
+xmlDtdPtr TypeRegistry::getParsedDTD()
+{
+    if (!m_pParsedDTD) {
+        m_pParsedDTD = parseDTD(getDTD(), "avg.dtd");
+    }
+    return m_pParsedDTD;
 }
 
 TypeDefinition& TypeRegistry::getTypeDef(const string& sType)
@@ -138,6 +157,16 @@ TypeDefinition& TypeRegistry::getTypeDef(const string& sType)
     return it->second;
 }
 
+void TypeRegistry::invalidateDTD()
+{
+    m_bDTDValid = false;
+    m_sDTD = "";
+    if (m_pParsedDTD) {
+        xmlFreeDtd(m_pParsedDTD);
+        m_pParsedDTD = 0;
+    }
+}
+
 void TypeRegistry::writeTypeDTD(const TypeDefinition& def, stringstream& ss) const
 {
     ss << "<!ELEMENT " << def.getName() << " " << def.getDTDChildrenString() << " >\n";
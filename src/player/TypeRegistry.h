@@ -49,14 +49,21 @@ public:
     ExportedObjectPtr createObject(const std::string& Type, const py::dict& PyDict);
     
     std::string getDTD() const;
+    // Parsed version of getDTD(). Stays valid until the next type is registered.
+    xmlDtdPtr getParsedDTD();
     
 private:
     TypeRegistry();
     void writeTypeDTD(const TypeDefinition& def, std::stringstream& ss) const;
+    void invalidateDTD();
     
     typedef std::map<std::string, TypeDefinition> TypeDefMap;
     TypeDefMap m_TypeDefs;
 
+    mutable std::string m_sDTD;
+    mutable bool m_bDTDValid;
+    xmlDtdPtr m_pParsedDTD;
+
     static TypeRegistry* s_pInstance;
 };
 
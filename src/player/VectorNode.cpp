@@ -24,6 +24,8 @@
 #include "TypeDefinition.h"
 #include "OGLSurface.h"
 #include "Image.h"
+#include "Canvas.h"
+#include "RenderBatcher.h"
 
 #include "../base/Exception.h"
 #include "../base/Logger.h"
@@ -138,6 +140,7 @@ void VectorNode::setBlendModeStr(const string& sBlendMode)
 {
     m_sBlendMode = sBlendMode;
     m_BlendMode = GLContext::stringToBlendMode(sBlendMode);
+    setCanvasDirty();
 }
 
 static ProfilingZoneID PrerenderProfilingZone("VectorNode::prerender");
@@ -154,6 +157,7 @@ void VectorNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
             Pixel32 color = getColorVal();
             calcVertexes(pShapeVD, color);
             m_bDrawNeeded = false;
+            setCanvasDirty();
         }
         if (isVisible()) {
             m_pShape->setVertexArray(pVA);
@@ -166,7 +170,9 @@ void VectorNode::maybeRender(const glm::mat4& parentTransform)
     AVG_ASSERT(getState() == NS_CANRENDER);
     if (isVisible()) {
         m_Transform = parentTransform;
-        GLContext::getMain()->setBlendMode(m_BlendMode);
+        if (!getCanvas()->isBatchRendering()) {
+            GLContext::getMain()->setBlendMode(m_BlendMode);
+        }
         render();
     }
 }
@@ -178,7 +184,12 @@ void VectorNode::render()
     ScopeTimer timer(RenderProfilingZone);
     float curOpacity = getEffectiveOpacity();
     if (curOpacity > 0.01) {
-        m_pShape->draw(m_Transform, curOpacity);
+        RenderBatcher* pBatcher = getCanvas()->getRenderBatcher();
+        if (pBatcher) {
+            m_pShape->addToBatch(pBatcher, m_Transform, curOpacity, m_BlendMode);
+        } else {
+            m_pShape->draw(m_Transform, curOpacity);
+        }
     }
 }
 
@@ -247,6 +258,7 @@ string VectorNode::lineJoin2String(LineJoin lineJoin)
 void VectorNode::setDrawNeeded()
 {
     m_bDrawNeeded = true;
+    invalidateHitBounds();
 }
         
 bool VectorNode::isDrawNeeded()
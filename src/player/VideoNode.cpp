@@ -286,6 +286,19 @@ void VideoNode::seekToTime(long long time)
     m_bSeekPending = true;
 }
 
+void VideoNode::seekToKeyframe(long long time)
+{
+    if (time < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE,
+                "Can't seek to a negative time in a video.");
+    }
+    exceptionIfUnloaded("seekToKeyframe");
+    // Seeking to a keyframe doesn't require decoding any frames that aren't displayed.
+    float keyframeTime = m_pDecoder->getKeyframeTime(float(time)/1000.0f);
+    seek((long long)(keyframeTime*1000));
+    m_bSeekPending = true;
+}
+
 bool VideoNode::getLoop() const
 {
     return m_bLoop;
@@ -499,6 +512,19 @@ void VideoNode::startDecoding()
     m_bSeekPending = true;
     
     createTextures(videoInfo.m_Size);
+    if (m_bThreaded && videoInfo.m_bHasVideo && !m_bUsesHardwareAcceleration) {
+        // Decoded frames are written directly into upload buffers owned by this node.
+        // Two extra buffers cover the frame being decoded and the one being displayed.
+        AsyncVideoDecoder* pAsyncDecoder = dynamic_cast<AsyncVideoDecoder*>(m_pDecoder);
+        m_pFramePool = VideoFramePoolPtr(new VideoFramePool(m_QueueLength+2,
+                videoInfo.m_Size, getPixelFormat()));
+        pAsyncDecoder->setFramePool(m_pFramePool);
+    }
+    if (m_bThreaded && m_bLoop && videoInfo.m_bHasVideo) {
+        // Decode across the loop boundary so looping doesn't need a seek.
+        AsyncVideoDecoder* pAsyncDecoder = dynamic_cast<AsyncVideoDecoder*>(m_pDecoder);
+        pAsyncDecoder->setLoop(true);
+    }
    
     if (m_SeekBeforeCanRenderTime != 0) {
         seek(m_SeekBeforeCanRenderTime);
@@ -551,6 +577,7 @@ void VideoNode::close()
         m_AudioID = -1;
     }
     m_pDecoder->close();
+    m_pFramePool = VideoFramePoolPtr();
     if (m_FramesTooLate > 0) {
         string sID;
         if (getID() == "") {
@@ -644,6 +671,9 @@ void VideoNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
 {
     ScopeTimer timer(PrerenderProfilingZone);
     Node::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
+    if (m_VideoState != Unloaded) {
+        updateDecoderPriority(isVisible());
+    }
     if (isVisible()) {
         if (m_VideoState != Unloaded) {
             if (m_VideoState == Playing) {
@@ -668,7 +698,7 @@ void VideoNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
             // stays in sync.
             m_pDecoder->throwAwayFrame(getNextFrameTime()/1000.0f);
 
-            if (m_pDecoder->isEOF()) {
+            if (isDecoderEOF()) {
                 updateStatusDueToDecoderEOF();
             }
         }
@@ -713,7 +743,7 @@ bool VideoNode::renderFrame()
         }
     }
 
-    if (m_pDecoder->isEOF()) {
+    if (isDecoderEOF()) {
         updateStatusDueToDecoderEOF();
         if (m_bLoop) {
             frameAvailable = 
@@ -774,6 +804,24 @@ bool VideoNode::renderFrame()
     return (frameAvailable == FA_NEW_FRAME);
 }
 
+void VideoNode::updateDecoderPriority(bool bVisible)
+{
+    AsyncVideoDecoder* pAsyncDecoder = dynamic_cast<AsyncVideoDecoder*>(m_pDecoder);
+    if (pAsyncDecoder) {
+        VideoDecoderPool::Priority priority;
+        if (m_VideoState == Playing) {
+            if (bVisible) {
+                priority = VideoDecoderPool::VISIBLE;
+            } else {
+                priority = VideoDecoderPool::PLAYING;
+            }
+        } else {
+            priority = VideoDecoderPool::PAUSED;
+        }
+        pAsyncDecoder->setPriority(priority);
+    }
+}
+
 void VideoNode::onEOF()
 {
     if (m_pEOFCallback) {
@@ -792,13 +840,25 @@ void VideoNode::updateStatusDueToDecoderEOF()
 {
     m_bEOFPending = true;
     if (m_bLoop) {
-        m_StartTime = Player::get()->getFrameTime();
+        AsyncVideoDecoder* pAsyncDecoder = dynamic_cast<AsyncVideoDecoder*>(m_pDecoder);
+        bool bGapless = pAsyncDecoder && pAsyncDecoder->isAtLoopEnd();
+        long long loopDuration = 0;
+        if (bGapless) {
+            loopDuration = (long long)(pAsyncDecoder->getLoopDuration()*1000);
+        }
+        if (loopDuration > 0) {
+            // The audio keeps playing across the boundary. Start the next loop 
+            // exactly one loop duration after the last one so video doesn't drift.
+            m_StartTime += m_PauseTime + loopDuration;
+        } else {
+            m_StartTime = Player::get()->getFrameTime();
+        }
         m_PauseStartTime = Player::get()->getFrameTime();
         m_JitterCompensation = 0.5;
         m_PauseTime = 0;
         m_FramesInRowTooLate = 0;
         m_bFrameAvailable = false;
-        if (m_AudioID != -1) {
+        if (m_AudioID != -1 && !bGapless) {
             AudioEngine::get()->notifySeek(m_AudioID);
         }
         m_pDecoder->loop();
@@ -807,6 +867,21 @@ void VideoNode::updateStatusDueToDecoderEOF()
     }
 }
 
+bool VideoNode::isDecoderEOF() const
+{
+    if (!m_pDecoder->isEOF()) {
+        return false;
+    }
+    AsyncVideoDecoder* pAsyncDecoder = dynamic_cast<AsyncVideoDecoder*>(m_pDecoder);
+    if (pAsyncDecoder && pAsyncDecoder->isAtLoopEnd()) {
+        // In a gapless loop with audio, the video holds its last frame until the
+        // audio reaches the loop boundary as well.
+        long long loopDuration = (long long)(pAsyncDecoder->getLoopDuration()*1000);
+        return getNextFrameTime() >= loopDuration;
+    }
+    return true;
+}
+
 
 }
 
@@ -34,6 +34,7 @@
 #include "../base/UTF8String.h"
 
 #include "../video/VideoDecoder.h"
+#include "../video/VideoFramePool.h"
 
 namespace avg {
 
@@ -84,6 +85,7 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
 
         long long getCurTime() const;
         void seekToTime(long long time);
+        void seekToKeyframe(long long time);
         bool getLoop() const;
         bool isThreaded() const;
         bool hasAudio() const;
@@ -102,9 +104,11 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
 
     private:
         bool renderFrame();
+        void updateDecoderPriority(bool bVisible);
         void seek(long long destTime);
         void onEOF();
         void updateStatusDueToDecoderEOF();
+        bool isDecoderEOF() const;
         void dumpFramesTooLate();
 
         void open();
@@ -149,6 +153,7 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
         int m_AudioID;
 
         GLTexturePtr m_pTextures[4];
+        VideoFramePoolPtr m_pFramePool;
 };
 
 }
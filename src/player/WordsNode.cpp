@@ -23,6 +23,7 @@
 #include "OGLSurface.h"
 #include "TypeDefinition.h"
 #include "TextEngine.h"
+#include "TextRenderManager.h"
 
 #include "../base/Logger.h"
 #include "../base/Exception.h"
@@ -103,6 +104,10 @@ void WordsNode::registerType()
                 offsetof(WordsNode, m_bRawTextMode)))
         .addArg(Arg<float>("letterspacing", 0))
         .addArg(Arg<bool>("hint", true))
+        .addArg(Arg<bool>("glyphcache", false, false, 
+                offsetof(WordsNode, m_bUseGlyphCache)))
+        .addArg(Arg<bool>("asyncrender", false, false, 
+                offsetof(WordsNode, m_bAsyncRender)))
         .addArg(Arg<FontStyle>("fontstyle", FontStyle()))
         ;
     TypeRegistry::get()->registerType(def);
@@ -112,7 +117,9 @@ WordsNode::WordsNode(const ArgList& args)
     : m_LogicalSize(0,0),
       m_pFontDescription(0),
       m_pLayout(0),
-      m_bRenderNeeded(true)
+      m_bRenderNeeded(true),
+      m_bGlyphCacheAllowed(false),
+      m_bNewTextBmp(false)
 {
     m_bParsedText = false;
     args.setMembers(this);
@@ -133,6 +140,7 @@ WordsNode::WordsNode(const ArgList& args)
 
 WordsNode::~WordsNode()
 {
+    cancelRenderJob();
     if (m_pFontDescription) {
         pango_font_description_free(m_pFontDescription);
     }
@@ -142,6 +150,13 @@ WordsNode::~WordsNode()
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
+void WordsNode::getArgs(ArgList& args) const
+{
+    RasterNode::getArgs(args);
+    args.setArgVal<FontStyle>("fontstyle", m_FontStyle);
+    args.setArgVal<UTF8String>("text", m_sRawText);
+}
+
 void WordsNode::setTextFromNodeValue(const string& sText)
 {
     // Gives priority to Node Values only if they aren't empty
@@ -170,6 +185,8 @@ void WordsNode::disconnect(bool bKill)
         m_pFontDescription = 0;
         updateFont();
     }
+    m_pGlyphPage = GlyphPagePtr();
+    m_GlyphQuads.clear();
     RasterNode::disconnect(bKill);
 }
 
@@ -217,6 +234,40 @@ void WordsNode::setHint(bool bHint)
     updateLayout();
 }
 
+bool WordsNode::getGlyphCache() const
+{
+    return m_bUseGlyphCache;
+}
+
+void WordsNode::setGlyphCache(bool bUseGlyphCache)
+{
+    m_bUseGlyphCache = bUseGlyphCache;
+    m_bRenderNeeded = true;
+}
+
+bool WordsNode::getAsyncRender() const
+{
+    return m_bAsyncRender;
+}
+
+void WordsNode::setAsyncRender(bool bAsyncRender)
+{
+    if (bAsyncRender != m_bAsyncRender) {
+        m_bAsyncRender = bAsyncRender;
+        m_pTextBmp = BitmapPtr();
+        updateLayout();
+    }
+}
+
+void WordsNode::onTextRendered(TextRenderJobPtr pJob)
+{
+    AVG_ASSERT(pJob == m_pRenderJob);
+    m_pRenderJob = TextRenderJobPtr();
+    m_pTextBmp = pJob->getBitmap();
+    m_bNewTextBmp = true;
+    applyExtents(pJob->getInkRect(), pJob->getLogicalRect());
+}
+
 float WordsNode::getWidth() const
 {
     return AreaNode::getWidth();
@@ -256,6 +307,18 @@ glm::vec2 WordsNode::toLocal(const glm::vec2& globalPos) const
     return getRotatedPivot(localPos, -getAngle(), getPivot());
 }
 
+FRect WordsNode::calcHitBounds()
+{
+    FRect bounds = AreaNode::calcHitBounds();
+    if (!isEmptyHitBounds(bounds)) {
+        // toLocal() applies the alignment offset before rotating.
+        glm::vec2 offset(m_AlignOffset, 0);
+        bounds.tl += offset;
+        bounds.br += offset;
+    }
+    return bounds;
+}
+
 glm::vec2 WordsNode::toGlobal(const glm::vec2& localPos) const
 {
     glm::vec2 alignPos = localPos + glm::vec2(m_AlignOffset, 0);
@@ -294,6 +357,13 @@ void WordsNode::addFontDir(const std::string& sDir)
 {
     TextEngine::get(true).addFontDir(sDir);
     TextEngine::get(false).addFontDir(sDir);
+    // Cached glyphs might belong to fonts that are replaced now.
+    GlyphCache::get()->clear();
+    if (TextRenderManager::exists()) {
+        // Restart the threads so they pick up the new font dir.
+        TextRenderManager* pManager = TextRenderManager::get();
+        pManager->setNumThreads(pManager->getNumThreads());
+    }
 }
 
 void WordsNode::setFontVariant(const std::string& sVariant)
@@ -540,89 +610,95 @@ void WordsNode::updateLayout()
 {
     ScopeTimer timer(UpdateLayoutProfilingZone);
 
+    cancelRenderJob();
     if (m_sText.length() == 0) {
         m_LogicalSize = IntPoint(0,0);
+        m_pTextBmp = BitmapPtr();
         m_bRenderNeeded = true;
     } else {
-        TextEngine& engine = TextEngine::get(m_FontStyle.getHint());
-        PangoContext* pContext = engine.getPangoContext();
-        pango_context_set_font_description(pContext, m_pFontDescription);
-
+        TextRenderJobPtr pJob = createRenderJob();
+        // In async mode, this layout is only used to answer queries like 
+        // getGlyphPos(). Pango doesn't do any actual work until then.
         if (m_pLayout) {
             g_object_unref(m_pLayout);
         }
-        m_pLayout = pango_layout_new(pContext);
+        TextEngine& engine = TextEngine::get(m_FontStyle.getHint());
+        m_pLayout = pJob->createLayout(engine.getPangoContext());
+        if (m_bAsyncRender) {
+            // Submitted in renderText() once the node can be displayed.
+            m_pRenderJob = pJob;
+        } else {
+            PangoRectangle logical_rect;
+            PangoRectangle ink_rect;
+            pango_layout_get_pixel_extents(m_pLayout, &ink_rect, &logical_rect);
+            applyExtents(ink_rect, logical_rect);
+        }
+    }
+}
 
-        PangoAttrList * pAttrList = 0;
+TextRenderJobPtr WordsNode::createRenderJob()
+{
+    PangoAttrList * pAttrList = 0;
+    string sText;
 #if PANGO_VERSION > PANGO_VERSION_ENCODE(1,18,2) 
-        PangoAttribute * pLetterSpacing = pango_attr_letter_spacing_new
-            (int(m_FontStyle.getLetterSpacing()*1024));
+    PangoAttribute * pLetterSpacing = pango_attr_letter_spacing_new
+        (int(m_FontStyle.getLetterSpacing()*1024));
 #endif
-        if (m_bParsedText) {
-            char * pText = 0;
-            parseString(&pAttrList, &pText);
+    if (m_bParsedText) {
+        char * pText = 0;
+        parseString(&pAttrList, &pText);
 #if PANGO_VERSION > PANGO_VERSION_ENCODE(1,18,2) 
-            // Workaround for pango bug.
-            pango_attr_list_insert_before(pAttrList, pLetterSpacing);
+        // Workaround for pango bug.
+        pango_attr_list_insert_before(pAttrList, pLetterSpacing);
 #endif            
-            pango_layout_set_text(m_pLayout, pText, -1);
-            g_free(pText);
-        } else {
-            pAttrList = pango_attr_list_new();
+        sText = pText;
+        g_free(pText);
+    } else {
+        pAttrList = pango_attr_list_new();
 #if PANGO_VERSION > PANGO_VERSION_ENCODE(1,18,2) 
-            pango_attr_list_insert_before(pAttrList, pLetterSpacing);
+        pango_attr_list_insert_before(pAttrList, pLetterSpacing);
 #endif
-            pango_layout_set_text(m_pLayout, m_sText.c_str(), -1);
-        }
-        pango_layout_set_attributes(m_pLayout, pAttrList);
-        pango_attr_list_unref(pAttrList);
-
-        pango_layout_set_wrap(m_pLayout, m_FontStyle.getWrapModeVal());
-        pango_layout_set_alignment(m_pLayout, m_FontStyle.getAlignmentVal());
-        pango_layout_set_justify(m_pLayout, m_FontStyle.getJustify());
-        if (getUserSize().x != 0) {
-            pango_layout_set_width(m_pLayout, int(getUserSize().x * PANGO_SCALE));
-        }
-        int indent = m_FontStyle.getIndent() * PANGO_SCALE;
-        pango_layout_set_indent(m_pLayout, indent);
-        if (indent < 0) {
-            // For hanging indentation, we add a tabstop to support lists
-            PangoTabArray* pTabs = pango_tab_array_new_with_positions(1, false,
-                    PANGO_TAB_LEFT, -indent);
-            pango_layout_set_tabs(m_pLayout, pTabs);
-            pango_tab_array_free(pTabs);
-        }
-        pango_layout_set_spacing(m_pLayout, 
-                (int)(m_FontStyle.getLineSpacing()*PANGO_SCALE));
-        PangoRectangle logical_rect;
-        PangoRectangle ink_rect;
-        pango_layout_get_pixel_extents(m_pLayout, &ink_rect, &logical_rect);
-
-        /*        
-                  cerr << getID() << endl;
-                  cerr << "Ink: " << ink_rect.x << ", " << ink_rect.y << ", " 
-                  << ink_rect.width << ", " << ink_rect.height << endl;
-                  cerr << "Logical: " << logical_rect.x << ", " << logical_rect.y << ", " 
-                  << logical_rect.width << ", " << logical_rect.height << endl;
-                  cerr << "User Size: " << getUserSize() << endl;
-                  */        
-        m_InkSize.y = ink_rect.height;
-        if (getUserSize().x == 0) {
-            m_InkSize.x = ink_rect.width;
-        } else {
-            m_InkSize.x = int(getUserSize().x);
-        }
-        if (m_InkSize.x == 0) {
-            m_InkSize.x = 1;
-        }
-        if (m_InkSize.y == 0) {
-            m_InkSize.y = 1;
-        }
-        m_LogicalSize.y = logical_rect.height;
-        m_LogicalSize.x = logical_rect.width;
-        m_InkOffset = IntPoint(ink_rect.x-logical_rect.x, ink_rect.y-logical_rect.y);
-        m_bRenderNeeded = true;
-        setViewport(-32767, -32767, -32767, -32767);
+        sText = m_sText;
+    }
+    return TextRenderJobPtr(new TextRenderJob(this, sText, pAttrList, 
+            m_pFontDescription, m_FontStyle, int(getUserSize().x)));
+}
+
+void WordsNode::applyExtents(const PangoRectangle& ink_rect, 
+        const PangoRectangle& logical_rect)
+{
+    /*        
+              cerr << getID() << endl;
+              cerr << "Ink: " << ink_rect.x << ", " << ink_rect.y << ", " 
+              << ink_rect.width << ", " << ink_rect.height << endl;
+              cerr << "Logical: " << logical_rect.x << ", " << logical_rect.y << ", " 
+              << logical_rect.width << ", " << logical_rect.height << endl;
+              cerr << "User Size: " << getUserSize() << endl;
+              */        
+    m_InkSize.y = ink_rect.height;
+    if (getUserSize().x == 0) {
+        m_InkSize.x = ink_rect.width;
+    } else {
+        m_InkSize.x = int(getUserSize().x);
+    }
+    if (m_InkSize.x == 0) {
+        m_InkSize.x = 1;
+    }
+    if (m_InkSize.y == 0) {
+        m_InkSize.y = 1;
+    }
+    m_LogicalSize.y = logical_rect.height;
+    m_LogicalSize.x = logical_rect.width;
+    m_InkOffset = IntPoint(ink_rect.x-logical_rect.x, ink_rect.y-logical_rect.y);
+    m_bRenderNeeded = true;
+    setViewport(-32767, -32767, -32767, -32767);
+}
+
+void WordsNode::cancelRenderJob()
+{
+    if (m_pRenderJob) {
+        m_pRenderJob->cancel();
+        m_pRenderJob = TextRenderJobPtr();
     }
 }
 
@@ -633,63 +709,204 @@ void WordsNode::renderText()
     if (!(getState() == NS_CANRENDER)) {
         return;
     }
+    if (m_pRenderJob && !m_pRenderJob->isSubmitted()) {
+        TextRenderManager::get()->renderText(m_pRenderJob);
+    }
     if (m_bRenderNeeded) {
+        m_pGlyphPage = GlyphPagePtr();
+        m_GlyphQuads.clear();
         if (m_sText.length() != 0) {
-            ScopeTimer timer(RenderTextProfilingZone);
-            TextEngine& engine = TextEngine::get(m_FontStyle.getHint());
-            PangoContext* pContext = engine.getPangoContext();
-            pango_context_set_font_description(pContext, m_pFontDescription);
-            int maxTexSize = GLContext::getMain()->getMaxTexSize();
-            if (m_InkSize.x > maxTexSize || m_InkSize.y > maxTexSize) {
-                throw Exception(AVG_ERR_UNSUPPORTED, 
-                        "WordsNode size exceeded maximum (Size=" 
-                        + toString(m_InkSize) + ", max=" + toString(maxTexSize) + ")");
-            }
-            GLTexturePtr pTex(new GLTexture(m_InkSize, A8));
-            getSurface()->create(A8, pTex);
-            TextureMoverPtr pMover = TextureMover::create(m_InkSize, A8, GL_DYNAMIC_DRAW);
-
-            BitmapPtr pBmp = pMover->lock();
-            FilterFill<unsigned char>(0).applyInPlace(pBmp);
-            FT_Bitmap bitmap;
-            bitmap.rows = m_InkSize.y;
-            bitmap.width = m_InkSize.x;
-            unsigned char * pLines = pBmp->getPixels();
-            bitmap.pitch = pBmp->getStride();
-            bitmap.buffer = pLines;
-            bitmap.num_grays = 256;
-            bitmap.pixel_mode = ft_pixel_mode_grays;
-
-            PangoRectangle logical_rect;
-            PangoRectangle ink_rect;
-            pango_layout_get_pixel_extents(m_pLayout, &ink_rect, &logical_rect);
-            pango_ft2_render_layout(&bitmap, m_pLayout, -ink_rect.x, -ink_rect.y);
             switch (m_FontStyle.getAlignmentVal()) {
                 case PANGO_ALIGN_LEFT:
                     m_AlignOffset = 0;
                     break;
                 case PANGO_ALIGN_CENTER:
-                    m_AlignOffset = -logical_rect.width/2;
+                    m_AlignOffset = -m_LogicalSize.x/2;
                     break;
                 case PANGO_ALIGN_RIGHT:
-                    m_AlignOffset = -logical_rect.width;
+                    m_AlignOffset = -m_LogicalSize.x;
                     break;
                 default:
                     AVG_ASSERT(false);
             }
+        }
+        if (m_sText.length() != 0 && m_bAsyncRender) {
+            m_bGlyphCacheAllowed = false;
+            // Until the first job is done, there is nothing to display.
+            if (m_pTextBmp) {
+                IntPoint size = m_pTextBmp->getSize();
+                checkTexSize(size);
+                GLTexturePtr pTex(new GLTexture(size, A8));
+                getSurface()->create(A8, pTex);
+                pTex->moveBmpToTexture(m_pTextBmp);
+                newSurface();
+                if (m_bNewTextBmp) {
+                    m_bNewTextBmp = false;
+                    TextRenderManager::get()->textDisplayed(getSharedThis());
+                }
+            }
+        } else if (m_sText.length() != 0) {
+            ScopeTimer timer(RenderTextProfilingZone);
+            TextEngine& engine = TextEngine::get(m_FontStyle.getHint());
+            PangoContext* pContext = engine.getPangoContext();
+            pango_context_set_font_description(pContext, m_pFontDescription);
+            PangoRectangle logical_rect;
+            PangoRectangle ink_rect;
+            pango_layout_get_pixel_extents(m_pLayout, &ink_rect, &logical_rect);
 
-            pMover->unlock();
-            pMover->moveToTexture(*pTex);
+            m_bGlyphCacheAllowed = canUseGlyphCache();
+            if (m_bGlyphCacheAllowed && layoutGlyphs(logical_rect)) {
+                getSurface()->create(A8, m_pGlyphPage->getTexture());
+            } else {
+                checkTexSize(m_InkSize);
+                GLTexturePtr pTex(new GLTexture(m_InkSize, A8));
+                getSurface()->create(A8, pTex);
+                TextureMoverPtr pMover = TextureMover::create(m_InkSize, A8, 
+                        GL_DYNAMIC_DRAW);
+
+                BitmapPtr pBmp = pMover->lock();
+                FilterFill<unsigned char>(0).applyInPlace(pBmp);
+                FT_Bitmap bitmap;
+                bitmap.rows = m_InkSize.y;
+                bitmap.width = m_InkSize.x;
+                unsigned char * pLines = pBmp->getPixels();
+                bitmap.pitch = pBmp->getStride();
+                bitmap.buffer = pLines;
+                bitmap.num_grays = 256;
+                bitmap.pixel_mode = ft_pixel_mode_grays;
+
+                pango_ft2_render_layout(&bitmap, m_pLayout, -ink_rect.x, -ink_rect.y);
+
+                pMover->unlock();
+                pMover->moveToTexture(*pTex);
+            }
             newSurface();
         }
         m_bRenderNeeded = false;
+        setCanvasDirty();
+        invalidateHitBounds();
+    }
+}
+
+void WordsNode::checkTexSize(const IntPoint& size)
+{
+    int maxTexSize = GLContext::getMain()->getMaxTexSize();
+    if (size.x > maxTexSize || size.y > maxTexSize) {
+        throw Exception(AVG_ERR_UNSUPPORTED, 
+                "WordsNode size exceeded maximum (Size=" 
+                + toString(size) + ", max=" + toString(maxTexSize) + ")");
+    }
+}
+
+bool WordsNode::canUseGlyphCache() const
+{
+    // The glyph atlas needs the layout in the main thread.
+    return m_bUseGlyphCache && !m_bAsyncRender && !hasMask() && !hasEffect();
+}
+
+bool WordsNode::hasTextDecorations() const
+{
+    // Underlines, strikethroughs etc. aren't glyphs, so the atlas can't render them.
+    PangoLayoutIter* pIter = pango_layout_get_iter(m_pLayout);
+    bool bFound = false;
+    do {
+        PangoLayoutRun* pRun = pango_layout_iter_get_run_readonly(pIter);
+        if (pRun) {
+            GSList* pAttrs = pRun->item->analysis.extra_attrs;
+            for (; pAttrs && !bFound; pAttrs = pAttrs->next) {
+                PangoAttribute* pAttr = (PangoAttribute*)pAttrs->data;
+                switch (pAttr->klass->type) {
+                    case PANGO_ATTR_UNDERLINE:
+                    case PANGO_ATTR_STRIKETHROUGH:
+                    case PANGO_ATTR_RISE:
+                        bFound = ((PangoAttrInt*)pAttr)->value != 0;
+                        break;
+                    case PANGO_ATTR_BACKGROUND:
+                    case PANGO_ATTR_SHAPE:
+                        bFound = true;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    } while (!bFound && pango_layout_iter_next_run(pIter));
+    pango_layout_iter_free(pIter);
+    return bFound;
+}
+
+bool WordsNode::layoutGlyphs(const PangoRectangle& logicalRect)
+{
+    if (hasTextDecorations()) {
+        return false;
+    }
+    GlyphCache* pCache = GlyphCache::get();
+    bool bHint = m_FontStyle.getHint();
+    GlyphPagePtr pPage = pCache->getCurPage(m_pFontDescription, bHint);
+    if (!fillGlyphQuads(pPage, logicalRect)) {
+        // The current page is full. Texts that don't fit into a fresh page use the
+        // per-node texture instead.
+        pPage = pCache->addPage(m_pFontDescription, bHint);
+        if (!fillGlyphQuads(pPage, logicalRect)) {
+            m_GlyphQuads.clear();
+            return false;
+        }
     }
+    m_pGlyphPage = pPage;
+    return true;
+}
+
+bool WordsNode::fillGlyphQuads(GlyphPagePtr pPage, const PangoRectangle& logicalRect)
+{
+    m_GlyphQuads.clear();
+    glm::vec2 pageSize(pPage->getSize());
+    glm::vec2 offset(m_AlignOffset-logicalRect.x, -logicalRect.y);
+    PangoLayoutIter* pIter = pango_layout_get_iter(m_pLayout);
+    bool bOk = true;
+    do {
+        PangoLayoutRun* pRun = pango_layout_iter_get_run_readonly(pIter);
+        if (!pRun) {
+            // End of line.
+            continue;
+        }
+        PangoRectangle runRect;
+        pango_layout_iter_get_run_extents(pIter, 0, &runRect);
+        int baseline = pango_layout_iter_get_baseline(pIter);
+        PangoFont* pFont = pRun->item->analysis.font;
+        PangoGlyphString* pGlyphs = pRun->glyphs;
+        int x = runRect.x;
+        for (int i = 0; i < pGlyphs->num_glyphs && bOk; ++i) {
+            PangoGlyphInfo& info = pGlyphs->glyphs[i];
+            if (info.glyph != PANGO_GLYPH_EMPTY) {
+                const GlyphPage::Glyph* pGlyph = pPage->getGlyph(pFont, info.glyph);
+                if (!pGlyph) {
+                    bOk = false;
+                } else if (pGlyph->m_Size != IntPoint(0,0)) {
+                    GlyphQuad quad;
+                    quad.m_Pos = glm::vec2(
+                            PANGO_PIXELS(x+info.geometry.x_offset)+pGlyph->m_Offset.x,
+                            PANGO_PIXELS(baseline+info.geometry.y_offset)+
+                                    pGlyph->m_Offset.y) + offset;
+                    quad.m_Size = glm::vec2(pGlyph->m_Size);
+                    quad.m_TexPos = glm::vec2(pGlyph->m_Pos)/pageSize;
+                    quad.m_TexSize = glm::vec2(pGlyph->m_Size)/pageSize;
+                    m_GlyphQuads.push_back(quad);
+                }
+            }
+            x += info.geometry.width;
+        }
+    } while (bOk && pango_layout_iter_next_run(pIter));
+    pango_layout_iter_free(pIter);
+    return bOk;
 }
 
 void WordsNode::redraw()
 {
     AVG_ASSERT(m_sText.length() < 32767);
     
+    if (canUseGlyphCache() != m_bGlyphCacheAllowed) {
+        m_bRenderNeeded = true;
+    }
     renderText();
 }
 
@@ -702,17 +919,62 @@ void WordsNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     }
     Pixel32 color = m_FontStyle.getColorVal();
     if (m_sText.length() != 0 && isVisible()) {
-        renderFX(getSize(), color, false);
+        if (m_pGlyphPage) {
+            m_pGlyphPage->uploadTexture();
+        } else {
+            renderFX(getSize(), color, false);
+        }
     }
     calcVertexArray(pVA, color);
 }
 
+bool WordsNode::supportsBatching() const
+{
+    return m_pGlyphPage != GlyphPagePtr();
+}
+
+void WordsNode::appendVertexes(bool bBatched, const Pixel32& color)
+{
+    if (!m_pGlyphPage) {
+        RasterNode::appendVertexes(bBatched, color);
+        return;
+    }
+    SubVertexArray& subVA = getSubVA();
+    glm::mat4 transform;
+    if (bBatched) {
+        transform = getLocalTransform();
+    }
+    for (unsigned i = 0; i < m_GlyphQuads.size(); ++i) {
+        const GlyphQuad& quad = m_GlyphQuads[i];
+        glm::vec2 pos[4];
+        pos[0] = quad.m_Pos;
+        pos[1] = quad.m_Pos + glm::vec2(quad.m_Size.x, 0);
+        pos[2] = quad.m_Pos + quad.m_Size;
+        pos[3] = quad.m_Pos + glm::vec2(0, quad.m_Size.y);
+        glm::vec2 texPos[4];
+        texPos[0] = quad.m_TexPos;
+        texPos[1] = quad.m_TexPos + glm::vec2(quad.m_TexSize.x, 0);
+        texPos[2] = quad.m_TexPos + quad.m_TexSize;
+        texPos[3] = quad.m_TexPos + glm::vec2(0, quad.m_TexSize.y);
+        int curVertex = subVA.getNumVerts();
+        for (int j = 0; j < 4; ++j) {
+            glm::vec4 pt = transform*glm::vec4(pos[j], 0, 1);
+            subVA.appendPos(glm::vec2(pt.x, pt.y), texPos[j], color);
+        }
+        subVA.appendQuadIndexes(curVertex+1, curVertex, curVertex+2, curVertex+3);
+    }
+}
+
 static ProfilingZoneID RenderProfilingZone("WordsNode::render");
 
 void WordsNode::render()
 {
     ScopeTimer timer(RenderProfilingZone);
-    if (m_sText.length() != 0 && isVisible()) {
+    if (m_sText.length() != 0 && isVisible() && m_pGlyphPage) {
+        // Glyph quads are already positioned in local coordinates.
+        blta8(getTransform(), glm::vec2(1,1), getEffectiveOpacity(), 
+                m_FontStyle.getColorVal(), getBlendMode());
+    } else if (m_sText.length() != 0 && isVisible()) {
         IntPoint offset = m_InkOffset + IntPoint(m_AlignOffset, 0);
         glm::mat4 transform;
         if (offset == IntPoint(0,0)) {
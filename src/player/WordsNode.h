@@ -25,6 +25,8 @@
 #include "../api.h"
 #include "RasterNode.h"
 #include "FontStyle.h"
+#include "GlyphCache.h"
+#include "TextRenderJob.h"
 #include "../graphics/Pixel32.h"
 #include "../base/UTF8String.h"
 
@@ -42,6 +44,7 @@ class AVG_API WordsNode : public RasterNode
         
         WordsNode(const ArgList& args);
         virtual ~WordsNode();
+        virtual void getArgs(ArgList& args) const;
         
         virtual void connectDisplay();
         virtual void connect(CanvasPtr pCanvas);
@@ -109,6 +112,13 @@ class AVG_API WordsNode : public RasterNode
         bool getHint() const;
         void setHint(bool bHint);
 
+        bool getGlyphCache() const;
+        void setGlyphCache(bool bUseGlyphCache);
+
+        bool getAsyncRender() const;
+        void setAsyncRender(bool bAsyncRender);
+        void onTextRendered(TextRenderJobPtr pJob);
+
         glm::vec2 getGlyphPos(int i);
         glm::vec2 getGlyphSize(int i);
         virtual IntPoint getMediaSize();
@@ -123,11 +133,21 @@ class AVG_API WordsNode : public RasterNode
                 const std::string& sFontName);
         static void addFontDir(const std::string& sDir);
 
+    protected:
+        virtual FRect calcHitBounds();
+        virtual bool supportsBatching() const;
+        virtual void appendVertexes(bool bBatched, const Pixel32& color);
+
     private:
         virtual void calcMaskCoords();
         void updateFont();
         void updateLayout();
+        TextRenderJobPtr createRenderJob();
+        void applyExtents(const PangoRectangle& inkRect, 
+                const PangoRectangle& logicalRect);
+        void cancelRenderJob();
         void renderText();
+        void checkTexSize(const IntPoint& size);
         void redraw();
         void parseString(PangoAttrList** ppAttrList, char** ppText);
         void setParsedText(const UTF8String& sText);
@@ -135,6 +155,11 @@ class AVG_API WordsNode : public RasterNode
         std::string removeExcessSpaces(const std::string & sText);
         PangoRectangle getGlyphRect(int i);
 
+        bool canUseGlyphCache() const;
+        bool hasTextDecorations() const;
+        bool layoutGlyphs(const PangoRectangle& logicalRect);
+        bool fillGlyphQuads(GlyphPagePtr pPage, const PangoRectangle& logicalRect);
+
         // Exposed Attributes
         FontStyle m_FontStyle;
         UTF8String m_sText;
@@ -150,6 +175,24 @@ class AVG_API WordsNode : public RasterNode
         PangoLayout * m_pLayout;
 
         bool m_bRenderNeeded;
+
+        // Asynchronous rendering.
+        bool m_bAsyncRender;
+        TextRenderJobPtr m_pRenderJob;
+        BitmapPtr m_pTextBmp;
+        bool m_bNewTextBmp;
+
+        // Glyph atlas rendering.
+        struct GlyphQuad {
+            glm::vec2 m_Pos;
+            glm::vec2 m_Size;
+            glm::vec2 m_TexPos;
+            glm::vec2 m_TexSize;
+        };
+        bool m_bUseGlyphCache;
+        bool m_bGlyphCacheAllowed;
+        GlyphPagePtr m_pGlyphPage;
+        std::vector<GlyphQuad> m_GlyphQuads;
 };
 
 }
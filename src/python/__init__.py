@@ -15,6 +15,11 @@ del system
 from avg import *
 player = avg.Player.get()
 
+# Deliver pending log records while python log sinks can still be called.
+import atexit
+atexit.register(logger.setAsync, False)
+del atexit
+
 from enumcompat import *
 
 import textarea
@@ -311,6 +311,56 @@ class AVTestCase(AVGTestCase):
             seek(26)
             self.assertNotEqual(videoNode.getCurFrame(), 0)
 
+    def testVideoSeekToKeyframe(self):
+        def checkCurFrame(frame):
+            self.assertEqual(videoNode.getCurFrame(), frame)
+
+        def checkCurTime(time):
+            self.assert_(abs(videoNode.getCurTime()-time) < 20)
+
+        player.setFakeFPS(25)
+        root = self.loadEmptyScene()
+        # Every frame of an mjpeg video is a keyframe.
+        videoNode = avg.VideoNode(parent=root, size=(96,96), threaded=False,
+                href="mjpeg-48x48.avi")
+        videoNode.play()
+        videoNode.seekToKeyframe(26*40)
+        self.start(False,
+                (lambda: checkCurFrame(26),
+                 lambda: self.compareImage("testVideoSeek0"),
+                ))
+
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, size=(96,96), threaded=False,
+                href="mpeg1-48x48.mov")
+        videoNode.play()
+        self.start(False,
+                # Keyframes are at frames 0, 12 and 24 (0, 400 and 800 ms).
+                (lambda: videoNode.seekToKeyframe(1000),
+                 lambda: checkCurTime(800),
+                 lambda: videoNode.seekToKeyframe(700),
+                 lambda: checkCurTime(400),
+                 lambda: videoNode.seekToTime(1000),
+                 lambda: self.assert_(abs(videoNode.getCurTime()-1000) < 40),
+                ))
+
+        # The decoder thread decodes the frames between the keyframe and the seek 
+        # target, but only the target frame is delivered. A paused node displays the 
+        # first frame it gets.
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, size=(96,96), threaded=True,
+                href="mpeg1-48x48.mov")
+        videoNode.play()
+        videoNode.pause()
+        self.start(False,
+                (lambda: videoNode.seekToFrame(20),
+                 lambda: checkCurFrame(20),
+                 lambda: checkCurTime(667),
+                 lambda: videoNode.seekToKeyframe(700),
+                 lambda: checkCurFrame(12),
+                 lambda: checkCurTime(400),
+                ))
+
     def testVideoFPS(self):
         player.setFakeFPS(25)
         root = self.loadEmptyScene()
@@ -344,6 +394,82 @@ class AVTestCase(AVGTestCase):
             player.subscribe(player.ON_FRAME, onFrame)
             player.play()
 
+    def testVideoGaplessLoop(self):
+        # In threaded loop mode, frames from the start of the video are decoded before
+        # the end is reached, so the queue is never empty at the loop boundary.
+        def onEOF():
+            self.framesQueued.append(videoNode.getNumFramesQueued())
+            if len(self.framesQueued) == 3:
+                player.stop()
+
+        self.framesQueued = []
+        player.setFakeFPS(25)
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, loop=True, fps=25, size=(96,96),
+                threaded=True, href="mpeg1-48x48.mov")
+        videoNode.subscribe(avg.Node.END_OF_FILE, onEOF)
+        videoNode.play()
+        player.play()
+        self.assertEqual(len(self.framesQueued), 3)
+        for numFrames in self.framesQueued:
+            self.assert_(numFrames > 0)
+
+        # With an audio track, every loop lasts exactly as long as the longer stream,
+        # so video and audio don't drift apart.
+        def onSoundEOF():
+            self.duration = videoNode.getDuration()
+            self.eofTimes.append(player.getFrameTime())
+            if len(self.eofTimes) == 4:
+                player.stop()
+
+        self.eofTimes = []
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, loop=True, size=(96,96), threaded=True,
+                href="mpeg1-48x48-sound.avi")
+        videoNode.subscribe(avg.Node.END_OF_FILE, onSoundEOF)
+        videoNode.play()
+        player.play()
+        self.assertEqual(len(self.eofTimes), 4)
+        loopTimes = [self.eofTimes[i+1]-self.eofTimes[i] for i in range(3)]
+        self.assert_(min(loopTimes) >= self.duration-40)
+        self.assert_(max(loopTimes)-min(loopTimes) <= 40)
+
+    def testVideoDecoderPool(self):
+        def checkPlaying():
+            for videoNode in videoNodes[:3]:
+                self.assert_(videoNode.getCurFrame() > 0)
+            self.assert_(pool.getNumTasks() >= 2*len(videoNodes))
+
+        def unlinkVideos():
+            for videoNode in videoNodes:
+                videoNode.unlink(True)
+
+        pool = avg.VideoDecoderPool.get()
+        numThreads = pool.getNumThreads()
+        try:
+            self.assertException(lambda: pool.setNumThreads(0))
+            # All videos need to play even if there are fewer threads than decoders.
+            pool.setNumThreads(1)
+            player.setFakeFPS(25)
+            root = self.loadEmptyScene()
+            videoNodes = []
+            for i in range(4):
+                videoNode = avg.VideoNode(parent=root, pos=(i*48,0), threaded=True,
+                        href="mpeg1-48x48.mov")
+                videoNode.play()
+                videoNodes.append(videoNode)
+            videoNodes[3].pause()
+            self.start(False,
+                    (None,
+                     None,
+                     lambda: self.delay(200),
+                     checkPlaying,
+                     unlinkVideos,
+                     lambda: self.assertEqual(pool.getNumTasks(), 0),
+                    ))
+        finally:
+            pool.setNumThreads(numThreads)
+
     def testVideoMask(self):
         def testWithFile(filename, testImgName):
             def setMask(href):
@@ -660,8 +786,11 @@ def AVTestSuite(tests):
             "testVideoHRef",
             "testVideoOpacity",
             "testVideoSeek",
+            "testVideoSeekToKeyframe",
             "testVideoFPS",
             "testVideoLoop",
+            "testVideoGaplessLoop",
+            "testVideoDecoderPool",
             "testVideoMask",
             "testVideoEOF",
             "testVideoSeekAfterEOF",
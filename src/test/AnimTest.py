@@ -457,6 +457,77 @@ class AnimTestCase(AVGTestCase):
         genericObject2 = None
         genericObject3 = None
 
+    def testNativeAttrAnim(self):
+        # Animations on C++ node attributes bypass python, but attributes overridden
+        # in python subclasses still need to go through the python setter.
+        class LoggingRectNode(avg.RectNode):
+            def __init__(self, parent=None, **kwargs):
+                super(LoggingRectNode, self).__init__(**kwargs)
+                self.registerInstance(self, parent)
+                self.numSetCalls = 0
+
+            def getAngle(self):
+                return avg.RectNode.angle.__get__(self)
+
+            def setAngle(self, angle):
+                self.numSetCalls += 1
+                avg.RectNode.angle.__set__(self, angle)
+
+            angle = property(getAngle, setAngle)
+
+        root = self.loadEmptyScene()
+        player.setFakeFPS(10)
+        imageNode = avg.ImageNode(pos=(0,0), href="rgb24-65x65.png", parent=root)
+        circleNode = avg.CircleNode(pos=(10,10), r=5, parent=root)
+        rectNode = LoggingRectNode(pos=(10,10), size=(20,20), parent=root)
+        anims = [
+                avg.LinearAnim(imageNode, "pos", 300, (0,0), (50,40)),
+                avg.EaseInOutAnim(imageNode, "opacity", 300, 1, 0.5, 100, 100),
+                avg.LinearAnim(circleNode, "r", 300, 5, 15, True),
+                avg.LinearAnim(rectNode, "angle", 300, 0, 1)]
+        self.start(False,
+                (lambda: [anim.start() for anim in anims],
+                 lambda: self.assertEqual(avg.getNumRunningAnims(), 4),
+                 lambda: self.assert_(rectNode.numSetCalls > 0),
+                 lambda: self.delay(400),
+                 lambda: self.assertEqual(avg.getNumRunningAnims(), 0),
+                 lambda: self.assertEqual(imageNode.pos, (50,40)),
+                 lambda: self.assertAlmostEqual(imageNode.opacity, 0.5),
+                 lambda: self.assertEqual(circleNode.r, 15),
+                 lambda: self.assertAlmostEqual(rectNode.angle, 1)
+                ))
+        anims = None
+
+        # An exception in a stepped setter ends playback, but doesn't keep
+        # animations from being stepped in the next playback.
+        class ThrowingRectNode(LoggingRectNode):
+            def setAngle(self, angle):
+                LoggingRectNode.setAngle(self, angle)
+                if self.numSetCalls > 1:
+                    raise RuntimeError("ThrowingRectNode")
+
+            angle = property(LoggingRectNode.getAngle, setAngle)
+
+        root = self.loadEmptyScene()
+        throwingNode = ThrowingRectNode(size=(20,20), parent=root)
+        throwingAnim = avg.LinearAnim(throwingNode, "angle", 300, 0, 1)
+        player.setTimeout(10, throwingAnim.start)
+        self.assertException(player.play)
+        self.assertEqual(throwingNode.numSetCalls, 2)
+
+        root = self.loadEmptyScene()
+        circleNode = avg.CircleNode(pos=(10,10), r=5, parent=root)
+        anim = avg.LinearAnim(circleNode, "r", 300, 5, 15)
+        self.start(False,
+                (anim.start,
+                 lambda: self.delay(400),
+                 lambda: self.assert_(not(anim.isRunning())),
+                 lambda: self.assertEqual(circleNode.r, 15),
+                 lambda: self.assertEqual(throwingNode.numSetCalls, 2)
+                ))
+        throwingAnim = None
+        anim = None
+
 
 def animTestSuite(tests):
     availableTests = (
@@ -475,7 +546,8 @@ def animTestSuite(tests):
         "testParallelAnim",
         "testParallelAnimRegistry",
         "testStateAnim",
-        "testNonNodeAttrAnim"
+        "testNonNodeAttrAnim",
+        "testNativeAttrAnim",
         )
     return createAVGTestSuite(availableTests, AnimTestCase, tests)
 
@@ -361,6 +361,63 @@ class DynamicsTestCase(AVGTestCase):
                  lambda: self.compareImage("testDynamicMediaDir2")
                 ))
 
+    def testClone(self):
+        root = self.loadEmptyScene()
+        div = avg.DivNode(id="row", pos=(10,20), size=(100,30), crop=True, parent=root)
+        img = avg.ImageNode(id="icon", href="rgb24-64x64.png", pos=(5,5), opacity=0.5,
+                parent=div)
+        words = avg.WordsNode(text="Row", fontsize=20, color="FF0000", x=40, 
+                parent=div)
+        avg.RectNode(pos=(1,2), size=(30,10), parent=div)
+        # Changes after construction need to be copied as well.
+        img.angle = 0.5
+        words.text = "Changed"
+
+        copy = div.clone()
+        self.assertEqual(copy.id, "")
+        self.assertEqual(copy.parent, None)
+        self.assertEqual(copy.pos, (10,20))
+        self.assertEqual(copy.size, (100,30))
+        self.assert_(copy.crop)
+        self.assertEqual(copy.getNumChildren(), 3)
+        imgCopy = copy.getChild(0)
+        self.assertEqual(imgCopy.id, "")
+        self.assertEqual(imgCopy.href, "rgb24-64x64.png")
+        self.assertEqual(imgCopy.pos, (5,5))
+        self.assertAlmostEqual(imgCopy.opacity, 0.5)
+        self.assertAlmostEqual(imgCopy.angle, 0.5)
+        wordsCopy = copy.getChild(1)
+        self.assertEqual(wordsCopy.text, "Changed")
+        self.assertEqual(wordsCopy.fontsize, 20)
+        self.assertEqual(wordsCopy.color, "FF0000")
+        self.assertEqual(copy.getChild(2).size, (30,10))
+        self.assertEqual(div.clone(deep=False).getNumChildren(), 0)
+        root.appendChild(copy)
+        self.assertException(lambda: root.clone())
+
+        template = avg.NodeTemplate(div)
+        self.assertEqual(template.type, "div")
+        self.assertEqual(template.numnodes, 4)
+        listNode = avg.DivNode(parent=root)
+        rows = template.instantiateMany(20, listNode)
+        self.assertEqual(len(rows), 20)
+        self.assertEqual(listNode.getNumChildren(), 20)
+        self.assertEqual(rows[19].getChild(1).text, "Changed")
+        row = template.instantiate(listNode)
+        self.assertEqual(row.parent, listNode)
+        self.assertEqual(template.instantiate().parent, None)
+        self.assertException(lambda: template.instantiateMany(-1))
+        self.assertException(lambda: avg.NodeTemplate(None))
+        # Invalid nodes in the list leave the parent unchanged.
+        self.assertException(lambda: listNode.appendChildren(
+                [template.instantiate(), None]))
+        self.assertException(lambda: listNode.appendChildren(
+                [template.instantiate(), row]))
+        self.assertEqual(listNode.getNumChildren(), 21)
+        self.start(False,
+                (lambda: self.assertEqual(rows[0].getChild(0).getMediaSize(), (64,64)),
+                ))
+
 
 def dynamicsTestSuite(tests):
     availableTests = (
@@ -375,6 +432,7 @@ def dynamicsTestSuite(tests):
             "testComplexDiv",
             "testNodeCustomization",
             "testDynamicMediaDir",
+            "testClone",
             )
 
     return createAVGTestSuite(availableTests, DynamicsTestCase, tests)
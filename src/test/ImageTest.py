@@ -118,6 +118,30 @@ class ImageTestCase(AVGTestCase):
                  lambda: self.compareImage("testImgPos2"),
                 ))
 
+    def testBatchRendering(self):
+        # Same scene as testImagePos, rendered with sibling batching enabled.
+        def addNodes(y):
+            for x in (16, 48, 80, 112):
+                avg.ImageNode(pos=(x, y), href="rgb24-32x32.png", parent=root)
+
+        def checkDrawCalls(numCalls):
+            self.assertEqual(player.getDrawCallCount(), numCalls)
+
+        root = self.loadEmptyScene()
+        player.setBatchRendering(True)
+        self.assert_(player.isBatchRendering())
+        addNodes(16)
+        self.start(False,
+                (lambda: self.compareImage("testImgPos1"),
+                 lambda: addNodes(48),
+                 lambda: self.compareImage("testImgPos2"),
+                 # All eight images share one texture and are drawn in one call.
+                 lambda: checkDrawCalls(1),
+                 lambda: player.setBatchRendering(False),
+                 lambda: self.compareImage("testImgPos2"),
+                 lambda: checkDrawCalls(8),
+                ))
+
     def testImageSize(self):
         def createXmlNode(pos, size):
             return player.createNode(
@@ -291,6 +315,64 @@ class ImageTestCase(AVGTestCase):
                  testSubBitmap,
                 ))
 
+    def testTextureUploadBudget(self):
+        def setBitmaps():
+            for node in nodes:
+                node.setBitmap(bmp)
+                # The size changes immediately, the texture when the upload is done.
+                self.assertEqual(node.getMediaSize(), (65,65))
+            self.assertEqual(player.getTextureUploadStats().numpending, 3)
+
+        def checkPending(numPending):
+            stats = player.getTextureUploadStats()
+            self.assertEqual(stats.numpending, numPending)
+            self.assertEqual(stats.pendingbytes, numPending*65*65*4)
+
+        def flushUpload():
+            nodes[0].setBitmap(bmp)
+            self.assertEqual(player.getTextureUploadStats().numpending, 1)
+            self.assertEqual(nodes[0].getBitmap().getSize(), (65,65))
+            self.assertEqual(player.getTextureUploadStats().numpending, 0)
+
+        def moveToCPU():
+            # A pending upload is taken back instead of being uploaded.
+            numUploaded = player.getTextureUploadStats().numuploaded
+            nodes[1].setBitmap(avg.Bitmap('media/rgb24-32x32.png'))
+            nodes[1].unlink()
+            stats = player.getTextureUploadStats()
+            self.assertEqual(stats.numpending, 0)
+            self.assertEqual(stats.numuploaded, numUploaded)
+            self.assertEqual(nodes[1].getBitmap().getSize(), (32,32))
+            root.appendChild(nodes[1])
+
+        def setEmptyBitmaps():
+            # Nodes without a texture aren't rendered until their upload is done.
+            for i in range(2):
+                node = avg.ImageNode(pos=(i*32,64), parent=root)
+                node.setBitmap(bmp)
+            self.assertEqual(player.getTextureUploadStats().numpending, 2)
+
+        self.assertException(lambda: player.setTextureUploadBudget(-1, 0))
+        # Every frame uploads at least one bitmap, so this uploads exactly one.
+        player.setTextureUploadBudget(1, 0)
+        root = self.loadEmptyScene()
+        nodes = [avg.ImageNode(pos=(i*32,0), href="rgb24-64x64.png", parent=root)
+                for i in range(3)]
+        bmp = avg.Bitmap('media/rgb24-65x65.png')
+        self.start(False,
+                (setBitmaps,
+                 lambda: checkPending(2),
+                 lambda: checkPending(1),
+                 lambda: checkPending(0),
+                 flushUpload,
+                 moveToCPU,
+                 lambda: self.assertEqual(nodes[1].getBitmap().getSize(), (32,32)),
+                 setEmptyBitmaps,
+                 lambda: checkPending(1),
+                 lambda: checkPending(0),
+                ))
+        player.setTextureUploadBudget(0, 0)
+
     def testBitmapManager(self):
         WAIT_TIMEOUT = 2000
         def expectException(returnValue, nextAction):
@@ -351,6 +433,71 @@ class ImageTestCase(AVGTestCase):
             player.play()
         avg.BitmapManager.get().setNumThreads(1)
         
+    def testBitmapManagerRequests(self):
+        def onLoaded(bmp, name):
+            self.assert_(not isinstance(bmp, Exception))
+            loadedBmps.append(bmp)
+            loadOrder.append(name)
+            loadFrames.append(player.getFrameTime())
+
+        def onCancelledLoaded(bmp):
+            self.fail("Callback of cancelled request invoked")
+
+        def onFrame():
+            # Loading happens in the background, so the results are checked once 
+            # everything has been delivered.
+            if len(loadOrder) == 4 and bitmapMgr.getNumPendingJobs() == 0:
+                checkResults()
+                player.stop()
+
+        def checkResults():
+            self.assertEqual(loadOrder, ["65x65", "64x64", "64x64", "32x32"])
+            # The delivery budget only allows one callback per frame.
+            self.assertEqual(len(set(loadFrames)), len(loadFrames))
+            # Requests for the same file share a decode, but not the bitmap.
+            bmp1 = loadedBmps[1]
+            bmp2 = loadedBmps[2]
+            self.assertEqual(bmp1.getSize(), bmp2.getSize())
+            self.assertEqual(bmp1.getPixels(), bmp2.getPixels())
+            bmp1.setPixels("\0"*len(bmp1.getPixels()))
+            self.assertNotEqual(bmp1.getPixels(), bmp2.getPixels())
+
+        bitmapMgr = avg.BitmapManager.get()
+        self.assertException(lambda: setattr(bitmapMgr, "deliverybudget", -1))
+        try:
+            bitmapMgr.deliverybudget = 0.001
+            bitmapMgr.setNumThreads(0)
+            player.setFakeFPS(25)
+            self.loadEmptyScene()
+            loadedBmps = []
+            loadOrder = []
+            loadFrames = []
+            for i in range(2):
+                bitmapMgr.loadBitmap("media/rgb24-64x64.png", 
+                        lambda bmp: onLoaded(bmp, "64x64"))
+            cancelledMsg = bitmapMgr.loadBitmap("media/rgb24alpha-64x64.png",
+                    onCancelledLoaded)
+            cancelledMsg.cancel()
+            self.assert_(cancelledMsg.isCancelled())
+            bitmapMgr.loadBitmap("media/rgb24-32x32.png", 
+                    lambda bmp: onLoaded(bmp, "32x32"))
+            msg = bitmapMgr.loadBitmap("media/rgb24-65x65.png", 
+                    lambda bmp: onLoaded(bmp, "65x65"))
+            msg.priority = 10
+            self.assertEqual(msg.priority, 10)
+            # Both requests for rgb24-64x64.png share one job.
+            self.assertEqual(bitmapMgr.getNumPendingJobs(), 3)
+            # All jobs are queued before the loader thread starts, so it picks them in 
+            # order of priority.
+            bitmapMgr.setNumThreads(1)
+            player.subscribe(player.ON_FRAME, onFrame)
+            # Frame times are fake, so this is generous to allow for slow machines.
+            player.setTimeout(20000, lambda: self.fail("BitmapManager didn't reply"))
+            player.play()
+        finally:
+            bitmapMgr.setNumThreads(1)
+            bitmapMgr.deliverybudget = 0
+
     def testBitmapManagerException(self):
         def bitmapCb(bitmap):
             raise RuntimeError
@@ -546,6 +693,39 @@ class ImageTestCase(AVGTestCase):
                  checkAlpha,
                 ])
 
+    def testImageCache(self):
+        def addNodes(y):
+            for x in (16, 48, 80, 112):
+                avg.ImageNode(pos=(x, y), href="rgb24-32x32.png", parent=root)
+
+        def checkStats():
+            self.assertEqual(cache.getNumHits()+cache.getNumMisses(), 8)
+            self.assert_(cache.getNumMisses() <= 1)
+            self.assert_(cache.getHitRate() >= 7/8.)
+            self.assert_(cache.getMemUsed() >= 32*32*3)
+
+        def removeNodes():
+            while root.getNumChildren() > 0:
+                root.getChild(0).unlink(True)
+            cache.setBudget(0)
+            self.assertEqual(cache.getNumEntries(), 0)
+            self.assertEqual(cache.getMemUsed(), 0)
+            cache.setBudget(oldBudget)
+
+        cache = avg.ImageCache.get()
+        oldBudget = cache.getBudget()
+        root = self.loadEmptyScene()
+        cache.clear()
+        cache.resetStatistics()
+        addNodes(16)
+        self.start(False,
+                (lambda: self.compareImage("testImgPos1"),
+                 lambda: addNodes(48),
+                 lambda: self.compareImage("testImgPos2"),
+                 checkStats,
+                 removeNodes,
+                ))
+
     def testSpline(self):
         spline = avg.CubicSpline([(0,3),(1,2),(2,1),(3,0)])
         self.assertAlmostEqual(spline.interpolate(0), 3)
@@ -566,11 +746,14 @@ def imageTestSuite(tests):
     availableTests = (
             "testImageHRef",
             "testImagePos",
+            "testBatchRendering",
             "testImageSize",
             "testImageWarp",
             "testBitmap",
+            "testTextureUploadBudget",
             "testBitmapManager",
             "testBitmapManagerException",
+            "testBitmapManagerRequests",
             "testBlendMode",
             "testImageMask",
             "testImageMaskCanvas",
@@ -578,6 +761,7 @@ def imageTestSuite(tests):
             "testImageMaskSize",
             "testImageMipmap",
             "testImageCompression",
+            "testImageCache",
             "testSpline",
             )
     return createAVGTestSuite(availableTests, ImageTestCase, tests)
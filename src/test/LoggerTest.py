@@ -83,6 +83,16 @@ class LoggerTestCase(AVGTestCase):
     def testUnknownCategoryWarning(self):
         self.assertException(lambda: logger.error("Foo", "Bar"))
 
+    def testAsyncLog(self):
+        logger.configureCategory(logger.Category.APP, logger.Severity.INFO)
+        logger.setAsync(True)
+        self.assert_(logger.isAsync())
+        logger.info(self.testMsg)
+        logger.flush()
+        logger.setAsync(False)
+        self.assert_(not(logger.isAsync()))
+        self._assertMsg()
+
 
 def loggerTestSuite(tests):
     availableTests = (
@@ -92,5 +102,6 @@ def loggerTestSuite(tests):
             "testOmitCategory",
             "testLogCategory",
             "testUnknownCategoryWarning",
+            "testAsyncLog",
             )
     return createAVGTestSuite(availableTests, LoggerTestCase, tests)
@@ -275,6 +275,47 @@ class OffscreenTestCase(AVGTestCase):
                  lambda: self.compareImage("testOffscreenAutoRender2")
                 ))
 
+    def testCanvasSkipUnchanged(self):
+        def storeFrameCounts():
+            self.__numRendered = self.__offscreenCanvas.numrenderedframes
+            self.__numSkipped = self.__offscreenCanvas.numskippedframes
+
+        def assertSkipped():
+            self.assertEqual(self.__offscreenCanvas.numrenderedframes, 
+                    self.__numRendered)
+            self.assert_(self.__offscreenCanvas.numskippedframes > self.__numSkipped)
+
+        def assertRendered():
+            self.assert_(self.__offscreenCanvas.numrenderedframes > self.__numRendered)
+
+        def changeContent():
+            self.__offscreenCanvas.getElementByID("test1").x = 42
+
+        def addNode():
+            avg.RectNode(pos=(2,2), size=(20,20), fillcolor="FF0000", fillopacity=1,
+                    parent=self.__offscreenCanvas.getRootNode())
+
+        root = self.loadEmptyScene()
+        self.__offscreenCanvas = self.__createOffscreenCanvas("testcanvas", False)
+        avg.ImageNode(href="canvas:testcanvas", parent=root)
+        self.start(False,
+                (None,
+                 storeFrameCounts,
+                 None,
+                 assertSkipped,
+                 lambda: self.compareImage("testOffscreenAutoRender1"),
+                 storeFrameCounts,
+                 changeContent,
+                 assertRendered,
+                 lambda: self.compareImage("testOffscreenAutoRender2"),
+                 storeFrameCounts,
+                 addNode,
+                 assertRendered,
+                 storeFrameCounts,
+                 lambda: self.__offscreenCanvas.render(),
+                 assertRendered,
+                ))
+
     def testCanvasCrop(self):
         root = self.loadEmptyScene()
         canvas = player.createCanvas(id="testcanvas", size=(160,120), 
@@ -459,6 +500,7 @@ def offscreenTestSuite(tests):
                 "testCanvasEventCapture",
                 "testCanvasRender",
                 "testCanvasAutoRender",
+                "testCanvasSkipUnchanged",
                 "testCanvasCrop",
                 "testCanvasAlpha",
                 "testCanvasBlendModes",
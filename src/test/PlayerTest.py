@@ -21,6 +21,7 @@
 
 import math
 import threading
+import json
 
 from libavg import avg, player
 from testcase import *
@@ -145,6 +146,50 @@ class PlayerTestCase(AVGTestCase):
                 (checkTime,
                 ))
 
+    def testFrameStats(self):
+        def checkStats():
+            stats = player.getFrameStats()
+            self.assert_(stats.numframes > 0)
+            self.assert_(stats.frame.p50 <= stats.frame.p95 <= stats.frame.p99
+                    <= stats.frame.max)
+            self.assert_(stats.render.max <= stats.frame.max)
+            player.dumpFrameStats("framestats.csv")
+            lines = open("framestats.csv").readlines()
+            os.remove("framestats.csv")
+            self.assertEqual(lines[0].strip(),
+                    "frametime,frame,timers,events,offscreen,render,wait,swap,late")
+            self.assertEqual(len(lines), stats.numframes+1)
+
+        self.loadEmptyScene()
+        self.start(False,
+                (None,
+                 None,
+                 checkStats,
+                ))
+
+    def testTracing(self):
+        def stopTracing():
+            avg.tracer.stop()
+            avg.tracer.writeChromeTrace("trace.json")
+            trace = json.load(open("trace.json"))
+            os.remove("trace.json")
+            events = trace["traceEvents"]
+            threadNames = [event["args"]["name"] for event in events
+                    if event["ph"] == "M"]
+            self.assert_("main" in threadNames)
+            frameEvents = [event for event in events
+                    if event["name"] == "Player - Total frame time"]
+            self.assert_(len(frameEvents) >= 2)
+            self.assertEqual(avg.tracer.getNumDroppedEvents(), 0)
+
+        self.loadEmptyScene()
+        avg.tracer.start()
+        self.start(False,
+                (None,
+                 None,
+                 stopTracing,
+                ))
+
     def testDivResize(self):
         def checkSize (w, h):
             self.assertEqual(node.width, w)
@@ -251,6 +296,52 @@ class PlayerTestCase(AVGTestCase):
                  lambda: self.compareImage("testRotatePivot3"),
                 ))
 
+    def testHitTest(self):
+        def checkHits(expected):
+            for pos, node in expected:
+                self.assertEqual(root.getElementByPos(pos), node)
+
+        def moveNodes():
+            div.pos = (100, 50)
+            circle.pos = (20, 20)
+
+        def rotateNodes():
+            image.angle = 0.79
+            rect.angle = 0.79
+
+        def setRectSensitive(sensitive):
+            rect.sensitive = sensitive
+
+        def setDivActive(active):
+            div.active = active
+
+        root = self.loadEmptyScene()
+        div = avg.DivNode(pos=(10,10), parent=root)
+        image = avg.ImageNode(pos=(0,0), href="rgb24-65x65.png", parent=div)
+        rect = avg.RectNode(pos=(40,40), size=(40,40), parent=div)
+        circle = avg.CircleNode(pos=(100,20), r=10, parent=root)
+        self.start(False,
+                (lambda: checkHits((((5,5), root), ((15,15), image), ((60,60), rect),
+                        ((100,20), circle), ((100,100), root))),
+                 moveNodes,
+                 lambda: checkHits((((15,15), root), ((105,55), image),
+                        ((150,100), rect), ((20,20), circle), ((100,20), root))),
+                 rotateNodes,
+                 # Corners of the unrotated image and rect are now outside of them.
+                 lambda: checkHits((((101,51), root), ((132,82), image),
+                        ((141,91), image), ((158,115), rect))),
+                 lambda: setRectSensitive(False),
+                 lambda: checkHits((((158,115), root),)),
+                 lambda: setRectSensitive(True),
+                 lambda: setDivActive(False),
+                 lambda: checkHits((((132,82), root), ((158,115), root))),
+                 lambda: setDivActive(True),
+                 rect.unlink,
+                 lambda: checkHits((((158,115), root), ((132,82), image))),
+                 lambda: div.appendChild(rect),
+                 lambda: checkHits((((158,115), rect),)),
+                ))
+
     def testOpacity(self):
         root = self.loadEmptyScene()
         avg.ImageNode(pos=(0,0), href="rgb24-65x65.png", opacity=0.5, parent=root)
@@ -420,6 +511,34 @@ class PlayerTestCase(AVGTestCase):
             </avg>
         """)
 
+    def testNodeArgs(self):
+        # Arguments that aren't set share their values with the type's templates, so
+        # setting them on one node mustn't change the defaults of other nodes.
+        for i in range(2):
+            node = player.createNode("""<image id="img" href="rgb24-64x64.png"
+                    pos="(10,20)" opacity="0.5" sensitive="False" maxtilewidth="32"/>""")
+            self.assertEqual(node.id, "img")
+            self.assertEqual(node.href, "rgb24-64x64.png")
+            self.assertEqual(node.pos, (10,20))
+            self.assertAlmostEqual(node.opacity, 0.5)
+            self.assert_(not(node.sensitive))
+            self.assertEqual(node.maxtilewidth, 32)
+            node = player.createNode("<image/>")
+            self.assertEqual(node.id, "")
+            self.assertEqual(node.pos, (0,0))
+            self.assertEqual(node.opacity, 1)
+            self.assert_(node.sensitive)
+            node = avg.ImageNode(pos=(30,40), opacity=0.25)
+            self.assertEqual(node.pos, (30,40))
+            self.assertAlmostEqual(node.opacity, 0.25)
+        node = player.createNode("<polyline pos='((10,10),(20,20))' texcoords='(0,1)'/>")
+        self.assertEqual(len(node.pos), 2)
+        self.assertEqual(node.pos[1], (20,20))
+        self.assertEqual(len(node.texcoords), 2)
+        self.assertException(lambda: player.createNode("<image invalidattr='1'/>"))
+        self.assertException(lambda: avg.ImageNode(invalidattr=1))
+        self.assertException(lambda: avg.ImageNode(opacity="bla"))
+
     def testMove(self):
         def moveit():
             node = player.getElementByID("nestedimg1")
@@ -822,10 +941,13 @@ def playerTestSuite(tests):
             "testBasics",
             "testColorParse",
             "testFakeTime",
+            "testFrameStats",
+            "testTracing",
             "testDivResize",
             "testRotate",
             "testRotate2",
             "testRotatePivot",
+            "testHitTest",
             "testOpacity",
             "testOutlines",
             "testWordsOutlines",
@@ -837,6 +959,7 @@ def playerTestSuite(tests):
             "testCallFromThread",
             "testAVGFile",
             "testBroken",
+            "testNodeArgs",
             "testMove",
             "testCropImage",
             "testCropMovie",
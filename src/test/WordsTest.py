@@ -374,6 +374,93 @@ class WordsTestCase(AVGTestCase):
                  changeTextWithInvalidTag
                 ))
 
+    def testGlyphCache(self):
+        # Text rendered from the glyph atlas should look like the per-node texture.
+        def changeText():
+            words.text = "blue" 
+            words.color = "404080"
+            words.x += 10
+        
+        def changeFont():
+            words.font = "Bitstream Vera Sans"
+            words.height = 28
+            words.height = 0
+            words.fontsize = 30
+        
+        def changeFont2():
+            words.fontsize = 18
+
+        def toggleGlyphCache():
+            words.glyphcache = False
+            self.assertEqual(words.glyphcache, False)
+            words.glyphcache = True
+        
+        def setDecoratedText():
+            # Underlines aren't glyphs, so this falls back to the per-node texture.
+            words.text = "<u>blue</u>"
+
+        def checkDecoratedText():
+            self.assertEqual(words.text, "<u>blue</u>")
+            # The pages used before are still cached and uploaded.
+            self.assert_(glyphCache.getNumPages() >= 1)
+            self.assert_(glyphCache.getNumTextures() >= 1)
+
+        glyphCache = avg.GlyphCache.get()
+        root = self.loadEmptyScene()
+        words = avg.WordsNode(pos=(1,1), fontsize=12, font="Bitstream Vera Sans",
+                text="foo", glyphcache=True, parent=root)
+        self.assert_(words.glyphcache)
+        self.start(True, 
+                (lambda: self.compareImage("testDynamicWords1"),
+                 changeText,
+                 changeFont,
+                 lambda: self.compareImage("testDynamicWords2"),
+                 toggleGlyphCache,
+                 lambda: self.compareImage("testDynamicWords2"),
+                 changeFont2,
+                 lambda: self.compareImage("testDynamicWords4"),
+                 setDecoratedText,
+                 checkDecoratedText,
+                ))
+        # The pages stay in the cache, but their textures go away with the GL context.
+        self.assert_(glyphCache.getNumPages() >= 1)
+        self.assertEqual(glyphCache.getNumTextures(), 0)
+
+    def testAsyncRender(self):
+        WAIT_TIMEOUT = 2000
+        def onFirstText():
+            self.assertEqual(asyncWords.size, syncWords.size)
+            player.setTimeout(0, changeText)
+            asyncWords.unsubscribe(avg.Node.TEXT_RENDERED, onFirstText)
+            asyncWords.subscribe(avg.Node.TEXT_RENDERED, onSecondText)
+
+        def changeText():
+            oldSize = asyncWords.size
+            asyncWords.text = "A somewhat longer text"
+            syncWords.text = "A somewhat longer text"
+            # The old text stays until the new one has been rendered.
+            self.assertEqual(asyncWords.size, oldSize)
+
+        def onSecondText():
+            self.assertEqual(asyncWords.size, syncWords.size)
+            player.stop()
+
+        def reportStuck():
+            player.stop()
+            raise RuntimeError("Async text wasn't rendered within %dms timeout" 
+                    % WAIT_TIMEOUT)
+
+        root = self.loadEmptyScene()
+        asyncWords = avg.WordsNode(pos=(1,1), fontsize=12, font="Bitstream Vera Sans",
+                text="foo", asyncrender=True, parent=root)
+        syncWords = avg.WordsNode(pos=(1,31), fontsize=12, font="Bitstream Vera Sans",
+                text="foo", parent=root)
+        self.assert_(asyncWords.asyncrender)
+        asyncWords.subscribe(avg.Node.TEXT_RENDERED, onFirstText)
+        player.setTimeout(WAIT_TIMEOUT, reportStuck)
+        player.setFakeFPS(-1)
+        player.play()
+
     def testI18NWords(self):
         def changeUnicodeText():
             words.text = "Arabic nonsense: ﯿﭗ"
@@ -683,6 +770,8 @@ def wordsTestSuite(tests):
             "testHinting",
             "testSpanWords",
             "testDynamicWords",
+            "testGlyphCache",
+            "testAsyncRender",
             "testI18NWords",
             "testRawText",
             "testWordsBR",
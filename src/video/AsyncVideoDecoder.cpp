@@ -43,13 +43,16 @@ using boost::dynamic_pointer_cast;
 #define AUDIO_STATUS_QUEUE_LENGTH -1
 #define PACKET_QUEUE_LENGTH 50
 
+// Bounded queues with a single producer don't need to lock. This keeps the audio
+// callback and the decoder threads from contending for queue mutexes. The command
+// queues and the audio status queue are unbounded and stay mutex-based.
+#define LOCK_FREE_QUEUES true
+
 namespace avg {
 
 AsyncVideoDecoder::AsyncVideoDecoder(int queueLength)
     : m_QueueLength(queueLength),
-      m_pDemuxThread(0),
-      m_pVDecoderThread(0),
-      m_pADecoderThread(0),
+      m_Priority(VideoDecoderPool::PLAYING),
       m_bUseStreamFPS(true),
       m_FPS(0)
 {
@@ -58,7 +61,7 @@ AsyncVideoDecoder::AsyncVideoDecoder(int queueLength)
 
 AsyncVideoDecoder::~AsyncVideoDecoder()
 {
-    if (m_pVDecoderThread || m_pADecoderThread) {
+    if (m_pVDecoderTask || m_pADecoderTask) {
         close();
     }
     ObjectCounter::get()->decRef(&typeid(*this));
@@ -72,6 +75,7 @@ void AsyncVideoDecoder::open(const std::string& sFilename, bool bUseHardwareAcce
     m_NumASeeksDone = 0;
     m_bAudioEOF = false;
     m_bVideoEOF = false;
+    m_bVideoLoopEnd = false;
     m_bWasVSeeking = false;
     m_bWasSeeking = false;
     m_CurVideoFrameTime = -1;
@@ -87,7 +91,7 @@ void AsyncVideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP
 {
     VideoDecoder::startDecoding(bDeliverYCbCr, pAP);
 
-    AVG_ASSERT(!m_pDemuxThread);
+    AVG_ASSERT(!m_pDemuxTask);
     vector<int> streamIndexes;
     if (getVStreamIndex() >= 0) {
         streamIndexes.push_back(getVStreamIndex());
@@ -104,21 +108,24 @@ void AsyncVideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP
             m_FPS = getStreamFPS();
         }
         m_pVCmdQ = VideoDecoderThread::CQueuePtr(new VideoDecoderThread::CQueue);
-        m_pVMsgQ = VideoMsgQueuePtr(new VideoMsgQueue(m_QueueLength));
+        m_pVMsgQ = VideoMsgQueuePtr(new VideoMsgQueue(m_QueueLength,
+                LOCK_FREE_QUEUES && m_QueueLength > 0));
         VideoMsgQueue& packetQ = *m_PacketQs[getVStreamIndex()];
 
-        m_pVDecoderThread = new boost::thread(VideoDecoderThread(
+        m_pVDecoderTask = VideoDecoderPool::get()->addWorker(VideoDecoderThread(
                 *m_pVCmdQ, *m_pVMsgQ, packetQ, getVideoStream(), 
-                getSize(), getPixelFormat(), usesVDPAU()));
+                getSize(), getPixelFormat(), usesVDPAU()), m_Priority);
     }
     
     if (getVideoInfo().m_bHasAudio) {
         m_pACmdQ = AudioDecoderThread::CQueuePtr(new AudioDecoderThread::CQueue);
-        m_pAMsgQ = AudioMsgQueuePtr(new AudioMsgQueue(AUDIO_MSG_QUEUE_LENGTH));
+        m_pAMsgQ = AudioMsgQueuePtr(new AudioMsgQueue(AUDIO_MSG_QUEUE_LENGTH,
+                LOCK_FREE_QUEUES));
         m_pAStatusQ = AudioMsgQueuePtr(new AudioMsgQueue(AUDIO_STATUS_QUEUE_LENGTH));
         VideoMsgQueue& packetQ = *m_PacketQs[getAStreamIndex()];
-        m_pADecoderThread = new boost::thread(
-                AudioDecoderThread(*m_pACmdQ, *m_pAMsgQ, packetQ, getAudioStream(), *pAP));
+        m_pADecoderTask = VideoDecoderPool::get()->addWorker(
+                AudioDecoderThread(*m_pACmdQ, *m_pAMsgQ, packetQ, getAudioStream(), *pAP),
+                m_Priority);
         m_LastAudioFrameTime = 0;
     }
 }
@@ -127,29 +134,32 @@ void AsyncVideoDecoder::close()
 {
     AVG_ASSERT(getState() != CLOSED);
 
-    if (m_pDemuxThread) {
+    VideoDecoderPool* pPool = VideoDecoderPool::get();
+    if (m_pDemuxTask) {
         m_pDemuxCmdQ->pushCmd(boost::bind(&VideoDemuxerThread::close, _1));
-        m_pDemuxThread->join();
+        pPool->waitForTask(m_pDemuxTask);
     }
 
-    if (m_pVDecoderThread) {
+    if (m_pVDecoderTask) {
         m_pVMsgQ->clear();
-        m_pVDecoderThread->join();
-        delete m_pVDecoderThread;
-        m_pVDecoderThread = 0;
+        pPool->waitForTask(m_pVDecoderTask);
+        m_pVDecoderTask = VideoDecoderTaskPtr();
         m_pVMsgQ = VideoMsgQueuePtr();
+        // Pending commands can hold pooled frame buffers. These need to be deleted 
+        // while the GL context still exists.
+        m_pVCmdQ->clear();
+        m_pFramePool = VideoFramePoolPtr();
     }
-    if (m_pADecoderThread) {
+    if (m_pADecoderTask) {
         m_pAMsgQ->clear();
         m_pAStatusQ->clear();
-        m_pADecoderThread->join();
-        delete m_pADecoderThread;
-        m_pADecoderThread = 0;
+        pPool->waitForTask(m_pADecoderTask);
+        m_pADecoderTask = VideoDecoderTaskPtr();
         m_pAStatusQ = AudioMsgQueuePtr();
         m_pAMsgQ = AudioMsgQueuePtr();
     }
     VideoDecoder::close();
-    if (m_pDemuxThread) {
+    if (m_pDemuxTask) {
         deleteDemuxer();
     }
 }
@@ -159,9 +169,11 @@ void AsyncVideoDecoder::seek(float destTime)
     AVG_ASSERT(getState() == DECODING);
     m_bAudioEOF = false;
     m_bVideoEOF = false;
+    m_bVideoLoopEnd = false;
     m_NumSeeksSent++;
     m_pDemuxCmdQ->pushCmd(boost::bind(&VideoDemuxerThread::seek, _1, m_NumSeeksSent,
             destTime));
+    VideoDecoderPool::get()->wake();
 }
 
 void AsyncVideoDecoder::loop()
@@ -169,7 +181,12 @@ void AsyncVideoDecoder::loop()
     m_LastVideoFrameTime = -1;
     m_bAudioEOF = false;
     m_bVideoEOF = false;
-    seek(0);
+    if (m_bVideoLoopEnd) {
+        // The frames from the start of the file are already in the queue.
+        m_bVideoLoopEnd = false;
+    } else {
+        seek(0);
+    }
 }
 
 int AsyncVideoDecoder::getCurFrame() const
@@ -202,7 +219,7 @@ float AsyncVideoDecoder::getFPS() const
 
 void AsyncVideoDecoder::setFPS(float fps)
 {
-    AVG_ASSERT(!m_pADecoderThread);
+    AVG_ASSERT(!m_pADecoderTask);
     m_pVCmdQ->pushCmd(boost::bind(&VideoDecoderThread::setFPS, _1, fps));
     m_bUseStreamFPS = (fps == 0);
     if (m_bUseStreamFPS) {
@@ -212,45 +229,96 @@ void AsyncVideoDecoder::setFPS(float fps)
     }
 }
 
-static ProfilingZoneID VDPAUDecodeProfilingZone("AsyncVideoDecoder: VDPAU", true);
-
 FrameAvailableCode AsyncVideoDecoder::renderToBmps(vector<BitmapPtr>& pBmps,
         float timeWanted)
 {
-    AVG_ASSERT(getState() == DECODING);
     FrameAvailableCode frameAvailable;
-    VideoMsgPtr pFrameMsg;
-    if (timeWanted == -1) {
-        waitForSeekDone();
-        pFrameMsg = getNextBmps(true);
-        frameAvailable = FA_NEW_FRAME;
-    } else {
-        pFrameMsg = getBmpsForTime(timeWanted, frameAvailable);
+    VideoMsgPtr pFrameMsg = getFrameMsg(timeWanted, frameAvailable);
+    if (frameAvailable == FA_NEW_FRAME) {
+        copyFrameToBmps(pFrameMsg, pBmps);
     }
+    return frameAvailable;
+}
+
+static ProfilingZoneID FramePoolUploadProfilingZone("AsyncVideoDecoder: Upload frame", 
+        true);
+
+FrameAvailableCode AsyncVideoDecoder::renderToTexture(GLTexturePtr pTextures[4],
+        float timeWanted)
+{
+    FrameAvailableCode frameAvailable;
+    VideoMsgPtr pFrameMsg = getFrameMsg(timeWanted, frameAvailable);
     if (frameAvailable == FA_NEW_FRAME) {
-        AVG_ASSERT(pFrameMsg);
-        m_LastVideoFrameTime = pFrameMsg->getFrameTime();
-        m_CurVideoFrameTime = m_LastVideoFrameTime;
-        if (pFrameMsg->getType() == VideoMsg::VDPAU_FRAME) {
-#ifdef AVG_ENABLE_VDPAU
-            ScopeTimer timer(VDPAUDecodeProfilingZone);
-            vdpau_render_state* pRenderState = pFrameMsg->getRenderState();
-            if (pixelFormatIsPlanar(getPixelFormat())) {
-                getPlanesFromVDPAU(pRenderState, pBmps[0], pBmps[1], pBmps[2]);
-            } else {
-                getBitmapFromVDPAU(pRenderState, pBmps[0]);
-            }
-#endif
+        VideoFrameBufferPtr pFrameBuffer;
+        if (pFrameMsg->getType() == VideoMsg::FRAME) {
+            pFrameBuffer = pFrameMsg->getFrameBuffer();
+        }
+        if (pFrameBuffer) {
+            // The decoder has written the frame directly to the upload buffers.
+            ScopeTimer timer(FramePoolUploadProfilingZone);
+            pFrameBuffer->moveToTextures(pTextures);
+            m_pFramePool->returnBuffer(pFrameBuffer);
         } else {
-            for (unsigned i = 0; i < pBmps.size(); ++i) {
-                pBmps[i]->copyPixels(*(pFrameMsg->getFrameBitmap(i)));
+            int numPlanes = getNumPixelFormatPlanes(getPixelFormat());
+            vector<BitmapPtr> pBmps;
+            for (int i = 0; i < numPlanes; ++i) {
+                pBmps.push_back(pTextures[i]->lockStreamingBmp());
+            }
+            copyFrameToBmps(pFrameMsg, pBmps);
+            for (int i = 0; i < numPlanes; ++i) {
+                pTextures[i]->unlockStreamingBmp(true);
             }
-            returnFrame(pFrameMsg);
         }
     }
     return frameAvailable;
 }
 
+void AsyncVideoDecoder::setFramePool(VideoFramePoolPtr pFramePool)
+{
+    AVG_ASSERT(getState() == DECODING);
+    AVG_ASSERT(m_pVCmdQ);
+    m_pFramePool = pFramePool;
+    m_pVCmdQ->pushCmd(boost::bind(&VideoDecoderThread::setFramePool, _1, pFramePool));
+}
+
+void AsyncVideoDecoder::setLoop(bool bLoop)
+{
+    AVG_ASSERT(getState() == DECODING);
+    m_pDemuxCmdQ->pushCmd(boost::bind(&VideoDemuxerThread::setLoop, _1, bLoop));
+    if (m_pACmdQ) {
+        float loopDuration = bLoop ? getLoopDuration() : 0;
+        m_pACmdQ->pushCmd(boost::bind(&AudioDecoderThread::setLoopDuration, _1,
+                loopDuration));
+    }
+}
+
+bool AsyncVideoDecoder::isAtLoopEnd() const
+{
+    return m_bVideoLoopEnd;
+}
+
+float AsyncVideoDecoder::getLoopDuration() const
+{
+    // Gapless loops of files with audio have the length of the longer stream. 
+    // The shorter stream waits (video) or is padded with silence (audio).
+    if (getVideoInfo().m_bHasAudio && getVideoInfo().m_bHasVideo) {
+        return max(getDuration(SS_VIDEO), getDuration(SS_AUDIO));
+    } else {
+        return 0;
+    }
+}
+
+void AsyncVideoDecoder::setPriority(VideoDecoderPool::Priority priority)
+{
+    m_Priority = priority;
+    VideoDecoderTaskPtr pTasks[] = {m_pDemuxTask, m_pVDecoderTask, m_pADecoderTask};
+    for (int i = 0; i < 3; ++i) {
+        if (pTasks[i]) {
+            pTasks[i]->setPriority(priority);
+        }
+    }
+}
+
 void AsyncVideoDecoder::updateAudioStatus()
 {
     if (m_pAStatusQ) {
@@ -265,6 +333,10 @@ void AsyncVideoDecoder::updateAudioStatus()
 bool AsyncVideoDecoder::isEOF() const
 {
     AVG_ASSERT(getState() == DECODING);
+    if (m_bVideoLoopEnd) {
+        // In loop mode, the audio stream continues seamlessly and never reports EOF.
+        return true;
+    }
     bool bEOF = true;
     if (getVideoInfo().m_bHasAudio && !m_bAudioEOF) {
         bEOF = false;
@@ -280,6 +352,9 @@ void AsyncVideoDecoder::throwAwayFrame(float timeWanted)
     AVG_ASSERT(getState() == DECODING);
     FrameAvailableCode frameAvailable;
     VideoMsgPtr pFrameMsg = getBmpsForTime(timeWanted, frameAvailable);
+    if (pFrameMsg && pFrameMsg->getType() == VideoMsg::FRAME) {
+        returnFrame(pFrameMsg);
+    }
 }
 
 AudioMsgQueuePtr AsyncVideoDecoder::getAudioMsgQ()
@@ -296,17 +371,18 @@ void AsyncVideoDecoder::setupDemuxer(vector<int> streamIndexes)
 {
     m_pDemuxCmdQ = VideoDemuxerThread::CQueuePtr(new VideoDemuxerThread::CQueue());    
     for (unsigned i = 0; i < streamIndexes.size(); ++i) {
-        VideoMsgQueuePtr pPacketQ(new VideoMsgQueue(PACKET_QUEUE_LENGTH));
+        VideoMsgQueuePtr pPacketQ(new VideoMsgQueue(PACKET_QUEUE_LENGTH,
+                LOCK_FREE_QUEUES));
         m_PacketQs[streamIndexes[i]] = pPacketQ;
     }
-    m_pDemuxThread = new boost::thread(VideoDemuxerThread(*m_pDemuxCmdQ,
-            getFormatContext(), m_PacketQs));
+    m_pDemuxTask = VideoDecoderPool::get()->addWorker(VideoDemuxerThread(*m_pDemuxCmdQ,
+            getFormatContext(), m_PacketQs, getVStreamIndex(), getKeyframeIndex()),
+            m_Priority);
 }
 
 void AsyncVideoDecoder::deleteDemuxer()
 {
-    delete m_pDemuxThread;
-    m_pDemuxThread = 0;
+    m_pDemuxTask = VideoDecoderTaskPtr();
     map<int, VideoMsgQueuePtr>::iterator it;
     for (it = m_PacketQs.begin(); it != m_PacketQs.end(); it++) {
         VideoMsgQueuePtr pPacketQ = it->second;
@@ -319,6 +395,48 @@ void AsyncVideoDecoder::deleteDemuxer()
     }
 }
 
+VideoMsgPtr AsyncVideoDecoder::getFrameMsg(float timeWanted, 
+        FrameAvailableCode& frameAvailable)
+{
+    AVG_ASSERT(getState() == DECODING);
+    VideoMsgPtr pFrameMsg;
+    if (timeWanted == -1) {
+        waitForSeekDone();
+        pFrameMsg = getNextBmps(true);
+        frameAvailable = FA_NEW_FRAME;
+    } else {
+        pFrameMsg = getBmpsForTime(timeWanted, frameAvailable);
+    }
+    if (frameAvailable == FA_NEW_FRAME) {
+        AVG_ASSERT(pFrameMsg);
+        m_LastVideoFrameTime = pFrameMsg->getFrameTime();
+        m_CurVideoFrameTime = m_LastVideoFrameTime;
+    }
+    return pFrameMsg;
+}
+
+static ProfilingZoneID VDPAUDecodeProfilingZone("AsyncVideoDecoder: VDPAU", true);
+
+void AsyncVideoDecoder::copyFrameToBmps(VideoMsgPtr pFrameMsg, vector<BitmapPtr>& pBmps)
+{
+    if (pFrameMsg->getType() == VideoMsg::VDPAU_FRAME) {
+#ifdef AVG_ENABLE_VDPAU
+        ScopeTimer timer(VDPAUDecodeProfilingZone);
+        vdpau_render_state* pRenderState = pFrameMsg->getRenderState();
+        if (pixelFormatIsPlanar(getPixelFormat())) {
+            getPlanesFromVDPAU(pRenderState, pBmps[0], pBmps[1], pBmps[2]);
+        } else {
+            getBitmapFromVDPAU(pRenderState, pBmps[0]);
+        }
+#endif
+    } else {
+        for (unsigned i = 0; i < pBmps.size(); ++i) {
+            pBmps[i]->copyPixels(*(pFrameMsg->getFrameBitmap(i)));
+        }
+        returnFrame(pFrameMsg);
+    }
+}
+
 VideoMsgPtr AsyncVideoDecoder::getBmpsForTime(float timeWanted, 
         FrameAvailableCode& frameAvailable)
 {
@@ -383,6 +501,8 @@ VideoMsgPtr AsyncVideoDecoder::getNextBmps(bool bWait)
 {
     VideoMsgPtr pMsg = m_pVMsgQ->pop(bWait);
     if (pMsg) {
+        // There's room in the queue for the decoder again.
+        VideoDecoderPool::get()->wake();
         switch (pMsg->getType()) {
             case VideoMsg::FRAME:
             case VideoMsg::VDPAU_FRAME:
@@ -391,6 +511,10 @@ VideoMsgPtr AsyncVideoDecoder::getNextBmps(bool bWait)
                 m_NumVSeeksDone = m_NumSeeksSent;
                 m_bVideoEOF = true;
                 return VideoMsgPtr();
+            case VideoMsg::LOOP_END:
+                m_bVideoEOF = true;
+                m_bVideoLoopEnd = true;
+                return VideoMsgPtr();
             case VideoMsg::ERROR:
                 m_bVideoEOF = true;
                 return VideoMsgPtr();
@@ -445,6 +569,9 @@ void AsyncVideoDecoder::handleVSeekMsg(VideoMsgPtr pMsg)
             m_NumVSeeksDone = m_NumSeeksSent;
             m_bVideoEOF = true;
             break;
+        case VideoMsg::LOOP_END:
+            // Loop boundary from before the seek.
+            break;
         default:
             // TODO: Handle ERROR messages here.
             AVG_ASSERT(false);
@@ -488,6 +615,13 @@ void AsyncVideoDecoder::returnFrame(VideoMsgPtr pFrameMsg)
 {
     if (pFrameMsg) {
         AVG_ASSERT(pFrameMsg->getType() == VideoMsg::FRAME);
+        VideoFrameBufferPtr pFrameBuffer = pFrameMsg->getFrameBuffer();
+        if (pFrameBuffer) {
+            // Skipped frame: The buffer hasn't been touched, so it can be reused 
+            // immediately.
+            m_pFramePool->returnBuffer(pFrameBuffer);
+            return;
+        }
         m_pVCmdQ->pushCmd(boost::bind(&VideoDecoderThread::returnFrame, _1, pFrameMsg));
     }
 }
@@ -28,6 +28,8 @@
 #include "VideoDecoderThread.h"
 #include "AudioDecoderThread.h"
 #include "VideoMsg.h"
+#include "VideoFramePool.h"
+#include "VideoDecoderPool.h"
 
 #include "../graphics/Bitmap.h"
 #include "../audio/AudioParams.h"
@@ -57,6 +59,13 @@ public:
 
     virtual FrameAvailableCode renderToBmps(std::vector<BitmapPtr>& pBmps, 
             float timeWanted);
+    virtual FrameAvailableCode renderToTexture(GLTexturePtr pTextures[4],
+            float timeWanted);
+    void setFramePool(VideoFramePoolPtr pFramePool);
+    void setLoop(bool bLoop);
+    bool isAtLoopEnd() const;
+    float getLoopDuration() const;
+    void setPriority(VideoDecoderPool::Priority priority);
     void updateAudioStatus();
     virtual bool isEOF() const;
     virtual void throwAwayFrame(float timeWanted);
@@ -67,6 +76,8 @@ public:
 private:
     void setupDemuxer(std::vector<int> streamIndexes);
     void deleteDemuxer();
+    VideoMsgPtr getFrameMsg(float timeWanted, FrameAvailableCode& frameAvailable);
+    void copyFrameToBmps(VideoMsgPtr pFrameMsg, std::vector<BitmapPtr>& pBmps);
     VideoMsgPtr getBmpsForTime(float timeWanted, FrameAvailableCode& frameAvailable);
     VideoMsgPtr getNextBmps(bool bWait);
     void waitForSeekDone();
@@ -79,16 +90,18 @@ private:
     bool isVSeeking() const;
 
     int m_QueueLength;
+    VideoDecoderPool::Priority m_Priority;
 
-    boost::thread* m_pDemuxThread;
+    VideoDecoderTaskPtr m_pDemuxTask;
     std::map<int, VideoMsgQueuePtr> m_PacketQs;
     VideoDemuxerThread::CQueuePtr m_pDemuxCmdQ;
 
-    boost::thread* m_pVDecoderThread;
+    VideoDecoderTaskPtr m_pVDecoderTask;
     VideoDecoderThread::CQueuePtr m_pVCmdQ;
     VideoMsgQueuePtr m_pVMsgQ;
+    VideoFramePoolPtr m_pFramePool;
 
-    boost::thread* m_pADecoderThread;
+    VideoDecoderTaskPtr m_pADecoderTask;
     AudioDecoderThread::CQueuePtr m_pACmdQ;
     AudioMsgQueuePtr m_pAMsgQ;
     AudioMsgQueuePtr m_pAStatusQ;
@@ -104,6 +117,7 @@ private:
 
     bool m_bAudioEOF;
     bool m_bVideoEOF;
+    bool m_bVideoLoopEnd;
 
     float m_LastVideoFrameTime;
     float m_CurVideoFrameTime;
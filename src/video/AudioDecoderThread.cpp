@@ -39,6 +39,10 @@ using namespace std;
 
 namespace avg {
 
+// One packet usually decodes to a single audio message, but some codecs deliver more.
+// If there is less space in the output queue, decoding the packet might block.
+static const int MIN_FREE_MSGS = 8;
+
 AudioDecoderThread::AudioDecoderThread(CQueue& cmdQ, AudioMsgQueue& msgQ, 
         VideoMsgQueue& packetQ, AVStream* pStream, const AudioParams& ap)
     : WorkerThread<AudioDecoderThread>(string("AudioDecoderThread"), cmdQ),
@@ -50,6 +54,7 @@ AudioDecoderThread::AudioDecoderThread(CQueue& cmdQ, AudioMsgQueue& msgQ,
       m_State(DECODING)
 {
     m_LastFrameTime = 0;
+    m_LoopDuration = 0;
     m_AudioStartTimestamp = 0;
 
     if (m_pStream->start_time != (long long)AV_NOPTS_VALUE) {
@@ -76,7 +81,24 @@ bool AudioDecoderThread::work()
     VideoMsgPtr pMsg;
     {
         ScopeTimer timer(PacketWaitProfilingZone);
-        pMsg = m_PacketQ.pop(true);
+        pMsg = m_PacketQ.peek(false);
+    }
+    if (!pMsg) {
+        setIdle();
+        return true;
+    }
+    VideoMsg::MsgType msgType = pMsg->getType();
+    if ((msgType == VideoMsg::PACKET || msgType == VideoMsg::END_OF_FILE) &&
+            m_MsgQ.getMaxSize()-m_MsgQ.size() < MIN_FREE_MSGS)
+    {
+        // We run on a shared thread, so we don't wait for the audio output to catch up.
+        setIdle();
+        return true;
+    }
+    pMsg = m_PacketQ.pop(false);
+    if (!pMsg) {
+        setIdle();
+        return true;
     }
     switch (pMsg->getType()) {
         case VideoMsg::PACKET: {
@@ -106,6 +128,9 @@ bool AudioDecoderThread::work()
         case VideoMsg::END_OF_FILE:
             pushEOF();
             break;
+        case VideoMsg::LOOP_END:
+            handleLoopEnd();
+            break;
         case VideoMsg::CLOSED:
             m_MsgQ.clear();
             stop();
@@ -208,6 +233,25 @@ void AudioDecoderThread::handleSeekDone(AVPacket* pPacket)
     }
 }
 
+void AudioDecoderThread::setLoopDuration(float duration)
+{
+    m_LoopDuration = duration;
+}
+
+void AudioDecoderThread::handleLoopEnd()
+{
+    // The packets that follow are from the start of the file again. Audio continues
+    // without a gap, only the timestamps start over. If the audio stream is shorter
+    // than the video stream, it is padded with silence so both loop in sync.
+    avcodec_flush_buffers(m_pStream->codec);
+    if (m_LoopDuration > m_LastFrameTime) {
+        float silence = m_LoopDuration - m_LastFrameTime;
+        m_LastFrameTime = m_LoopDuration;
+        insertSilence(silence);
+    }
+    m_LastFrameTime = 0;
+}
+
 void AudioDecoderThread::discardPacket(AVPacket* pPacket)
 {
     m_LastFrameTime = float(pPacket->dts*av_q2d(m_pStream->time_base))
@@ -46,10 +46,12 @@ class AVG_API AudioDecoderThread : public WorkerThread<AudioDecoderThread> {
         virtual ~AudioDecoderThread();
         
         bool work();
+        void setLoopDuration(float duration);
 
     private:
         void decodePacket(AVPacket* pPacket);
         void handleSeekDone(AVPacket* pPacket);
+        void handleLoopEnd();
         void discardPacket(AVPacket* pPacket);
         AudioBufferPtr resampleAudio(char* pDecodedData, int framesDecoded,
                 int currentSampleFormat);
@@ -72,6 +74,7 @@ class AVG_API AudioDecoderThread : public WorkerThread<AudioDecoderThread> {
         ReSampleContext * m_pResampleContext;
         float m_AudioStartTimestamp;
         float m_LastFrameTime;
+        float m_LoopDuration;
     
         enum State {DECODING, SEEK_DONE, DISCARDING};
         State m_State;
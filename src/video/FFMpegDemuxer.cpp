@@ -34,7 +34,8 @@ using namespace std;
 namespace avg {
 
 FFMpegDemuxer::FFMpegDemuxer(AVFormatContext * pFormatContext, vector<int> streamIndexes)
-    : m_pFormatContext(pFormatContext)
+    : m_pFormatContext(pFormatContext),
+      m_KeyframeStreamIndex(-1)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
     for (unsigned i = 0; i < streamIndexes.size(); ++i) {
@@ -88,6 +89,9 @@ AVPacket * FFMpegDemuxer::getPacket(int streamIndex)
                 pPacket = 0;
                 return 0;
             }
+            if (m_pKeyframeIndex && pPacket->stream_index == m_KeyframeStreamIndex) {
+                m_pKeyframeIndex->addPacket(pPacket);
+            }
             if (pPacket->stream_index != streamIndex) {
                 if (m_PacketLists.find(pPacket->stream_index) != m_PacketLists.end()) {
                     // Relevant stream, but not ours
@@ -126,6 +130,12 @@ void FFMpegDemuxer::seek(float destTime)
     clearPacketCache();
 }
 
+void FFMpegDemuxer::setKeyframeIndex(int streamIndex, KeyframeIndexPtr pKeyframeIndex)
+{
+    m_KeyframeStreamIndex = streamIndex;
+    m_pKeyframeIndex = pKeyframeIndex;
+}
+
 void FFMpegDemuxer::clearPacketCache()
 {
     map<int, PacketList>::iterator it;
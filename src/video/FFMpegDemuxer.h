@@ -25,6 +25,7 @@
 #include "../avgconfigwrapper.h"
 
 #include "WrapFFMpeg.h"
+#include "KeyframeIndex.h"
 
 #include <list>
 #include <vector>
@@ -41,6 +42,7 @@ class AVG_API FFMpegDemuxer {
        
         AVPacket * getPacket(int streamIndex);
         void seek(float destTime);
+        void setKeyframeIndex(int streamIndex, KeyframeIndexPtr pKeyframeIndex);
         void dump();
         
     private:
@@ -51,6 +53,9 @@ class AVG_API FFMpegDemuxer {
         std::map<int, PacketList> m_PacketLists;
        
         AVFormatContext * m_pFormatContext;
+
+        int m_KeyframeStreamIndex;
+        KeyframeIndexPtr m_pKeyframeIndex;
 };
 typedef boost::shared_ptr<FFMpegDemuxer> FFMpegDemuxerPtr;
 }
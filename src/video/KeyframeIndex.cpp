@@ -0,0 +1,136 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "KeyframeIndex.h"
+
+#include "../base/ObjectCounter.h"
+#include "../base/ThreadHelper.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace avg {
+
+KeyframeIndex::KeyframeIndex(AVStream* pStream)
+    : m_bComplete(false),
+      m_bStopScan(false),
+      m_StartTimestamp(0)
+{
+    m_TimeUnitsPerSecond = float(1.0/av_q2d(pStream->time_base));
+    if (pStream->start_time != (long long)AV_NOPTS_VALUE) {
+        m_StartTimestamp = pStream->start_time;
+    }
+    // The start of the stream is always a valid seek target.
+    m_Times.push_back(0);
+    for (int i = 0; i < pStream->nb_index_entries; ++i) {
+        const AVIndexEntry& entry = pStream->index_entries[i];
+        if (entry.flags & AVINDEX_KEYFRAME) {
+            addKeyframe(entry.timestamp);
+            m_bComplete = true;
+        }
+    }
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+KeyframeIndex::~KeyframeIndex()
+{
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+void KeyframeIndex::addPacket(AVPacket* pPacket)
+{
+    if (pPacket->flags & AV_PKT_FLAG_KEY) {
+        long long timestamp = pPacket->dts;
+        if (timestamp == (long long)AV_NOPTS_VALUE) {
+            timestamp = pPacket->pts;
+        }
+        if (timestamp != (long long)AV_NOPTS_VALUE) {
+            lock_guard lock(m_Mutex);
+            addKeyframe(timestamp);
+        }
+    }
+}
+
+bool KeyframeIndex::isComplete() const
+{
+    lock_guard lock(m_Mutex);
+    return m_bComplete;
+}
+
+void KeyframeIndex::scan(AVFormatContext* pFormatContext, int streamIndex)
+{
+    // pFormatContext is a separate context for the same file, so this doesn't 
+    // interfere with the demuxer.
+    AVPacket packet;
+    while (av_read_frame(pFormatContext, &packet) >= 0) {
+        if (packet.stream_index == streamIndex) {
+            addPacket(&packet);
+        }
+        av_free_packet(&packet);
+        lock_guard lock(m_Mutex);
+        if (m_bStopScan) {
+            return;
+        }
+    }
+    lock_guard lock(m_Mutex);
+    m_bComplete = true;
+}
+
+void KeyframeIndex::stopScan()
+{
+    lock_guard lock(m_Mutex);
+    m_bStopScan = true;
+}
+
+float KeyframeIndex::getKeyframeTime(float time) const
+{
+    lock_guard lock(m_Mutex);
+    vector<float>::const_iterator it = upper_bound(m_Times.begin(), m_Times.end(), time);
+    if (it == m_Times.begin()) {
+        return 0;
+    } else {
+        --it;
+        return *it;
+    }
+}
+
+int KeyframeIndex::getNumKeyframes() const
+{
+    lock_guard lock(m_Mutex);
+    return int(m_Times.size());
+}
+
+void KeyframeIndex::addKeyframe(long long timestamp)
+{
+    float time = float(timestamp-m_StartTimestamp)/m_TimeUnitsPerSecond;
+    if (time < 0) {
+        return;
+    }
+    vector<float>::iterator it = lower_bound(m_Times.begin(), m_Times.end(), time);
+    // Packets after a seek or a loop are seen again, so keyframes are only added once.
+    if (it == m_Times.end() || *it-time > 0.0001f) {
+        m_Times.insert(it, time);
+    }
+}
+
+}
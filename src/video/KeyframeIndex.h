@@ -0,0 +1,69 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _KeyframeIndex_H_
+#define _KeyframeIndex_H_
+
+#include "../api.h"
+
+#include "WrapFFMpeg.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <vector>
+
+namespace avg {
+
+// Sorted list of keyframe times (in seconds) of a video stream. The index is 
+// initialized from the container index if there is one. Streams without a container 
+// index are indexed by scan(), which runs in a background thread. In addition, the 
+// demuxer adds keyframe packets as it encounters them. The index can be queried 
+// from the main thread at any time and returns the best keyframe known so far.
+class AVG_API KeyframeIndex
+{
+public:
+    KeyframeIndex(AVStream* pStream);
+    virtual ~KeyframeIndex();
+
+    void addPacket(AVPacket* pPacket);
+    bool isComplete() const;
+    void scan(AVFormatContext* pFormatContext, int streamIndex);
+    void stopScan();
+    float getKeyframeTime(float time) const;
+    int getNumKeyframes() const;
+
+private:
+    void addKeyframe(long long timestamp);
+
+    std::vector<float> m_Times;
+    bool m_bComplete;
+    bool m_bStopScan;
+    float m_TimeUnitsPerSecond;
+    long long m_StartTimestamp;
+    mutable boost::mutex m_Mutex;
+};
+
+typedef boost::shared_ptr<KeyframeIndex> KeyframeIndexPtr;
+
+}
+#endif
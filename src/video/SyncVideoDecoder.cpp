@@ -78,6 +78,7 @@ void SyncVideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP)
     vector<int> streamIndexes;
     streamIndexes.push_back(getVStreamIndex());
     m_pDemuxer = new FFMpegDemuxer(getFormatContext(), streamIndexes);
+    m_pDemuxer->setKeyframeIndex(getVStreamIndex(), getKeyframeIndex());
 
     m_pFrameDecoder = FFMpegFrameDecoderPtr(new FFMpegFrameDecoder(getVideoStream()));
     m_pFrameDecoder->setFPS(m_FPS);
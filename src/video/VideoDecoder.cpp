@@ -34,6 +34,7 @@
 #include "../graphics/GLTexture.h"
 
 #include <string>
+#include <boost/bind.hpp>
 
 #include "WrapFFMpeg.h"
 
@@ -53,6 +54,7 @@ VideoDecoder::VideoDecoder()
       m_pVStream(0),
       m_PF(NO_PIXELFORMAT),
       m_Size(0,0),
+      m_pIndexThread(0),
 #ifdef AVG_ENABLE_VDPAU
       m_pVDPAUDecoder(0),
 #endif
@@ -154,6 +156,7 @@ void VideoDecoder::open(const string& sFilename, bool bUseHardwareAcceleration,
                     sFilename + ": unsupported video codec ("+szCodec+").");
         }
         m_PF = calcPixelFormat(true);
+        m_pKeyframeIndex = KeyframeIndexPtr(new KeyframeIndex(m_pVStream));
     }
     // Enable audio stream demuxing.
     if (m_AStreamIndex >= 0) {
@@ -172,6 +175,10 @@ void VideoDecoder::open(const string& sFilename, bool bUseHardwareAcceleration,
         throw Exception(AVG_ERR_VIDEO_INIT_FAILED, 
                 sFilename + ": no usable streams found.");
     }
+    if (m_pKeyframeIndex && !m_pKeyframeIndex->isComplete()) {
+        m_pIndexThread = new boost::thread(boost::bind(&VideoDecoder::indexKeyframes,
+                m_sFilename, m_VStreamIndex, m_pKeyframeIndex));
+    }
 
     m_State = OPENED;
 }
@@ -211,6 +218,13 @@ void VideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP)
 
 void VideoDecoder::close() 
 {
+    if (m_pIndexThread) {
+        // The index thread needs s_OpenMutex to close its file.
+        m_pKeyframeIndex->stopScan();
+        m_pIndexThread->join();
+        delete m_pIndexThread;
+        m_pIndexThread = 0;
+    }
     lock_guard lock(s_OpenMutex);
     AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, "Closing " << m_sFilename);
     
@@ -219,6 +233,7 @@ void VideoDecoder::close()
         avcodec_close(m_pVStream->codec);
         m_pVStream = 0;
         m_VStreamIndex = -1;
+        m_pKeyframeIndex = KeyframeIndexPtr();
     }
 
     if (m_pAStream) {
@@ -281,6 +296,49 @@ float VideoDecoder::getStreamFPS() const
     return avg::getStreamFPS(m_pVStream);
 }
 
+float VideoDecoder::getKeyframeTime(float time) const
+{
+    AVG_ASSERT(m_State != CLOSED);
+    if (m_pKeyframeIndex) {
+        return m_pKeyframeIndex->getKeyframeTime(time);
+    } else {
+        return time;
+    }
+}
+
+void VideoDecoder::indexKeyframes(const string& sFilename, int streamIndex,
+        KeyframeIndexPtr pKeyframeIndex)
+{
+    // Runs in its own thread. The demuxer owns m_pFormatContext, so the keyframes are 
+    // read using a separate context. Until this is done or if it fails, seeks use 
+    // the keyframes known so far.
+    AVFormatContext* pFormatContext = 0;
+    int err;
+    {
+        lock_guard lock(s_OpenMutex);
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53,2,0)
+        err = avformat_open_input(&pFormatContext, sFilename.c_str(), 0, 0);
+#else
+        AVFormatParameters params;
+        memset(&params, 0, sizeof(params));
+        err = av_open_input_file(&pFormatContext, sFilename.c_str(), 0, 0, &params);
+#endif
+    }
+    if (err < 0) {
+        AVG_TRACE(Logger::category::PLAYER, Logger::severity::WARNING, sFilename <<
+                ": Could not open file to index keyframes.");
+        return;
+    }
+    pKeyframeIndex->scan(pFormatContext, streamIndex);
+
+    lock_guard lock(s_OpenMutex);
+#if LIBAVCODEC_VERSION_INT > AV_VERSION_INT(53, 21, 0)
+    avformat_close_input(&pFormatContext);
+#else
+    av_close_input_file(pFormatContext);
+#endif
+}
+
 FrameAvailableCode VideoDecoder::renderToBmp(BitmapPtr pBmp, float timeWanted)
 {
     std::vector<BitmapPtr> pBmps;
@@ -379,6 +437,11 @@ AVStream* VideoDecoder::getAudioStream() const
     return m_pAStream;
 }
 
+KeyframeIndexPtr VideoDecoder::getKeyframeIndex() const
+{
+    return m_pKeyframeIndex;
+}
+
 void VideoDecoder::initVideoSupport()
 {
     if (!s_bInitialized) {
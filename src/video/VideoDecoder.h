@@ -26,6 +26,7 @@
 #include "../avgconfigwrapper.h"
 
 #include "VideoInfo.h"
+#include "KeyframeIndex.h"
 
 #include "../audio/AudioParams.h"
 #include "../graphics/PixelFormat.h"
@@ -35,6 +36,7 @@
 #include <string>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 struct vdpau_render_state;
 
@@ -69,6 +71,7 @@ class AVG_API VideoDecoder
         PixelFormat getPixelFormat() const;
         IntPoint getSize() const;
         float getStreamFPS() const;
+        float getKeyframeTime(float time) const;
 
         virtual void seek(float destTime) = 0;
         virtual void loop() = 0;
@@ -99,11 +102,14 @@ class AVG_API VideoDecoder
         AVStream* getVideoStream() const;
         int getAStreamIndex() const;
         AVStream* getAudioStream() const;
+        KeyframeIndexPtr getKeyframeIndex() const;
 
     private:
         void initVideoSupport();
         int openCodec(int streamIndex, bool bUseHardwareAcceleration);
         float getDuration(StreamSelect streamSelect) const;
+        static void indexKeyframes(const std::string& sFilename, int streamIndex,
+                KeyframeIndexPtr pKeyframeIndex);
         PixelFormat calcPixelFormat(bool bUseYCbCr);
         std::string getStreamPF() const;
 
@@ -116,6 +122,8 @@ class AVG_API VideoDecoder
         AVStream * m_pVStream;
         PixelFormat m_PF;
         IntPoint m_Size;
+        KeyframeIndexPtr m_pKeyframeIndex;
+        boost::thread* m_pIndexThread;
 #ifdef AVG_ENABLE_VDPAU
         VDPAUDecoder* m_pVDPAUDecoder;
 #endif
@@ -0,0 +1,266 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "VideoDecoderPool.h"
+
+#include "../base/ConfigMgr.h"
+#include "../base/Exception.h"
+#include "../base/Logger.h"
+#include "../base/ThreadHelper.h"
+#include "../base/ThreadProfiler.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/once.hpp>
+
+#include <algorithm>
+#include <exception>
+
+using namespace std;
+
+namespace avg {
+
+// Idle tasks are retried after this time even if nothing woke the pool, since not all
+// of their inputs (e.g. the audio callback consuming samples) notify it.
+static const int IDLE_RETRY_MS = 5;
+
+VideoDecoderTask::VideoDecoderTask()
+    : m_Priority(VideoDecoderPool::PLAYING)
+{
+}
+
+VideoDecoderTask::~VideoDecoderTask()
+{
+}
+
+void VideoDecoderTask::setPriority(int priority)
+{
+    m_Priority = priority;
+}
+
+int VideoDecoderTask::getPriority() const
+{
+    return m_Priority;
+}
+
+VideoDecoderPool::TaskEntry::TaskEntry(VideoDecoderTaskPtr pTask)
+    : m_pTask(pTask),
+      m_bRunning(false),
+      m_bIdle(false)
+{
+}
+
+VideoDecoderPool* VideoDecoderPool::s_pVideoDecoderPool = 0;
+
+static boost::once_flag s_CreateOnce = BOOST_ONCE_INIT;
+
+VideoDecoderPool* VideoDecoderPool::get()
+{
+    boost::call_once(s_CreateOnce, &VideoDecoderPool::createInstance);
+    return s_pVideoDecoderPool;
+}
+
+void VideoDecoderPool::createInstance()
+{
+    s_pVideoDecoderPool = new VideoDecoderPool;
+    atexit(&VideoDecoderPool::deleteInstance);
+}
+
+void VideoDecoderPool::deleteInstance()
+{
+    delete s_pVideoDecoderPool;
+    s_pVideoDecoderPool = 0;
+}
+
+VideoDecoderPool::VideoDecoderPool()
+    : m_bStop(false)
+{
+    int numThreads = ConfigMgr::get()->getIntOption("cpu", "numdecoderthreads", -1);
+    if (numThreads < 1) {
+        numThreads = max(int(boost::thread::hardware_concurrency()), 1);
+    }
+    startThreads(numThreads);
+}
+
+VideoDecoderPool::~VideoDecoderPool()
+{
+    stopThreads();
+}
+
+void VideoDecoderPool::setNumThreads(int numThreads)
+{
+    if (numThreads < 1) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE,
+                "VideoDecoderPool.setNumThreads: At least one thread is needed.");
+    }
+    stopThreads();
+    startThreads(numThreads);
+}
+
+int VideoDecoderPool::getNumThreads() const
+{
+    return int(m_pThreads.size());
+}
+
+int VideoDecoderPool::getNumTasks() const
+{
+    lock_guard lock(m_Mutex);
+    return int(m_Tasks.size());
+}
+
+void VideoDecoderPool::addTask(VideoDecoderTaskPtr pTask)
+{
+    lock_guard lock(m_Mutex);
+    m_Tasks.push_back(TaskEntry(pTask));
+    m_WorkCond.notify_one();
+}
+
+void VideoDecoderPool::waitForTask(VideoDecoderTaskPtr pTask)
+{
+    boost::unique_lock<boost::mutex> lock(m_Mutex);
+    clearIdleFlags();
+    m_WorkCond.notify_all();
+    while (true) {
+        bool bFound = false;
+        for (TaskList::iterator it = m_Tasks.begin(); it != m_Tasks.end(); ++it) {
+            if (it->m_pTask == pTask) {
+                bFound = true;
+                break;
+            }
+        }
+        if (!bFound) {
+            return;
+        }
+        m_TaskDoneCond.wait(lock);
+    }
+}
+
+void VideoDecoderPool::wake()
+{
+    lock_guard lock(m_Mutex);
+    clearIdleFlags();
+    m_WorkCond.notify_all();
+}
+
+void VideoDecoderPool::startThreads(int numThreads)
+{
+    for (int i = 0; i < numThreads; ++i) {
+        m_pThreads.push_back(new boost::thread(
+                boost::bind(&VideoDecoderPool::threadFunc, this)));
+    }
+}
+
+void VideoDecoderPool::stopThreads()
+{
+    {
+        lock_guard lock(m_Mutex);
+        m_bStop = true;
+        m_WorkCond.notify_all();
+    }
+    for (unsigned i = 0; i < m_pThreads.size(); ++i) {
+        m_pThreads[i]->join();
+        delete m_pThreads[i];
+    }
+    m_pThreads.clear();
+    m_bStop = false;
+}
+
+void VideoDecoderPool::threadFunc()
+{
+    setAffinityMask(false);
+    ThreadProfiler* pProfiler = ThreadProfiler::get();
+    pProfiler->setName("Video Decoder Pool");
+    pProfiler->setLogCategory(Logger::category::PROFILE_VIDEO);
+    pProfiler->start();
+
+    boost::unique_lock<boost::mutex> lock(m_Mutex);
+    while (!m_bStop) {
+        TaskList::iterator it = findRunnableTask();
+        if (it == m_Tasks.end()) {
+            m_WorkCond.timed_wait(lock, boost::posix_time::milliseconds(IDLE_RETRY_MS));
+            clearIdleFlags();
+            continue;
+        }
+        // Moving the task to the end of the list makes sure that tasks with the same
+        // priority take turns.
+        m_Tasks.splice(m_Tasks.end(), m_Tasks, it);
+        it->m_bRunning = true;
+        VideoDecoderTaskPtr pTask = it->m_pTask;
+        lock.unlock();
+        bool bWorked = true;
+        bool bDone;
+        try {
+            bWorked = pTask->step();
+            bDone = pTask->isDone();
+        } catch (const Exception& e) {
+            AVG_LOG_ERROR("Uncaught exception in video decoder task: " << e.getStr());
+            bDone = true;
+        } catch (const std::exception& e) {
+            AVG_LOG_ERROR("Uncaught exception in video decoder task: " << e.what());
+            bDone = true;
+        } catch (...) {
+            AVG_LOG_ERROR("Uncaught unknown exception in video decoder task.");
+            bDone = true;
+        }
+        lock.lock();
+        it->m_bRunning = false;
+        if (bDone) {
+            m_Tasks.erase(it);
+            m_TaskDoneCond.notify_all();
+        } else if (bWorked) {
+            // The output of this task is probably the input of another one.
+            clearIdleFlags();
+            m_WorkCond.notify_one();
+        } else {
+            it->m_bIdle = true;
+        }
+    }
+    lock.unlock();
+    pProfiler->dumpStatistics();
+    pProfiler->kill();
+}
+
+VideoDecoderPool::TaskList::iterator VideoDecoderPool::findRunnableTask()
+{
+    // Called with m_Mutex locked.
+    TaskList::iterator bestIt = m_Tasks.end();
+    int bestPriority = -1;
+    for (TaskList::iterator it = m_Tasks.begin(); it != m_Tasks.end(); ++it) {
+        if (!it->m_bRunning && !it->m_bIdle) {
+            int priority = it->m_pTask->getPriority();
+            if (priority > bestPriority) {
+                bestIt = it;
+                bestPriority = priority;
+            }
+        }
+    }
+    return bestIt;
+}
+
+void VideoDecoderPool::clearIdleFlags()
+{
+    // Called with m_Mutex locked.
+    for (TaskList::iterator it = m_Tasks.begin(); it != m_Tasks.end(); ++it) {
+        it->m_bIdle = false;
+    }
+}
+
+}
@@ -0,0 +1,153 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _VideoDecoderPool_H_
+#define _VideoDecoderPool_H_
+
+#include "../api.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+#include <list>
+#include <vector>
+
+namespace avg {
+
+// A unit of demuxing or decoding work that is scheduled by the VideoDecoderPool. 
+// A task is never run by more than one thread at a time.
+class AVG_API VideoDecoderTask
+{
+public:
+    VideoDecoderTask();
+    virtual ~VideoDecoderTask();
+
+    // Does a small amount of work without blocking and returns false if there was 
+    // nothing to do.
+    virtual bool step() = 0;
+    virtual bool isDone() const = 0;
+
+    void setPriority(int priority);
+    int getPriority() const;
+
+private:
+    boost::atomic<int> m_Priority;
+};
+
+typedef boost::shared_ptr<VideoDecoderTask> VideoDecoderTaskPtr;
+
+// Runs a WorkerThread using WorkerThread::step().
+template<class WORKER>
+class AVG_TEMPLATE_API WorkerTask: public VideoDecoderTask
+{
+public:
+    WorkerTask(const WORKER& worker)
+        : m_Worker(worker)
+    {
+    }
+
+    virtual bool step()
+    {
+        return m_Worker.step();
+    }
+
+    virtual bool isDone() const
+    {
+        return m_Worker.isDone();
+    }
+
+private:
+    WORKER m_Worker;
+};
+
+// Fixed set of threads that runs the demuxer and decoder tasks of all threaded video
+// decoders. Tasks of streams that are visible and playing are run first, tasks of 
+// paused streams last. Tasks that have nothing to do are retried when another task 
+// has made progress, when wake() is called or after a short timeout.
+//
+// The number of threads is taken from the cpu/numdecoderthreads avgrc option. The
+// default (-1) uses one thread per processor.
+class AVG_API VideoDecoderPool
+{
+public:
+    enum Priority {PAUSED, PLAYING, VISIBLE};
+
+    static VideoDecoderPool* get();
+    virtual ~VideoDecoderPool();
+
+    void setNumThreads(int numThreads);
+    int getNumThreads() const;
+    int getNumTasks() const;
+
+    template<class WORKER>
+    VideoDecoderTaskPtr addWorker(const WORKER& worker, Priority priority);
+    void addTask(VideoDecoderTaskPtr pTask);
+    void waitForTask(VideoDecoderTaskPtr pTask);
+    void wake();
+
+private:
+    VideoDecoderPool();
+    static void createInstance();
+    static void deleteInstance();
+
+    struct TaskEntry {
+        TaskEntry(VideoDecoderTaskPtr pTask);
+
+        VideoDecoderTaskPtr m_pTask;
+        bool m_bRunning;
+        bool m_bIdle;
+    };
+    typedef std::list<TaskEntry> TaskList;
+
+    void startThreads(int numThreads);
+    void stopThreads();
+    void threadFunc();
+    TaskList::iterator findRunnableTask();
+    void clearIdleFlags();
+
+    std::vector<boost::thread*> m_pThreads;
+
+    // Protected by m_Mutex.
+    mutable boost::mutex m_Mutex;
+    boost::condition m_WorkCond;
+    boost::condition m_TaskDoneCond;
+    TaskList m_Tasks;
+    bool m_bStop;
+
+    static VideoDecoderPool* s_pVideoDecoderPool;
+};
+
+template<class WORKER>
+VideoDecoderTaskPtr VideoDecoderPool::addWorker(const WORKER& worker, Priority priority)
+{
+    VideoDecoderTaskPtr pTask(new WorkerTask<WORKER>(worker));
+    pTask->setPriority(priority);
+    addTask(pTask);
+    return pTask;
+}
+
+}
+
+#endif
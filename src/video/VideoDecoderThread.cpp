@@ -47,7 +47,10 @@ VideoDecoderThread::VideoDecoderThread(CQueue& cmdQ, VideoMsgQueue& msgQ,
       m_PF(pf),
       m_bUseVDPAU(bUseVDPAU),
       m_bSeekDone(false),
-      m_bProcessingLastFrames(false)
+      m_bDiscardingFrames(false),
+      m_SeekTime(0),
+      m_bProcessingLastFrames(false),
+      m_bLoopEnd(false)
 {
     m_pFrameDecoder = FFMpegFrameDecoderPtr(new FFMpegFrameDecoder(pStream));
 }
@@ -83,21 +86,49 @@ bool VideoDecoderThread::work()
     ScopeTimer timer(DecoderProfilingZone);
     if (m_bProcessingLastFrames) {
         // EOF received, but last frames still need to be decoded.
-        handleEOF();
+        if (isMsgQFull()) {
+            setIdle();
+        } else {
+            handleEOF();
+        }
     } else {
         // Standard decoding.
         VideoMsgPtr pMsg;
         {
             ScopeTimer timer(PacketWaitProfilingZone);
-            pMsg = m_PacketQ.pop(true);
+            pMsg = m_PacketQ.peek(false);
+        }
+        if (!pMsg) {
+            setIdle();
+            return true;
+        }
+        VideoMsg::MsgType msgType = pMsg->getType();
+        if ((msgType == VideoMsg::PACKET || msgType == VideoMsg::END_OF_FILE || 
+                msgType == VideoMsg::LOOP_END) && isMsgQFull())
+        {
+            // Can't deliver the frame. We run on a shared thread, so we don't wait.
+            setIdle();
+            return true;
+        }
+        // The demuxer may have cleared the queue in the meantime, but in that case
+        // the first message is a SEEK_DONE or CLOSED.
+        pMsg = m_PacketQ.pop(false);
+        if (!pMsg) {
+            setIdle();
+            return true;
         }
         switch (pMsg->getType()) {
             case VideoMsg::PACKET:
                 decodePacket(pMsg->getPacket());
                 break;
             case VideoMsg::END_OF_FILE:
+                m_bProcessingLastFrames = true;
                 handleEOF();
+                break;
+            case VideoMsg::LOOP_END:
+                m_bLoopEnd = true;
                 m_bProcessingLastFrames = true;
+                handleEOF();
                 break;
             case VideoMsg::SEEK_DONE:
                 handleSeekDone(pMsg);
@@ -121,6 +152,15 @@ void VideoDecoderThread::setFPS(float fps)
 
 void VideoDecoderThread::returnFrame(VideoMsgPtr pMsg)
 {
+    VideoFrameBufferPtr pFrameBuffer = pMsg->getFrameBuffer();
+    if (pFrameBuffer) {
+        // Frame was never uploaded, so the buffer is still mapped and can be reused
+        // as is.
+        if (m_pFramePool) {
+            m_pFramePool->returnBuffer(pFrameBuffer);
+        }
+        return;
+    }
     m_pBmpQ->push(pMsg->getFrameBitmap(0));
     if (pixelFormatIsPlanar(m_PF)) {
         m_pHalfBmpQ->push(pMsg->getFrameBitmap(1));
@@ -131,11 +171,26 @@ void VideoDecoderThread::returnFrame(VideoMsgPtr pMsg)
     }
 }
 
+void VideoDecoderThread::setFramePool(VideoFramePoolPtr pFramePool)
+{
+    m_pFramePool = pFramePool;
+}
+
 void VideoDecoderThread::decodePacket(AVPacket* pPacket)
 {
     bool bGotPicture = m_pFrameDecoder->decodePacket(pPacket, m_pFrame, m_bSeekDone);
     if (bGotPicture) {
         m_bSeekDone = false;
+        if (m_bDiscardingFrames) {
+            float timePerFrame = 1.0f/m_pFrameDecoder->getFPS();
+            if (m_pFrameDecoder->getCurTime() < m_SeekTime-0.5f*timePerFrame) {
+                // The seek started at the preceding keyframe. Frames before the seek 
+                // target are needed to decode the target, but aren't displayed, so 
+                // there is no need to convert and queue them.
+                return;
+            }
+            m_bDiscardingFrames = false;
+        }
         sendFrame(m_pFrame);
     }
 }
@@ -147,17 +202,37 @@ void VideoDecoderThread::handleEOF()
         sendFrame(m_pFrame);
     } else {
         m_bProcessingLastFrames = false;
-        VideoMsgPtr pMsg(new VideoMsg());
-        pMsg->setEOF();
-        pushMsg(pMsg);
+        if (m_bLoopEnd) {
+            handleLoopEnd();
+        } else {
+            VideoMsgPtr pMsg(new VideoMsg());
+            pMsg->setEOF();
+            pushMsg(pMsg);
+        }
     }
 }
 
+void VideoDecoderThread::handleLoopEnd()
+{
+    // The demuxer has already rewound the file, so the packets that follow belong to
+    // the next loop. Reset the decoder as after a seek, but keep the frames queued.
+    m_bLoopEnd = false;
+    m_pFrameDecoder->handleSeek();
+    m_bSeekDone = true;
+    VideoMsgPtr pMsg(new VideoMsg());
+    pMsg->setLoopEnd();
+    pushMsg(pMsg);
+}
+
 void VideoDecoderThread::handleSeekDone(VideoMsgPtr pMsg)
 {
     m_pFrameDecoder->handleSeek();
     m_bSeekDone = true;
-    m_MsgQ.clear();
+    m_bLoopEnd = false;
+    // VDPAU surfaces are released by the main thread, so all VDPAU frames are sent.
+    m_bDiscardingFrames = !m_bUseVDPAU;
+    m_SeekTime = pMsg->getSeekTime();
+    clearMsgQ();
     pushMsg(pMsg);
 }
 
@@ -171,31 +246,43 @@ void VideoDecoderThread::sendFrame(AVFrame* pFrame)
         pMsg->setVDPAUFrame(pRenderState, m_pFrameDecoder->getCurTime());
     } else {
         vector<BitmapPtr> pBmps;
+        VideoFrameBufferPtr pFrameBuffer;
+        if (m_pFramePool) {
+            // If all pooled buffers are in flight, we fall back to plain bitmaps.
+            pFrameBuffer = m_pFramePool->getFreeBuffer();
+        }
+        if (pFrameBuffer) {
+            pBmps = pFrameBuffer->getBitmaps();
+        }
         if (pixelFormatIsPlanar(m_PF)) {
             ScopeTimer timer(CopyImageProfilingZone);
-            IntPoint halfSize(m_Size.x/2, m_Size.y/2);
-            pBmps.push_back(getBmp(m_pBmpQ, m_Size, I8));
-            pBmps.push_back(getBmp(m_pHalfBmpQ, halfSize, I8));
-            pBmps.push_back(getBmp(m_pHalfBmpQ, halfSize, I8));
-            if (m_PF == YCbCrA420p) {
+            if (!pFrameBuffer) {
+                IntPoint halfSize(m_Size.x/2, m_Size.y/2);
                 pBmps.push_back(getBmp(m_pBmpQ, m_Size, I8));
+                pBmps.push_back(getBmp(m_pHalfBmpQ, halfSize, I8));
+                pBmps.push_back(getBmp(m_pHalfBmpQ, halfSize, I8));
+                if (m_PF == YCbCrA420p) {
+                    pBmps.push_back(getBmp(m_pBmpQ, m_Size, I8));
+                }
             }
             for (unsigned i = 0; i < pBmps.size(); ++i) {
                 m_pFrameDecoder->copyPlaneToBmp(pBmps[i], pFrame->data[i], 
                         pFrame->linesize[i]);
             }
         } else {
-            pBmps.push_back(getBmp(m_pBmpQ, m_Size, m_PF));
+            if (!pFrameBuffer) {
+                pBmps.push_back(getBmp(m_pBmpQ, m_Size, m_PF));
+            }
             m_pFrameDecoder->convertFrameToBmp(pFrame, pBmps[0]);
         }
-        pMsg->setFrame(pBmps, m_pFrameDecoder->getCurTime());
+        pMsg->setFrame(pBmps, m_pFrameDecoder->getCurTime(), pFrameBuffer);
     }
     pushMsg(pMsg);
 }
 
 void VideoDecoderThread::close()
 {
-    m_MsgQ.clear();
+    clearMsgQ();
     stop();
 }
 
@@ -211,6 +298,23 @@ BitmapPtr VideoDecoderThread::getBmp(BitmapQueuePtr pBmpQ, const IntPoint& size,
     }
 }
 
+bool VideoDecoderThread::isMsgQFull() const
+{
+    return m_MsgQ.getMaxSize() > 0 && m_MsgQ.size() >= m_MsgQ.getMaxSize();
+}
+
+void VideoDecoderThread::clearMsgQ()
+{
+    // Frames still in the queue are recycled instead of being thrown away.
+    VideoMsgPtr pMsg;
+    do {
+        pMsg = m_MsgQ.pop(false);
+        if (pMsg && pMsg->getType() == VideoMsg::FRAME) {
+            returnFrame(pMsg);
+        }
+    } while (pMsg);
+}
+
 static ProfilingZoneID PushMsgProfilingZone("Push message", true);
 
 void VideoDecoderThread::pushMsg(VideoMsgPtr pMsg)
@@ -24,6 +24,7 @@
 
 #include "../api.h"
 #include "VideoMsg.h"
+#include "VideoFramePool.h"
 
 #include "../base/WorkerThread.h"
 #include "../base/Command.h"
@@ -52,15 +53,19 @@ class AVG_API VideoDecoderThread: public WorkerThread<VideoDecoderThread> {
         bool work();
         void setFPS(float fps);
         void returnFrame(VideoMsgPtr pMsg);
+        void setFramePool(VideoFramePoolPtr pFramePool);
 
     private:
         void decodePacket(AVPacket* pPacket);
         void handleEOF();
+        void handleLoopEnd();
         void handleSeekDone(VideoMsgPtr pMsg);
         void sendFrame(AVFrame* pFrame);
         void close();
         BitmapPtr getBmp(BitmapQueuePtr pBmpQ, const IntPoint& size, PixelFormat pf);
         void pushMsg(VideoMsgPtr pMsg);
+        bool isMsgQFull() const;
+        void clearMsgQ();
 
         VideoMsgQueue& m_MsgQ;
         FFMpegFrameDecoderPtr m_pFrameDecoder;
@@ -68,13 +73,17 @@ class AVG_API VideoDecoderThread: public WorkerThread<VideoDecoderThread> {
 
         BitmapQueuePtr m_pBmpQ;
         BitmapQueuePtr m_pHalfBmpQ;
+        VideoFramePoolPtr m_pFramePool;
         
         IntPoint m_Size;
         PixelFormat m_PF;
         bool m_bUseVDPAU;
 
         bool m_bSeekDone;
+        bool m_bDiscardingFrames;
+        float m_SeekTime;
         bool m_bProcessingLastFrames;
+        bool m_bLoopEnd;
         AVFrame* m_pFrame;
 };
 
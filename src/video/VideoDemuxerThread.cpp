@@ -28,12 +28,16 @@ using namespace std;
 namespace avg {
 
 VideoDemuxerThread::VideoDemuxerThread(CQueue& cmdQ, AVFormatContext* pFormatContext,
-        const map<int, VideoMsgQueuePtr>& packetQs)
+        const map<int, VideoMsgQueuePtr>& packetQs, int keyframeStreamIndex, 
+        KeyframeIndexPtr pKeyframeIndex)
     : WorkerThread<VideoDemuxerThread>("VideoDemuxer", cmdQ),
       m_PacketQs(packetQs),
       m_bEOF(false),
+      m_bLoop(false),
       m_pFormatContext(pFormatContext),
-      m_pDemuxer()
+      m_pDemuxer(),
+      m_KeyframeStreamIndex(keyframeStreamIndex),
+      m_pKeyframeIndex(pKeyframeIndex)
 {
     map<int, VideoMsgQueuePtr>::iterator it;
     for (it = m_PacketQs.begin(); it != m_PacketQs.end(); it++) {
@@ -54,13 +58,17 @@ bool VideoDemuxerThread::init()
         streamIndexes.push_back(it->first);
     }
     m_pDemuxer = FFMpegDemuxerPtr(new FFMpegDemuxer(m_pFormatContext, streamIndexes));
+    if (m_pKeyframeIndex) {
+        m_pDemuxer->setKeyframeIndex(m_KeyframeStreamIndex, m_pKeyframeIndex);
+    }
     return true;
 }
 
 bool VideoDemuxerThread::work() 
 {
     if (m_bEOF) {
-        waitForCommand();
+        // Nothing to do until the next seek or close command.
+        setIdle();
     } else {
         map<int, VideoMsgQueuePtr>::iterator it;
         int shortestQ = -1;
@@ -76,11 +84,11 @@ bool VideoDemuxerThread::work()
         }
         
         if (shortestQ < 0) {
-            // All queues are at their max capacity. Take a nap and try again later.
-            // Note that we can't wait on the queue. If decoding is paused, the queues can
-            // remain full indefinitely and commands from the application (seek() and 
-            // close() must still be processed.
-            msleep(10);
+            // All queues are at their max capacity. Note that we can't wait on the 
+            // queue. If decoding is paused, the queues can remain full indefinitely and
+            // commands from the application (seek() and close()) must still be 
+            // processed.
+            setIdle();
             return true;
         }
 
@@ -88,12 +96,20 @@ bool VideoDemuxerThread::work()
         VideoMsgPtr pMsg(new VideoMsg);
         if (pPacket == 0) {
             onStreamEOF(shortestQ);
-            pMsg->setEOF();
+            if (m_bLoop) {
+                pMsg->setLoopEnd();
+            } else {
+                pMsg->setEOF();
+            }
         } else {
             pMsg->setPacket(pPacket);
         }
         m_PacketQs[shortestQ]->push(pMsg);
-        msleep(0);
+        if (m_bEOF && m_bLoop) {
+            // Keep demuxing across the loop boundary so the decoders can start on the
+            // beginning of the file before playback reaches the end.
+            rewind();
+        }
     }
     return true;
 }
@@ -114,6 +130,11 @@ void VideoDemuxerThread::seek(int seqNum, float destTime)
     }
     m_bEOF = false;
 }
+
+void VideoDemuxerThread::setLoop(bool bLoop)
+{
+    m_bLoop = bLoop;
+}
        
 void VideoDemuxerThread::close()
 {
@@ -143,6 +164,16 @@ void VideoDemuxerThread::onStreamEOF(int streamIndex)
     }
 }
         
+void VideoDemuxerThread::rewind()
+{
+    m_pDemuxer->seek(0);
+    map<int, bool>::iterator it;
+    for (it = m_PacketQEOFMap.begin(); it != m_PacketQEOFMap.end(); it++) {
+        it->second = false;
+    }
+    m_bEOF = false;
+}
+
 void VideoDemuxerThread::clearQueue(VideoMsgQueuePtr pPacketQ)
 {
     VideoMsgPtr pMsg;
@@ -39,23 +39,30 @@ namespace avg {
 class AVG_API VideoDemuxerThread: public WorkerThread<VideoDemuxerThread> {
     public:
         VideoDemuxerThread(CQueue& cmdQ, AVFormatContext* pFormatContext, 
-                const std::map<int, VideoMsgQueuePtr>& packetQs);
+                const std::map<int, VideoMsgQueuePtr>& packetQs, 
+                int keyframeStreamIndex=-1, 
+                KeyframeIndexPtr pKeyframeIndex=KeyframeIndexPtr());
         virtual ~VideoDemuxerThread();
         bool init();
         bool work();
 
         void seek(int seqNum, float DestTime);
+        void setLoop(bool bLoop);
         void close();
 
     private:
         void onStreamEOF(int streamIndex);
+        void rewind();
         void clearQueue(VideoMsgQueuePtr pPacketQ);
 
         std::map<int, VideoMsgQueuePtr> m_PacketQs;
         std::map<int, bool> m_PacketQEOFMap;
         bool m_bEOF;
+        bool m_bLoop;
         AVFormatContext* m_pFormatContext;
         FFMpegDemuxerPtr m_pDemuxer;
+        int m_KeyframeStreamIndex;
+        KeyframeIndexPtr m_pKeyframeIndex;
 };
 
 }
@@ -0,0 +1,110 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "VideoFramePool.h"
+
+#include "../base/Exception.h"
+#include "../base/ObjectCounter.h"
+
+using namespace std;
+
+namespace avg {
+
+VideoFrameBuffer::VideoFrameBuffer(const IntPoint& size, PixelFormat pf)
+{
+    ObjectCounter::get()->incRef(&typeid(*this));
+    if (pixelFormatIsPlanar(pf)) {
+        IntPoint halfSize(size.x/2, size.y/2);
+        m_pMovers.push_back(TextureMover::create(size, I8, GL_STREAM_DRAW));
+        m_pMovers.push_back(TextureMover::create(halfSize, I8, GL_STREAM_DRAW));
+        m_pMovers.push_back(TextureMover::create(halfSize, I8, GL_STREAM_DRAW));
+        if (pixelFormatHasAlpha(pf)) {
+            m_pMovers.push_back(TextureMover::create(size, I8, GL_STREAM_DRAW));
+        }
+    } else {
+        m_pMovers.push_back(TextureMover::create(size, pf, GL_STREAM_DRAW));
+    }
+    for (unsigned i = 0; i < m_pMovers.size(); ++i) {
+        m_pBmps.push_back(m_pMovers[i]->lock());
+    }
+}
+
+VideoFrameBuffer::~VideoFrameBuffer()
+{
+    for (unsigned i = 0; i < m_pMovers.size(); ++i) {
+        m_pMovers[i]->unlock();
+    }
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+const vector<BitmapPtr>& VideoFrameBuffer::getBitmaps() const
+{
+    return m_pBmps;
+}
+
+void VideoFrameBuffer::moveToTextures(GLTexturePtr pTextures[4])
+{
+    for (unsigned i = 0; i < m_pMovers.size(); ++i) {
+        m_pMovers[i]->unlock();
+        m_pMovers[i]->moveToTexture(*pTextures[i]);
+        // lock() orphans the old buffer contents, so this doesn't wait for the 
+        // upload to finish.
+        m_pBmps[i] = m_pMovers[i]->lock();
+    }
+}
+
+
+VideoFramePool::VideoFramePool(int numFrames, const IntPoint& size, PixelFormat pf)
+{
+    AVG_ASSERT(numFrames > 0);
+    for (int i = 0; i < numFrames; ++i) {
+        VideoFrameBufferPtr pBuffer(new VideoFrameBuffer(size, pf));
+        m_pBuffers.push_back(pBuffer);
+        m_FreeBuffers.push(pBuffer);
+    }
+}
+
+VideoFramePool::~VideoFramePool()
+{
+}
+
+VideoFrameBufferPtr VideoFramePool::getFreeBuffer()
+{
+    return m_FreeBuffers.pop(false);
+}
+
+void VideoFramePool::returnBuffer(VideoFrameBufferPtr pBuffer)
+{
+    m_FreeBuffers.push(pBuffer);
+}
+
+int VideoFramePool::getNumFrames() const
+{
+    return int(m_pBuffers.size());
+}
+
+int VideoFramePool::getNumFreeFrames() const
+{
+    return m_FreeBuffers.size();
+}
+
+}
@@ -0,0 +1,82 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _VideoFramePool_H_
+#define _VideoFramePool_H_
+
+#include "../api.h"
+
+#include "../base/Queue.h"
+#include "../graphics/Bitmap.h"
+#include "../graphics/GLTexture.h"
+#include "../graphics/TextureMover.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace avg {
+
+// Upload buffers (mapped PBOs, or plain memory if PBOs aren't available) for all
+// planes of one video frame. The decoder thread writes decoded frames directly into
+// the bitmaps returned by getBitmaps(); the main thread moves them to the textures.
+class AVG_API VideoFrameBuffer
+{
+public:
+    VideoFrameBuffer(const IntPoint& size, PixelFormat pf);
+    virtual ~VideoFrameBuffer();
+
+    const std::vector<BitmapPtr>& getBitmaps() const;
+    void moveToTextures(GLTexturePtr pTextures[4]);
+
+private:
+    std::vector<TextureMoverPtr> m_pMovers;
+    std::vector<BitmapPtr> m_pBmps;
+};
+
+typedef boost::shared_ptr<VideoFrameBuffer> VideoFrameBufferPtr;
+
+// Fixed set of VideoFrameBuffers shared by a VideoNode and its decoder thread. All
+// buffers are owned by the pool, which must be created and destroyed in the thread 
+// that owns the GL context. Buffers not in use are kept in a queue, so they can be 
+// taken by the decoder and returned by either thread.
+class AVG_API VideoFramePool
+{
+public:
+    VideoFramePool(int numFrames, const IntPoint& size, PixelFormat pf);
+    virtual ~VideoFramePool();
+
+    VideoFrameBufferPtr getFreeBuffer();
+    void returnBuffer(VideoFrameBufferPtr pBuffer);
+    int getNumFrames() const;
+    int getNumFreeFrames() const;
+
+private:
+    std::vector<VideoFrameBufferPtr> m_pBuffers;
+    Queue<VideoFrameBuffer> m_FreeBuffers;
+};
+
+typedef boost::shared_ptr<VideoFramePool> VideoFramePoolPtr;
+
+}
+
+#endif
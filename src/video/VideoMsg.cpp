@@ -35,12 +35,14 @@ VideoMsg::~VideoMsg()
 {
 }
 
-void VideoMsg::setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime)
+void VideoMsg::setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime,
+        VideoFrameBufferPtr pFrameBuffer)
 {
     AVG_ASSERT(pBmps.size() == 1 || pBmps.size() == 3 || pBmps.size() == 4);
     setType(FRAME);
     m_pBmps = pBmps;
     m_FrameTime = frameTime;
+    m_pFrameBuffer = pFrameBuffer;
 }
 
 void VideoMsg::setVDPAUFrame(vdpau_render_state* pRenderState, float frameTime)
@@ -78,6 +80,12 @@ BitmapPtr VideoMsg::getFrameBitmap(int i)
     return m_pBmps[i];
 }
 
+VideoFrameBufferPtr VideoMsg::getFrameBuffer()
+{
+    AVG_ASSERT(getType() == FRAME);
+    return m_pFrameBuffer;
+}
+
 float VideoMsg::getFrameTime()
 {
     AVG_ASSERT(getType() == FRAME || getType() == VDPAU_FRAME);
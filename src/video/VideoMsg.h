@@ -35,16 +35,21 @@ struct AVPacket;
 
 namespace avg {
 
+class VideoFrameBuffer;
+typedef boost::shared_ptr<VideoFrameBuffer> VideoFrameBufferPtr;
+
 class AVG_API VideoMsg: public AudioMsg {
 public:
     VideoMsg();
-    void setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime);
+    void setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime,
+            VideoFrameBufferPtr pFrameBuffer=VideoFrameBufferPtr());
     void setVDPAUFrame(vdpau_render_state* pRenderState, float frameTime);
     void setPacket(AVPacket* pPacket);
 
     virtual ~VideoMsg();
 
     BitmapPtr getFrameBitmap(int i);
+    VideoFrameBufferPtr getFrameBuffer();
     float getFrameTime();
     AVPacket* getPacket();
     void freePacket();
@@ -55,6 +60,7 @@ private:
     // FRAME
     std::vector<BitmapPtr> m_pBmps;
     float m_FrameTime;
+    VideoFrameBufferPtr m_pFrameBuffer;
 
     // VDPAU_FRAME
     vdpau_render_state* m_pRenderState;
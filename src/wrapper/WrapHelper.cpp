@@ -426,3 +426,19 @@ void pytrace(PyObject * self, const avg::category_t& category, const UTF8String&
     Logger::get()->trace(sMsg, category, severity);
 }
 
+// Python log sinks are called from the logger's sink thread and need the GIL, so it
+// has to be released while waiting for that thread.
+void setLoggerAsync(PyObject * self, bool bAsync)
+{
+    Py_BEGIN_ALLOW_THREADS
+    Logger::get()->setAsync(bAsync);
+    Py_END_ALLOW_THREADS
+}
+
+void flushLogger(PyObject * self)
+{
+    Py_BEGIN_ALLOW_THREADS
+    Logger::get()->flush();
+    Py_END_ALLOW_THREADS
+}
+
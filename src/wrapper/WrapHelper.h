@@ -394,4 +394,7 @@ void removePythonLogger(PyObject * self, PyObject * pyLogger);
 void pytrace(PyObject * self, const avg::category_t& category, const avg::UTF8String& sMsg,
         avg::severity_t severity);
 
+void setLoggerAsync(PyObject * self, bool bAsync);
+void flushLogger(PyObject * self);
+
 #endif
@@ -28,6 +28,7 @@ void export_anim();
 #include "raw_constructor.hpp"
 
 #include "../base/Logger.h"
+#include "../base/TraceRecorder.h"
 #include "../base/OSHelper.h"
 #include "../base/GeomHelper.h"
 #include "../base/XMLHelper.h"
@@ -110,6 +111,10 @@ BOOST_PYTHON_MODULE(avg)
                 .def("configureCategory", &Logger::configureCategory,
                         (bp::arg("severity")=Logger::severity::NONE))
                 .def("getCategories", &Logger::getCategories)
+                .def("setAsync", setLoggerAsync)
+                .def("isAsync", &Logger::isAsync)
+                .def("flush", flushLogger)
+                .def("getNumDroppedRecords", &Logger::getNumDroppedRecords)
                 .def("trace", pytrace,
                         (bp::arg("severity")=Logger::severity::INFO))
                 .def("debug", &Logger::logDebug,
@@ -153,6 +158,16 @@ BOOST_PYTHON_MODULE(avg)
 
         scope().attr("logger") = boost::python::ptr(Logger::get());
 
+        class_<TraceRecorder, boost::noncopyable>("TraceRecorder", no_init)
+            .def("start", &TraceRecorder::start,
+                    (bp::arg("maxeventsperthread")=TraceRecorder::DEFAULT_MAX_EVENTS))
+            .def("stop", &TraceRecorder::stop)
+            .def("isRecording", &TraceRecorder::isRecording)
+            .def("writeChromeTrace", &TraceRecorder::writeChromeTrace)
+            .def("getNumDroppedEvents", &TraceRecorder::getNumDroppedEvents)
+        ;
+        scope().attr("tracer") = boost::python::ptr(TraceRecorder::get());
+
         class_<ExportedObject, boost::shared_ptr<ExportedObject>, boost::noncopyable>
                 ("ExportedObject", no_init)
             .def(self == self)
@@ -209,6 +224,8 @@ BOOST_PYTHON_MODULE(avg)
             .def("setOGLOptions", &Player::setOGLOptions)
             .def("setMultiSampleSamples", &Player::setMultiSampleSamples)
             .def("enableGLErrorChecks", &Player::enableGLErrorChecks)
+            .def("setBatchRendering", &Player::setBatchRendering)
+            .def("isBatchRendering", &Player::isBatchRendering)
             .def("getScreenResolution", &Player::getScreenResolution)
             .def("getPixelsPerMM", &Player::getPixelsPerMM)
             .def("getPhysicalScreenDimensions", &Player::getPhysicalScreenDimensions)
@@ -233,6 +250,11 @@ BOOST_PYTHON_MODULE(avg)
             .def("setFakeFPS", &Player::setFakeFPS)
             .def("getFrameTime", &Player::getFrameTime)
             .def("getFrameDuration", &Player::getFrameDuration)
+            .def("getFrameStats", &Player::getFrameStats)
+            .def("dumpFrameStats", &Player::dumpFrameStats)
+            .def("setTextureUploadBudget", &Player::setTextureUploadBudget)
+            .def("getTextureUploadStats", &Player::getTextureUploadStats)
+            .def("getDrawCallCount", &Player::getDrawCallCount)
             .def("createNode", &Player::createNodeFromXmlString)
             .def("createNode", &Player::createNode, Player_createNode_overloads())
             .def("enableMultitouch", &Player::enableMultitouch)
@@ -293,6 +315,8 @@ BOOST_PYTHON_MODULE(avg)
             .add_property("autorender", &OffscreenCanvas::getAutoRender,
                     &OffscreenCanvas::setAutoRender)
             .def("getNumDependentCanvases", &OffscreenCanvas::getNumDependentCanvases)
+            .add_property("numrenderedframes", &OffscreenCanvas::getNumRenderedFrames)
+            .add_property("numskippedframes", &OffscreenCanvas::getNumSkippedFrames)
             .def("isSupported", &OffscreenCanvas::isSupported)
             .staticmethod("isSupported")
             .def("isMultisampleSupported", &OffscreenCanvas::isMultisampleSupported)
@@ -349,6 +373,34 @@ BOOST_PYTHON_MODULE(avg)
             .add_property("builder", &VersionInfo::getBuilder)
             .add_property("buildtime", &VersionInfo::getBuildTime)
             ;
+
+        class_<FrameStageStats>("FrameStageStats", no_init)
+            .def_readonly("p50", &FrameStageStats::m_P50)
+            .def_readonly("p95", &FrameStageStats::m_P95)
+            .def_readonly("p99", &FrameStageStats::m_P99)
+            .def_readonly("max", &FrameStageStats::m_Max)
+            ;
+
+        class_<FrameStatsSummary>("FrameStats", no_init)
+            .def_readonly("numframes", &FrameStatsSummary::m_NumFrames)
+            .def_readonly("numlateframes", &FrameStatsSummary::m_NumLateFrames)
+            .def_readonly("frame", &FrameStatsSummary::m_Frame)
+            .def_readonly("timers", &FrameStatsSummary::m_Timers)
+            .def_readonly("events", &FrameStatsSummary::m_Events)
+            .def_readonly("offscreen", &FrameStatsSummary::m_Offscreen)
+            .def_readonly("render", &FrameStatsSummary::m_Render)
+            .def_readonly("wait", &FrameStatsSummary::m_Wait)
+            .def_readonly("swap", &FrameStatsSummary::m_Swap)
+            ;
+
+        class_<TextureUploadStats>("TextureUploadStats", no_init)
+            .def_readonly("numpending", &TextureUploadStats::m_NumPending)
+            .def_readonly("pendingbytes", &TextureUploadStats::m_PendingBytes)
+            .def_readonly("numuploaded", &TextureUploadStats::m_NumUploaded)
+            .def_readonly("uploadedbytes", &TextureUploadStats::m_UploadedBytes)
+            .def_readonly("lastframebytes", &TextureUploadStats::m_LastFrameBytes)
+            .def_readonly("lastframetime", &TextureUploadStats::m_LastFrameTime)
+            ;
     } catch (const exception& e) {
         PyErr_SetString(PyExc_RuntimeError, e.what());
         throw error_already_set();
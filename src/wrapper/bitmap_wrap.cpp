@@ -23,6 +23,7 @@
 
 #include "../player/BoostPython.h"
 #include "../player/BitmapManager.h"
+#include "../player/ImageCache.h"
 
 #include "../graphics/Bitmap.h"
 #include "../graphics/BitmapLoader.h"
@@ -114,7 +115,7 @@ BitmapPtr createBitmapWithRect(BitmapPtr pBmp,
 }
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(loadBitmap_overloads, BitmapManager::loadBitmapPy, 
-        2, 3);
+        2, 4);
 
 void export_bitmap()
 {
@@ -191,12 +192,38 @@ void export_bitmap()
                 return_value_policy<copy_const_reference>())
     ;
     
-    class_<BitmapManager>("BitmapManager", no_init)
+    class_<BitmapManager, boost::noncopyable>("BitmapManager", no_init)
         .def("get", &BitmapManager::get,
                 return_value_policy<reference_existing_object>())
         .staticmethod("get")
         .def("loadBitmap", &BitmapManager::loadBitmapPy, loadBitmap_overloads())
         .def("setNumThreads", &BitmapManager::setNumThreads)
+        .def("getNumPendingJobs", &BitmapManager::getNumPendingJobs)
+        .add_property("deliverybudget", &BitmapManager::getDeliveryBudget,
+                &BitmapManager::setDeliveryBudget)
+    ;
+
+    class_<BitmapManagerMsg, BitmapManagerMsgPtr, boost::noncopyable>(
+            "BitmapManagerMsg", no_init)
+        .def("cancel", &BitmapManagerMsg::cancel)
+        .def("isCancelled", &BitmapManagerMsg::isCancelled)
+        .add_property("priority", &BitmapManagerMsg::getPriority, 
+                &BitmapManagerMsg::setPriority)
+    ;
+
+    class_<ImageCache>("ImageCache", no_init)
+        .def("get", &ImageCache::get,
+                return_value_policy<reference_existing_object>())
+        .staticmethod("get")
+        .def("clear", &ImageCache::clear)
+        .def("setBudget", &ImageCache::setBudget)
+        .def("getBudget", &ImageCache::getBudget)
+        .def("getMemUsed", &ImageCache::getMemUsed)
+        .def("getNumEntries", &ImageCache::getNumEntries)
+        .def("getNumHits", &ImageCache::getNumHits)
+        .def("getNumMisses", &ImageCache::getNumMisses)
+        .def("getHitRate", &ImageCache::getHitRate)
+        .def("resetStatistics", &ImageCache::resetStatistics)
     ;
 
     class_<CubicSpline, boost::noncopyable>("CubicSpline", no_init)
@@ -36,6 +36,7 @@ void export_devices();
 #include "../player/AVGNode.h"
 #include "../player/CanvasNode.h"
 #include "../player/DivNode.h"
+#include "../player/NodeTemplate.h"
 #include "../player/SoundNode.h"
 #include "../player/LineNode.h"
 #include "../player/RectNode.h"
@@ -54,6 +55,11 @@ using namespace avg;
 using namespace std;
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(unlink_overloads, Node::unlink, 0, 1);
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(clone_overloads, Node::clone, 0, 1);
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(instantiate_overloads, 
+        NodeTemplate::instantiate, 0, 1);
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(instantiateMany_overloads, 
+        NodeTemplate::instantiateMany, 1, 2);
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(disconnectEventHandler_overloads, 
         Node::disconnectEventHandler, 1, 2);
 
@@ -97,6 +103,9 @@ void export_node()
     to_python_converter<VectorVec2Vector, to_list<VectorVec2Vector> >();
     from_python_sequence<VectorVec2Vector, variable_capacity_policy>();
 
+    to_python_converter<vector<NodePtr>, to_list<vector<NodePtr> > >();
+    from_python_sequence<vector<NodePtr>, variable_capacity_policy>();
+
     object nodeClass = class_<Node, boost::shared_ptr<Node>, bases<Publisher>, 
             boost::noncopyable>("Node", no_init)
         .add_property("id", make_function(&Node::getID,
@@ -104,6 +113,7 @@ void export_node()
         .def("registerInstance", &Node::registerInstance)
         .def("getParent", &Node::getParent)
         .def("unlink", &Node::unlink, unlink_overloads(args("bKill")))
+        .def("clone", &Node::clone, clone_overloads(args("deep")))
         .def("setEventCapture", &Node::setMouseEventCapture)
         .def("setEventCapture", &Node::setEventCapture)
         .def("releaseEventCapture", &Node::releaseMouseEventCapture)
@@ -156,6 +166,7 @@ void export_node()
         .def("getChild", make_function(&DivNode::getChild,
                 return_value_policy<copy_const_reference>()))
         .def("appendChild", &DivNode::appendChild)
+        .def("appendChildren", &DivNode::appendChildren)
         .def("insertChildBefore", &DivNode::insertChildBefore)
         .def("insertChildAfter", &DivNode::insertChildAfter)
         .def("insertChild", &DivNode::insertChild)
@@ -171,6 +182,17 @@ void export_node()
                 return_value_policy<copy_const_reference>()), &DivNode::setMediaDir)
     ;
 
+    class_<NodeTemplate, NodeTemplatePtr, boost::noncopyable>("NodeTemplate",
+            init<NodePtr, optional<bool> >())
+        .def("instantiate", &NodeTemplate::instantiate, 
+                instantiate_overloads(args("parent")))
+        .def("instantiateMany", &NodeTemplate::instantiateMany, 
+                instantiateMany_overloads(args("numnodes", "parent")))
+        .add_property("type", make_function(&NodeTemplate::getTypeStr,
+                return_value_policy<copy_const_reference>()))
+        .add_property("numnodes", &NodeTemplate::getNumNodes)
+    ;
+
     class_<CanvasNode, bases<DivNode> >("CanvasNode",
             no_init)
     ;
@@ -27,6 +27,8 @@
 #include "../player/VideoNode.h"
 #include "../player/FontStyle.h"
 #include "../player/WordsNode.h"
+#include "../player/GlyphCache.h"
+#include "../video/VideoDecoderPool.h"
 
 using namespace boost::python;
 using namespace avg;
@@ -174,6 +176,7 @@ void export_raster()
         .def("getNumAudioChannels", &VideoNode::getNumAudioChannels)
         .def("getCurTime", &VideoNode::getCurTime)
         .def("seekToTime", &VideoNode::seekToTime)
+        .def("seekToKeyframe", &VideoNode::seekToKeyframe)
         .def("hasAudio", &VideoNode::hasAudio)
         .def("hasAlpha", &VideoNode::hasAlpha)
         .def("setEOFCallback", &VideoNode::setEOFCallback)
@@ -191,6 +194,24 @@ void export_raster()
         .add_property("accelerated", &VideoNode::isAccelerated)
     ;
 
+    class_<GlyphCache, boost::noncopyable>("GlyphCache", no_init)
+        .def("get", &GlyphCache::get,
+                return_value_policy<reference_existing_object>())
+        .staticmethod("get")
+        .def("clear", &GlyphCache::clear)
+        .def("getNumPages", &GlyphCache::getNumPages)
+        .def("getNumTextures", &GlyphCache::getNumTextures)
+    ;
+
+    class_<VideoDecoderPool, boost::noncopyable>("VideoDecoderPool", no_init)
+        .def("get", &VideoDecoderPool::get,
+                return_value_policy<reference_existing_object>())
+        .staticmethod("get")
+        .def("setNumThreads", &VideoDecoderPool::setNumThreads)
+        .def("getNumThreads", &VideoDecoderPool::getNumThreads)
+        .def("getNumTasks", &VideoDecoderPool::getNumTasks)
+    ;
+
     class_<FontStyle, bases<ExportedObject> >("FontStyle", no_init)
         .def("__init__", raw_constructor(createExportedObject<fontStyleName>))
         .def("__copy__", copyObject<FontStyle>)
@@ -261,6 +282,10 @@ void export_raster()
         .add_property("letterspacing", &WordsNode::getLetterSpacing, 
                 &WordsNode::setLetterSpacing)
         .add_property("hint", &WordsNode::getHint, &WordsNode::setHint)
+        .add_property("glyphcache", &WordsNode::getGlyphCache, 
+                &WordsNode::setGlyphCache)
+        .add_property("asyncrender", &WordsNode::getAsyncRender, 
+                &WordsNode::setAsyncRender)
         .def("getGlyphPos", &WordsNode::getGlyphPos)
         .def("getGlyphSize", &WordsNode::getGlyphSize)
         .def("getNumLines", &WordsNode::getNumLines)